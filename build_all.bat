@@ -83,4 +83,8 @@ REM Tests Executable
 make -j -f Makefile.exe.mak %ACTION% TARGET=%TARGET% ASSEMBLY=tests PLATFORM=%PLATFORM_DIR% LDFLAGS="-Lbuild\%PLATFORM_DIR%\bin -lengine -lgame -leditor"
 IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit /b %ERRORLEVEL%)
 
+REM Benchmarks Executable
+make -j -f Makefile.exe.mak %ACTION% TARGET=%TARGET% ASSEMBLY=benchmarks PLATFORM=%PLATFORM_DIR% LDFLAGS="-Lbuild\%PLATFORM_DIR%\bin -lsdl3 -lengine"
+IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit /b %ERRORLEVEL%)
+
 ECHO All assemblies %ACTION_STR_PAST% successfully.
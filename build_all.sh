@@ -91,4 +91,11 @@ if [ $? -ne 0 ]; then
     exit $?
 fi
 
+# Benchmarks Executable
+make -j -f Makefile.exe.mak $ACTION TARGET=$TARGET ASSEMBLY=benchmarks PLATFORM=$PLATFORM_DIR LDFLAGS="-Lbuild/$PLATFORM_DIR/bin -lengine -lSDL3"
+if [ $? -ne 0 ]; then
+    echo "Error: $?"
+    exit $?
+fi
+
 echo "All assemblies $ACTION_STR_PAST successfully."
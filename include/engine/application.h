@@ -2,6 +2,7 @@
 #define ENGINE_APPLICATION_H
 
 #include "engine/defines.h"
+#include "engine/platform.h"
 #include "engine/renderer.h"
 #include "engine/window.h"
 
@@ -11,9 +12,27 @@ typedef struct Application Application;
 typedef struct MemoryPool MemoryPool;
 typedef struct Platform Platform;
 
+// Default fixed-timestep settings used when the configuration leaves them as 0.
+#define APPLICATION_DEFAULT_FIXED_UPDATE_RATE 60
+#define APPLICATION_DEFAULT_MAX_FIXED_STEPS 8
+
+// Longest frame (in seconds) fed into the simulation, e.g. after a breakpoint.
+#define APPLICATION_MAX_FRAME_TIME 0.25
+
 // Callback function types.
 typedef void (*AppUpdateFunc)(f32 deltaTime);
-typedef void (*AppRenderFunc)(void);
+typedef void (*AppFixedUpdateFunc)(f32 fixedDeltaTime);
+typedef void (*AppRenderFunc)(f32 alpha);
+
+/**
+ * @brief Controls when the application loop updates and presents a frame.
+ */
+typedef enum ApplicationRedrawMode {
+    /** @brief Update, render and present on every iteration of the run loop (games). */
+    APPLICATION_REDRAW_CONTINUOUS = 0,
+    /** @brief Sleep in the platform event wait until input, a timeout, or a redraw request arrives (tools). */
+    APPLICATION_REDRAW_ON_DEMAND,
+} ApplicationRedrawMode;
 
 /**
  * @brief Application configuration structure for initialization.
@@ -24,6 +43,11 @@ typedef struct ApplicationConfig {
     AppUpdateFunc update;    /**< Update callback function. */
     AppRenderFunc render;    /**< Render callback function. */
     // TODO: Add other callbacks.
+    AppFixedUpdateFunc fixedUpdate;   /**< Optional fixed-timestep simulation callback. */
+    u32 fixedUpdateRate;              /**< Fixed updates per second (0 uses APPLICATION_DEFAULT_FIXED_UPDATE_RATE). */
+    u32 maxFixedStepsPerFrame;        /**< Catch-up cap per frame (0 uses APPLICATION_DEFAULT_MAX_FIXED_STEPS). */
+    ApplicationRedrawMode redrawMode; /**< When frames are produced. Defaults to continuous. */
+    u32 idleTimeoutMs;                /**< On-demand only: longest idle sleep before a timer frame (0 sleeps until woken). */
 } ApplicationConfig;
 
 /**
@@ -37,6 +61,15 @@ typedef struct Application {
     AppRenderFunc render;   /**< Render callback function. */
     MemoryPool *memoryPool; /**< Pointer to the memory pool instance. */
     // TODO: Add other internal state (i.e. input, audio, etc.).
+    AppFixedUpdateFunc fixedUpdate;    /**< Fixed-timestep simulation callback. */
+    f64 fixedDeltaTime;                /**< Duration of one fixed step in seconds. */
+    f64 fixedAccumulator;              /**< Unsimulated time carried between frames in seconds. */
+    u32 maxFixedStepsPerFrame;         /**< Maximum fixed steps run in a single frame. */
+    f32 interpolationAlpha;            /**< Fraction of a fixed step left in the accumulator. */
+    ApplicationRedrawMode redrawMode;  /**< When frames are produced. */
+    u32 idleTimeoutMs;                 /**< Longest idle sleep in milliseconds (0 sleeps until woken). */
+    u32 continuousUpdateRequests;      /**< Number of outstanding requests for continuous updates. */
+    PlatformAtomicI32 redrawRequested; /**< Non-zero if a frame has been requested since the last one. */
 } Application;
 
 /**
@@ -57,6 +90,46 @@ ENGINE_API EngineResult application_init(Engine *engine, const ApplicationConfig
  */
 ENGINE_API void application_run(Application *app);
 
+/**
+ * @brief Gets the interpolation factor between the previous and current fixed
+ * simulation states, as last passed to the render callback.
+ *
+ * @param app A pointer to the application structure.
+ * @return f32 A value in [0, 1), or 1 if no fixed update callback is set.
+ */
+ENGINE_API f32 application_get_interpolation_alpha(const Application *app);
+
+/**
+ * @brief Requests that the application produces at least one more frame.
+ *
+ * In on-demand mode this wakes the run loop if it is sleeping. In continuous
+ * mode it has no effect. Safe to call from any thread.
+ *
+ * @param app A pointer to the application structure.
+ * @return void
+ */
+ENGINE_API void application_request_redraw(Application *app);
+
+/**
+ * @brief Asks the application to keep producing frames every iteration, even in
+ * on-demand mode (e.g. while an animation or simulation is playing).
+ *
+ * Requests are counted; every call must be paired with
+ * application_end_continuous_updates.
+ *
+ * @param app A pointer to the application structure.
+ * @return void
+ */
+ENGINE_API void application_begin_continuous_updates(Application *app);
+
+/**
+ * @brief Releases a request made with application_begin_continuous_updates.
+ *
+ * @param app A pointer to the application structure.
+ * @return void
+ */
+ENGINE_API void application_end_continuous_updates(Application *app);
+
 /**
  * @brief Shuts down the application and frees resources.
  *
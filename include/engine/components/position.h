@@ -0,0 +1,29 @@
+/**
+ * @file position.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief Position component.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef COMPONENT_POSITION_H
+#define COMPONENT_POSITION_H
+
+#include "engine/defines.h"
+#include "engine/ecs/ecs.h"
+
+/**
+ * @brief World-space position of an entity.
+ */
+typedef struct Position {
+    f32 x; /**< X component. */
+    f32 y; /**< Y component. */
+    f32 z; /**< Z component. */
+} Position;
+
+// Static component ID of Position, defined by the engine.
+ENGINE_API ECS_COMPONENT_EXTERN(Position);
+
+#endif // COMPONENT_POSITION_H
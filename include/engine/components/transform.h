@@ -0,0 +1,54 @@
+/**
+ * @file transform.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief Local and world transform components.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef COMPONENT_TRANSFORM_H
+#define COMPONENT_TRANSFORM_H
+
+#include "engine/defines.h"
+
+/**
+ * @brief Transform of an entity relative to its parent: scale, then
+ * rotation, then translation. The rotation is kept as the cosine and sine of
+ * its angle so propagation needs no trigonometry.
+ */
+typedef struct Transform {
+    f32 x;      /**< X translation in the parent's space. */
+    f32 y;      /**< Y translation in the parent's space. */
+    f32 z;      /**< Depth, added to the parent's. */
+    f32 cosine; /**< Cosine of the rotation angle (1 for no rotation). */
+    f32 sine;   /**< Sine of the rotation angle (0 for no rotation). */
+    f32 scaleX; /**< Scale along the local x axis. */
+    f32 scaleY; /**< Scale along the local y axis. */
+} Transform;
+
+/**
+ * @brief Local-to-world affine transform: a point (px, py) maps to
+ * (a * px + c * py + x, b * px + d * py + y).
+ */
+typedef struct WorldTransform {
+    f32 a; /**< Row 0, column 0 of the linear part. */
+    f32 b; /**< Row 1, column 0 of the linear part. */
+    f32 c; /**< Row 0, column 1 of the linear part. */
+    f32 d; /**< Row 1, column 1 of the linear part. */
+    f32 x; /**< World x translation. */
+    f32 y; /**< World y translation. */
+    f32 z; /**< World depth. */
+} WorldTransform;
+
+/**
+ * @brief Gets the identity transform.
+ *
+ * @return Transform A transform with no translation, rotation or scaling.
+ */
+static ENGINE_INLINE Transform transform_identity(void) {
+    return (Transform){0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f};
+}
+
+#endif // COMPONENT_TRANSFORM_H
@@ -0,0 +1,29 @@
+/**
+ * @file velocity.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief Velocity component.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef COMPONENT_VELOCITY_H
+#define COMPONENT_VELOCITY_H
+
+#include "engine/defines.h"
+#include "engine/ecs/ecs.h"
+
+/**
+ * @brief Linear velocity of an entity in units per second.
+ */
+typedef struct Velocity {
+    f32 vx; /**< X component. */
+    f32 vy; /**< Y component. */
+    f32 vz; /**< Z component. */
+} Velocity;
+
+// Static component ID of Velocity, defined by the engine.
+ENGINE_API ECS_COMPONENT_EXTERN(Velocity);
+
+#endif // COMPONENT_VELOCITY_H
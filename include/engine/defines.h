@@ -76,6 +76,10 @@
 #define ENGINE_ARRAY_COUNT(arr) (sizeof(arr) / sizeof((arr)[0])) // Get array element count.
 #define ENGINE_ALIGN(x) __attribute__((aligned(x)))              // Align data to x bytes.
 #define ENGINE_INLINE inline                                     // Inline function.
+#define ENGINE_NOINLINE __attribute__((noinline))                // Never inline function.
+#define ENGINE_CONSTRUCTOR __attribute__((constructor))          // Run function when the binary loads, before main.
+#define ENGINE_THREAD_LOCAL _Thread_local                        // Per-thread variable.
+#define ENGINE_CACHE_LINE_SIZE 64                                // Assumed CPU cache line size in bytes.
 
 // Common typedefs
 #include <stdbool.h>
@@ -0,0 +1,209 @@
+/**
+ * @file command_buffer.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief Deferred ECS structural changes. Threads record entity creation and
+ * destruction and component adds and removes into their own arena-backed
+ * buffer; the queue plays every buffer back at a sync point.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef ENGINE_ECS_COMMAND_BUFFER_H
+#define ENGINE_ECS_COMMAND_BUFFER_H
+
+#include "engine/defines.h"
+#include "engine/ecs/ecs.h"
+#include "engine/job_system.h"
+
+// Size of each arena block a command buffer records into. Blocks are kept
+// across playbacks, so a buffer stops allocating once it has seen its
+// busiest frame.
+#define ECS_COMMAND_BLOCK_SIZE (64 * 1024)
+
+// One buffer per job system worker, plus one shared by threads outside the pool.
+#define ECS_COMMAND_MAX_BUFFERS (JOB_SYSTEM_MAX_WORKERS + 1)
+
+// Generation bit marking an entity handle returned by
+// ecs_command_create_entity that has not been played back yet.
+#define ECS_COMMAND_PENDING_GENERATION 0x80000000u
+
+// =============================================================================
+#pragma region Types
+
+/**
+ * @brief Kinds of recorded command.
+ */
+typedef enum EcsCommandType {
+    ECS_COMMAND_CREATE = 0, /**< Create an entity. */
+    ECS_COMMAND_DESTROY,    /**< Destroy an entity. */
+    ECS_COMMAND_ADD,        /**< Add a component to an entity. */
+    ECS_COMMAND_REMOVE      /**< Remove a component from an entity. */
+} EcsCommandType;
+
+/**
+ * @brief One recorded command. Commands are written from the front of an
+ * arena block and component data from the back.
+ */
+typedef struct EcsCommand {
+    u64 sortKey;             /**< Orders playback across buffers. */
+    Entity entity;           /**< The target entity, possibly pending. */
+    EcsCommandType type;     /**< What the command does. */
+    ComponentType component; /**< The component type of an add or remove. */
+    const void *data;        /**< Component data of an add, NULL to zero it. */
+} EcsCommand;
+
+/**
+ * @brief An arena block. The header is followed by the block's memory.
+ */
+typedef struct EcsCommandBlock {
+    struct EcsCommandBlock *next; /**< The next block of the buffer. */
+    u32 size;                     /**< Bytes of memory after the header. */
+    u32 commandCount;             /**< Commands written from the front. */
+    u32 dataOffset;               /**< Start of the component data written from the back. */
+} EcsCommandBlock;
+
+/**
+ * @brief Commands recorded by one thread. Only that thread writes to it.
+ */
+typedef struct EcsCommandBuffer {
+    ECSManager *ecs;         /**< The ECS the commands apply to. */
+    EcsCommandBlock *first;  /**< The first arena block. */
+    EcsCommandBlock *active; /**< The block being written. */
+    u32 index;               /**< The buffer's slot in its queue. */
+    u32 commandCount;        /**< Commands recorded since the last playback. */
+    u32 createCount;         /**< Entities created since the last playback. */
+} ENGINE_ALIGN(ENGINE_CACHE_LINE_SIZE) EcsCommandBuffer;
+
+/**
+ * @brief A recorded command gathered for playback.
+ */
+typedef struct EcsCommandRef {
+    u64 key;                   /**< The sort key of the current playback phase. */
+    const EcsCommand *command; /**< The command. */
+    u32 buffer;                /**< The buffer that recorded it. */
+    Entity entity;             /**< The target entity, resolved once pending handles are created. */
+} EcsCommandRef;
+
+/**
+ * @brief Per-thread command buffers and the scratch memory to play them back.
+ */
+typedef struct EcsCommandQueue {
+    ECSManager *ecs;                                   /**< The ECS the commands apply to. */
+    EcsCommandBuffer buffers[ECS_COMMAND_MAX_BUFFERS]; /**< One buffer per worker, then the external buffer. */
+    EcsCommandRef *refs;                               /**< Gathered commands. */
+    EcsCommandRef *scratch;                            /**< Radix sort scratch, as large as refs. */
+    u32 refCapacity;                                   /**< The capacity of refs and scratch. */
+    Entity *created;                                   /**< Real entities of pending handles, buffer by buffer. */
+    u32 createdCapacity;                               /**< The capacity of created. */
+    u32 createdOffsets[ECS_COMMAND_MAX_BUFFERS];       /**< Index of each buffer's first entity in created. */
+} EcsCommandQueue;
+
+#pragma endregion
+// =============================================================================
+#pragma region Interface
+
+/**
+ * @brief Checks whether an entity handle was returned by
+ * ecs_command_create_entity and not played back yet. A pending handle is only
+ * valid in commands recorded to the same queue before the next playback.
+ *
+ * @param entity The entity handle.
+ * @return b8 True if the handle is pending.
+ */
+static ENGINE_INLINE b8 ecs_entity_is_pending(Entity entity) {
+    return entity != INVALID_ENTITY && (ecs_entity_generation(entity) & ECS_COMMAND_PENDING_GENERATION) != 0;
+}
+
+/**
+ * @brief Initializes a command queue. Nothing is allocated until commands are
+ * recorded.
+ *
+ * @param queue A pointer to the queue to initialize.
+ * @param ecs A pointer to the ECS the commands apply to.
+ * @return ENGINE_SUCCESS if the queue was initialized, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_command_queue_init(EcsCommandQueue *queue, ECSManager *ecs);
+
+/**
+ * @brief Frees every arena block and scratch array. Unplayed commands are
+ * discarded.
+ *
+ * @param queue A pointer to the queue.
+ * @return void
+ */
+ENGINE_API void ecs_command_queue_shutdown(EcsCommandQueue *queue);
+
+/**
+ * @brief Gets the calling thread's buffer: one per job system worker, and a
+ * single buffer shared by threads outside the pool, which must not record at
+ * the same time.
+ *
+ * @param queue A pointer to the queue.
+ * @return EcsCommandBuffer* The calling thread's buffer.
+ */
+ENGINE_API EcsCommandBuffer *ecs_command_queue_get_buffer(EcsCommandQueue *queue);
+
+/**
+ * @brief Plays back every buffer and rewinds them, keeping their blocks. Must
+ * be called from a sync point, when no thread is recording or iterating.
+ *
+ * Commands are first put in sort key order; commands with equal keys keep the
+ * order they were recorded in, so the result does not depend on which thread
+ * recorded what as long as each key is only used from one thread at a time.
+ * Creates are then applied in that order, adds and removes grouped by
+ * component type (sparse-set storage) or by the entity's archetype (archetype
+ * storage) and then entity index, and destroys last.
+ *
+ * @param queue A pointer to the queue.
+ * @return u32 The number of commands played back.
+ */
+ENGINE_API u32 ecs_command_queue_flush(EcsCommandQueue *queue);
+
+/**
+ * @brief Records the creation of an entity.
+ *
+ * @param buffer A pointer to the calling thread's buffer.
+ * @param sortKey Orders the command against other buffers.
+ * @return Entity A pending handle for later commands, or INVALID_ENTITY on failure.
+ */
+ENGINE_API Entity ecs_command_create_entity(EcsCommandBuffer *buffer, u64 sortKey);
+
+/**
+ * @brief Records the destruction of an entity.
+ *
+ * @param buffer A pointer to the calling thread's buffer.
+ * @param sortKey Orders the command against other buffers.
+ * @param entity The entity, live or pending.
+ * @return void
+ */
+ENGINE_API void ecs_command_destroy_entity(EcsCommandBuffer *buffer, u64 sortKey, Entity entity);
+
+/**
+ * @brief Records adding a component, copying its data into the buffer.
+ *
+ * @param buffer A pointer to the calling thread's buffer.
+ * @param sortKey Orders the command against other buffers.
+ * @param entity The entity, live or pending.
+ * @param type The component type.
+ * @param componentData The component to copy, or NULL to zero-initialize it at playback.
+ * @return void* A pointer to the recorded copy, which may be written until playback, or NULL on failure or if componentData is NULL.
+ */
+ENGINE_API void *ecs_command_add_component(EcsCommandBuffer *buffer, u64 sortKey, Entity entity, ComponentType type, const void *componentData);
+
+/**
+ * @brief Records removing a component.
+ *
+ * @param buffer A pointer to the calling thread's buffer.
+ * @param sortKey Orders the command against other buffers.
+ * @param entity The entity, live or pending.
+ * @param type The component type.
+ * @return void
+ */
+ENGINE_API void ecs_command_remove_component(EcsCommandBuffer *buffer, u64 sortKey, Entity entity, ComponentType type);
+
+#pragma endregion
+// =============================================================================
+
+#endif // ENGINE_ECS_COMMAND_BUFFER_H
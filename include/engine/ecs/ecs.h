@@ -0,0 +1,977 @@
+/**
+ * @file ecs.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief Entity Component System. Entities are generational handles. Components are stored
+ * either per type in packed sparse sets, or per archetype in fixed-size
+ * chunks with one packed column per component type.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef ENGINE_ECS_H
+#define ENGINE_ECS_H
+
+#include "engine/defines.h"
+#include "engine/memory.h"
+#include "engine/platform.h"
+
+// Signature matching compares all 256 bits at once with the widest vector
+// instructions the target was compiled for: AVX2 when enabled, SSE2 on any
+// other x86-64 target, NEON on ARM, and a 64-bit word loop elsewhere.
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#    define ECS_SIGNATURE_SIMD "avx2"
+#elif defined(__x86_64__) || defined(_M_X64)
+#    include <emmintrin.h>
+#    define ECS_SIGNATURE_SIMD "sse2"
+#elif defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define ECS_SIGNATURE_SIMD "neon"
+#else
+#    define ECS_SIGNATURE_SIMD "scalar"
+#endif
+
+#define INVALID_ENTITY MAX_U64
+#define INVALID_COMPONENT_TYPE MAX_U32
+
+// Maximum number of registered component types.
+#define ECS_MAX_COMPONENTS 256
+
+// Entries per sparse page. Pages are allocated the first time an entity in
+// their range gets a component of the type.
+#define ECS_SPARSE_PAGE_SIZE 4096
+
+// Capacity of a packed component array when its first component is added.
+#define ECS_DENSE_INITIAL_CAPACITY 64
+
+// Alignment of packed component arrays.
+#define ECS_COMPONENT_ALIGNMENT ENGINE_CACHE_LINE_SIZE
+
+// Size of an archetype chunk in bytes. Chosen to fit comfortably in L1/L2
+// while holding a few hundred typical entities.
+#define ECS_CHUNK_SIZE (16 * 1024)
+
+// Minimum alignment of each column inside an archetype chunk. Columns of
+// types with a larger alignment, up to ECS_COMPONENT_ALIGNMENT, use theirs.
+#define ECS_COLUMN_ALIGNMENT 16
+
+// Number of 64-bit words in a component signature.
+#define ECS_SIGNATURE_WORDS (ECS_MAX_COMPONENTS / 64)
+
+// Maximum number of components requested by one ecs_each call, and of
+// required plus optional terms in one query.
+#define ECS_MAX_VIEW_COMPONENTS 16
+
+// Maximum number of excluded component types in one query.
+#define ECS_MAX_QUERY_EXCLUDED 16
+
+// Packed rows sharing one change version in sparse-set storage. Archetype
+// storage keeps one version per column per chunk.
+#define ECS_CHANGE_BLOCK_SIZE 256
+
+// A sort that finds more than 1/ECS_SORT_RADIX_FRACTION of a sorted array's
+// rows out of place, or would shift more rows by insertion than the array
+// holds, radix sorts it instead.
+#define ECS_SORT_RADIX_FRACTION 8
+
+// Declares the static ID of a component type defined with ECS_COMPONENT, for
+// use in headers.
+#define ECS_COMPONENT_EXTERN(T) extern ComponentType ECS_ID_##T
+
+// Defines the static ID of a component type in exactly one source file. The ID
+// is assigned when the binary loads, before main, and every ECS initialized
+// afterwards registers the type under it.
+#define ECS_COMPONENT(T)                                                          \
+    ComponentType ECS_ID_##T = INVALID_COMPONENT_TYPE;                            \
+    ENGINE_CONSTRUCTOR static void ecs_component_declare_##T(void) {              \
+        ECS_ID_##T = ecs_component_declare(#T, (u32)sizeof(T), (u32)_Alignof(T)); \
+    }
+
+// Defines the static ID of a tag: a component type with no data, such as an
+// Enemy or Selected marker. Declare it in headers with ECS_COMPONENT_EXTERN.
+#define ECS_TAG(T)                                             \
+    ComponentType ECS_ID_##T = INVALID_COMPONENT_TYPE;         \
+    ENGINE_CONSTRUCTOR static void ecs_tag_declare_##T(void) { \
+        ECS_ID_##T = ecs_component_declare(#T, 0, 1);          \
+    }
+
+// The static ID of a component type defined with ECS_COMPONENT or ECS_TAG.
+#define ECS_ID(T) ECS_ID_##T
+
+// =============================================================================
+#pragma region Types
+
+/**
+ * @brief Entity handle: the entity's index in the low 32 bits and the
+ * generation of that index in the high 32 bits. Destroying an entity bumps
+ * its index's generation, so stale handles are detected instead of aliasing
+ * the next entity to reuse the index.
+ */
+typedef u64 Entity;
+typedef u32 ComponentType;
+
+typedef struct EcsQuery EcsQuery;
+
+/**
+ * @brief How an ECS stores component data.
+ */
+typedef enum ECSStorage {
+    ECS_STORAGE_SPARSE_SET = 0, /**< One packed sparse set per component type. Cheap add/remove; joins need a lookup per entity. */
+    ECS_STORAGE_ARCHETYPE,      /**< Entities grouped by component signature in chunks. Joins are linear; add/remove move the entity. */
+} ECSStorage;
+
+/**
+ * @brief Configuration structure for initializing an ECS.
+ */
+typedef struct ECSConfig {
+    ECSStorage storage; /**< Component storage layout. */
+} ECSConfig;
+
+/**
+ * @brief Set of component types, one bit per type.
+ */
+typedef struct EcsSignature {
+    u64 bits[ECS_SIGNATURE_WORDS]; /**< Bit (type % 64) of word (type / 64) is set if the type is present. */
+} EcsSignature;
+
+/**
+ * @brief Entity manager structure.
+ */
+typedef struct EntityManager {
+    u32 nextIndex;          /**< The next never-used entity index. */
+    u32 *generations;       /**< Current generation of each index handed out. */
+    u32 generationCapacity; /**< The length of the generations array. */
+    u32 *freeIndices;       /**< Indices of destroyed entities that can be reused. */
+    u32 freeCount;          /**< The number of reusable indices. */
+    u32 freeCapacity;       /**< The length of the freeIndices array. */
+} EntityManager;
+
+/**
+ * @brief Extracts the sort key of a component kept sorted by ecs_sort_by.
+ * Components are ordered by ascending key; equal keys keep their order.
+ *
+ * @param component A pointer to the component.
+ * @return u64 The component's key.
+ */
+typedef u64 (*EcsSortKeyFunc)(const void *component);
+
+/**
+ * @brief Sparse set holding every component of one type.
+ *
+ * Component data is packed: the component at dense index i lives at
+ * data + i * size and belongs to entities[i]. Removing a component moves the
+ * last component's bytes into the hole, so the array never has gaps and
+ * systems can walk it linearly. The packed arrays double when full.
+ *
+ * The sparse array is split into ECS_SPARSE_PAGE_SIZE entry pages that are
+ * only allocated once an entity in their range gets the component, so memory
+ * follows the entities actually using the type rather than the highest ID.
+ * Each ECS_CHANGE_BLOCK_SIZE rows of the packed arrays share a change version.
+ * An array owned by a group keeps the group's entities in its first rows.
+ * A tag (size 0) has no sparse pages or packed arrays: its members are the
+ * entities whose signature has its bit, and count tracks them. data points at
+ * one shared placeholder so a present tag's column is not NULL.
+ * A sorted array also caches the sort key of each packed row.
+ * In archetype storage only count and size are used.
+ */
+typedef struct ComponentArray {
+    u8 *data;               /**< Packed component data, count * size bytes in use. */
+    Entity *entities;       /**< Owning entity of each packed component. */
+    u32 **sparsePages;      /**< Dense index of each entity index's component, INVALID_ID_U32 if it has none. NULL pages hold no entries. */
+    u32 sparsePageCount;    /**< The length of the sparsePages array. */
+    u32 *versions;          /**< Change version of each block of ECS_CHANGE_BLOCK_SIZE packed rows. */
+    u32 count;              /**< The number of entities that have this component. */
+    u32 capacity;           /**< The number of components data and entities can hold. */
+    u32 size;               /**< The size of the component in bytes, 0 for a tag. */
+    u32 alignment;          /**< The alignment of the component in bytes. */
+    const char *name;       /**< The type's name if declared with ECS_COMPONENT, otherwise NULL. */
+    u32 group;              /**< Index of the group that owns the array, INVALID_ID_U32 if none. */
+    EcsSortKeyFunc sortKey; /**< Extracts each component's sort key, or NULL if the array is not sorted. */
+    u64 *sortKeys;          /**< Cached key of each packed row. */
+    u32 sortKeyCapacity;    /**< The length of the sortKeys array. */
+    u32 sortedCount;        /**< The number of rows at the last sort; later rows have no cached key. */
+    u32 sortedVersion;      /**< Change version the last sort ran at; blocks changed after it are re-keyed. */
+} ComponentArray;
+
+/**
+ * @brief An owning group over sparse sets.
+ *
+ * The entities that have every owned type fill the first count rows of each
+ * owned array, in the same order, so row i of every owned array belongs to
+ * the same entity and the group is walked as parallel linear arrays. Adding
+ * the last missing owned type swaps an entity into the prefix and removing
+ * one swaps it out. A component array is owned by at most one group.
+ */
+typedef struct EcsGroup {
+    ComponentType types[ECS_MAX_VIEW_COMPONENTS]; /**< Owned component types. */
+    u32 typeCount;                                /**< The number of owned types. */
+    u32 count;                                    /**< The number of entities with every owned type. */
+} EcsGroup;
+
+/**
+ * @brief One ECS_CHUNK_SIZE block of an archetype.
+ *
+ * The chunk is laid out as structure-of-arrays: an Entity column followed by
+ * one packed column per component type, each `capacity` rows long, then the
+ * change version of each component column.
+ */
+typedef struct EcsChunk {
+    u8 *memory; /**< ECS_CHUNK_SIZE bytes; the entity column starts at offset 0. */
+    u32 count;  /**< The number of rows in use. */
+} EcsChunk;
+
+/**
+ * @brief Every entity with exactly one set of component types.
+ *
+ * All chunks but the last are full; removing a row moves the archetype's last
+ * row into the hole.
+ */
+typedef struct EcsArchetype {
+    EcsSignature signature; /**< Component types of the archetype. */
+    ComponentType *types;   /**< Component types in ascending order. */
+    u32 *offsets;           /**< Byte offset of each type's column within a chunk. */
+    u32 versionOffset;      /**< Byte offset of the column change versions within a chunk. */
+    u32 typeCount;          /**< The number of component types. */
+    u32 capacity;           /**< Rows per chunk. */
+    EcsChunk *chunks;       /**< Chunks of the archetype. */
+    u32 chunkCount;         /**< The number of chunks in use. */
+    u32 chunkCapacity;      /**< The length of the chunks array. */
+    u8 *spareChunk;         /**< An emptied chunk kept for the next push, or NULL. */
+    u32 entityCount;        /**< The number of entities in the archetype. */
+} EcsArchetype;
+
+/**
+ * @brief Location of an entity's row in archetype storage.
+ */
+typedef struct EcsRecord {
+    u32 archetype; /**< Archetype index, INVALID_ID_U32 if the entity has no components. */
+    u32 chunk;     /**< Chunk index within the archetype. */
+    u32 row;       /**< Row within the chunk. */
+} EcsRecord;
+
+/**
+ * @brief A run of entities handed to an ecs_each or ecs_query_each callback,
+ * with one column per requested component type.
+ *
+ * When rows[t] is NULL, row i of term t is element i of columns[t]. When it is
+ * set (sparse-set queries), row i is element rows[t][i] of columns[t], and
+ * INVALID_ID_U32 marks an absent optional component. columns[t] is NULL when
+ * no row has the component. ecs_view_row() covers every case.
+ */
+typedef struct EcsView {
+    u32 count;                                /**< The number of entities in the view. */
+    const Entity *entities;                   /**< The entity of each row. */
+    void *columns[ECS_MAX_VIEW_COMPONENTS];   /**< Column of each requested type, in request order. */
+    const u32 *rows[ECS_MAX_VIEW_COMPONENTS]; /**< Element index of each row in columns[t], or NULL if rows are packed. */
+} EcsView;
+
+/**
+ * @brief Callback invoked by ecs_each for every view.
+ *
+ * @param view A pointer to the view to process.
+ * @param userData The user data passed to ecs_each.
+ */
+typedef void (*EcsViewFunc)(const EcsView *view, void *userData);
+
+/**
+ * @brief ECS manager structure.
+ */
+typedef struct ECSManager {
+    MemoryPool *pool;                                   /**< Pool all ECS storage is allocated from. */
+    ECSStorage storage;                                 /**< Component storage layout. */
+    EntityManager entityManager;                        /**< The entity manager. */
+    ComponentArray componentArrays[ECS_MAX_COMPONENTS]; /**< Storage per component type. */
+    u32 registeredComponents;                           /**< The number of registered component types. */
+    EcsArchetype *archetypes;                           /**< Archetypes (archetype storage only). */
+    u32 archetypeCount;                                 /**< The number of archetypes. */
+    u32 archetypeCapacity;                              /**< The length of the archetypes array. */
+    EcsRecord *records;                                 /**< Row of each entity index (archetype storage only). */
+    u32 recordCapacity;                                 /**< The length of the records array. */
+    EcsSignature *signatures;                           /**< Component types of each entity index (sparse-set storage only). */
+    u32 signatureCapacity;                              /**< The length of the signatures array. */
+    EcsQuery **queries;                                 /**< Live queries, kept up to date on structural changes. */
+    u32 queryCount;                                     /**< The number of live queries. */
+    u32 queryCapacity;                                  /**< The length of the queries array. */
+    EcsGroup *groups;                                   /**< Owning groups (sparse-set storage only). */
+    u32 groupCount;                                     /**< The number of groups. */
+    u32 groupCapacity;                                  /**< The length of the groups array. */
+    PlatformAtomicI32 changeVersion;                    /**< Version stamped on mutated columns. Each pass of a change-filtered query advances it. */
+} ECSManager;
+
+/**
+ * @brief Component terms of a query. Arrays may be NULL when their count is 0.
+ */
+typedef struct EcsQueryDesc {
+    const ComponentType *required; /**< Types every matched entity has. At least one is needed. */
+    u32 requiredCount;             /**< The number of required types. */
+    const ComponentType *optional; /**< Types passed to the callback when present. */
+    u32 optionalCount;             /**< The number of optional types. */
+    const ComponentType *excluded; /**< Types no matched entity has. */
+    u32 excludedCount;             /**< The number of excluded types. */
+    const ComponentType *writes;   /**< Terms the query's callbacks write. Their columns are marked changed for every view handed out. */
+    u32 writeCount;                /**< The number of written types. */
+    const ComponentType *changed;  /**< Terms to filter on: views only cover data where one of them changed since the query's last pass. */
+    u32 changedCount;              /**< The number of filtered types, 0 to visit everything. */
+} EcsQueryDesc;
+
+/**
+ * @brief A cached query over an ECS.
+ *
+ * In archetype storage the cache is the list of matching archetypes with the
+ * column offset of every term; archetypes created later are appended as they
+ * appear. In sparse-set storage the cache is the list of matching entities
+ * with the dense index of every term. Adding or removing a component of a
+ * type the query mentions marks it stale, and the next iteration rebuilds it
+ * by walking the smallest required set. A sparse-set query whose required
+ * terms are exactly the types of an owning group, with no optional or
+ * excluded terms, has no cache: its views are the group's packed rows.
+ *
+ * A change-filtered query skips chunks (archetype storage) or entities
+ * (sparse-set storage) whose filtered columns have not changed since its last
+ * pass. Changes are tracked per chunk column or per ECS_CHANGE_BLOCK_SIZE
+ * packed rows, so unchanged data is skipped in bulk and a kept view may hold
+ * rows that did not change themselves.
+ */
+typedef struct EcsQuery {
+    ECSManager *ecs;                                /**< The ECS the query belongs to. */
+    ComponentType terms[ECS_MAX_VIEW_COMPONENTS];   /**< Required types, then optional types. */
+    u32 requiredCount;                              /**< The number of required terms. */
+    u32 termCount;                                  /**< The number of required and optional terms. */
+    ComponentType excluded[ECS_MAX_QUERY_EXCLUDED]; /**< Excluded types. */
+    u32 excludedCount;                              /**< The number of excluded types. */
+    EcsSignature required;                          /**< Required types as a signature. */
+    EcsSignature excludedSignature;                 /**< Excluded types as a signature. */
+    EcsSignature watched;                           /**< Every type the query mentions. */
+    b8 stale;                                       /**< Whether the sparse-set cache must be rebuilt. */
+    u32 *archetypes;                                /**< Matching archetype indices (archetype storage). */
+    u32 *offsets;                                   /**< termCount column offsets per matching archetype, INVALID_ID_U32 if absent. */
+    u32 *columns;                                   /**< termCount column indices per matching archetype, INVALID_ID_U32 if absent. */
+    u32 archetypeCount;                             /**< The number of matching archetypes. */
+    u32 archetypeCapacity;                          /**< The capacity of archetypes and offsets. */
+    u32 *viewStarts;                                /**< Index of the first view of each matching archetype, set by ecs_query_prepare_views. */
+    u32 viewCount;                                  /**< The number of views found by ecs_query_prepare_views. */
+    u32 viewGrain;                                  /**< Entities per view in sparse-set storage. */
+    Entity *entities;                               /**< Matching entities (sparse-set storage). */
+    u32 *rows;                                      /**< Dense index of each term of each match, term-major. */
+    u32 count;                                      /**< The number of matching entities (sparse-set storage). */
+    u32 capacity;                                   /**< The capacity of entities and of each term's rows. */
+    u32 driverTerm;                                 /**< The term whose set the cache was built by walking; its rows increase. */
+    u32 group;                                      /**< The owning group that replaces the cache, INVALID_ID_U32 if none. */
+    u32 writeMask;                                  /**< Bit per written term. */
+    u32 changedMask;                                /**< Bit per term the change filter looks at. */
+    b8 passed;                                      /**< Whether a change-filtered pass has started before. */
+    b8 filtering;                                   /**< Whether the current pass skips unchanged data; false on the first pass. */
+    u32 changedSince;                               /**< Changes newer than this and no newer than lastVersion pass the filter. */
+    u32 lastVersion;                                /**< The change version when the current pass started. */
+} EcsQuery;
+
+#pragma endregion
+// =============================================================================
+#pragma region Interface
+
+/**
+ * @brief Gets the index of an entity handle. Sparse arrays and records are
+ * indexed by it.
+ *
+ * @param entity The entity handle.
+ * @return u32 The entity's index.
+ */
+static ENGINE_INLINE u32 ecs_entity_index(Entity entity) {
+    return (u32)entity;
+}
+
+/**
+ * @brief Gets the generation of an entity handle.
+ *
+ * @param entity The entity handle.
+ * @return u32 The entity's generation.
+ */
+static ENGINE_INLINE u32 ecs_entity_generation(Entity entity) {
+    return (u32)(entity >> 32);
+}
+
+/**
+ * @brief Packs an index and a generation into an entity handle.
+ *
+ * @param index The entity index.
+ * @param generation The generation of the index.
+ * @return Entity The entity handle.
+ */
+static ENGINE_INLINE Entity ecs_entity_make(u32 index, u32 generation) {
+    return ((Entity)generation << 32) | index;
+}
+
+/**
+ * @brief Adds a component type to a signature.
+ *
+ * @param signature A pointer to the signature.
+ * @param type The component type.
+ * @return void
+ */
+static ENGINE_INLINE void ecs_signature_set(EcsSignature *signature, ComponentType type) {
+    signature->bits[type / 64] |= 1ull << (type % 64);
+}
+
+/**
+ * @brief Removes a component type from a signature.
+ *
+ * @param signature A pointer to the signature.
+ * @param type The component type.
+ * @return void
+ */
+static ENGINE_INLINE void ecs_signature_clear(EcsSignature *signature, ComponentType type) {
+    signature->bits[type / 64] &= ~(1ull << (type % 64));
+}
+
+/**
+ * @brief Checks whether a signature has a component type.
+ *
+ * @param signature A pointer to the signature.
+ * @param type The component type.
+ * @return b8 True if the type is in the signature.
+ */
+static ENGINE_INLINE b8 ecs_signature_has(const EcsSignature *signature, ComponentType type) {
+    return (signature->bits[type / 64] >> (type % 64)) & 1;
+}
+
+/**
+ * @brief Checks whether two signatures hold the same component types.
+ *
+ * @param a A pointer to the first signature.
+ * @param b A pointer to the second signature.
+ * @return b8 True if the signatures are equal.
+ */
+static ENGINE_INLINE b8 ecs_signature_equal(const EcsSignature *a, const EcsSignature *b) {
+    for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+        if (a->bits[word] != b->bits[word]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Builds a signature from a list of component types, such as the
+ * static IDs of ECS_COMPONENT types.
+ *
+ * @param types The component types.
+ * @param typeCount The number of types.
+ * @return EcsSignature The signature holding every listed type.
+ */
+static ENGINE_INLINE EcsSignature ecs_signature_make(const ComponentType *types, u32 typeCount) {
+    EcsSignature signature = {0};
+    for (u32 i = 0; i < typeCount; ++i) {
+        ecs_signature_set(&signature, types[i]);
+    }
+    return signature;
+}
+
+/**
+ * @brief Checks whether a signature has every component type of a mask.
+ *
+ * @param signature A pointer to the signature.
+ * @param mask A pointer to the mask.
+ * @return b8 True if every type in mask is in signature.
+ */
+static ENGINE_INLINE b8 ecs_signature_contains(const EcsSignature *signature, const EcsSignature *mask) {
+    u64 missing = 0;
+    for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+        missing |= mask->bits[word] & ~signature->bits[word];
+    }
+    return missing == 0;
+}
+
+/**
+ * @brief Checks whether a signature has every required type and none of the
+ * excluded ones, comparing the whole 256-bit sets at once: AND-NOT against
+ * the required mask and AND against the excluded mask must both be zero.
+ *
+ * @param signature A pointer to the signature.
+ * @param required A pointer to the required types.
+ * @param excluded A pointer to the excluded types.
+ * @return b8 True if the signature matches.
+ */
+static ENGINE_INLINE b8 ecs_signature_matches(const EcsSignature *signature, const EcsSignature *required, const EcsSignature *excluded) {
+#if ECS_SIGNATURE_WORDS == 4 && defined(__AVX2__)
+    __m256i bits = _mm256_loadu_si256((const __m256i *)signature->bits);
+    __m256i missing = _mm256_andnot_si256(bits, _mm256_loadu_si256((const __m256i *)required->bits));
+    __m256i any = _mm256_or_si256(missing, _mm256_and_si256(bits, _mm256_loadu_si256((const __m256i *)excluded->bits)));
+    return _mm256_testz_si256(any, any);
+#elif ECS_SIGNATURE_WORDS == 4 && (defined(__x86_64__) || defined(_M_X64))
+    __m128i low = _mm_loadu_si128((const __m128i *)signature->bits);
+    __m128i high = _mm_loadu_si128((const __m128i *)signature->bits + 1);
+    __m128i missing = _mm_or_si128(_mm_andnot_si128(low, _mm_loadu_si128((const __m128i *)required->bits)), _mm_andnot_si128(high, _mm_loadu_si128((const __m128i *)required->bits + 1)));
+    __m128i hit = _mm_or_si128(_mm_and_si128(low, _mm_loadu_si128((const __m128i *)excluded->bits)), _mm_and_si128(high, _mm_loadu_si128((const __m128i *)excluded->bits + 1)));
+    __m128i any = _mm_or_si128(missing, hit);
+    return _mm_cvtsi128_si64(_mm_or_si128(any, _mm_unpackhi_epi64(any, any))) == 0;
+#elif ECS_SIGNATURE_WORDS == 4 && defined(__ARM_NEON)
+    uint64x2_t low = vld1q_u64((const uint64_t *)signature->bits);
+    uint64x2_t high = vld1q_u64((const uint64_t *)signature->bits + 2);
+    uint64x2_t missing = vorrq_u64(vbicq_u64(vld1q_u64((const uint64_t *)required->bits), low), vbicq_u64(vld1q_u64((const uint64_t *)required->bits + 2), high));
+    uint64x2_t hit = vorrq_u64(vandq_u64(low, vld1q_u64((const uint64_t *)excluded->bits)), vandq_u64(high, vld1q_u64((const uint64_t *)excluded->bits + 2)));
+    uint64x2_t any = vorrq_u64(missing, hit);
+    return (vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)) == 0;
+#else
+    u64 any = 0;
+    for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+        any |= (required->bits[word] & ~signature->bits[word]) | (excluded->bits[word] & signature->bits[word]);
+    }
+    return any == 0;
+#endif
+}
+
+/**
+ * @brief Gets the element of a view column that holds a row.
+ *
+ * @param view A pointer to the view.
+ * @param term The term (column) index.
+ * @param row The row within the view.
+ * @return u32 The element index in view->columns[term], or INVALID_ID_U32 if the row lacks the optional component.
+ */
+static ENGINE_INLINE u32 ecs_view_row(const EcsView *view, u32 term, u32 row) {
+    if (!view->columns[term]) {
+        return INVALID_ID_U32;
+    }
+    return view->rows[term] ? view->rows[term][row] : row;
+}
+
+/**
+ * @brief Initializes an ECS. Nothing is allocated until entities and
+ * components are created.
+ *
+ * @param ecs A pointer to the ECS manager to initialize.
+ * @param pool A pointer to the memory pool to allocate storage from.
+ * @param config A pointer to the ECS configuration.
+ * @return ENGINE_SUCCESS if the ECS was initialized successfully, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_init(ECSManager *ecs, MemoryPool *pool, const ECSConfig *config);
+
+/**
+ * @brief Shuts down an ECS and frees all of its storage.
+ *
+ * @param ecs A pointer to the ECS manager to shut down.
+ * @return void
+ */
+ENGINE_API void ecs_shutdown(ECSManager *ecs);
+
+/**
+ * @brief Creates a new entity.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @return Entity The new entity, or INVALID_ENTITY if IDs are exhausted or allocation failed.
+ */
+ENGINE_API Entity ecs_create_entity(ECSManager *ecs);
+
+/**
+ * @brief Destroys an entity and removes all of its components. Every handle
+ * to it stops being alive, including after its index is reused.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entity The entity to destroy.
+ * @return void
+ */
+ENGINE_API void ecs_destroy_entity(ECSManager *ecs, Entity entity);
+
+/**
+ * @brief Creates entities that all get the same component types, in bulk.
+ *
+ * Indices are reserved together, with one allocation per entity array. Each
+ * type's components are copied in with one memory_copy per packed run: per
+ * chunk in archetype storage, per type in sparse-set storage. Sparse entries
+ * or records are then written in one pass, and each type's queries are marked
+ * stale once.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param count The number of entities to create.
+ * @param types The component types every new entity gets, each listed once (may be NULL if typeCount is 0).
+ * @param typeCount The number of component types.
+ * @param initData One pointer per type to count consecutive components to copy, or NULL to zero them. The whole array may be NULL.
+ * @param entities Receives the count new entities.
+ * @return ENGINE_SUCCESS if every entity was created. On failure, no entity created by the call is left alive.
+ */
+ENGINE_API EngineResult ecs_create_batch(ECSManager *ecs, u32 count, const ComponentType *types, u32 typeCount, const void *const *initData, Entity *entities);
+
+/**
+ * @brief Destroys entities in bulk, as ecs_destroy_entity would one by one.
+ * The free list grows once, and in sparse-set storage each type's queries are
+ * marked stale once. Stale handles are skipped with one warning.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entities The entities to destroy.
+ * @param count The number of entities.
+ * @return void
+ */
+ENGINE_API void ecs_destroy_batch(ECSManager *ecs, const Entity *entities, u32 count);
+
+/**
+ * @brief Checks whether an entity handle refers to a live entity, in O(1).
+ * Handles of destroyed entities are never alive, even once their index has
+ * been reused. Generations are 32-bit, so a stale handle could only alias a
+ * new entity after its index has been recycled 2^32 times.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entity The entity handle to check.
+ * @return b8 True if the entity is alive.
+ */
+ENGINE_API b8 ecs_entity_alive(const ECSManager *ecs, Entity entity);
+
+/**
+ * @brief Registers a new component type. Its ID follows every type declared
+ * with ECS_COMPONENT and differs between ECS instances; prefer ECS_COMPONENT
+ * for types known at compile time. The alignment is assumed to be the largest
+ * power of two dividing the size, up to ECS_COLUMN_ALIGNMENT.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentSize The size of the component in bytes.
+ * @return ComponentType The new component type, or INVALID_COMPONENT_TYPE on failure.
+ */
+ENGINE_API ComponentType ecs_register_component(ECSManager *ecs, u32 componentSize);
+
+/**
+ * @brief Registers a tag: a component type with no data. A tag costs an
+ * entity one signature bit, which is also its sparse-set membership, and
+ * archetype columns of it take no bytes. Tags cannot be owned by groups,
+ * written or filtered on by queries, or iterated with ecs_each in sparse-set
+ * storage. Prefer ECS_TAG for tags known at compile time.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @return ComponentType The new tag type, or INVALID_COMPONENT_TYPE on failure.
+ */
+ENGINE_API ComponentType ecs_register_tag(ECSManager *ecs);
+
+/**
+ * @brief Declares a component type for every ECS, giving it a static ID.
+ * Called by ECS_COMPONENT at load time; ECS instances initialized earlier do
+ * not know the type.
+ *
+ * @param name The type's name. Must outlive every ECS (use a string literal).
+ * @param size The size of the component in bytes, 0 for a tag.
+ * @param alignment The alignment of the component, a power of two no larger than ECS_COMPONENT_ALIGNMENT.
+ * @return ComponentType The static ID, or INVALID_COMPONENT_TYPE on failure.
+ */
+ENGINE_API ComponentType ecs_component_declare(const char *name, u32 size, u32 alignment);
+
+/**
+ * @brief Gets the number of component types declared with ECS_COMPONENT.
+ * Their IDs are 0 to this count minus one in every ECS.
+ *
+ * @return u32 The number of declared types.
+ */
+ENGINE_API u32 ecs_component_declared_count(void);
+
+/**
+ * @brief Adds a component to an entity by copying it into the packed array.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entity The entity to add the component to.
+ * @param type The component type to add.
+ * @param componentData A pointer to the initial component data, or NULL to zero it. Ignored for tags.
+ * @return void* A pointer to the stored component, or NULL on failure. A tag's pointer addresses no bytes.
+ */
+ENGINE_API void *ecs_add_component(ECSManager *ecs, Entity entity, ComponentType type, const void *componentData);
+
+/**
+ * @brief Removes a component from an entity. The last component of the type
+ * is moved into its slot, so pointers to that component are invalidated.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entity The entity to remove the component from.
+ * @param type The component type to remove.
+ * @return void
+ */
+ENGINE_API void ecs_remove_component(ECSManager *ecs, Entity entity, ComponentType type);
+
+/**
+ * @brief Gets an entity's component. The pointer stays valid until a
+ * component of the same type is added or removed (in archetype storage, until
+ * any component is added or removed). The component is marked changed, since
+ * the caller may write through the pointer.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entity The entity to get the component from.
+ * @param type The component type to get.
+ * @return void* A pointer to the component, or NULL if the entity does not have it or is not alive.
+ */
+ENGINE_API void *ecs_get_component(ECSManager *ecs, Entity entity, ComponentType type);
+
+/**
+ * @brief Checks whether an entity has a component.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entity The entity to check.
+ * @param type The component type to check for.
+ * @return b8 True if the entity is alive and has the component.
+ */
+ENGINE_API b8 ecs_has_component(const ECSManager *ecs, Entity entity, ComponentType type);
+
+/**
+ * @brief Gets the component types an entity has as a signature: its
+ * archetype's in archetype storage, or the entity's own in sparse-set storage.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entity The entity.
+ * @return const EcsSignature* The entity's signature, valid until its next structural change, or NULL if the handle is stale.
+ */
+ENGINE_API const EcsSignature *ecs_entity_signature(const ECSManager *ecs, Entity entity);
+
+/**
+ * @brief Gets the number of components of a type. In sparse-set storage this
+ * is the length of the arrays returned by ecs_component_data and
+ * ecs_component_entities.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param type The component type.
+ * @return u32 The number of components.
+ */
+ENGINE_API u32 ecs_component_count(const ECSManager *ecs, ComponentType type);
+
+/**
+ * @brief Gets the packed component array of a type for linear iteration.
+ * Sparse-set storage only. Every component of the type is marked changed.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param type The component type.
+ * @return void* A pointer to the first component, or NULL if the type is invalid.
+ */
+ENGINE_API void *ecs_component_data(ECSManager *ecs, ComponentType type);
+
+/**
+ * @brief Gets the entity owning each packed component of a type. Sparse-set
+ * storage only.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param type The component type.
+ * @return const Entity* A pointer to the first entity, or NULL if the type is invalid or a tag.
+ */
+ENGINE_API const Entity *ecs_component_entities(const ECSManager *ecs, ComponentType type);
+
+/**
+ * @brief Calls fn for every run of entities that have all the given
+ * component types, with each type's data as a packed column.
+ *
+ * In archetype storage, matching archetypes are found once per call and each
+ * of their chunks becomes one view. In sparse-set storage a single type, or
+ * exactly the types of an owning group in any order, can be requested; the
+ * packed array or the group's rows are one view. Components must not
+ * be added or removed from inside fn. Every visited column is marked changed;
+ * use a query with writes to mark only what is written.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param types The component types to iterate.
+ * @param typeCount The number of types (1 to ECS_MAX_VIEW_COMPONENTS).
+ * @param fn The function to call for each view.
+ * @param userData User data passed to fn.
+ * @return void
+ */
+ENGINE_API void ecs_each(ECSManager *ecs, const ComponentType *types, u32 typeCount, EcsViewFunc fn, void *userData);
+
+/**
+ * @brief Creates an owning group over component types that no other group
+ * owns, reordering their sparse sets so the entities with every type come
+ * first, in the same order in each. Sparse-set storage only.
+ *
+ * The group is kept sorted on every add and remove of an owned type, which
+ * costs a few swaps per change. Queries whose required terms are exactly the
+ * group's types, with no optional or excluded terms, use the group's rows
+ * directly, including queries created before the group.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param types The component types to own.
+ * @param typeCount The number of types (1 to ECS_MAX_VIEW_COMPONENTS).
+ * @return u32 The group's index, or INVALID_ID_U32 on failure.
+ */
+ENGINE_API u32 ecs_group_create(ECSManager *ecs, const ComponentType *types, u32 typeCount);
+
+/**
+ * @brief Gets the number of entities in a group: the length of the aligned
+ * prefix of each owned array.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param group The group's index.
+ * @return u32 The number of entities with every owned type, 0 if the group is invalid.
+ */
+ENGINE_API u32 ecs_group_count(const ECSManager *ecs, u32 group);
+
+/**
+ * @brief Keeps a component type's packed array sorted by a key extracted from
+ * each component, and sorts it now. Sparse-set storage only; tags and types
+ * owned by a group cannot be sorted.
+ *
+ * ecs_each walks a sorted type in key order, and queries that require one are
+ * driven by it, so their matches also come out in key order. Pass NULL to
+ * stop sorting the type.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param type The component type.
+ * @param key The key function, or NULL.
+ * @return ENGINE_SUCCESS if the type is sorted, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_sort_by(ECSManager *ecs, ComponentType type, EcsSortKeyFunc key);
+
+/**
+ * @brief Restores the order of a sorted type after components were added,
+ * removed or changed. Call it where the order is needed, such as once per
+ * frame before rendering, and not while systems run.
+ *
+ * Only rows in blocks marked changed since the last sort (see change
+ * detection) and rows added since then are re-keyed; the rest keep their
+ * cached keys. Out-of-place rows are moved by insertion, so a frame's small
+ * changes cost about as much as the rows they pass. When more than
+ * 1/ECS_SORT_RADIX_FRACTION of the rows are out of place, or insertion would
+ * shift more rows than the array holds, the whole array is radix sorted.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param type The component type.
+ * @return ENGINE_SUCCESS if the type is sorted, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_sort(ECSManager *ecs, ComponentType type);
+
+/**
+ * @brief Creates a cached query and registers it with the ECS so structural
+ * changes keep it up to date. Destroy it before the ECS is shut down.
+ *
+ * @param query A pointer to the query to initialize.
+ * @param ecs A pointer to the ECS manager.
+ * @param desc A pointer to the query's component terms.
+ * @return ENGINE_SUCCESS if the query was created, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_query_init(EcsQuery *query, ECSManager *ecs, const EcsQueryDesc *desc);
+
+/**
+ * @brief Unregisters a query and frees its cache.
+ *
+ * @param query A pointer to the query to destroy.
+ * @return void
+ */
+ENGINE_API void ecs_query_destroy(EcsQuery *query);
+
+/**
+ * @brief Gets the number of entities a query matches, refreshing its cache if
+ * it is stale.
+ *
+ * @param query A pointer to the query.
+ * @return u32 The number of matching entities.
+ */
+ENGINE_API u32 ecs_query_count(EcsQuery *query);
+
+/**
+ * @brief Checks whether an entity matches a query's required and excluded
+ * terms with one signature compare. Change filters are not considered.
+ *
+ * @param query A pointer to the query.
+ * @param entity The entity.
+ * @return b8 True if the entity is alive and matches.
+ */
+ENGINE_API b8 ecs_query_matches(const EcsQuery *query, Entity entity);
+
+/**
+ * @brief Calls fn for every run of entities matching a query. Views have one
+ * column per required term followed by one per optional term.
+ *
+ * Archetype storage produces one packed view per chunk. Sparse-set storage
+ * produces a single view whose rows index the packed component arrays. No
+ * component is looked up or validated per entity while the cache is fresh.
+ * Components must not be added or removed from inside fn.
+ *
+ * A change-filtered query skips unchanged chunks, and in sparse-set storage
+ * produces one view per run of changed entities instead.
+ *
+ * @param query A pointer to the query.
+ * @param fn The function to call for each view.
+ * @param userData User data passed to fn.
+ * @return void
+ */
+ENGINE_API void ecs_query_each(EcsQuery *query, EcsViewFunc fn, void *userData);
+
+/**
+ * @brief Splits a query's matches into independent views, refreshing its cache
+ * if it is stale. Views can then be fetched by index with ecs_query_get_view,
+ * from any thread, until the next structural change.
+ *
+ * Archetype storage produces one view per chunk and ignores grainSize.
+ * Sparse-set storage produces views of grainSize entities, the last one
+ * shorter. A change-filtered query starts a new pass here; views with nothing
+ * changed come back from ecs_query_get_view empty.
+ *
+ * @param query A pointer to the query.
+ * @param grainSize Entities per view in sparse-set storage, 0 for one view.
+ * @return u32 The number of views.
+ */
+ENGINE_API u32 ecs_query_prepare_views(EcsQuery *query, u32 grainSize);
+
+/**
+ * @brief Gets one of the views counted by the last ecs_query_prepare_views.
+ *
+ * @param query A pointer to the query.
+ * @param index The index of the view, less than the prepared view count.
+ * @param view A pointer to the view to fill, with a count of 0 if the change filter skips it.
+ * @return void
+ */
+ENGINE_API void ecs_query_get_view(const EcsQuery *query, u32 index, EcsView *view);
+
+/**
+ * @brief Gets the size of a snapshot of the ECS in bytes.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @return u64 The number of bytes ecs_snapshot writes, or 0 if ecs is NULL.
+ */
+ENGINE_API u64 ecs_snapshot_size(const ECSManager *ecs);
+
+/**
+ * @brief Writes a snapshot of every entity and component of the ECS.
+ *
+ * A snapshot is a small header followed by contiguous, 16-byte-aligned
+ * blocks copied straight from the ECS: entity generations and free indices,
+ * then either each component type's packed array, entities and sparse pages
+ * (sparse-set storage) or entity records and each archetype's chunks
+ * (archetype storage). It holds no pointers, so it can be written to a file
+ * as is. Component data is copied bit for bit; components that own
+ * pointers must be fixed up by the caller. Queries, group definitions,
+ * sort keys and registered types are not part of it.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param buffer The buffer to write to.
+ * @param capacity The size of buffer in bytes; at least ecs_snapshot_size(ecs).
+ * @return ENGINE_SUCCESS if the snapshot was written, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_snapshot(const ECSManager *ecs, void *buffer, u64 capacity);
+
+/**
+ * @brief Replaces every entity and component of the ECS with those of a
+ * snapshot.
+ *
+ * The ECS must use the same storage and groups as the one the snapshot was
+ * taken from and have at least its component types, registered in the same
+ * order with the same sizes; types registered later end up empty. Storage
+ * already allocated is reused, so restoring a snapshot of a similar world
+ * costs about one copy of it. The snapshot is only read, block by block, so
+ * it may live in read-only memory such as a mapped file. Handles from the
+ * snapshot's world are valid again afterwards; live queries see the
+ * restored entities.
+ *
+ * The whole snapshot is checked before the ECS is changed, so a truncated
+ * or mismatched one leaves it untouched. If an allocation fails during the
+ * restore the ECS is left partly restored and may only be shut down.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param snapshot The snapshot, as written by ecs_snapshot.
+ * @param size The number of readable bytes at snapshot.
+ * @return ENGINE_SUCCESS if the snapshot was restored, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_restore(ECSManager *ecs, const void *snapshot, u64 size);
+
+/**
+ * @brief Gets the number of bytes of pool memory the ECS has allocated for
+ * entities and component storage.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @return u64 The number of bytes allocated.
+ */
+ENGINE_API u64 ecs_memory_usage(const ECSManager *ecs);
+
+#pragma endregion
+// =============================================================================
+
+#endif // ENGINE_ECS_H
@@ -0,0 +1,186 @@
+/**
+ * @file hierarchy.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief Parent/child relationships between entities and the transform
+ * system that propagates local transforms to world transforms. Transforms
+ * are kept in depth-first order, so propagation is one linear pass per root
+ * that skips unchanged subtrees, and independent roots update in parallel.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef ENGINE_ECS_HIERARCHY_H
+#define ENGINE_ECS_HIERARCHY_H
+
+#include "engine/components/transform.h"
+#include "engine/defines.h"
+#include "engine/ecs/ecs.h"
+
+// Hierarchies with fewer nodes than this always update on the calling thread.
+#define ECS_HIERARCHY_SERIAL_THRESHOLD 4096
+
+// Upper bound on the jobs one update splits its roots across.
+#define ECS_HIERARCHY_MAX_BATCHES 64
+
+// Node flag: the node's local transform changed since the last update.
+#define ECS_HIERARCHY_DIRTY 0x1
+
+// Node flag: a node below this one is dirty, so its subtree can't be skipped.
+#define ECS_HIERARCHY_DESCENDANT_DIRTY 0x2
+
+// Node flag: the node's world transform was recomputed in the current update.
+#define ECS_HIERARCHY_UPDATED 0x4
+
+// =============================================================================
+#pragma region Types
+
+/**
+ * @brief The hierarchy component of one entity: links to its parent,
+ * children and siblings by entity index, and its slot in the transform
+ * arrays. Children keep the order they were attached in; roots are siblings
+ * of each other.
+ */
+typedef struct EcsHierarchyNode {
+    Entity entity;       /**< The entity's handle, INVALID_ENTITY if the index is not in the hierarchy. */
+    u32 parent;          /**< Entity index of the parent, INVALID_ID_U32 for a root. */
+    u32 firstChild;      /**< Entity index of the first child, INVALID_ID_U32 if none. */
+    u32 lastChild;       /**< Entity index of the last child, INVALID_ID_U32 if none. */
+    u32 nextSibling;     /**< Entity index of the next sibling, INVALID_ID_U32 if none. */
+    u32 previousSibling; /**< Entity index of the previous sibling, INVALID_ID_U32 if none. */
+    u32 slot;            /**< The entity's slot in the transform arrays. */
+} EcsHierarchyNode;
+
+/**
+ * @brief Entity hierarchy with transforms stored per slot.
+ *
+ * After ecs_hierarchy_update, slots are in depth-first order: each node's
+ * parent comes before it and its subtree is the slots [slot, ends[slot]).
+ * Structural changes append new nodes at the end and leave removed slots
+ * behind; the next update restores the order.
+ */
+typedef struct EcsHierarchy {
+    ECSManager *ecs;         /**< The ECS whose entities the hierarchy links. */
+    EcsHierarchyNode *nodes; /**< Hierarchy component of each entity index. */
+    u32 nodeCapacity;        /**< The length of the nodes array. */
+    u32 firstRoot;           /**< Entity index of the first root, INVALID_ID_U32 if empty. */
+    u32 lastRoot;            /**< Entity index of the last root, INVALID_ID_U32 if empty. */
+    u8 *memory;              /**< One allocation holding every slot array. */
+    WorldTransform *worlds;  /**< World transform of each slot. */
+    Transform *locals;       /**< Local transform of each slot. */
+    u32 *entities;           /**< Entity index of each slot, INVALID_ID_U32 once removed. */
+    u32 *parents;            /**< Parent slot of each slot, INVALID_ID_U32 for roots. */
+    u32 *ends;               /**< One past the last slot of each slot's subtree. */
+    u8 *flags;               /**< ECS_HIERARCHY_* flags of each slot. */
+    u32 slotCount;           /**< The number of slots in use, including removed ones. */
+    u32 slotCapacity;        /**< The length of each slot array. */
+    u32 nodeCount;           /**< The number of entities in the hierarchy. */
+    u32 *roots;              /**< Slot of each root, in depth-first order. */
+    u32 rootCount;           /**< The number of roots. */
+    u32 rootCapacity;        /**< The length of the roots array. */
+    b8 structureDirty;       /**< Whether slots must be put back in depth-first order. */
+} EcsHierarchy;
+
+#pragma endregion
+// =============================================================================
+#pragma region Interface
+
+/**
+ * @brief Initializes an empty hierarchy. Nothing is allocated until entities
+ * are added.
+ *
+ * @param hierarchy A pointer to the hierarchy to initialize.
+ * @param ecs A pointer to the ECS whose entities the hierarchy links.
+ * @return ENGINE_SUCCESS if the hierarchy was initialized, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_hierarchy_init(EcsHierarchy *hierarchy, ECSManager *ecs);
+
+/**
+ * @brief Frees the hierarchy's storage.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @return void
+ */
+ENGINE_API void ecs_hierarchy_shutdown(EcsHierarchy *hierarchy);
+
+/**
+ * @brief Adds an entity to the hierarchy with a local transform.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param entity The entity to add, which must be alive and not in the hierarchy yet.
+ * @param parent The parent, which must be in the hierarchy, or INVALID_ENTITY for a root.
+ * @param local A pointer to the local transform, or NULL for the identity.
+ * @return ENGINE_SUCCESS if the entity was added, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_hierarchy_add(EcsHierarchy *hierarchy, Entity entity, Entity parent, const Transform *local);
+
+/**
+ * @brief Removes an entity and all its descendants from the hierarchy. The
+ * entities themselves are not destroyed. Remove an entity before destroying
+ * it.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param entity The entity to remove.
+ * @return void
+ */
+ENGINE_API void ecs_hierarchy_remove(EcsHierarchy *hierarchy, Entity entity);
+
+/**
+ * @brief Moves an entity and its subtree under a new parent. The local
+ * transform is kept, so the subtree moves with its new parent.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param entity The entity to move.
+ * @param parent The new parent, or INVALID_ENTITY to make the entity a root. Must not be in the entity's subtree.
+ * @return ENGINE_SUCCESS if the entity was moved, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_hierarchy_set_parent(EcsHierarchy *hierarchy, Entity entity, Entity parent);
+
+/**
+ * @brief Gets the parent of an entity.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param entity The entity.
+ * @return Entity The parent, or INVALID_ENTITY for roots and entities not in the hierarchy.
+ */
+ENGINE_API Entity ecs_hierarchy_parent(const EcsHierarchy *hierarchy, Entity entity);
+
+/**
+ * @brief Gets an entity's local transform for writing and marks it dirty, so
+ * the next update recomputes its subtree.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param entity The entity.
+ * @return Transform* The local transform, valid until the next structural change or update, or NULL if the entity is not in the hierarchy.
+ */
+ENGINE_API Transform *ecs_hierarchy_local(EcsHierarchy *hierarchy, Entity entity);
+
+/**
+ * @brief Gets an entity's world transform as of the last update.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param entity The entity.
+ * @return const WorldTransform* The world transform, valid until the next structural change or update, or NULL if the entity is not in the hierarchy.
+ */
+ENGINE_API const WorldTransform *ecs_hierarchy_world(const EcsHierarchy *hierarchy, Entity entity);
+
+/**
+ * @brief Restores depth-first order after structural changes, then
+ * recomputes the world transform of every dirty node and its descendants.
+ *
+ * Each root's subtree is one linear pass in which a node's parent has always
+ * been updated first; clean subtrees with no dirty descendants are skipped
+ * whole. Roots are split across jobs by node count when the job system has
+ * workers and the hierarchy is large enough. Must not run while local
+ * transforms are being written.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @return u32 The number of world transforms recomputed.
+ */
+ENGINE_API u32 ecs_hierarchy_update(EcsHierarchy *hierarchy);
+
+#pragma endregion
+// =============================================================================
+
+#endif // ENGINE_ECS_HIERARCHY_H
@@ -0,0 +1,212 @@
+/**
+ * @file prefab.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief Prefabs: templates of one or more entities with pre-laid-out
+ * component data. Instantiating a prefab copies each component's template in
+ * bulk into the ECS and remaps entity references inside the template from
+ * relative to absolute handles.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef ENGINE_ECS_PREFAB_H
+#define ENGINE_ECS_PREFAB_H
+
+#include "engine/components/transform.h"
+#include "engine/defines.h"
+#include "engine/ecs/ecs.h"
+#include "engine/ecs/hierarchy.h"
+
+// Maximum number of entities in one prefab.
+#define ECS_PREFAB_MAX_ENTITIES 64
+
+// Maximum number of components across all entities of one prefab.
+#define ECS_PREFAB_MAX_COMPONENTS 256
+
+// Maximum number of entity fields declared per prefab.
+#define ECS_PREFAB_MAX_FIELDS 16
+
+// Instances created per round; bounds the staging memory of one instantiation.
+#define ECS_PREFAB_ROUND_INSTANCES 4096
+
+// Generation bit that marks a handle as relative to its prefab.
+#define ECS_PREFAB_RELATIVE_GENERATION 0x40000000u
+
+// =============================================================================
+#pragma region Types
+
+/**
+ * @brief One entity of a prefab.
+ */
+typedef struct EcsPrefabEntity {
+    u32 parent;      /**< Prefab index of the parent, INVALID_ID_U32 for a root. */
+    Transform local; /**< Local transform, used when instantiating into a hierarchy. */
+    u32 part;        /**< Part the entity belongs to once baked. */
+    u32 member;      /**< The entity's position within its part. */
+} EcsPrefabEntity;
+
+/**
+ * @brief One component value of a prefab entity.
+ */
+typedef struct EcsPrefabComponent {
+    u32 entity;         /**< Prefab index of the entity. */
+    ComponentType type; /**< The component type. */
+    u32 offset;         /**< Offset of the value in the prefab's data. */
+} EcsPrefabComponent;
+
+/**
+ * @brief A component field holding an Entity that instantiation remaps.
+ */
+typedef struct EcsPrefabField {
+    ComponentType type; /**< The component type. */
+    u32 offset;         /**< Byte offset of the Entity inside the component. */
+} EcsPrefabField;
+
+/**
+ * @brief Prefab entities sharing one component set, created together with
+ * ecs_create_batch. Each type's template holds one component per member, in
+ * member order.
+ */
+typedef struct EcsPrefabPart {
+    ComponentType types[ECS_MAX_VIEW_COMPONENTS]; /**< The part's component types, ascending. */
+    u32 templates[ECS_MAX_VIEW_COMPONENTS];       /**< Offset of each type's template in the baked data. */
+    u32 typeCount;                                /**< The number of component types. */
+    u32 memberCount;                              /**< The number of prefab entities in the part. */
+    u64 instanceSize;                             /**< Component bytes of one instance of the part. */
+} EcsPrefabPart;
+
+/**
+ * @brief A relative handle in a prefab's data, resolved per instance.
+ */
+typedef struct EcsPrefabFixup {
+    u32 entity;         /**< Prefab index of the entity whose component holds the handle. */
+    ComponentType type; /**< The component type. */
+    u32 offset;         /**< Byte offset of the handle inside the component. */
+    u32 target;         /**< Prefab index the handle refers to. */
+} EcsPrefabFixup;
+
+/**
+ * @brief A template of entities and their component data.
+ *
+ * Build a prefab with ecs_prefab_add_entity and ecs_prefab_set, then
+ * instantiate it any number of times. The first instantiation after a change
+ * bakes the prefab: entities are grouped into parts by component set and each
+ * part's components are laid out as the contiguous runs the ECS copies from.
+ */
+typedef struct EcsPrefab {
+    ECSManager *ecs;                                          /**< The ECS instances are created in. */
+    EcsPrefabEntity entities[ECS_PREFAB_MAX_ENTITIES];        /**< The prefab's entities. */
+    u32 entityCount;                                          /**< The number of entities. */
+    EcsPrefabComponent components[ECS_PREFAB_MAX_COMPONENTS]; /**< Component values in the order they were set. */
+    u32 componentCount;                                       /**< The number of component values. */
+    EcsPrefabField fields[ECS_PREFAB_MAX_FIELDS];             /**< Declared entity fields. */
+    u32 fieldCount;                                           /**< The number of entity fields. */
+    u8 *data;                                                 /**< Component values, each at its component's offset. */
+    u32 dataSize;                                             /**< Bytes of data in use. */
+    u32 dataCapacity;                                         /**< The length of data. */
+    EcsPrefabPart parts[ECS_PREFAB_MAX_ENTITIES];             /**< Baked parts. */
+    u32 partCount;                                            /**< The number of parts. */
+    u8 *baked;                                                /**< Baked part templates. */
+    EcsPrefabFixup *fixups;                                   /**< Relative handles found while baking. */
+    u32 fixupCount;                                           /**< The number of fixups. */
+    b8 dirty;                                                 /**< Whether the prefab must be baked again. */
+} EcsPrefab;
+
+#pragma endregion
+// =============================================================================
+#pragma region Interface
+
+/**
+ * @brief Makes a handle to an entity of the prefab, for storing in a declared
+ * entity field. Instantiation replaces it with the instance's entity.
+ *
+ * @param index The entity's prefab index.
+ * @return Entity The relative handle.
+ */
+static ENGINE_INLINE Entity ecs_prefab_ref(u32 index) {
+    return ecs_entity_make(index, ECS_PREFAB_RELATIVE_GENERATION);
+}
+
+/**
+ * @brief Checks whether a handle was made by ecs_prefab_ref.
+ *
+ * @param entity The entity handle.
+ * @return b8 True if the handle is relative to a prefab.
+ */
+static ENGINE_INLINE b8 ecs_prefab_is_ref(Entity entity) {
+    return entity != INVALID_ENTITY && (ecs_entity_generation(entity) & ECS_PREFAB_RELATIVE_GENERATION) != 0;
+}
+
+/**
+ * @brief Initializes an empty prefab.
+ *
+ * @param prefab A pointer to the prefab to initialize.
+ * @param ecs A pointer to the ECS instances are created in.
+ * @return ENGINE_SUCCESS if the prefab was initialized, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_prefab_init(EcsPrefab *prefab, ECSManager *ecs);
+
+/**
+ * @brief Frees the prefab's data.
+ *
+ * @param prefab A pointer to the prefab.
+ * @return void
+ */
+ENGINE_API void ecs_prefab_shutdown(EcsPrefab *prefab);
+
+/**
+ * @brief Adds an entity to the prefab.
+ *
+ * @param prefab A pointer to the prefab.
+ * @param parent Prefab index of the parent, which must already exist, or INVALID_ID_U32 for a root.
+ * @param local A pointer to the local transform, or NULL for the identity. Only used when instantiating into a hierarchy.
+ * @return u32 The entity's prefab index, or INVALID_ID_U32 on failure.
+ */
+ENGINE_API u32 ecs_prefab_add_entity(EcsPrefab *prefab, u32 parent, const Transform *local);
+
+/**
+ * @brief Sets a component of a prefab entity, adding it if the entity does
+ * not have it yet.
+ *
+ * @param prefab A pointer to the prefab.
+ * @param entity The entity's prefab index.
+ * @param type The component type.
+ * @param componentData A pointer to the value to copy, or NULL to zero it.
+ * @return void* The prefab's copy of the value, valid until the next call to ecs_prefab_set, or NULL on failure.
+ */
+ENGINE_API void *ecs_prefab_set(EcsPrefab *prefab, u32 entity, ComponentType type, const void *componentData);
+
+/**
+ * @brief Declares an Entity field of a component type. Handles made by
+ * ecs_prefab_ref in that field are remapped to the instance's entities;
+ * other handles are copied unchanged.
+ *
+ * @param prefab A pointer to the prefab.
+ * @param type The component type.
+ * @param offset Byte offset of the Entity inside the component.
+ * @return ENGINE_SUCCESS if the field was declared, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_prefab_entity_field(EcsPrefab *prefab, ComponentType type, u32 offset);
+
+/**
+ * @brief Creates instances of the prefab.
+ *
+ * Every part of the prefab is created with one ecs_create_batch per round of
+ * up to ECS_PREFAB_ROUND_INSTANCES instances, copying its component templates
+ * in bulk, and relative handles are then remapped. Structural changes must
+ * not happen concurrently.
+ *
+ * @param prefab A pointer to the prefab.
+ * @param count The number of instances.
+ * @param hierarchy A pointer to a hierarchy to link each instance's entities into with their local transforms, or NULL.
+ * @param entities Receives count * entityCount handles: entity i of instance n at n * entityCount + i.
+ * @return ENGINE_SUCCESS if every instance was created. On failure, no entity created by the call is left alive.
+ */
+ENGINE_API EngineResult ecs_prefab_instantiate(EcsPrefab *prefab, u32 count, EcsHierarchy *hierarchy, Entity *entities);
+
+#pragma endregion
+// =============================================================================
+
+#endif // ENGINE_ECS_PREFAB_H
@@ -0,0 +1,172 @@
+/**
+ * @file system.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief ECS systems and the scheduler that runs them. Systems declare the
+ * component types they read and write; systems that do not conflict run
+ * concurrently on the job system.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef ENGINE_ECS_SYSTEM_H
+#define ENGINE_ECS_SYSTEM_H
+
+#include "engine/defines.h"
+#include "engine/ecs/command_buffer.h"
+#include "engine/ecs/ecs.h"
+#include "engine/job_system.h"
+#include "engine/platform.h"
+
+// Maximum number of systems per scheduler.
+#define ECS_MAX_SYSTEMS 128
+
+// Words in a system's dependent bitmask.
+#define ECS_SYSTEM_MASK_WORDS (ECS_MAX_SYSTEMS / 64)
+
+// Entities per view when a sparse-set query system gives no grain size.
+#define ECS_SYSTEM_DEFAULT_GRAIN_SIZE 4096
+
+// Upper bound on the jobs one query system splits its views across.
+#define ECS_SYSTEM_MAX_BATCHES 64
+
+// =============================================================================
+#pragma region Types
+
+// Forward declarations.
+typedef struct EcsScheduler EcsScheduler;
+
+/**
+ * @brief What a system is given each run.
+ */
+typedef struct EcsSystemContext {
+    ECSManager *ecs;           /**< The ECS being updated. */
+    f32 deltaTime;             /**< Seconds since the last run. */
+    void *userData;            /**< The system's user data. */
+    EcsCommandQueue *commands; /**< Queue for structural changes, played back after the run (NULL if the scheduler has none). */
+    u64 sortKey;               /**< Sort key for commands recorded here: the system index in the high 32 bits, the view index in the low. */
+} EcsSystemContext;
+
+/**
+ * @brief Runs a system once.
+ *
+ * @param context A pointer to the run's context.
+ */
+typedef void (*EcsSystemFunc)(const EcsSystemContext *context);
+
+/**
+ * @brief Processes one view of a query system. Views of one system may be
+ * processed concurrently.
+ *
+ * @param view A pointer to the view.
+ * @param context A pointer to the run's context.
+ */
+typedef void (*EcsSystemEachFunc)(const EcsView *view, const EcsSystemContext *context);
+
+/**
+ * @brief Describes a system to ecs_scheduler_add_system.
+ *
+ * Set update for a system that runs once per frame, or query and each for one
+ * that is called per view of a query. reads and writes must name every
+ * component type the system touches; the scheduler trusts them.
+ */
+typedef struct EcsSystemDesc {
+    const char *name;            /**< Name of the system's profiler zone. Must outlive the profiler (use a string literal). */
+    const ComponentType *reads;  /**< Component types the system only reads. */
+    u32 readCount;               /**< The number of read types. */
+    const ComponentType *writes; /**< Component types the system writes. */
+    u32 writeCount;              /**< The number of written types. */
+    EcsSystemFunc update;        /**< Called once per run, if set. */
+    EcsQuery *query;             /**< The query whose views are passed to each. Owned by the caller. */
+    EcsSystemEachFunc each;      /**< Called per non-empty view of query, if update is not set. A change-filtered query skips unchanged views. */
+    u32 grainSize;               /**< Entities per view in sparse-set storage (0 uses ECS_SYSTEM_DEFAULT_GRAIN_SIZE). */
+    void *userData;              /**< User data passed in the context. */
+} EcsSystemDesc;
+
+/**
+ * @brief A registered system and its place in the dependency graph.
+ */
+typedef struct EcsSystem {
+    EcsSystemDesc desc;                    /**< The system as registered. */
+    EcsSignature reads;                    /**< Read types as a signature. */
+    EcsSignature writes;                   /**< Written types as a signature. */
+    u64 dependents[ECS_SYSTEM_MASK_WORDS]; /**< Bit per later system that must wait for this one. */
+    u32 dependencyCount;                   /**< The number of earlier systems this one waits for. */
+    PlatformAtomicI32 pending;             /**< Dependencies not yet finished in the current run. */
+    EcsScheduler *scheduler;               /**< The scheduler the system belongs to. */
+    f64 lastSeconds;                       /**< Wall time of the system's last run. */
+} EcsSystem;
+
+/**
+ * @brief Runs a set of systems in registration order, as far as their
+ * component accesses allow, concurrently.
+ */
+typedef struct EcsScheduler {
+    ECSManager *ecs;                    /**< The ECS the systems update. */
+    EcsSystem systems[ECS_MAX_SYSTEMS]; /**< Registered systems in registration order. */
+    u32 systemCount;                    /**< The number of registered systems. */
+    u32 roots[ECS_MAX_SYSTEMS];         /**< Systems with no dependencies. */
+    u32 rootCount;                      /**< The number of roots. */
+    b8 graphDirty;                      /**< Whether the dependency graph must be rebuilt. */
+    f32 deltaTime;                      /**< Delta time of the current run. */
+    JobCounter counter;                 /**< Counts the current run's unfinished system jobs. */
+    PlatformAtomicI64 workTicks;        /**< Ticks jobs spent in systems during the current run. */
+    f64 lastWallSeconds;                /**< Wall time of the last run. */
+    f64 lastWorkSeconds;                /**< Time jobs spent in systems during the last run, across threads. */
+    f64 lastCriticalPathSeconds;        /**< Longest chain of dependent systems in the last run. */
+    EcsCommandQueue *commands;          /**< Command queue handed to systems and flushed after each run, if set. */
+} EcsScheduler;
+
+#pragma endregion
+// =============================================================================
+#pragma region Interface
+
+/**
+ * @brief Initializes an empty scheduler.
+ *
+ * @param scheduler A pointer to the scheduler to initialize.
+ * @param ecs A pointer to the ECS the systems update.
+ * @return ENGINE_SUCCESS if the scheduler was initialized, otherwise an error code.
+ */
+ENGINE_API EngineResult ecs_scheduler_init(EcsScheduler *scheduler, ECSManager *ecs);
+
+/**
+ * @brief Registers a system. A system depends on every earlier system that
+ * writes a type it reads or writes, or reads a type it writes.
+ *
+ * @param scheduler A pointer to the scheduler.
+ * @param desc A pointer to the system description.
+ * @return u32 The system's index, or INVALID_ID_U32 on failure.
+ */
+ENGINE_API u32 ecs_scheduler_add_system(EcsScheduler *scheduler, const EcsSystemDesc *desc);
+
+/**
+ * @brief Runs every system once and returns when all have finished.
+ *
+ * Systems start as soon as the systems they depend on finish, each on a job.
+ * Query systems split their views across further jobs. Without the job system
+ * everything runs on the calling thread, each system after its dependencies.
+ * Systems must not create or destroy entities or add or remove components
+ * directly; they record those into the scheduler's command queue, which is
+ * played back once every system has finished.
+ *
+ * @param scheduler A pointer to the scheduler.
+ * @param deltaTime Seconds since the last run.
+ * @return void
+ */
+ENGINE_API void ecs_scheduler_run(EcsScheduler *scheduler, f32 deltaTime);
+
+/**
+ * @brief Gets the average number of threads busy with systems during the last
+ * run: work time divided by wall time.
+ *
+ * @param scheduler A pointer to the scheduler.
+ * @return f64 The achieved parallelism, 0 before the first run.
+ */
+ENGINE_API f64 ecs_scheduler_parallelism(const EcsScheduler *scheduler);
+
+#pragma endregion
+// =============================================================================
+
+#endif // ENGINE_ECS_SYSTEM_H
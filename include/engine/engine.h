@@ -13,6 +13,7 @@
 #define ENGINE_H
 
 #include "engine/defines.h"
+#include "engine/job_system.h"
 #include "engine/memory.h"
 #include "engine/platform.h"
 
@@ -27,7 +28,9 @@ typedef struct Application Application;
  * @brief Configuration structure for initializing the engine.
  */
 typedef struct EngineConfig {
-    u64 memoryPoolSize; /**< Size of the memory pool in bytes. */
+    u64 memoryPoolSize;         /**< Size of the memory pool in bytes. */
+    u32 jobWorkerCount;         /**< Job system workers including the main thread (0 uses the processor count). */
+    b8 profileHardwareCounters; /**< Read hardware performance counters in the profiler (Linux only). */
     // TODO: Other configuration params as needed.
 } EngineConfig;
 
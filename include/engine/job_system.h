@@ -0,0 +1,160 @@
+/**
+ * @file job_system.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief Work-stealing job system. Runs small units of work ("jobs") across a
+ * fixed pool of worker threads, with completion tracked through counters.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef ENGINE_JOB_SYSTEM_H
+#define ENGINE_JOB_SYSTEM_H
+
+#include "engine/defines.h"
+#include "engine/memory.h"
+#include "engine/platform.h"
+
+// Maximum number of workers, including the thread that calls job_system_init.
+#define JOB_SYSTEM_MAX_WORKERS 64
+
+// Capacity of each worker's deque. Must be a power of two. Jobs pushed to a
+// full deque run immediately on the pushing thread instead.
+#define JOB_SYSTEM_QUEUE_CAPACITY 4096
+
+// Default number of fibers preallocated in fiber mode. Bounds how many jobs
+// can be suspended in job_wait at once; beyond that, jobs run directly on the
+// worker's stack and wait by helping, as in thread mode.
+#define JOB_SYSTEM_DEFAULT_FIBER_COUNT 128
+
+// Default stack size of each fiber in bytes.
+#define JOB_SYSTEM_DEFAULT_FIBER_STACK_SIZE (64 * 1024)
+
+// =============================================================================
+#pragma region Types
+
+/**
+ * @brief Job entry point.
+ *
+ * @param userData The user data supplied in the JobDecl.
+ */
+typedef void (*JobFunc)(void *userData);
+
+/**
+ * @brief Declaration of a single job to run.
+ */
+typedef struct JobDecl {
+    JobFunc func;   /**< The function to run. */
+    void *userData; /**< User data passed to the function. */
+} JobDecl;
+
+/**
+ * @brief Tracks completion of a group of jobs.
+ *
+ * Zero-initialize before first use. job_run adds the number of jobs submitted
+ * and each job decrements it when it finishes, so a counter can be shared by
+ * several job_run calls and is complete when it reaches zero again. Jobs that
+ * depend on others wait on the counter of the work they depend on.
+ */
+typedef struct JobCounter {
+    PlatformAtomicI32 value; /**< Number of outstanding jobs. */
+} JobCounter;
+
+/**
+ * @brief Configuration structure for initializing the job system.
+ */
+typedef struct JobSystemConfig {
+    u32 workerCount;    /**< Workers including the calling thread (0 uses the processor count). */
+    b8 useFibers;       /**< Run jobs on fibers so job_wait suspends instead of nesting (ignored where unsupported). */
+    u32 fiberCount;     /**< Fibers in the pool (0 uses JOB_SYSTEM_DEFAULT_FIBER_COUNT). */
+    u32 fiberStackSize; /**< Stack size per fiber in bytes (0 uses JOB_SYSTEM_DEFAULT_FIBER_STACK_SIZE). */
+} JobSystemConfig;
+
+#pragma endregion
+// =============================================================================
+#pragma region Interface
+
+/**
+ * @brief Initializes the job system and starts its worker threads.
+ *
+ * The calling thread becomes worker 0 and takes part in running jobs whenever
+ * it calls job_wait.
+ *
+ * @param pool A pointer to the memory pool to allocate worker state from.
+ * @param config A pointer to the job system configuration.
+ * @return ENGINE_SUCCESS if the job system was initialized successfully, otherwise an error code.
+ */
+ENGINE_API EngineResult job_system_init(MemoryPool *pool, const JobSystemConfig *config);
+
+/**
+ * @brief Stops the worker threads and frees the job system's resources.
+ *
+ * All submitted jobs must have completed before calling this.
+ *
+ * @return void
+ */
+ENGINE_API void job_system_shutdown(void);
+
+/**
+ * @brief Gets the number of workers, including the main thread.
+ *
+ * @return u32 The worker count, or 1 if the job system is not initialized.
+ */
+ENGINE_API u32 job_system_get_worker_count(void);
+
+/**
+ * @brief Gets the index of the calling worker.
+ *
+ * @return u32 The worker index in [0, worker count), or INVALID_ID_U32 if the
+ * calling thread is not a job system worker.
+ */
+ENGINE_API u32 job_system_get_worker_index(void);
+
+/**
+ * @brief Checks whether jobs are running on fibers.
+ *
+ * @return b8 True if the job system was initialized in fiber mode.
+ */
+ENGINE_API b8 job_system_uses_fibers(void);
+
+/**
+ * @brief Submits jobs to the calling worker's queue.
+ *
+ * Idle workers steal from the queue, so the jobs run in parallel. If the job
+ * system is not initialized, or the caller is not a worker, the jobs run
+ * immediately on the calling thread.
+ *
+ * @param jobs A pointer to the array of jobs to submit.
+ * @param count The number of jobs in the array.
+ * @param counter An optional counter incremented by count and decremented as each job completes.
+ * @return void
+ */
+ENGINE_API void job_run(const JobDecl *jobs, u32 count, JobCounter *counter);
+
+/**
+ * @brief Waits until a counter reaches zero.
+ *
+ * The calling worker runs other queued jobs while it waits rather than
+ * blocking, so waiting inside a job cannot starve the pool. In fiber mode a
+ * job that waits is suspended instead: its fiber is parked until the counter
+ * reaches zero and the worker moves on to other work. The job may resume on a
+ * different worker thread.
+ *
+ * @param counter A pointer to the counter to wait on.
+ * @return void
+ */
+ENGINE_API void job_wait(JobCounter *counter);
+
+/**
+ * @brief Checks whether every job tracked by a counter has completed.
+ *
+ * @param counter A pointer to the counter to check.
+ * @return b8 True if the counter is zero.
+ */
+ENGINE_API b8 job_is_complete(JobCounter *counter);
+
+#pragma endregion
+// =============================================================================
+
+#endif // ENGINE_JOB_SYSTEM_H
@@ -2,11 +2,18 @@
 #define ENGINE_MEMORY_H
 
 #include "engine/defines.h"
+#include "engine/platform.h"
 
 // Magic number for integrity checking.
 #define MEMORY_MAGIC_NUMBER 0xDEADBEEF
 #define ENGINE_STANDARD_ALIGNMENT 16
 
+// Maximum number of live allocations tracked across all memory pools.
+#define MEMORY_MAX_ALLOCATION_RECORDS 65536
+
+// Smallest remainder split off a reused free block.
+#define MEMORY_MIN_SPLIT_SIZE 64
+
 // =============================================================================
 
 typedef enum MemoryTag {
@@ -25,6 +32,7 @@ typedef enum MemoryTag {
     MEMORY_TAG_ASSET,
     MEMORY_TAG_EDITOR,
     MEMORY_TAG_GAME,
+    MEMORY_TAG_ECS,
 
     MEMORY_TAG_MAX,
 } MemoryTag;
@@ -36,8 +44,9 @@ typedef struct MemoryBlockHeader MemoryBlockHeader;
  * @brief Memory block header.
  */
 typedef struct MemoryBlockHeader {
-    struct MemoryBlockHeader *next; /**< Pointer to the next free memory block. */
-    u64 size;                       /**< Size of the memory block. */
+    struct MemoryBlockHeader *next; /**< Pointer to the next free memory block, in address order. */
+    u64 size;                       /**< Size of the memory block, from the header to its end. */
+    u64 padding;                    /**< Unused bytes between the start of the block and the header. */
     MemoryTag tag;                  /**< Tag associated with the memory block. */
     u32 magic;                      /**< Magic number for memory block validation. */
 } MemoryBlockHeader;
@@ -60,7 +69,7 @@ typedef struct MemoryPool {
     u64 used;                                      /**< Amount of memory used. */
     MemoryBlockHeader *freeList;                   /**< Pointer to the free memory block list. */
     AllocationRecord *allocations[MEMORY_TAG_MAX]; /**< Allocation tracking per tag. */
-    void *lock;                                    /**< Pointer to the memory pool lock. */
+    PlatformFastMutex lock;                        /**< Lock guarding the free list and allocation tracking. */
 } MemoryPool;
 
 // =============================================================================
@@ -0,0 +1,107 @@
+/**
+ * @file parallel.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief Data-parallel loop primitives built on the job system.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef ENGINE_PARALLEL_H
+#define ENGINE_PARALLEL_H
+
+#include "engine/defines.h"
+
+// Loops with fewer elements than this always run serially on the caller; the
+// cost of waking workers outweighs the work.
+#define PARALLEL_SERIAL_THRESHOLD 1024
+
+// Smallest chunk handed to a job when the grain size is chosen automatically.
+#define PARALLEL_MIN_GRAIN_SIZE 256
+
+// Upper bound on chunks per call. Larger loops get proportionally larger chunks.
+#define PARALLEL_MAX_CHUNKS 256
+
+// Chunks targeted by parallel_reduce when the grain size is chosen
+// automatically. Fixed (not derived from the worker count) so the partition,
+// and therefore the result, is identical on every machine.
+#define PARALLEL_REDUCE_CHUNKS 64
+
+// Largest partial result parallel_reduce supports. Each partial gets its own
+// cache line so workers never share one.
+#define PARALLEL_MAX_RESULT_SIZE ENGINE_CACHE_LINE_SIZE
+
+// =============================================================================
+#pragma region Types
+
+/**
+ * @brief Processes the elements in [begin, end).
+ *
+ * @param begin The first element index of the range.
+ * @param end One past the last element index of the range.
+ * @param userData The user data passed to parallel_for.
+ */
+typedef void (*ParallelForFunc)(u32 begin, u32 end, void *userData);
+
+/**
+ * @brief Accumulates the elements in [begin, end) into a partial result.
+ *
+ * @param begin The first element index of the range.
+ * @param end One past the last element index of the range.
+ * @param partial The partial result to accumulate into, initialized to the identity.
+ * @param userData The user data passed to parallel_reduce.
+ */
+typedef void (*ParallelReduceFunc)(u32 begin, u32 end, void *partial, void *userData);
+
+/**
+ * @brief Combines a partial result into the final result.
+ *
+ * @param result The running result.
+ * @param partial The partial result to fold in.
+ * @param userData The user data passed to parallel_reduce.
+ */
+typedef void (*ParallelCombineFunc)(void *result, const void *partial, void *userData);
+
+#pragma endregion
+// =============================================================================
+#pragma region Interface
+
+/**
+ * @brief Runs fn over [0, count) split into chunks across the job system, and
+ * returns once every chunk has completed.
+ *
+ * The calling thread takes part in the work. Small loops run serially.
+ *
+ * @param count The number of elements.
+ * @param grainSize Elements per chunk, or 0 to choose from the count and worker count.
+ * @param fn The function to run on each chunk.
+ * @param userData User data passed to fn.
+ * @return void
+ */
+ENGINE_API void parallel_for(u32 count, u32 grainSize, ParallelForFunc fn, void *userData);
+
+/**
+ * @brief Reduces [0, count) in parallel.
+ *
+ * On entry result holds the identity value. Each chunk starts from a copy of
+ * it, reduceFn accumulates the chunk, and the partials are then combined into
+ * result in chunk order on the calling thread. The partition depends only on
+ * count and grainSize, so the result is bit-for-bit identical regardless of
+ * worker count or scheduling (important for floating point sums).
+ *
+ * @param count The number of elements.
+ * @param grainSize Elements per chunk, or 0 to choose from the count alone.
+ * @param reduceFn The function accumulating a chunk into a partial.
+ * @param combineFn The function folding a partial into the result.
+ * @param result The identity on entry; the reduced value on return.
+ * @param resultSize The size of the result in bytes (at most PARALLEL_MAX_RESULT_SIZE).
+ * @param userData User data passed to reduceFn and combineFn.
+ * @return void
+ */
+ENGINE_API void parallel_reduce(u32 count, u32 grainSize, ParallelReduceFunc reduceFn, ParallelCombineFunc combineFn, void *result, u32 resultSize, void *userData);
+
+#pragma endregion
+// =============================================================================
+
+#endif // ENGINE_PARALLEL_H
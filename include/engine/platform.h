@@ -14,15 +14,25 @@
 #define ENGINE_PLATFORM_H
 
 #include "engine/defines.h"
-#include "engine/memory.h"
-#include "engine/window.h"
+
+// Lock contention profiling. Build everything (engine and game) with
+// -DENGINE_ENABLE_LOCK_PROFILER=1 to record acquisitions, wait time and hold
+// time for every named lock. When disabled, naming a lock compiles to nothing
+// and the locks carry no extra state.
+#ifndef ENGINE_ENABLE_LOCK_PROFILER
+#    define ENGINE_ENABLE_LOCK_PROFILER 0
+#endif
 
 // =============================================================================
 #pragma region Types
 
-// Forward declaration.
+// Forward declaration. memory.h embeds platform locks, so it includes this
+// header rather than the other way round.
+typedef struct MemoryPool MemoryPool;
 typedef struct Platform Platform;
+typedef struct ProfilerLock ProfilerLock;
 typedef struct Renderer Renderer;
+typedef struct Window Window;
 
 /**
  * @brief Function pointer types for platform abstraction.
@@ -30,6 +40,8 @@ typedef struct Renderer Renderer;
 typedef EngineResult (*PlatformInitFunc)(Platform *platform, MemoryPool *pool);
 typedef void (*PlatformShutdownFunc)(Platform *platform);
 typedef void (*PlatformPollEventsFunc)(Platform *platform);
+typedef b8 (*PlatformWaitEventsFunc)(Platform *platform, u32 timeoutMs);
+typedef void (*PlatformWakeFunc)(Platform *platform);
 typedef b8 (*PlatformIsRunningFunc)(Platform *platform);
 typedef u64 (*PlatformGetAbsoluteTimeFunc)(Platform *platform);
 
@@ -44,6 +56,8 @@ typedef struct Platform {
     PlatformInitFunc init;                       /**< Function pointer to initialize the platform. */
     PlatformShutdownFunc shutdown;               /**< Function pointer to shutdown the platform. */
     PlatformPollEventsFunc pollEvents;           /**< Function pointer to poll events. */
+    PlatformWaitEventsFunc waitEvents;           /**< Function pointer to block until events arrive. */
+    PlatformWakeFunc wake;                       /**< Function pointer to wake a blocked event wait. */
     PlatformIsRunningFunc isRunning;             /**< Function pointer to check if the platform is running. */
     PlatformGetAbsoluteTimeFunc getAbsoluteTime; /**< Function pointer to get the absolute time. */
 } Platform;
@@ -77,6 +91,29 @@ ENGINE_API void platform_shutdown(Platform *platform);
  */
 ENGINE_API void platform_poll_events(Platform *platform);
 
+/**
+ * @brief Blocks until a platform event arrives or the timeout expires, then
+ * processes every pending event in the same way as platform_poll_events.
+ *
+ * Used by the application loop when idle so the process sleeps in the OS
+ * instead of spinning on an empty event queue.
+ *
+ * @param platform A pointer to the Platform structure.
+ * @param timeoutMs The maximum time to wait in milliseconds, or 0 to wait indefinitely.
+ * @return b8 True if at least one event was processed, false if the wait timed out.
+ */
+ENGINE_API b8 platform_wait_events(Platform *platform, u32 timeoutMs);
+
+/**
+ * @brief Wakes a thread blocked in platform_wait_events.
+ *
+ * Safe to call from any thread.
+ *
+ * @param platform A pointer to the Platform structure.
+ * @return void
+ */
+ENGINE_API void platform_wake(Platform *platform);
+
 /**
  * @brief Check if the platform should continue running.
  *
@@ -93,6 +130,23 @@ ENGINE_API b8 platform_is_running(Platform *platform);
  */
 ENGINE_API u64 platform_get_absolute_time(Platform *platform);
 
+/**
+ * @brief Gets the current value of the high resolution performance counter.
+ *
+ * Only meaningful relative to other readings; divide differences by
+ * platform_get_performance_frequency to convert to seconds.
+ *
+ * @return u64 The current counter value.
+ */
+ENGINE_API u64 platform_get_performance_counter(void);
+
+/**
+ * @brief Gets the number of performance counter ticks per second.
+ *
+ * @return u64 The performance counter frequency.
+ */
+ENGINE_API u64 platform_get_performance_frequency(void);
+
 #pragma endregion
 // =============================================================================
 // #pragma region Window
@@ -236,6 +290,643 @@ ENGINE_API void platform_mutex_lock(void *lock);
  */
 ENGINE_API void platform_mutex_unlock(void *lock);
 
+#if ENGINE_ENABLE_LOCK_PROFILER
+/**
+ * @brief Names a mutex so the lock profiler records its contention. Locks
+ * sharing a name are reported together.
+ *
+ * @param lock A pointer to the mutex to name.
+ * @param name The lock name. Must outlive the program (use a string literal).
+ * @return void
+ */
+ENGINE_API void platform_mutex_set_name(void *lock, const char *name);
+#else
+#    define platform_mutex_set_name(lock, name) ((void)(lock), (void)(name))
+#endif
+
+/**
+ * @brief Thread entry point signature.
+ *
+ * @param data The user data passed to platform_thread_create.
+ * @return i32 The thread's exit code, returned by platform_thread_join.
+ */
+typedef i32 (*PlatformThreadFunc)(void *data);
+
+/**
+ * @brief Creates and starts a thread.
+ *
+ * @param func The function to run on the new thread.
+ * @param data User data passed to the thread function.
+ * @param name A debug name for the thread (shown in debuggers and profilers).
+ * @param thread A double pointer that receives the thread handle.
+ * @return ENGINE_SUCCESS if the thread was started, otherwise an error code.
+ */
+ENGINE_API EngineResult platform_thread_create(PlatformThreadFunc func, void *data, const char *name, void **thread);
+
+/**
+ * @brief Waits for a thread to finish and releases its handle.
+ *
+ * @param thread A pointer to the thread to join.
+ * @return i32 The exit code returned by the thread function.
+ */
+ENGINE_API i32 platform_thread_join(void *thread);
+
+/**
+ * @brief Gets an identifier for the calling thread.
+ *
+ * @return u64 The calling thread's identifier.
+ */
+ENGINE_API u64 platform_thread_get_id(void);
+
+/**
+ * @brief Gives up the remainder of the calling thread's time slice.
+ *
+ * @return void
+ */
+ENGINE_API void platform_thread_yield(void);
+
+/**
+ * @brief Suspends the calling thread.
+ *
+ * @param ms The time to sleep in milliseconds.
+ * @return void
+ */
+ENGINE_API void platform_sleep(u32 ms);
+
+/**
+ * @brief Gets the number of logical processors available to the process.
+ *
+ * @return u32 The logical processor count (at least 1).
+ */
+ENGINE_API u32 platform_get_processor_count(void);
+
+/**
+ * @brief Creates a counting semaphore.
+ *
+ * @param semaphore A double pointer that receives the semaphore handle.
+ * @param initialValue The initial count of the semaphore.
+ * @return void
+ */
+ENGINE_API void platform_semaphore_create(void **semaphore, u32 initialValue);
+
+/**
+ * @brief Destroys a semaphore.
+ *
+ * @param semaphore A pointer to the semaphore to destroy.
+ * @return void
+ */
+ENGINE_API void platform_semaphore_destroy(void *semaphore);
+
+/**
+ * @brief Waits until the semaphore count is positive, then decrements it.
+ *
+ * @param semaphore A pointer to the semaphore to wait on.
+ * @return void
+ */
+ENGINE_API void platform_semaphore_wait(void *semaphore);
+
+/**
+ * @brief Waits until the semaphore count is positive or the timeout expires.
+ *
+ * @param semaphore A pointer to the semaphore to wait on.
+ * @param timeoutMs The maximum time to wait in milliseconds.
+ * @return b8 True if the semaphore was acquired, false if the wait timed out.
+ */
+ENGINE_API b8 platform_semaphore_wait_timeout(void *semaphore, u32 timeoutMs);
+
+/**
+ * @brief Increments the semaphore count, waking one waiter if any.
+ *
+ * @param semaphore A pointer to the semaphore to signal.
+ * @return void
+ */
+ENGINE_API void platform_semaphore_signal(void *semaphore);
+
+#pragma endregion
+// =============================================================================
+#pragma region Fibers
+
+// Fibers are cooperatively scheduled execution contexts with their own stack.
+// They are currently only implemented on Linux (ucontext); elsewhere
+// platform_fiber_supported returns false and creation fails.
+
+/**
+ * @brief Fiber entry point. It must never return; switch to another fiber instead.
+ *
+ * @param data The user data passed to platform_fiber_create.
+ */
+typedef void (*PlatformFiberFunc)(void *data);
+
+/**
+ * @brief Checks whether fibers are available on this platform.
+ *
+ * @return b8 True if platform_fiber_create is supported.
+ */
+ENGINE_API b8 platform_fiber_supported(void);
+
+/**
+ * @brief Creates a fiber with its own stack. The fiber does not run until it
+ * is switched to.
+ *
+ * @param func The function the fiber starts in.
+ * @param data User data passed to the fiber function.
+ * @param stackSize The stack size in bytes (rounded up to the page size).
+ * @param fiber A double pointer that receives the fiber handle.
+ * @return ENGINE_SUCCESS if the fiber was created, otherwise an error code.
+ */
+ENGINE_API EngineResult platform_fiber_create(PlatformFiberFunc func, void *data, u64 stackSize, void **fiber);
+
+/**
+ * @brief Creates a fiber handle for the calling thread, so the thread can
+ * switch to other fibers and be switched back to.
+ *
+ * @param fiber A double pointer that receives the fiber handle.
+ * @return ENGINE_SUCCESS if the handle was created, otherwise an error code.
+ */
+ENGINE_API EngineResult platform_fiber_create_from_thread(void **fiber);
+
+/**
+ * @brief Destroys a fiber and releases its stack. The fiber must not be running.
+ *
+ * @param fiber A pointer to the fiber to destroy.
+ * @return void
+ */
+ENGINE_API void platform_fiber_destroy(void *fiber);
+
+/**
+ * @brief Saves the current context into one fiber and resumes another.
+ *
+ * @param from A pointer to the fiber that is currently running on this thread.
+ * @param to A pointer to the fiber to resume.
+ * @return void
+ */
+ENGINE_API void platform_fiber_switch(void *from, void *to);
+
+#pragma endregion
+// =============================================================================
+#pragma region Performance Counters
+
+// Hardware performance counters for the calling thread. Currently Linux only
+// (perf_event_open); elsewhere, or when the kernel or a VM does not expose the
+// PMU, opening fails and callers should carry on without counters.
+
+/**
+ * @brief Hardware events that can be counted.
+ */
+typedef enum PlatformPerfCounter {
+    PLATFORM_PERF_COUNTER_CYCLES = 0,    /**< CPU cycles. */
+    PLATFORM_PERF_COUNTER_INSTRUCTIONS,  /**< Retired instructions. */
+    PLATFORM_PERF_COUNTER_L1D_MISSES,    /**< L1 data cache read misses. */
+    PLATFORM_PERF_COUNTER_LLC_MISSES,    /**< Last level cache misses. */
+    PLATFORM_PERF_COUNTER_BRANCH_MISSES, /**< Mispredicted branches. */
+
+    PLATFORM_PERF_COUNTER_COUNT,
+} PlatformPerfCounter;
+
+/**
+ * @brief A snapshot of the counters. Values are cumulative since the counters
+ * were opened; subtract two snapshots to measure a region.
+ */
+typedef struct PlatformPerfCounterValues {
+    u64 values[PLATFORM_PERF_COUNTER_COUNT]; /**< Counter values, indexed by PlatformPerfCounter. */
+    u32 validMask;                           /**< Bit (1 << counter) set for each counter that is being counted. */
+} PlatformPerfCounterValues;
+
+/**
+ * @brief Opens and starts the hardware counters for the calling thread. The
+ * handle must only be read from the thread that opened it.
+ *
+ * @param counters A double pointer that receives the counter handle.
+ * @return ENGINE_SUCCESS if at least the cycle counter is available, otherwise an error code.
+ */
+ENGINE_API EngineResult platform_perf_counters_open(void **counters);
+
+/**
+ * @brief Stops and closes hardware counters.
+ *
+ * @param counters A pointer to the counters to close.
+ * @return void
+ */
+ENGINE_API void platform_perf_counters_close(void *counters);
+
+/**
+ * @brief Reads the current counter values. Values are scaled up when the
+ * kernel had to multiplex the counters.
+ *
+ * @param counters A pointer to the counters to read.
+ * @param values A pointer that receives the values.
+ * @return b8 True if the values were read.
+ */
+ENGINE_API b8 platform_perf_counters_read(void *counters, PlatformPerfCounterValues *values);
+
+#pragma endregion
+// =============================================================================
+#pragma region Atomics
+
+// Atomics are implemented inline with compiler builtins (clang/gcc) so they
+// compile down to single instructions rather than calls into the platform
+// library. Loads are acquire, stores are release, and read-modify-write
+// operations are sequentially consistent unless stated otherwise.
+
+/** @brief 32-bit signed integer accessed atomically. */
+typedef struct PlatformAtomicI32 {
+    volatile i32 value; /**< The underlying value. Access only through platform_atomic_* functions. */
+} PlatformAtomicI32;
+
+/** @brief 64-bit signed integer accessed atomically. */
+typedef struct PlatformAtomicI64 {
+    volatile i64 value; /**< The underlying value. Access only through platform_atomic_* functions. */
+} PlatformAtomicI64;
+
+/** @brief Pointer accessed atomically. */
+typedef struct PlatformAtomicPtr {
+    void *volatile value; /**< The underlying value. Access only through platform_atomic_* functions. */
+} PlatformAtomicPtr;
+
+static ENGINE_INLINE i32 platform_atomic_load_i32(const PlatformAtomicI32 *atomic) {
+    return __atomic_load_n(&atomic->value, __ATOMIC_ACQUIRE);
+}
+
+static ENGINE_INLINE void platform_atomic_store_i32(PlatformAtomicI32 *atomic, i32 value) {
+    __atomic_store_n(&atomic->value, value, __ATOMIC_RELEASE);
+}
+
+static ENGINE_INLINE i32 platform_atomic_exchange_i32(PlatformAtomicI32 *atomic, i32 value) {
+    return __atomic_exchange_n(&atomic->value, value, __ATOMIC_SEQ_CST);
+}
+
+/** @brief Atomically replaces *expected with the current value on failure. Returns true on success. */
+static ENGINE_INLINE b8 platform_atomic_compare_exchange_i32(PlatformAtomicI32 *atomic, i32 *expected, i32 desired) {
+    return __atomic_compare_exchange_n(&atomic->value, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/** @brief Adds to the value and returns the previous value. */
+static ENGINE_INLINE i32 platform_atomic_fetch_add_i32(PlatformAtomicI32 *atomic, i32 value) {
+    return __atomic_fetch_add(&atomic->value, value, __ATOMIC_SEQ_CST);
+}
+
+static ENGINE_INLINE i64 platform_atomic_load_i64(const PlatformAtomicI64 *atomic) {
+    return __atomic_load_n(&atomic->value, __ATOMIC_ACQUIRE);
+}
+
+static ENGINE_INLINE void platform_atomic_store_i64(PlatformAtomicI64 *atomic, i64 value) {
+    __atomic_store_n(&atomic->value, value, __ATOMIC_RELEASE);
+}
+
+static ENGINE_INLINE i64 platform_atomic_exchange_i64(PlatformAtomicI64 *atomic, i64 value) {
+    return __atomic_exchange_n(&atomic->value, value, __ATOMIC_SEQ_CST);
+}
+
+/** @brief Atomically replaces *expected with the current value on failure. Returns true on success. */
+static ENGINE_INLINE b8 platform_atomic_compare_exchange_i64(PlatformAtomicI64 *atomic, i64 *expected, i64 desired) {
+    return __atomic_compare_exchange_n(&atomic->value, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/** @brief Adds to the value and returns the previous value. */
+static ENGINE_INLINE i64 platform_atomic_fetch_add_i64(PlatformAtomicI64 *atomic, i64 value) {
+    return __atomic_fetch_add(&atomic->value, value, __ATOMIC_SEQ_CST);
+}
+
+static ENGINE_INLINE void *platform_atomic_load_ptr(const PlatformAtomicPtr *atomic) {
+    return __atomic_load_n(&atomic->value, __ATOMIC_ACQUIRE);
+}
+
+static ENGINE_INLINE void platform_atomic_store_ptr(PlatformAtomicPtr *atomic, void *value) {
+    __atomic_store_n(&atomic->value, value, __ATOMIC_RELEASE);
+}
+
+/** @brief Atomically replaces *expected with the current value on failure. Returns true on success. */
+static ENGINE_INLINE b8 platform_atomic_compare_exchange_ptr(PlatformAtomicPtr *atomic, void **expected, void *desired) {
+    return __atomic_compare_exchange_n(&atomic->value, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/** @brief Full sequentially consistent memory fence. */
+static ENGINE_INLINE void platform_atomic_fence(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/** @brief Hints to the CPU that the caller is busy-waiting. */
+static ENGINE_INLINE void platform_cpu_relax(void) {
+#if defined(ENGINE_ARCH_X64) || defined(ENGINE_ARCH_X86)
+    __builtin_ia32_pause();
+#elif defined(ENGINE_ARCH_ARM64) || defined(ENGINE_ARCH_ARM)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Locks
+
+// Lightweight locks that live by value inside the structure they protect and
+// lock without leaving the caller in the uncontended case. Only the contended
+// slow path calls into the platform layer (a futex on Linux). None of them are
+// recursive, and none need to be destroyed.
+
+// Number of times a contended lock spins before it sleeps.
+#define PLATFORM_LOCK_SPIN_COUNT 128
+
+/**
+ * @brief Sleeps while a 32-bit word still holds an expected value.
+ *
+ * May return spuriously; callers must re-check their condition. Platforms
+ * without a futex fall back to yielding the thread.
+ *
+ * @param address A pointer to the word to wait on.
+ * @param expected The value the word must hold for the caller to sleep.
+ * @return void
+ */
+ENGINE_API void platform_futex_wait(PlatformAtomicI32 *address, i32 expected);
+
+/**
+ * @brief Wakes threads sleeping in platform_futex_wait on a word.
+ *
+ * @param address A pointer to the word the threads wait on.
+ * @param count The maximum number of threads to wake (MAX_U32 wakes all).
+ * @return void
+ */
+ENGINE_API void platform_futex_wake(PlatformAtomicI32 *address, u32 count);
+
+/**
+ * @brief Adaptive mutex: spins briefly, then sleeps on a futex.
+ *
+ * Zero-initialized is unlocked. State 0 is unlocked, 1 locked, and 2 locked
+ * with possible sleepers, so an uncontended unlock never makes a system call.
+ */
+typedef struct PlatformFastMutex {
+    PlatformAtomicI32 state; /**< 0 unlocked, 1 locked, 2 locked with waiters. */
+#if ENGINE_ENABLE_LOCK_PROFILER
+    ProfilerLock *profile; /**< Contention record, NULL until the lock is named. */
+    u64 acquiredTicks;     /**< Performance counter when the current owner acquired the lock. */
+#endif
+} PlatformFastMutex;
+
+/**
+ * @brief Ticket spinlock. Fair (FIFO) and never sleeps, though waiters yield
+ * after PLATFORM_LOCK_SPIN_COUNT spins; use only around a handful of
+ * instructions. Zero-initialized is unlocked.
+ */
+typedef struct PlatformSpinLock {
+    PlatformAtomicI32 next;    /**< Next ticket to hand out. */
+    PlatformAtomicI32 serving; /**< Ticket currently allowed to hold the lock. */
+} PlatformSpinLock;
+
+/**
+ * @brief Reader-writer lock that prefers writers. Readers share the lock;
+ * writers are exclusive. Zero-initialized is unlocked.
+ */
+typedef struct PlatformRWLock {
+    PlatformAtomicI32 state;          /**< Reader count, or -1 while a writer holds the lock. */
+    PlatformAtomicI32 writersWaiting; /**< Writers waiting; new readers back off while non-zero. */
+    PlatformAtomicI32 sleepers;       /**< Threads asleep on sequence. */
+    PlatformAtomicI32 sequence;       /**< Bumped on release when there are sleepers. */
+} PlatformRWLock;
+
+#if ENGINE_ENABLE_LOCK_PROFILER
+// Lock profiler hooks, implemented by the profiler (core/profiler.c).
+
+/**
+ * @brief Finds or creates the contention record for a lock name.
+ *
+ * @param name The lock name. Must outlive the program.
+ * @return ProfilerLock* The record, or NULL if the record table is full.
+ */
+ENGINE_API ProfilerLock *profiler_lock_register(const char *name);
+
+/**
+ * @brief Records an acquisition. Called by the new owner.
+ *
+ * @param lock A pointer to the contention record.
+ * @param waitTicks Performance counter ticks spent waiting, 0 if the lock was free.
+ * @return void
+ */
+ENGINE_API void profiler_lock_acquired(ProfilerLock *lock, u64 waitTicks);
+
+/**
+ * @brief Records a release. Called by the owner before it unlocks.
+ *
+ * @param lock A pointer to the contention record.
+ * @param holdTicks Performance counter ticks the lock was held for.
+ * @return void
+ */
+ENGINE_API void profiler_lock_released(ProfilerLock *lock, u64 holdTicks);
+#endif
+
+static ENGINE_INLINE void platform_fast_mutex_init(PlatformFastMutex *mutex) {
+    platform_atomic_store_i32(&mutex->state, 0);
+#if ENGINE_ENABLE_LOCK_PROFILER
+    mutex->profile = NULL;
+    mutex->acquiredTicks = 0;
+#endif
+}
+
+/** @brief Single attempt to take the lock, without profiling. */
+static ENGINE_INLINE b8 platform_fast_mutex_acquire(PlatformFastMutex *mutex) {
+    i32 expected = 0;
+    return platform_atomic_compare_exchange_i32(&mutex->state, &expected, 1);
+}
+
+/** @brief Contended path of platform_fast_mutex_lock. */
+static ENGINE_INLINE void platform_fast_mutex_lock_slow(PlatformFastMutex *mutex) {
+    for (u32 spin = 0; spin < PLATFORM_LOCK_SPIN_COUNT; ++spin) {
+        platform_cpu_relax();
+        if (platform_atomic_load_i32(&mutex->state) == 0 && platform_fast_mutex_acquire(mutex)) {
+            return;
+        }
+    }
+
+    // Mark the lock as contended so the owner's unlock wakes us.
+    while (platform_atomic_exchange_i32(&mutex->state, 2) != 0) {
+        platform_futex_wait(&mutex->state, 2);
+    }
+}
+
+#if ENGINE_ENABLE_LOCK_PROFILER
+/**
+ * @brief Names a fast mutex so the lock profiler records its contention.
+ * Locks sharing a name are reported together. May be called while holding
+ * the lock; that hold is then not timed.
+ *
+ * @param mutex A pointer to the mutex to name.
+ * @param name The lock name. Must outlive the program (use a string literal).
+ * @return void
+ */
+static ENGINE_INLINE void platform_fast_mutex_set_name(PlatformFastMutex *mutex, const char *name) {
+    mutex->profile = profiler_lock_register(name);
+    mutex->acquiredTicks = 0;
+}
+
+static ENGINE_INLINE b8 platform_fast_mutex_try_lock(PlatformFastMutex *mutex) {
+    if (!platform_fast_mutex_acquire(mutex)) {
+        return false;
+    }
+
+    if (mutex->profile) {
+        mutex->acquiredTicks = platform_get_performance_counter();
+        profiler_lock_acquired(mutex->profile, 0);
+    }
+    return true;
+}
+
+static ENGINE_INLINE void platform_fast_mutex_lock(PlatformFastMutex *mutex) {
+    if (!mutex->profile) {
+        if (!platform_fast_mutex_acquire(mutex)) {
+            platform_fast_mutex_lock_slow(mutex);
+        }
+        return;
+    }
+
+    u64 start = platform_get_performance_counter();
+    b8 contended = !platform_fast_mutex_acquire(mutex);
+    if (contended) {
+        platform_fast_mutex_lock_slow(mutex);
+    }
+
+    mutex->acquiredTicks = platform_get_performance_counter();
+    profiler_lock_acquired(mutex->profile, contended ? mutex->acquiredTicks - start : 0);
+}
+
+static ENGINE_INLINE void platform_fast_mutex_unlock(PlatformFastMutex *mutex) {
+    if (mutex->profile && mutex->acquiredTicks) {
+        profiler_lock_released(mutex->profile, platform_get_performance_counter() - mutex->acquiredTicks);
+    }
+
+    if (platform_atomic_exchange_i32(&mutex->state, 0) == 2) {
+        platform_futex_wake(&mutex->state, 1);
+    }
+}
+#else
+#    define platform_fast_mutex_set_name(mutex, name) ((void)(mutex), (void)(name))
+
+static ENGINE_INLINE b8 platform_fast_mutex_try_lock(PlatformFastMutex *mutex) {
+    return platform_fast_mutex_acquire(mutex);
+}
+
+static ENGINE_INLINE void platform_fast_mutex_lock(PlatformFastMutex *mutex) {
+    if (!platform_fast_mutex_acquire(mutex)) {
+        platform_fast_mutex_lock_slow(mutex);
+    }
+}
+
+static ENGINE_INLINE void platform_fast_mutex_unlock(PlatformFastMutex *mutex) {
+    if (platform_atomic_exchange_i32(&mutex->state, 0) == 2) {
+        platform_futex_wake(&mutex->state, 1);
+    }
+}
+#endif
+
+static ENGINE_INLINE void platform_spinlock_init(PlatformSpinLock *lock) {
+    platform_atomic_store_i32(&lock->next, 0);
+    platform_atomic_store_i32(&lock->serving, 0);
+}
+
+static ENGINE_INLINE b8 platform_spinlock_try_lock(PlatformSpinLock *lock) {
+    i32 serving = platform_atomic_load_i32(&lock->serving);
+    i32 expected = serving;
+    return platform_atomic_compare_exchange_i32(&lock->next, &expected, serving + 1);
+}
+
+static ENGINE_INLINE void platform_spinlock_lock(PlatformSpinLock *lock) {
+    i32 ticket = platform_atomic_fetch_add_i32(&lock->next, 1);
+    // Yield after spinning, so a preempted holder or earlier ticket can run
+    // when there are more threads than processors.
+    for (u32 spin = 0; platform_atomic_load_i32(&lock->serving) != ticket; ++spin) {
+        if (spin < PLATFORM_LOCK_SPIN_COUNT) {
+            platform_cpu_relax();
+        } else {
+            platform_thread_yield();
+        }
+    }
+}
+
+static ENGINE_INLINE void platform_spinlock_unlock(PlatformSpinLock *lock) {
+    // Only the holder writes serving, so a plain increment is enough.
+    platform_atomic_store_i32(&lock->serving, lock->serving.value + 1);
+}
+
+static ENGINE_INLINE void platform_rwlock_init(PlatformRWLock *lock) {
+    platform_atomic_store_i32(&lock->state, 0);
+    platform_atomic_store_i32(&lock->writersWaiting, 0);
+    platform_atomic_store_i32(&lock->sleepers, 0);
+    platform_atomic_store_i32(&lock->sequence, 0);
+}
+
+static ENGINE_INLINE b8 platform_rwlock_try_read_lock(PlatformRWLock *lock) {
+    i32 state = platform_atomic_load_i32(&lock->state);
+    return state >= 0 && platform_atomic_load_i32(&lock->writersWaiting) == 0 &&
+           platform_atomic_compare_exchange_i32(&lock->state, &state, state + 1);
+}
+
+static ENGINE_INLINE b8 platform_rwlock_try_write_lock(PlatformRWLock *lock) {
+    i32 expected = 0;
+    return platform_atomic_compare_exchange_i32(&lock->state, &expected, -1);
+}
+
+/**
+ * @brief Contended path shared by readers and writers: spins, then sleeps on
+ * the sequence word until a release bumps it.
+ *
+ * @param lock A pointer to the lock.
+ * @param write True to acquire for writing.
+ * @return void
+ */
+static ENGINE_INLINE void platform_rwlock_lock_slow(PlatformRWLock *lock, b8 write) {
+    for (;;) {
+        for (u32 spin = 0; spin < PLATFORM_LOCK_SPIN_COUNT; ++spin) {
+            if (write ? platform_rwlock_try_write_lock(lock) : platform_rwlock_try_read_lock(lock)) {
+                return;
+            }
+            platform_cpu_relax();
+        }
+
+        // Read the sequence before re-checking: a release between the check
+        // and the wait changes it, so the wait returns immediately.
+        i32 sequence = platform_atomic_load_i32(&lock->sequence);
+        platform_atomic_fetch_add_i32(&lock->sleepers, 1);
+        if (write ? platform_rwlock_try_write_lock(lock) : platform_rwlock_try_read_lock(lock)) {
+            platform_atomic_fetch_add_i32(&lock->sleepers, -1);
+            return;
+        }
+        platform_futex_wait(&lock->sequence, sequence);
+        platform_atomic_fetch_add_i32(&lock->sleepers, -1);
+    }
+}
+
+/** @brief Wakes every sleeper after a release; they re-check the lock. */
+static ENGINE_INLINE void platform_rwlock_wake(PlatformRWLock *lock) {
+    if (platform_atomic_load_i32(&lock->sleepers) > 0) {
+        platform_atomic_fetch_add_i32(&lock->sequence, 1);
+        platform_futex_wake(&lock->sequence, MAX_U32);
+    }
+}
+
+static ENGINE_INLINE void platform_rwlock_read_lock(PlatformRWLock *lock) {
+    if (!platform_rwlock_try_read_lock(lock)) {
+        platform_rwlock_lock_slow(lock, false);
+    }
+}
+
+static ENGINE_INLINE void platform_rwlock_read_unlock(PlatformRWLock *lock) {
+    if (platform_atomic_fetch_add_i32(&lock->state, -1) == 1) {
+        platform_rwlock_wake(lock);
+    }
+}
+
+static ENGINE_INLINE void platform_rwlock_write_lock(PlatformRWLock *lock) {
+    if (platform_rwlock_try_write_lock(lock)) {
+        return;
+    }
+
+    platform_atomic_fetch_add_i32(&lock->writersWaiting, 1);
+    platform_rwlock_lock_slow(lock, true);
+    platform_atomic_fetch_add_i32(&lock->writersWaiting, -1);
+}
+
+static ENGINE_INLINE void platform_rwlock_write_unlock(PlatformRWLock *lock) {
+    platform_atomic_exchange_i32(&lock->state, 0);
+    platform_rwlock_wake(lock);
+}
+
 #pragma endregion
 // =============================================================================
 // #pragma region Shared Library
@@ -0,0 +1,225 @@
+/**
+ * @file profiler.h
+ * @author Andrew Hughes (a.hughes@gmail.com)
+ * @brief Lightweight CPU profiler. Times named zones and frames and, where the
+ * platform supports it, reads hardware performance counters around them.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Era Engine is Copyright (c) Andrew Hughes 2024
+ */
+
+#ifndef ENGINE_PROFILER_H
+#define ENGINE_PROFILER_H
+
+#include "engine/defines.h"
+#include "engine/platform.h"
+
+// Profiler zone macros are compiled in for debug builds unless overridden.
+#ifndef ENGINE_ENABLE_PROFILER
+#    if defined(_DEBUG)
+#        define ENGINE_ENABLE_PROFILER 1
+#    else
+#        define ENGINE_ENABLE_PROFILER 0
+#    endif
+#endif
+
+// Maximum number of distinct zone names.
+#define PROFILER_MAX_ZONES 128
+
+// Maximum number of threads that can read hardware counters.
+#define PROFILER_MAX_THREADS 64
+
+// Seconds between frame timing reports when none is configured.
+#define PROFILER_DEFAULT_REPORT_INTERVAL 5.0
+
+// Maximum number of distinct lock names tracked by the lock profiler.
+#define PROFILER_MAX_LOCKS 64
+
+// Number of locks listed in the contention report at shutdown.
+#define PROFILER_LOCK_REPORT_COUNT 10
+
+// =============================================================================
+#pragma region Types
+
+/**
+ * @brief Configuration structure for initializing the profiler.
+ */
+typedef struct ProfilerConfig {
+    b8 hardwareCounters; /**< Read hardware performance counters around zones and frames. */
+    f64 reportInterval;  /**< Seconds between frame timing reports (0 uses the default, negative disables). */
+} ProfilerConfig;
+
+/**
+ * @brief An open zone. Lives on the stack between begin and end.
+ */
+typedef struct ProfilerZone {
+    u32 zoneId;                              /**< Index of the zone's statistics. */
+    u64 startTicks;                          /**< Performance counter value at begin. */
+    PlatformPerfCounterValues startCounters; /**< Hardware counters at begin (validMask 0 if unavailable). */
+} ProfilerZone;
+
+/**
+ * @brief Accumulated statistics for one zone name.
+ */
+typedef struct ProfilerZoneStats {
+    const char *name;                          /**< Zone name. */
+    u64 calls;                                 /**< Number of completed begin/end pairs. */
+    f64 totalSeconds;                          /**< Total time spent in the zone. */
+    f64 maxSeconds;                            /**< Longest single call. */
+    f64 workSeconds;                           /**< Time jobs spent on the zone's work across threads, from profiler_zone_add_work. */
+    u64 counters[PLATFORM_PERF_COUNTER_COUNT]; /**< Hardware counter totals, indexed by PlatformPerfCounter. */
+    u32 counterMask;                           /**< Bit (1 << counter) set if every call recorded that counter. */
+} ProfilerZoneStats;
+
+/**
+ * @brief Accumulated contention statistics for one lock name. Only recorded
+ * when built with ENGINE_ENABLE_LOCK_PROFILER.
+ */
+typedef struct ProfilerLockStats {
+    const char *name;   /**< Lock name. */
+    u64 acquisitions;   /**< Number of times the lock was taken. */
+    u64 contentions;    /**< Acquisitions that found the lock held and had to wait. */
+    f64 waitSeconds;    /**< Total time spent waiting for the lock. */
+    f64 maxWaitSeconds; /**< Longest single wait. */
+    f64 holdSeconds;    /**< Total time the lock was held. */
+    f64 maxHoldSeconds; /**< Longest single hold. */
+} ProfilerLockStats;
+
+#pragma endregion
+// =============================================================================
+#pragma region Interface
+
+/**
+ * @brief Initializes the profiler. The calling thread is treated as the main
+ * thread whose frames are timed.
+ *
+ * @param config A pointer to the profiler configuration.
+ * @return ENGINE_SUCCESS if the profiler was initialized successfully, otherwise an error code.
+ */
+ENGINE_API EngineResult profiler_init(const ProfilerConfig *config);
+
+/**
+ * @brief Logs the zone report and shuts down the profiler.
+ *
+ * @return void
+ */
+ENGINE_API void profiler_shutdown(void);
+
+/**
+ * @brief Checks whether hardware counters are being read on the calling thread.
+ *
+ * @return b8 True if the counters are open for this thread.
+ */
+ENGINE_API b8 profiler_has_hardware_counters(void);
+
+/**
+ * @brief Reads the calling thread's hardware counters.
+ *
+ * @param values A pointer that receives the values; validMask is 0 if counters are unavailable.
+ * @return void
+ */
+ENGINE_API void profiler_read_counters(PlatformPerfCounterValues *values);
+
+/**
+ * @brief Formats the difference between two counter snapshots, e.g.
+ * "IPC 1.92 | L1D miss 1.2M | LLC miss 40.1K | branch miss 3.0K".
+ *
+ * @param begin A pointer to the earlier snapshot.
+ * @param end A pointer to the later snapshot.
+ * @param divisor Divides each count, e.g. the number of frames or iterations (0 is treated as 1).
+ * @param buffer A pointer to the buffer that receives the text.
+ * @param bufferSize The size of the buffer in bytes.
+ * @return u32 The number of characters written, 0 if no counters are valid in both snapshots.
+ */
+ENGINE_API u32 profiler_format_counters(const PlatformPerfCounterValues *begin, const PlatformPerfCounterValues *end, u64 divisor, char *buffer, u32 bufferSize);
+
+/**
+ * @brief Begins a zone. Prefer the PROFILER_ZONE_BEGIN macro.
+ *
+ * @param zone A pointer to the zone to begin.
+ * @param name The zone name. Must outlive the profiler (use a string literal).
+ * @return void
+ */
+ENGINE_API void profiler_zone_begin(ProfilerZone *zone, const char *name);
+
+/**
+ * @brief Ends a zone and accumulates its statistics. Prefer the PROFILER_ZONE_END macro.
+ *
+ * @param zone A pointer to the zone to end.
+ * @return void
+ */
+ENGINE_API void profiler_zone_end(ProfilerZone *zone);
+
+/**
+ * @brief Adds time spent by jobs on an open zone's work, on any thread. The
+ * report shows work divided by the zone's wall time as its parallelism.
+ * Prefer the PROFILER_ZONE_ADD_WORK macro.
+ *
+ * @param zone A pointer to the open zone.
+ * @param seconds The busy seconds to add.
+ * @return void
+ */
+ENGINE_API void profiler_zone_add_work(ProfilerZone *zone, f64 seconds);
+
+/**
+ * @brief Marks the end of a frame on the main thread. Logs average frame time
+ * (and hardware counters per frame) every report interval.
+ *
+ * @return void
+ */
+ENGINE_API void profiler_frame_end(void);
+
+/**
+ * @brief Copies the accumulated zone statistics, sorted by total time.
+ *
+ * @param stats A pointer to the array that receives the statistics.
+ * @param maxStats The capacity of the array.
+ * @return u32 The number of zones written.
+ */
+ENGINE_API u32 profiler_get_zone_stats(ProfilerZoneStats *stats, u32 maxStats);
+
+/**
+ * @brief Logs a table of every zone's statistics.
+ *
+ * @return void
+ */
+ENGINE_API void profiler_report(void);
+
+/**
+ * @brief Copies the contention statistics of every named lock, sorted by total
+ * wait time. Values are read while other threads may be updating them, so a
+ * snapshot taken mid-frame can be slightly inconsistent.
+ *
+ * @param stats A pointer to the array that receives the statistics.
+ * @param maxStats The capacity of the array.
+ * @return u32 The number of locks written (always 0 without ENGINE_ENABLE_LOCK_PROFILER).
+ */
+ENGINE_API u32 profiler_get_lock_stats(ProfilerLockStats *stats, u32 maxStats);
+
+/**
+ * @brief Logs the most contended locks. Called by profiler_shutdown.
+ *
+ * @param maxLocks The maximum number of locks to list.
+ * @return void
+ */
+ENGINE_API void profiler_report_locks(u32 maxLocks);
+
+#if ENGINE_ENABLE_PROFILER
+#    define PROFILER_ZONE_BEGIN(zone, name) \
+        ProfilerZone zone;                  \
+        profiler_zone_begin(&zone, name)
+#    define PROFILER_ZONE_END(zone) profiler_zone_end(&zone)
+#    define PROFILER_ZONE_ADD_WORK(zone, seconds) profiler_zone_add_work(&zone, seconds)
+#    define PROFILER_FRAME_END() profiler_frame_end()
+#else
+#    define PROFILER_ZONE_BEGIN(zone, name)
+#    define PROFILER_ZONE_END(zone)
+#    define PROFILER_ZONE_ADD_WORK(zone, seconds)
+#    define PROFILER_FRAME_END()
+#endif
+
+#pragma endregion
+// =============================================================================
+
+#endif // ENGINE_PROFILER_H
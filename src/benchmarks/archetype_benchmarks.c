@@ -0,0 +1,233 @@
+#include "benchmarks.h"
+#include <engine/components/position.h>
+#include <engine/components/velocity.h>
+#include <engine/ecs/ecs.h>
+#include <engine/logging.h>
+#include <stdio.h>
+
+#define BENCH_ARCHETYPE_REPEATS 10
+#define BENCH_ARCHETYPE_DELTA_TIME (1.0f / 60.0f)
+
+static const u32 benchArchetypeCounts[] = {100 * 1000, 1000 * 1000};
+
+/** @brief Bench-local acceleration component. */
+typedef struct BenchAcceleration {
+    f32 ax; /**< The x-axis acceleration. */
+    f32 ay; /**< The y-axis acceleration. */
+    f32 az; /**< The z-axis acceleration. */
+} BenchAcceleration;
+
+/** @brief Bench-local drag component. */
+typedef struct BenchDrag {
+    f32 factor; /**< Velocity scale applied each step. */
+} BenchDrag;
+
+/** @brief Bench-local component given to every fourth entity so the queries span two archetypes. */
+typedef struct BenchHealth {
+    f32 value; /**< The current health. */
+} BenchHealth;
+
+/**
+ * @brief Component types of one benchmark ECS.
+ */
+typedef struct BenchArchetypeTypes {
+    ComponentType position;     /**< Position component type. */
+    ComponentType velocity;     /**< Velocity component type. */
+    ComponentType acceleration; /**< BenchAcceleration component type. */
+    ComponentType drag;         /**< BenchDrag component type. */
+    ComponentType health;       /**< BenchHealth component type. */
+} BenchArchetypeTypes;
+
+/**
+ * @brief Advances a xorshift state and returns the next value.
+ *
+ * @param state A pointer to the generator state.
+ * @return u32 The next pseudo-random value.
+ */
+static u32 bench_archetype_random(u32 *state) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Walks the packed velocities and looks each entity's position up through the sparse set.
+static void sparse_movement(ECSManager *ecs, const BenchArchetypeTypes *types, f32 dt) {
+    const Velocity *velocities = (const Velocity *)ecs_component_data(ecs, types->velocity);
+    const Entity *entities = ecs_component_entities(ecs, types->velocity);
+    u32 count = ecs_component_count(ecs, types->velocity);
+    for (u32 i = 0; i < count; ++i) {
+        Position *position = (Position *)ecs_get_component(ecs, entities[i], types->position);
+        position->x += velocities[i].vx * dt;
+        position->y += velocities[i].vy * dt;
+        position->z += velocities[i].vz * dt;
+    }
+}
+
+// Walks the packed drag components and looks the other three up per entity.
+static void sparse_integrate(ECSManager *ecs, const BenchArchetypeTypes *types, f32 dt) {
+    const BenchDrag *drags = (const BenchDrag *)ecs_component_data(ecs, types->drag);
+    const Entity *entities = ecs_component_entities(ecs, types->drag);
+    u32 count = ecs_component_count(ecs, types->drag);
+    for (u32 i = 0; i < count; ++i) {
+        Position *position = (Position *)ecs_get_component(ecs, entities[i], types->position);
+        Velocity *velocity = (Velocity *)ecs_get_component(ecs, entities[i], types->velocity);
+        const BenchAcceleration *acceleration = (const BenchAcceleration *)ecs_get_component(ecs, entities[i], types->acceleration);
+        velocity->vx = (velocity->vx + acceleration->ax * dt) * drags[i].factor;
+        velocity->vy = (velocity->vy + acceleration->ay * dt) * drags[i].factor;
+        velocity->vz = (velocity->vz + acceleration->az * dt) * drags[i].factor;
+        position->x += velocity->vx * dt;
+        position->y += velocity->vy * dt;
+        position->z += velocity->vz * dt;
+    }
+}
+
+static void archetype_movement(const EcsView *view, void *userData) {
+    f32 dt = *(const f32 *)userData;
+    Position *positions = (Position *)view->columns[0];
+    const Velocity *velocities = (const Velocity *)view->columns[1];
+    for (u32 i = 0; i < view->count; ++i) {
+        positions[i].x += velocities[i].vx * dt;
+        positions[i].y += velocities[i].vy * dt;
+        positions[i].z += velocities[i].vz * dt;
+    }
+}
+
+static void archetype_integrate(const EcsView *view, void *userData) {
+    f32 dt = *(const f32 *)userData;
+    Position *positions = (Position *)view->columns[0];
+    Velocity *velocities = (Velocity *)view->columns[1];
+    const BenchAcceleration *accelerations = (const BenchAcceleration *)view->columns[2];
+    const BenchDrag *drags = (const BenchDrag *)view->columns[3];
+    for (u32 i = 0; i < view->count; ++i) {
+        velocities[i].vx = (velocities[i].vx + accelerations[i].ax * dt) * drags[i].factor;
+        velocities[i].vy = (velocities[i].vy + accelerations[i].ay * dt) * drags[i].factor;
+        velocities[i].vz = (velocities[i].vz + accelerations[i].az * dt) * drags[i].factor;
+        positions[i].x += velocities[i].vx * dt;
+        positions[i].y += velocities[i].vy * dt;
+        positions[i].z += velocities[i].vz * dt;
+    }
+}
+
+/**
+ * @brief Times the 2- and 4-component queries.
+ *
+ * @param ecs A pointer to the ECS to update.
+ * @param types A pointer to the component types.
+ * @param movement Receives seconds per pass of the 2-component query.
+ * @param integrate Receives seconds per pass of the 4-component query.
+ * @return void
+ */
+static void bench_archetype_queries(ECSManager *ecs, const BenchArchetypeTypes *types, f64 *movement, f64 *integrate) {
+    f32 dt = BENCH_ARCHETYPE_DELTA_TIME;
+    ComponentType query[] = {types->position, types->velocity, types->acceleration, types->drag};
+
+    f64 start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_ARCHETYPE_REPEATS; ++repeat) {
+        if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+            ecs_each(ecs, query, 2, archetype_movement, &dt);
+        } else {
+            sparse_movement(ecs, types, dt);
+        }
+    }
+    *movement = (bench_now() - start) / BENCH_ARCHETYPE_REPEATS;
+
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_ARCHETYPE_REPEATS; ++repeat) {
+        if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+            ecs_each(ecs, query, 4, archetype_integrate, &dt);
+        } else {
+            sparse_integrate(ecs, types, dt);
+        }
+    }
+    *integrate = (bench_now() - start) / BENCH_ARCHETYPE_REPEATS;
+}
+
+/**
+ * @brief Builds an ECS with one storage layout, times both queries fresh and
+ * after churn, and prints one row.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param storage The storage layout to benchmark.
+ * @param entityCount The number of entities to create.
+ * @return void
+ */
+static void bench_archetype_storage(MemoryPool *pool, ECSStorage storage, u32 entityCount) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS for %u entities.", entityCount);
+        return;
+    }
+
+    BenchArchetypeTypes types;
+    types.position = ecs_register_component(&ecs, sizeof(Position));
+    types.velocity = ecs_register_component(&ecs, sizeof(Velocity));
+    types.acceleration = ecs_register_component(&ecs, sizeof(BenchAcceleration));
+    types.drag = ecs_register_component(&ecs, sizeof(BenchDrag));
+    types.health = ecs_register_component(&ecs, sizeof(BenchHealth));
+    if (types.health == INVALID_COMPONENT_TYPE) {
+        log_error("Failed to register the benchmark components.");
+        ecs_shutdown(&ecs);
+        return;
+    }
+
+    for (u32 i = 0; i < entityCount; ++i) {
+        Entity entity = ecs_create_entity(&ecs);
+        Position position = {(f32)i, 0.0f, 0.0f};
+        Velocity velocity = {1.0f, 0.0f, (f32)(i % 5)};
+        BenchAcceleration acceleration = {0.0f, -9.81f, 0.0f};
+        BenchDrag drag = {0.99f};
+        if (entity == INVALID_ENTITY || !ecs_add_component(&ecs, entity, types.position, &position) || !ecs_add_component(&ecs, entity, types.velocity, &velocity) ||
+            !ecs_add_component(&ecs, entity, types.acceleration, &acceleration) || !ecs_add_component(&ecs, entity, types.drag, &drag) ||
+            (i % 4 == 0 && !ecs_add_component(&ecs, entity, types.health, NULL))) {
+            log_error("Failed to create entity %u of %u; skipping this row.", i, entityCount);
+            ecs_shutdown(&ecs);
+            return;
+        }
+    }
+
+    f64 movement, integrate;
+    bench_archetype_queries(&ecs, &types, &movement, &integrate);
+
+    // Re-add every Position in random order. Sparse sets lose their shared
+    // order; archetype rows are reshuffled but stay packed.
+    u32 seed = 0x1234567u;
+    for (u32 i = 0; i < entityCount; ++i) {
+        Entity entity = ecs_entity_make(bench_archetype_random(&seed) % entityCount, 0);
+        const Position *current = (const Position *)ecs_get_component(&ecs, entity, types.position);
+        if (!current) {
+            log_error("Entity %u has no Position to re-add; skipping this row.", ecs_entity_index(entity));
+            ecs_shutdown(&ecs);
+            return;
+        }
+        Position position = *current;
+        ecs_remove_component(&ecs, entity, types.position);
+        if (!ecs_add_component(&ecs, entity, types.position, &position)) {
+            log_error("Failed to re-add Position %u of %u; skipping this row.", i, entityCount);
+            ecs_shutdown(&ecs);
+            return;
+        }
+    }
+
+    f64 churnedMovement, churnedIntegrate;
+    bench_archetype_queries(&ecs, &types, &churnedMovement, &churnedIntegrate);
+
+    f64 scale = 1e9 / entityCount;
+    printf("%9u %-11s %14.2f %14.2f %14.2f %14.2f\n", entityCount, storage == ECS_STORAGE_ARCHETYPE ? "archetype" : "sparse set", movement * scale, integrate * scale, churnedMovement * scale, churnedIntegrate * scale);
+
+    ecs_shutdown(&ecs);
+}
+
+void bench_archetypes(MemoryPool *pool) {
+    printf("Position+Velocity (2) and Position+Velocity+Acceleration+Drag (4) queries, ns per entity\n");
+    printf("%9s %-11s %14s %14s %14s %14s\n", "entities", "storage", "2 fresh", "4 fresh", "2 churned", "4 churned");
+
+    for (u32 i = 0; i < ENGINE_ARRAY_COUNT(benchArchetypeCounts); ++i) {
+        bench_archetype_storage(pool, ECS_STORAGE_SPARSE_SET, benchArchetypeCounts[i]);
+        bench_archetype_storage(pool, ECS_STORAGE_ARCHETYPE, benchArchetypeCounts[i]);
+    }
+}
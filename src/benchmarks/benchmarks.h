@@ -0,0 +1,142 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <engine/defines.h>
+#include <engine/memory.h>
+#include <engine/platform.h>
+
+// Each benchmark suite lives in its own source file and is registered in
+// main.c. Suites receive a memory pool owned by the runner.
+
+/**
+ * @brief Gets a high resolution timestamp in seconds.
+ *
+ * @return f64 The current time in seconds.
+ */
+f64 bench_now(void);
+
+/**
+ * @brief Prints the hardware counters accumulated on the calling thread since
+ * begin. Prints nothing if counters are unavailable.
+ *
+ * @param begin A pointer to the snapshot taken before the measured work.
+ * @param iterations Divides each count to report per-iteration values (1 for totals).
+ */
+void bench_print_counters(const PlatformPerfCounterValues *begin, u64 iterations);
+
+/**
+ * @brief Benchmarks job system throughput while scaling from 1 to N workers.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_job_system(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks parallel_for and parallel_reduce integrating one million bodies.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_parallel(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks deep job dependency graphs with fiber waits against nested waits.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_fibers(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks uncontended and contended costs of the platform locks.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_locks(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks ECS iteration over packed sparse sets against the
+ * reference pointer-per-component layout.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_ecs(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks 2- and 4-component ECS queries over archetype chunks
+ * against sparse-set joins.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_archetypes(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks cached ECS queries against per-entity component lookups.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_queries(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks the ECS system scheduler against running the same systems
+ * serially, reporting achieved parallelism while scaling from 1 to N workers.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_systems(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks owning-group iteration against unsorted sparse-set
+ * co-iteration, fresh and after churn.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_groups(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks transform propagation through deep and wide entity
+ * hierarchies against a linked walk, and full updates from 1 to N workers.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_hierarchy(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks spawning a multi-entity prefab from templates against
+ * creating the same entities one component at a time.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_prefabs(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks matching archetype and entity signatures against queries
+ * with one vector compare, against per-term lookups.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_signatures(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks memory, build time and query passes of a marker-heavy
+ * scene with markers as one-byte components and as tags.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_tags(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks keeping a sprite array sorted by key through frames of
+ * small and large key changes, incrementally and by full re-sorts.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_sorting(MemoryPool *pool);
+
+/**
+ * @brief Benchmarks snapshotting a world of entities, restoring it into the
+ * same ECS after a frame of changes and loading it into a fresh ECS.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ */
+void bench_snapshots(MemoryPool *pool);
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,456 @@
+#include "benchmarks.h"
+#include <engine/components/position.h>
+#include <engine/components/velocity.h>
+#include <engine/ecs/ecs.h>
+#include <engine/logging.h>
+#include <engine/platform.h>
+#include <stdio.h>
+
+#define BENCH_ECS_ENTITY_COUNT (1024 * 1024)
+#define BENCH_ECS_REPEATS 10
+#define BENCH_ECS_DELTA_TIME (1.0f / 60.0f)
+
+// Entities per spawn wave, as in a burst of particles or bullets.
+#define BENCH_ECS_WAVE_SIZE 10000
+#define BENCH_ECS_WAVE_COUNT 100
+
+/**
+ * @brief The reference ECS layout: one heap block per component, reached
+ * through a pointer per entity.
+ */
+typedef struct BenchPointerStore {
+    Position **positions;  /**< Position block of each entity. */
+    Velocity **velocities; /**< Velocity block of each entity. */
+} BenchPointerStore;
+
+/**
+ * @brief Advances a xorshift state and returns the next value.
+ *
+ * @param state A pointer to the generator state.
+ * @return u32 The next pseudo-random value.
+ */
+static u32 bench_random(u32 *state) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Shuffles the entity order of a pointer store, as create/destroy
+ * churn does to the reference layout's dense arrays over time.
+ *
+ * @param store A pointer to the store to shuffle.
+ * @return void
+ */
+static void bench_shuffle_pointers(BenchPointerStore *store) {
+    u32 seed = 0x1234567u;
+    for (u32 i = BENCH_ECS_ENTITY_COUNT - 1; i > 0; --i) {
+        u32 j = bench_random(&seed) % (i + 1);
+        Position *position = store->positions[i];
+        store->positions[i] = store->positions[j];
+        store->positions[j] = position;
+        Velocity *velocity = store->velocities[i];
+        store->velocities[i] = store->velocities[j];
+        store->velocities[j] = velocity;
+    }
+}
+
+static void pointer_gravity(BenchPointerStore *store, f32 dt) {
+    for (u32 i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        store->velocities[i]->vy -= 9.81f * dt;
+    }
+}
+
+static void pointer_movement(BenchPointerStore *store, f32 dt) {
+    for (u32 i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        Position *position = store->positions[i];
+        const Velocity *velocity = store->velocities[i];
+        position->x += velocity->vx * dt;
+        position->y += velocity->vy * dt;
+        position->z += velocity->vz * dt;
+    }
+}
+
+static void packed_gravity(ECSManager *ecs, ComponentType velocityType, f32 dt) {
+    Velocity *velocities = (Velocity *)ecs_component_data(ecs, velocityType);
+    u32 count = ecs_component_count(ecs, velocityType);
+    for (u32 i = 0; i < count; ++i) {
+        velocities[i].vy -= 9.81f * dt;
+    }
+}
+
+// Walks the packed velocities and looks each entity's position up through the sparse set.
+static void packed_movement(ECSManager *ecs, ComponentType positionType, ComponentType velocityType, f32 dt) {
+    const Velocity *velocities = (const Velocity *)ecs_component_data(ecs, velocityType);
+    const Entity *entities = ecs_component_entities(ecs, velocityType);
+    u32 count = ecs_component_count(ecs, velocityType);
+    for (u32 i = 0; i < count; ++i) {
+        Position *position = (Position *)ecs_get_component(ecs, entities[i], positionType);
+        position->x += velocities[i].vx * dt;
+        position->y += velocities[i].vy * dt;
+        position->z += velocities[i].vz * dt;
+    }
+}
+
+/**
+ * @brief Prints one benchmark row in nanoseconds per entity.
+ *
+ * @param label The row label.
+ * @param gravity Seconds per pass of the single-component scan.
+ * @param movement Seconds per pass of the two-component join.
+ * @return void
+ */
+static void bench_ecs_row(const char *label, f64 gravity, f64 movement) {
+    printf("%-34s %18.2f %22.2f\n", label, gravity * 1e9 / BENCH_ECS_ENTITY_COUNT, movement * 1e9 / BENCH_ECS_ENTITY_COUNT);
+}
+
+/**
+ * @brief Times both passes over the reference pointer layout.
+ *
+ * @param label The row label.
+ * @param store A pointer to the store to update.
+ * @return void
+ */
+static void bench_pointer_store(const char *label, BenchPointerStore *store) {
+    f64 start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_ECS_REPEATS; ++repeat) {
+        pointer_gravity(store, BENCH_ECS_DELTA_TIME);
+    }
+    f64 gravity = (bench_now() - start) / BENCH_ECS_REPEATS;
+
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_ECS_REPEATS; ++repeat) {
+        pointer_movement(store, BENCH_ECS_DELTA_TIME);
+    }
+    f64 movement = (bench_now() - start) / BENCH_ECS_REPEATS;
+
+    bench_ecs_row(label, gravity, movement);
+}
+
+/**
+ * @brief Times both passes over the packed sparse sets.
+ *
+ * @param label The row label.
+ * @param ecs A pointer to the ECS to update.
+ * @param positionType The Position component type.
+ * @param velocityType The Velocity component type.
+ * @return void
+ */
+static void bench_packed_store(const char *label, ECSManager *ecs, ComponentType positionType, ComponentType velocityType) {
+    f64 start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_ECS_REPEATS; ++repeat) {
+        packed_gravity(ecs, velocityType, BENCH_ECS_DELTA_TIME);
+    }
+    f64 gravity = (bench_now() - start) / BENCH_ECS_REPEATS;
+
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_ECS_REPEATS; ++repeat) {
+        packed_movement(ecs, positionType, velocityType, BENCH_ECS_DELTA_TIME);
+    }
+    f64 movement = (bench_now() - start) / BENCH_ECS_REPEATS;
+
+    bench_ecs_row(label, gravity, movement);
+}
+
+/**
+ * @brief Prints the init time of an ECS with eight registered component types
+ * and its memory use as entities with Position and Velocity are added.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @return void
+ */
+static void bench_ecs_footprint(MemoryPool *pool) {
+    static const u32 counts[] = {0, 1000, 100 * 1000, BENCH_ECS_ENTITY_COUNT};
+
+    printf("%-34s %18s %22s\n", "footprint", "init+register us", "ECS memory KB");
+    for (u32 i = 0; i < ENGINE_ARRAY_COUNT(counts); ++i) {
+        ECSManager ecs;
+        ECSConfig config = {0};
+        f64 start = bench_now();
+        if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+            log_error("Failed to initialize the ECS.");
+            return;
+        }
+        ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+        ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+        for (u32 type = 2; type < 8; ++type) {
+            ecs_register_component(&ecs, 16);
+        }
+        f64 init = bench_now() - start;
+
+        for (u32 n = 0; n < counts[i]; ++n) {
+            Entity entity = ecs_create_entity(&ecs);
+            ecs_add_component(&ecs, entity, positionType, NULL);
+            ecs_add_component(&ecs, entity, velocityType, NULL);
+        }
+
+        char label[64];
+        snprintf(label, sizeof(label), "%u entities", counts[i]);
+        printf("%-34s %18.2f %22.1f\n", label, init * 1e6, ecs_memory_usage(&ecs) / 1024.0);
+        ecs_shutdown(&ecs);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Times creating, destroying and recycling entities, then checks
+ * liveness of live and stale handles, and prints one row.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param label The row label.
+ * @param storage The storage layout to use.
+ * @param withComponents Whether each entity gets Position and Velocity.
+ * @param live Scratch array of BENCH_ECS_ENTITY_COUNT handles.
+ * @param stale Scratch array of BENCH_ECS_ENTITY_COUNT handles.
+ * @return void
+ */
+static void bench_ecs_churn_row(MemoryPool *pool, const char *label, ECSStorage storage, b8 withComponents, Entity *live, Entity *stale) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS.");
+        return;
+    }
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+    Position position = {0.0f, 0.0f, 0.0f};
+    Velocity velocity = {1.0f, 0.0f, 0.0f};
+
+    f64 start = bench_now();
+    for (u32 i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        live[i] = ecs_create_entity(&ecs);
+        if (withComponents) {
+            ecs_add_component(&ecs, live[i], positionType, &position);
+            ecs_add_component(&ecs, live[i], velocityType, &velocity);
+        }
+    }
+    f64 create = bench_now() - start;
+
+    // Destroy a random slot and refill it, so freed indices are reused with
+    // new generations while the population stays constant.
+    u32 seed = 0x1234567u;
+    start = bench_now();
+    for (u32 i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        u32 slot = bench_random(&seed) % BENCH_ECS_ENTITY_COUNT;
+        stale[i] = live[slot];
+        ecs_destroy_entity(&ecs, live[slot]);
+        live[slot] = ecs_create_entity(&ecs);
+        if (withComponents) {
+            ecs_add_component(&ecs, live[slot], positionType, &position);
+            ecs_add_component(&ecs, live[slot], velocityType, &velocity);
+        }
+    }
+    f64 churn = bench_now() - start;
+
+    u32 alive = 0;
+    start = bench_now();
+    for (u32 i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        alive += ecs_entity_alive(&ecs, live[i]);
+        alive += ecs_entity_alive(&ecs, stale[i]);
+    }
+    f64 check = bench_now() - start;
+
+    start = bench_now();
+    for (u32 i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        ecs_destroy_entity(&ecs, live[i]);
+    }
+    f64 destroy = bench_now() - start;
+
+    f64 millions = BENCH_ECS_ENTITY_COUNT / 1e6;
+    printf("%-34s %10.1f %10.1f %14.1f %12.1f\n", label, millions / create, millions / destroy, millions / churn, 2.0 * millions / check);
+    if (alive != BENCH_ECS_ENTITY_COUNT) {
+        log_error("%u handles alive after churn, expected %u.", alive, BENCH_ECS_ENTITY_COUNT);
+    }
+
+    ecs_shutdown(&ecs);
+}
+
+/**
+ * @brief Prints entity create/destroy throughput with generational handles.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @return void
+ */
+static void bench_ecs_churn(MemoryPool *pool) {
+    Entity *live = (Entity *)memory_allocate(pool, sizeof(Entity) * BENCH_ECS_ENTITY_COUNT, MEMORY_TAG_ENGINE);
+    Entity *stale = (Entity *)memory_allocate(pool, sizeof(Entity) * BENCH_ECS_ENTITY_COUNT, MEMORY_TAG_ENGINE);
+    if (!live || !stale) {
+        log_error("Failed to allocate handle arrays for %u entities.", BENCH_ECS_ENTITY_COUNT);
+        return;
+    }
+
+    printf("%u entities, millions per second\n", BENCH_ECS_ENTITY_COUNT);
+    printf("%-34s %10s %10s %14s %12s\n", "entity churn", "create", "destroy", "destroy+create", "alive check");
+    bench_ecs_churn_row(pool, "no components", ECS_STORAGE_SPARSE_SET, false, live, stale);
+    bench_ecs_churn_row(pool, "Position+Velocity (sparse set)", ECS_STORAGE_SPARSE_SET, true, live, stale);
+    bench_ecs_churn_row(pool, "Position+Velocity (archetype)", ECS_STORAGE_ARCHETYPE, true, live, stale);
+    printf("\n");
+
+    memory_free(pool, live, MEMORY_TAG_ENGINE);
+    memory_free(pool, stale, MEMORY_TAG_ENGINE);
+}
+
+/**
+ * @brief Spawns and then despawns BENCH_ECS_WAVE_COUNT waves of particles
+ * with Position and Velocity, per entity or in batches, and prints one row.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param label The row label.
+ * @param storage The storage layout to use.
+ * @param batched Whether to use ecs_create_batch and ecs_destroy_batch.
+ * @param entities Scratch array of BENCH_ECS_WAVE_SIZE * BENCH_ECS_WAVE_COUNT handles.
+ * @param positions BENCH_ECS_WAVE_SIZE initial positions.
+ * @param velocities BENCH_ECS_WAVE_SIZE initial velocities.
+ * @return void
+ */
+static void bench_ecs_spawn_row(MemoryPool *pool, const char *label, ECSStorage storage, b8 batched, Entity *entities, const Position *positions, const Velocity *velocities) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS.");
+        return;
+    }
+    ComponentType types[] = {ecs_register_component(&ecs, sizeof(Position)), ecs_register_component(&ecs, sizeof(Velocity))};
+    const void *initData[] = {positions, velocities};
+
+    f64 start = bench_now();
+    for (u32 wave = 0; wave < BENCH_ECS_WAVE_COUNT; ++wave) {
+        Entity *spawned = entities + (u64)wave * BENCH_ECS_WAVE_SIZE;
+        if (batched) {
+            ecs_create_batch(&ecs, BENCH_ECS_WAVE_SIZE, types, 2, initData, spawned);
+            continue;
+        }
+        for (u32 i = 0; i < BENCH_ECS_WAVE_SIZE; ++i) {
+            spawned[i] = ecs_create_entity(&ecs);
+            ecs_add_component(&ecs, spawned[i], types[0], &positions[i]);
+            ecs_add_component(&ecs, spawned[i], types[1], &velocities[i]);
+        }
+    }
+    f64 spawn = bench_now() - start;
+
+    start = bench_now();
+    for (u32 wave = 0; wave < BENCH_ECS_WAVE_COUNT; ++wave) {
+        Entity *despawned = entities + (u64)wave * BENCH_ECS_WAVE_SIZE;
+        if (batched) {
+            ecs_destroy_batch(&ecs, despawned, BENCH_ECS_WAVE_SIZE);
+            continue;
+        }
+        for (u32 i = 0; i < BENCH_ECS_WAVE_SIZE; ++i) {
+            ecs_destroy_entity(&ecs, despawned[i]);
+        }
+    }
+    f64 despawn = bench_now() - start;
+
+    f64 millions = (f64)BENCH_ECS_WAVE_SIZE * BENCH_ECS_WAVE_COUNT / 1e6;
+    printf("%-34s %10.1f %10.1f\n", label, millions / spawn, millions / despawn);
+    ecs_shutdown(&ecs);
+}
+
+/**
+ * @brief Prints spawn and despawn rates of per-entity calls against batches.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @return void
+ */
+static void bench_ecs_spawn(MemoryPool *pool) {
+    Entity *entities = (Entity *)memory_allocate(pool, sizeof(Entity) * BENCH_ECS_WAVE_SIZE * BENCH_ECS_WAVE_COUNT, MEMORY_TAG_ENGINE);
+    Position *positions = (Position *)memory_allocate(pool, sizeof(Position) * BENCH_ECS_WAVE_SIZE, MEMORY_TAG_ENGINE);
+    Velocity *velocities = (Velocity *)memory_allocate(pool, sizeof(Velocity) * BENCH_ECS_WAVE_SIZE, MEMORY_TAG_ENGINE);
+    if (!entities || !positions || !velocities) {
+        log_error("Failed to allocate spawn data for %u entities.", BENCH_ECS_WAVE_SIZE * BENCH_ECS_WAVE_COUNT);
+        return;
+    }
+    for (u32 i = 0; i < BENCH_ECS_WAVE_SIZE; ++i) {
+        positions[i] = (Position){(f32)i, 0.0f, 0.0f};
+        velocities[i] = (Velocity){1.0f, 0.0f, (f32)(i % 5)};
+    }
+
+    printf("%u waves of %u entities with Position and Velocity, millions per second\n", BENCH_ECS_WAVE_COUNT, BENCH_ECS_WAVE_SIZE);
+    printf("%-34s %10s %10s\n", "spawn", "spawn", "despawn");
+    bench_ecs_spawn_row(pool, "per entity (sparse set)", ECS_STORAGE_SPARSE_SET, false, entities, positions, velocities);
+    bench_ecs_spawn_row(pool, "batched (sparse set)", ECS_STORAGE_SPARSE_SET, true, entities, positions, velocities);
+    bench_ecs_spawn_row(pool, "per entity (archetype)", ECS_STORAGE_ARCHETYPE, false, entities, positions, velocities);
+    bench_ecs_spawn_row(pool, "batched (archetype)", ECS_STORAGE_ARCHETYPE, true, entities, positions, velocities);
+    printf("\n");
+
+    memory_free(pool, entities, MEMORY_TAG_ENGINE);
+    memory_free(pool, positions, MEMORY_TAG_ENGINE);
+    memory_free(pool, velocities, MEMORY_TAG_ENGINE);
+}
+
+void bench_ecs(MemoryPool *pool) {
+    bench_ecs_footprint(pool);
+    bench_ecs_churn(pool);
+    bench_ecs_spawn(pool);
+
+    printf("%u entities with Position and Velocity, ns per entity\n", BENCH_ECS_ENTITY_COUNT);
+    printf("%-34s %18s %22s\n", "layout", "Velocity scan", "Position+Velocity");
+
+    // Reference layout. Each component is its own heap block, as
+    // ecs_add_component did with memory_allocate in the reference ECS. The
+    // platform allocator is used because the pool tracks too few allocations.
+    BenchPointerStore store = {0};
+    store.positions = (Position **)memory_allocate(pool, sizeof(Position *) * BENCH_ECS_ENTITY_COUNT, MEMORY_TAG_ENGINE);
+    store.velocities = (Velocity **)memory_allocate(pool, sizeof(Velocity *) * BENCH_ECS_ENTITY_COUNT, MEMORY_TAG_ENGINE);
+    if (!store.positions || !store.velocities) {
+        log_error("Failed to allocate the pointer store for %u entities.", BENCH_ECS_ENTITY_COUNT);
+        return;
+    }
+
+    for (u32 i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        store.positions[i] = (Position *)platform_memory_allocate(sizeof(Position));
+        store.velocities[i] = (Velocity *)platform_memory_allocate(sizeof(Velocity));
+        *store.positions[i] = (Position){(f32)i, 0.0f, 0.0f};
+        *store.velocities[i] = (Velocity){1.0f, 0.0f, (f32)(i % 5)};
+    }
+
+    bench_pointer_store("pointer per entity (fresh)", &store);
+    bench_shuffle_pointers(&store);
+    bench_pointer_store("pointer per entity (after churn)", &store);
+
+    for (u32 i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        platform_memory_free(store.positions[i]);
+        platform_memory_free(store.velocities[i]);
+    }
+    memory_free(pool, store.positions, MEMORY_TAG_ENGINE);
+    memory_free(pool, store.velocities, MEMORY_TAG_ENGINE);
+
+    // Packed sparse sets.
+    ECSManager ecs;
+    ECSConfig config = {0};
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS for %u entities.", BENCH_ECS_ENTITY_COUNT);
+        return;
+    }
+
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+    for (u32 i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        Entity entity = ecs_create_entity(&ecs);
+        Position position = {(f32)i, 0.0f, 0.0f};
+        Velocity velocity = {1.0f, 0.0f, (f32)(i % 5)};
+        ecs_add_component(&ecs, entity, positionType, &position);
+        ecs_add_component(&ecs, entity, velocityType, &velocity);
+    }
+
+    bench_packed_store("packed sparse set (fresh)", &ecs, positionType, velocityType);
+
+    // Re-add every Position in random order so the two packed arrays no
+    // longer share an order and the join jumps around the Position array.
+    u32 seed = 0x1234567u;
+    for (u32 i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        Entity entity = ecs_entity_make(bench_random(&seed) % BENCH_ECS_ENTITY_COUNT, 0);
+        Position position = *(Position *)ecs_get_component(&ecs, entity, positionType);
+        ecs_remove_component(&ecs, entity, positionType);
+        ecs_add_component(&ecs, entity, positionType, &position);
+    }
+
+    bench_packed_store("packed sparse set (after churn)", &ecs, positionType, velocityType);
+
+    ecs_shutdown(&ecs);
+}
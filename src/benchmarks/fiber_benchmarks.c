@@ -0,0 +1,111 @@
+#include "benchmarks.h"
+#include <engine/job_system.h>
+#include <engine/logging.h>
+#include <engine/platform.h>
+#include <stdio.h>
+
+#define BENCH_TREE_FANOUT 4
+#define BENCH_TREE_DEPTH 7
+#define BENCH_CHAIN_DEPTH 512
+#define BENCH_GRAPH_RUNS 5
+#define BENCH_LEAF_WORK 2000
+#define BENCH_FIBER_COUNT 1024
+
+typedef struct BenchNode {
+    u32 depth; /**< Remaining levels below this node. */
+    u32 fanout; /**< Children spawned per node. */
+} BenchNode;
+
+static volatile u32 benchSink;
+
+static void leaf_work(void) {
+    u32 value = 1;
+    for (u32 i = 0; i < BENCH_LEAF_WORK; ++i) {
+        value = value * 1664525u + 1013904223u;
+    }
+    benchSink = value;
+}
+
+// Spawns its children and waits on them, so every level of the graph has a
+// job blocked in job_wait while the level below runs.
+static void node_job(void *userData) {
+    const BenchNode *node = (const BenchNode *)userData;
+    leaf_work();
+
+    if (node->depth == 0) {
+        return;
+    }
+
+    BenchNode child = {node->depth - 1, node->fanout};
+    JobDecl children[BENCH_TREE_FANOUT];
+    for (u32 i = 0; i < node->fanout; ++i) {
+        children[i] = (JobDecl){node_job, &child};
+    }
+
+    JobCounter counter = {0};
+    job_run(children, node->fanout, &counter);
+    job_wait(&counter);
+}
+
+static u32 graph_job_count(const BenchNode *root) {
+    u32 count = 0;
+    u32 level = 1;
+    for (u32 depth = 0; depth <= root->depth; ++depth) {
+        count += level;
+        level *= root->fanout;
+    }
+    return count;
+}
+
+static f64 run_graph(const BenchNode *root) {
+    f64 best = 1e30;
+    for (u32 run = 0; run < BENCH_GRAPH_RUNS; ++run) {
+        JobDecl job = {node_job, (void *)root};
+        JobCounter counter = {0};
+
+        f64 start = bench_now();
+        job_run(&job, 1, &counter);
+        job_wait(&counter);
+        f64 elapsed = bench_now() - start;
+
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+void bench_fibers(MemoryPool *pool) {
+    if (!platform_fiber_supported()) {
+        printf("fibers are not supported on this platform; skipping\n");
+        return;
+    }
+
+    const BenchNode tree = {BENCH_TREE_DEPTH, BENCH_TREE_FANOUT};
+    const BenchNode chain = {BENCH_CHAIN_DEPTH, 1};
+    u32 treeJobs = graph_job_count(&tree);
+    u32 chainJobs = graph_job_count(&chain);
+
+    printf("%-8s %-8s %18s %14s %18s %14s\n", "workers", "waits", "tree total (ms)", "tree (us/job)", "chain total (ms)", "chain (us/job)");
+    u32 maxWorkers = platform_get_processor_count();
+    for (u32 workers = 1; workers <= maxWorkers; workers *= 2) {
+        for (u32 mode = 0; mode < 2; ++mode) {
+            JobSystemConfig config = {0};
+            config.workerCount = workers;
+            config.useFibers = mode == 1;
+            config.fiberCount = BENCH_FIBER_COUNT;
+            if (job_system_init(pool, &config) != ENGINE_SUCCESS) {
+                log_error("Failed to initialize job system with %u workers.", workers);
+                return;
+            }
+
+            f64 treeTime = run_graph(&tree);
+            f64 chainTime = run_graph(&chain);
+            printf("%-8u %-8s %18.3f %14.3f %18.3f %14.3f\n", workers, mode ? "fiber" : "nested",
+                   treeTime * 1000.0, treeTime * 1e6 / treeJobs,
+                   chainTime * 1000.0, chainTime * 1e6 / chainJobs);
+
+            job_system_shutdown();
+        }
+    }
+}
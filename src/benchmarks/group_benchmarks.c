@@ -0,0 +1,153 @@
+#include "benchmarks.h"
+#include <engine/components/position.h>
+#include <engine/components/velocity.h>
+#include <engine/ecs/ecs.h>
+#include <engine/logging.h>
+#include <stdio.h>
+
+#define BENCH_GROUP_ENTITY_COUNT (1000 * 1000)
+#define BENCH_GROUP_REPEATS 10
+#define BENCH_GROUP_DELTA_TIME (1.0f / 60.0f)
+
+/** @brief Bench-local component on every entity, so Position's set is not the smallest. */
+typedef struct BenchGroupHealth {
+    f32 value; /**< The current health. */
+} BenchGroupHealth;
+
+/**
+ * @brief Advances a xorshift state and returns the next value.
+ *
+ * @param state A pointer to the generator state.
+ * @return u32 The next pseudo-random value.
+ */
+static u32 bench_group_random(u32 *state) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Packed views (a group) are lockstep linear scans; cached sparse-set views
+// go through each term's row indices.
+static void group_movement(const EcsView *view, void *userData) {
+    f32 dt = *(const f32 *)userData;
+    Position *positions = (Position *)view->columns[0];
+    const Velocity *velocities = (const Velocity *)view->columns[1];
+    if (!view->rows[0]) {
+        for (u32 i = 0; i < view->count; ++i) {
+            positions[i].x += velocities[i].vx * dt;
+            positions[i].y += velocities[i].vy * dt;
+            positions[i].z += velocities[i].vz * dt;
+        }
+        return;
+    }
+
+    const u32 *positionRows = view->rows[0];
+    const u32 *velocityRows = view->rows[1];
+    for (u32 i = 0; i < view->count; ++i) {
+        Position *position = &positions[positionRows[i]];
+        const Velocity *velocity = &velocities[velocityRows[i]];
+        position->x += velocity->vx * dt;
+        position->y += velocity->vy * dt;
+        position->z += velocity->vz * dt;
+    }
+}
+
+/**
+ * @brief Times BENCH_GROUP_REPEATS passes of the movement query.
+ *
+ * @param query A pointer to the Position+Velocity query.
+ * @return f64 Seconds per pass.
+ */
+static f64 bench_group_passes(EcsQuery *query) {
+    f32 dt = BENCH_GROUP_DELTA_TIME;
+    f64 start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_GROUP_REPEATS; ++repeat) {
+        ecs_query_each(query, group_movement, &dt);
+    }
+    return (bench_now() - start) / BENCH_GROUP_REPEATS;
+}
+
+/**
+ * @brief Builds a sparse-set ECS with or without a Position+Velocity group,
+ * times the movement query fresh, the cost of re-adding every Velocity in
+ * random order, and the query again after that churn, and prints one row.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param grouped Whether Position and Velocity are owned by a group.
+ * @return void
+ */
+static void bench_group_row(MemoryPool *pool, b8 grouped) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = ECS_STORAGE_SPARSE_SET;
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS.");
+        return;
+    }
+
+    ComponentType health = ecs_register_component(&ecs, sizeof(BenchGroupHealth));
+    ComponentType position = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocity = ecs_register_component(&ecs, sizeof(Velocity));
+    ComponentType types[] = {position, velocity};
+    if (grouped && ecs_group_create(&ecs, types, 2) == INVALID_ID_U32) {
+        log_error("Failed to create the Position+Velocity group.");
+        ecs_shutdown(&ecs);
+        return;
+    }
+
+    // Every entity has Health and Position; three in four move.
+    for (u32 i = 0; i < BENCH_GROUP_ENTITY_COUNT; ++i) {
+        Entity entity = ecs_create_entity(&ecs);
+        ecs_add_component(&ecs, entity, health, NULL);
+        ecs_add_component(&ecs, entity, position, &(Position){(f32)i, 0.0f, 0.0f});
+        if (i % 4 != 0) {
+            ecs_add_component(&ecs, entity, velocity, &(Velocity){1.0f, 0.0f, (f32)(i % 5)});
+        }
+    }
+
+    EcsQuery query;
+    if (ecs_query_init(&query, &ecs, &(EcsQueryDesc){.required = types, .requiredCount = 2}) != ENGINE_SUCCESS) {
+        log_error("Failed to create the movement query.");
+        ecs_shutdown(&ecs);
+        return;
+    }
+    u32 matched = ecs_query_count(&query);
+    f64 fresh = bench_group_passes(&query);
+
+    // Re-add every Velocity in random order. Without a group the sparse sets
+    // lose their shared order; a group swaps each entity back into step.
+    u32 seed = 0x1234567u;
+    f64 start = bench_now();
+    for (u32 i = 0; i < BENCH_GROUP_ENTITY_COUNT; ++i) {
+        Entity entity = ecs_entity_make(bench_group_random(&seed) % BENCH_GROUP_ENTITY_COUNT, 0);
+        Velocity *moved = (Velocity *)ecs_get_component(&ecs, entity, velocity);
+        if (moved) {
+            Velocity copy = *moved;
+            ecs_remove_component(&ecs, entity, velocity);
+            ecs_add_component(&ecs, entity, velocity, &copy);
+        }
+    }
+    f64 churn = bench_now() - start;
+
+    // The first pass after churn pays for any cache rebuild.
+    f32 dt = BENCH_GROUP_DELTA_TIME;
+    start = bench_now();
+    ecs_query_each(&query, group_movement, &dt);
+    f64 rebuild = bench_now() - start;
+    f64 churned = bench_group_passes(&query);
+
+    printf("%-30s %10u %10.3f %10.3f %10.3f %10.1f\n", grouped ? "owning group" : "cached sparse-set query", matched, fresh * 1e3, churned * 1e3, rebuild * 1e3, churn * 1e3);
+
+    ecs_query_destroy(&query);
+    ecs_shutdown(&ecs);
+}
+
+void bench_groups(MemoryPool *pool) {
+    printf("%u entities, Position+Velocity on 3 in 4, ms per pass (churn: ms to re-add every Velocity)\n", BENCH_GROUP_ENTITY_COUNT);
+    printf("%-30s %10s %10s %10s %10s %10s\n", "layout", "matched", "fresh", "churned", "rebuild", "churn");
+    bench_group_row(pool, false);
+    bench_group_row(pool, true);
+}
@@ -0,0 +1,227 @@
+#include "benchmarks.h"
+#include <engine/ecs/ecs.h>
+#include <engine/ecs/hierarchy.h>
+#include <engine/job_system.h>
+#include <engine/logging.h>
+#include <engine/platform.h>
+#include <stdio.h>
+
+#define BENCH_HIERARCHY_NODE_COUNT (100 * 1000)
+#define BENCH_HIERARCHY_REPEATS 20
+#define BENCH_HIERARCHY_SPARSE_STRIDE 100
+
+/**
+ * @brief Advances a xorshift state and returns the next value.
+ *
+ * @param state A pointer to the generator state.
+ * @return u32 The next pseudo-random value.
+ */
+static u32 bench_hierarchy_random(u32 *state) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Baseline: a recursive walk over the child links composing
+ * transforms stored by entity index, as a hierarchy without a sorted layout
+ * would.
+ *
+ * @param hierarchy A pointer to the hierarchy whose links are walked.
+ * @param locals Local transforms by entity index.
+ * @param worlds World transforms by entity index.
+ * @param index The entity index to update, with its subtree.
+ * @param parent A pointer to the parent's world transform, or NULL for a root.
+ * @return void
+ */
+static void bench_hierarchy_walk(const EcsHierarchy *hierarchy, const Transform *locals, WorldTransform *worlds, u32 index, const WorldTransform *parent) {
+    const Transform *local = &locals[index];
+    WorldTransform *world = &worlds[index];
+    f32 a = local->cosine * local->scaleX;
+    f32 b = local->sine * local->scaleX;
+    f32 c = -local->sine * local->scaleY;
+    f32 d = local->cosine * local->scaleY;
+    if (parent) {
+        *world = (WorldTransform){parent->a * a + parent->c * b, parent->b * a + parent->d * b, parent->a * c + parent->c * d, parent->b * c + parent->d * d,
+                                  parent->a * local->x + parent->c * local->y + parent->x, parent->b * local->x + parent->d * local->y + parent->y, parent->z + local->z};
+    } else {
+        *world = (WorldTransform){a, b, c, d, local->x, local->y, local->z};
+    }
+
+    for (u32 child = hierarchy->nodes[index].firstChild; child != INVALID_ID_U32; child = hierarchy->nodes[child].nextSibling) {
+        bench_hierarchy_walk(hierarchy, locals, worlds, child, world);
+    }
+}
+
+/**
+ * @brief Builds a hierarchy of BENCH_HIERARCHY_NODE_COUNT nodes split into
+ * trees of one root and fanout * depth descendants, with entities assigned
+ * to tree positions in random order, then times the sort, full, sparse and
+ * clean updates against the linked-walk baseline and prints one row.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param label The shape's name.
+ * @param fanout Children of every root.
+ * @param depth Length of the chain below each root child.
+ * @return void
+ */
+static void bench_hierarchy_shape(MemoryPool *pool, const char *label, u32 fanout, u32 depth) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS.");
+        return;
+    }
+
+    u32 treeSize = 1 + fanout * depth;
+    u32 count = BENCH_HIERARCHY_NODE_COUNT / treeSize * treeSize;
+    Entity *entities = (Entity *)memory_allocate(pool, sizeof(Entity) * count, MEMORY_TAG_ECS);
+    Transform *locals = (Transform *)memory_allocate(pool, sizeof(Transform) * count, MEMORY_TAG_ECS);
+    WorldTransform *worlds = (WorldTransform *)memory_allocate(pool, sizeof(WorldTransform) * count, MEMORY_TAG_ECS);
+    EcsHierarchy hierarchy;
+    if (!entities || !locals || !worlds || ecs_create_batch(&ecs, count, NULL, 0, NULL, entities) != ENGINE_SUCCESS || ecs_hierarchy_init(&hierarchy, &ecs) != ENGINE_SUCCESS) {
+        log_error("Failed to set up the %s hierarchy.", label);
+        ecs_shutdown(&ecs);
+        return;
+    }
+
+    // Shuffle the entities so entity order says nothing about tree order.
+    u32 seed = 0x2545F491u;
+    for (u32 i = count - 1; i > 0; --i) {
+        u32 j = bench_hierarchy_random(&seed) % (i + 1);
+        Entity swap = entities[i];
+        entities[i] = entities[j];
+        entities[j] = swap;
+    }
+
+    // Position p of a tree is its root at 0, then the chains one after another.
+    f32 turn = 0.7071068f;
+    for (u32 i = 0; i < count; ++i) {
+        u32 position = i % treeSize;
+        Entity parent = INVALID_ENTITY;
+        if (position != 0) {
+            parent = (position - 1) % depth == 0 ? entities[i - position] : entities[i - 1];
+        }
+        Transform local = {1.0f, 0.5f, 0.01f, turn, turn, 1.0f, 1.0f};
+        locals[ecs_entity_index(entities[i])] = local;
+        ecs_hierarchy_add(&hierarchy, entities[i], parent, &local);
+    }
+
+    f64 start = bench_now();
+    ecs_hierarchy_update(&hierarchy);
+    f64 sort = bench_now() - start;
+
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_HIERARCHY_REPEATS; ++repeat) {
+        for (u32 root = 0; root < hierarchy.rootCount; ++root) {
+            bench_hierarchy_walk(&hierarchy, locals, worlds, hierarchy.entities[hierarchy.roots[root]], NULL);
+        }
+    }
+    f64 walk = (bench_now() - start) / BENCH_HIERARCHY_REPEATS;
+
+    // Full: every root moves. Sparse: one node in BENCH_HIERARCHY_SPARSE_STRIDE moves.
+    u32 updated = 0;
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_HIERARCHY_REPEATS; ++repeat) {
+        for (u32 i = 0; i < count; i += treeSize) {
+            ecs_hierarchy_local(&hierarchy, entities[i])->x += 1.0f;
+        }
+        updated = ecs_hierarchy_update(&hierarchy);
+    }
+    f64 full = (bench_now() - start) / BENCH_HIERARCHY_REPEATS;
+
+    u32 sparseUpdated = 0;
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_HIERARCHY_REPEATS; ++repeat) {
+        for (u32 i = repeat; i < count; i += BENCH_HIERARCHY_SPARSE_STRIDE) {
+            ecs_hierarchy_local(&hierarchy, entities[i])->y += 1.0f;
+        }
+        sparseUpdated = ecs_hierarchy_update(&hierarchy);
+    }
+    f64 sparse = (bench_now() - start) / BENCH_HIERARCHY_REPEATS;
+
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_HIERARCHY_REPEATS; ++repeat) {
+        ecs_hierarchy_update(&hierarchy);
+    }
+    f64 clean = (bench_now() - start) / BENCH_HIERARCHY_REPEATS;
+
+    printf("%-24s %8u %8u %10.3f %10.3f %10.3f %10.3f %10u %10.3f\n", label, hierarchy.rootCount, depth + 1, sort * 1e3, walk * 1e3, full * 1e3, sparse * 1e3, sparseUpdated, clean * 1e3);
+    if (updated != count) {
+        log_error("Full update of the %s hierarchy recomputed %u of %u nodes.", label, updated, count);
+    }
+
+    ecs_hierarchy_shutdown(&hierarchy);
+    memory_free(pool, worlds, MEMORY_TAG_ECS);
+    memory_free(pool, locals, MEMORY_TAG_ECS);
+    memory_free(pool, entities, MEMORY_TAG_ECS);
+    ecs_shutdown(&ecs);
+}
+
+/**
+ * @brief Times a full update of a wide forest while scaling from 1 to N
+ * workers.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @return void
+ */
+static void bench_hierarchy_workers(MemoryPool *pool) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    EcsHierarchy hierarchy;
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS || ecs_hierarchy_init(&hierarchy, &ecs) != ENGINE_SUCCESS) {
+        log_error("Failed to set up the worker hierarchy.");
+        return;
+    }
+
+    // 1000 roots with 99 children each.
+    Entity root = INVALID_ENTITY;
+    for (u32 i = 0; i < BENCH_HIERARCHY_NODE_COUNT; ++i) {
+        Entity entity = ecs_create_entity(&ecs);
+        Transform local = transform_identity();
+        local.x = 1.0f;
+        ecs_hierarchy_add(&hierarchy, entity, i % 100 == 0 ? INVALID_ENTITY : root, &local);
+        root = i % 100 == 0 ? entity : root;
+    }
+    ecs_hierarchy_update(&hierarchy);
+
+    printf("%-8s %12s %10s\n", "workers", "full (ms)", "speedup");
+    f64 single = 0.0;
+    u32 maxWorkers = platform_get_processor_count();
+    for (u32 workers = 1; workers <= maxWorkers; ++workers) {
+        JobSystemConfig jobConfig = {0};
+        jobConfig.workerCount = workers;
+        if (job_system_init(pool, &jobConfig) != ENGINE_SUCCESS) {
+            log_error("Failed to initialize job system with %u workers.", workers);
+            break;
+        }
+
+        f64 start = bench_now();
+        for (u32 repeat = 0; repeat < BENCH_HIERARCHY_REPEATS; ++repeat) {
+            for (u32 slot = 0; slot < hierarchy.rootCount; ++slot) {
+                ecs_hierarchy_local(&hierarchy, ecs_entity_make(hierarchy.entities[hierarchy.roots[slot]], 0))->x += 1.0f;
+            }
+            ecs_hierarchy_update(&hierarchy);
+        }
+        f64 full = (bench_now() - start) / BENCH_HIERARCHY_REPEATS;
+        single = workers == 1 ? full : single;
+        printf("%-8u %12.3f %9.2fx\n", workers, full * 1e3, single / full);
+        job_system_shutdown();
+    }
+
+    ecs_hierarchy_shutdown(&hierarchy);
+    ecs_shutdown(&ecs);
+}
+
+void bench_hierarchy(MemoryPool *pool) {
+    printf("~%u nodes in random entity order, ms per update (walk: recursive link walk over entity-indexed transforms)\n", BENCH_HIERARCHY_NODE_COUNT);
+    printf("%-24s %8s %8s %10s %10s %10s %10s %10s %10s\n", "shape", "roots", "depth", "sort", "walk", "full", "sparse", "recomputed", "clean");
+    bench_hierarchy_shape(pool, "deep (chains of 1000)", 1, 999);
+    bench_hierarchy_shape(pool, "wide (100 children)", 99, 1);
+    bench_hierarchy_shape(pool, "bushy (10 x chains of 10)", 10, 10);
+    printf("\n");
+    bench_hierarchy_workers(pool);
+}
@@ -0,0 +1,75 @@
+#include "benchmarks.h"
+#include <engine/job_system.h>
+#include <engine/logging.h>
+#include <stdio.h>
+
+#define BENCH_JOB_COUNT 65536
+#define BENCH_JOB_WORK 2000
+#define BENCH_JOB_REPEATS 5
+
+// Results are written here so the compiler cannot discard the work.
+static volatile u32 sink[BENCH_JOB_COUNT];
+
+// A fixed amount of ALU work per job, standing in for a small system update.
+static void compute_job(void *userData) {
+    u32 index = (u32)(uintptr_t)userData;
+    u32 x = index + 1;
+    for (u32 i = 0; i < BENCH_JOB_WORK; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    sink[index] = x;
+}
+
+// An empty job, measuring pure scheduling overhead.
+static void empty_job(void *userData) {
+    ENGINE_UNUSED(userData);
+}
+
+static f64 run_batch(JobDecl *jobs, u32 count) {
+    f64 best = 1e30;
+    for (u32 repeat = 0; repeat < BENCH_JOB_REPEATS; ++repeat) {
+        JobCounter counter = {0};
+        f64 start = bench_now();
+        job_run(jobs, count, &counter);
+        job_wait(&counter);
+        f64 elapsed = bench_now() - start;
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+void bench_job_system(MemoryPool *pool) {
+    static JobDecl computeJobs[BENCH_JOB_COUNT];
+    static JobDecl emptyJobs[BENCH_JOB_COUNT];
+    for (u32 i = 0; i < BENCH_JOB_COUNT; ++i) {
+        computeJobs[i] = (JobDecl){compute_job, (void *)(uintptr_t)i};
+        emptyJobs[i] = (JobDecl){empty_job, NULL};
+    }
+
+    u32 maxWorkers = platform_get_processor_count();
+    f64 baseline = 0.0;
+
+    printf("%-8s %14s %10s %16s\n", "workers", "compute (ms)", "speedup", "empty (ns/job)");
+    for (u32 workers = 1; workers <= maxWorkers; ++workers) {
+        JobSystemConfig config = {0};
+        config.workerCount = workers;
+        if (job_system_init(pool, &config) != ENGINE_SUCCESS) {
+            log_error("Failed to initialize job system with %u workers.", workers);
+            return;
+        }
+
+        f64 compute = run_batch(computeJobs, BENCH_JOB_COUNT);
+        f64 empty = run_batch(emptyJobs, BENCH_JOB_COUNT);
+        if (workers == 1) {
+            baseline = compute;
+        }
+
+        printf("%-8u %14.3f %9.2fx %16.1f\n", workers, compute * 1000.0, baseline / compute, empty * 1e9 / BENCH_JOB_COUNT);
+
+        job_system_shutdown();
+    }
+}
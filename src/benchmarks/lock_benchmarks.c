@@ -0,0 +1,156 @@
+#include "benchmarks.h"
+#include <engine/logging.h>
+#include <engine/platform.h>
+#include <stdio.h>
+
+#define BENCH_UNCONTENDED_ITERATIONS 10000000
+#define BENCH_CONTENDED_ITERATIONS 1000000
+#define BENCH_MAX_LOCK_THREADS 16
+
+typedef enum BenchLockKind {
+    BENCH_LOCK_SDL_MUTEX = 0,
+    BENCH_LOCK_FAST_MUTEX,
+    BENCH_LOCK_SPINLOCK,
+    BENCH_LOCK_RWLOCK_WRITE,
+    BENCH_LOCK_RWLOCK_READ,
+    BENCH_LOCK_KIND_COUNT,
+} BenchLockKind;
+
+static const char *benchLockNames[BENCH_LOCK_KIND_COUNT] = {
+    "platform_mutex (SDL)",
+    "PlatformFastMutex",
+    "PlatformSpinLock",
+    "PlatformRWLock write",
+    "PlatformRWLock read",
+};
+
+typedef struct BenchLocks {
+    void *sdlMutex;             /**< Heap-allocated platform mutex. */
+    PlatformFastMutex fast;     /**< Futex-backed mutex. */
+    PlatformSpinLock spin;      /**< Ticket spinlock. */
+    PlatformRWLock rw;          /**< Reader-writer lock. */
+    volatile u64 counter;       /**< Protected data. */
+} BenchLocks;
+
+typedef struct BenchLockThread {
+    BenchLocks *locks;  /**< Shared locks. */
+    BenchLockKind kind; /**< Lock to hammer. */
+    u32 iterations;     /**< Lock/unlock pairs to perform. */
+} BenchLockThread;
+
+static void lock_loop(BenchLocks *locks, BenchLockKind kind, u32 iterations) {
+    switch (kind) {
+        case BENCH_LOCK_SDL_MUTEX:
+            for (u32 i = 0; i < iterations; ++i) {
+                platform_mutex_lock(locks->sdlMutex);
+                locks->counter++;
+                platform_mutex_unlock(locks->sdlMutex);
+            }
+            break;
+        case BENCH_LOCK_FAST_MUTEX:
+            for (u32 i = 0; i < iterations; ++i) {
+                platform_fast_mutex_lock(&locks->fast);
+                locks->counter++;
+                platform_fast_mutex_unlock(&locks->fast);
+            }
+            break;
+        case BENCH_LOCK_SPINLOCK:
+            for (u32 i = 0; i < iterations; ++i) {
+                platform_spinlock_lock(&locks->spin);
+                locks->counter++;
+                platform_spinlock_unlock(&locks->spin);
+            }
+            break;
+        case BENCH_LOCK_RWLOCK_WRITE:
+            for (u32 i = 0; i < iterations; ++i) {
+                platform_rwlock_write_lock(&locks->rw);
+                locks->counter++;
+                platform_rwlock_write_unlock(&locks->rw);
+            }
+            break;
+        case BENCH_LOCK_RWLOCK_READ:
+            // Readers only read, so the counter check is the "work".
+            for (u32 i = 0; i < iterations; ++i) {
+                platform_rwlock_read_lock(&locks->rw);
+                if (locks->counter == MAX_U64) {
+                    log_error("Unexpected counter value.");
+                }
+                platform_rwlock_read_unlock(&locks->rw);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static i32 noop_thread(void *data) {
+    ENGINE_UNUSED(data);
+    return 0;
+}
+
+static i32 lock_thread(void *data) {
+    BenchLockThread *thread = (BenchLockThread *)data;
+    lock_loop(thread->locks, thread->kind, thread->iterations);
+    return 0;
+}
+
+void bench_locks(MemoryPool *pool) {
+    ENGINE_UNUSED(pool);
+
+    BenchLocks locks = {0};
+    platform_mutex_create(&locks.sdlMutex);
+    if (!locks.sdlMutex) {
+        log_error("Failed to create SDL mutex for lock benchmark.");
+        return;
+    }
+
+    // Some C libraries skip atomic instructions in their mutexes until a
+    // second thread has existed; make sure every lock is measured for real.
+    void *warmup = NULL;
+    if (platform_thread_create(noop_thread, NULL, "LockBenchWarmup", &warmup) == ENGINE_SUCCESS) {
+        platform_thread_join(warmup);
+    }
+
+    printf("uncontended lock/unlock pairs:\n");
+    for (u32 kind = 0; kind < BENCH_LOCK_KIND_COUNT; ++kind) {
+        f64 start = bench_now();
+        lock_loop(&locks, (BenchLockKind)kind, BENCH_UNCONTENDED_ITERATIONS);
+        f64 elapsed = bench_now() - start;
+        printf("  %-22s %8.2f ns\n", benchLockNames[kind], elapsed * 1e9 / BENCH_UNCONTENDED_ITERATIONS);
+    }
+
+    u32 processorCount = platform_get_processor_count();
+    u32 threadCount = processorCount;
+    if (threadCount < 2) {
+        threadCount = 2; // Still measures contention through preemption.
+    }
+    if (threadCount > BENCH_MAX_LOCK_THREADS) {
+        threadCount = BENCH_MAX_LOCK_THREADS;
+    }
+
+    printf("contended, %u threads, %u pairs each:\n", threadCount, BENCH_CONTENDED_ITERATIONS);
+    for (u32 kind = 0; kind < BENCH_LOCK_KIND_COUNT; ++kind) {
+        BenchLockThread threads[BENCH_MAX_LOCK_THREADS];
+        void *handles[BENCH_MAX_LOCK_THREADS] = {0};
+        locks.counter = 0;
+
+        f64 start = bench_now();
+        for (u32 i = 0; i < threadCount; ++i) {
+            threads[i] = (BenchLockThread){&locks, (BenchLockKind)kind, BENCH_CONTENDED_ITERATIONS};
+            platform_thread_create(lock_thread, &threads[i], "LockBench", &handles[i]);
+        }
+        for (u32 i = 0; i < threadCount; ++i) {
+            if (handles[i]) {
+                platform_thread_join(handles[i]);
+            }
+        }
+        f64 elapsed = bench_now() - start;
+
+        // Writers must not lose increments; readers leave the counter alone.
+        u64 expected = kind == BENCH_LOCK_RWLOCK_READ ? 0 : (u64)threadCount * BENCH_CONTENDED_ITERATIONS;
+        printf("  %-22s %8.2f ns/pair %s\n", benchLockNames[kind], elapsed * 1e9 / ((f64)threadCount * BENCH_CONTENDED_ITERATIONS),
+               locks.counter == expected ? "" : "(LOST UPDATES)");
+    }
+
+    platform_mutex_destroy(locks.sdlMutex);
+}
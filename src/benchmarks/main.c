@@ -0,0 +1,79 @@
+#include "benchmarks.h"
+#include <engine/logging.h>
+#include <engine/platform.h>
+#include <engine/profiler.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef void (*BenchFunc)(MemoryPool *pool);
+
+typedef struct BenchSuite {
+    const char *name; /**< Name used to select the suite on the command line. */
+    BenchFunc run;    /**< Entry point of the suite. */
+} BenchSuite;
+
+static const BenchSuite suites[] = {
+    {"jobs", bench_job_system},
+    {"parallel", bench_parallel},
+    {"fibers", bench_fibers},
+    {"locks", bench_locks},
+    {"ecs", bench_ecs},
+    {"archetypes", bench_archetypes},
+    {"queries", bench_queries},
+    {"systems", bench_systems},
+    {"groups", bench_groups},
+    {"hierarchy", bench_hierarchy},
+    {"prefabs", bench_prefabs},
+    {"signatures", bench_signatures},
+    {"tags", bench_tags},
+    {"sorting", bench_sorting},
+    {"snapshots", bench_snapshots},
+};
+
+f64 bench_now(void) {
+    return (f64)platform_get_performance_counter() / (f64)platform_get_performance_frequency();
+}
+
+void bench_print_counters(const PlatformPerfCounterValues *begin, u64 iterations) {
+    PlatformPerfCounterValues end;
+    profiler_read_counters(&end);
+
+    char text[256];
+    if (profiler_format_counters(begin, &end, iterations, text, sizeof(text))) {
+        printf("  counters%s (calling thread): %s\n", iterations > 1 ? " per iteration" : "", text);
+    }
+}
+
+// Usage: benchmarks [suite...]. Runs every suite when none are named.
+int main(int argc, char **argv) {
+    MemoryPool pool;
+    if (memory_pool_init(&pool, 1024ull * 1024 * 512) != ENGINE_SUCCESS) { // 512MB
+        log_error("Failed to initialize benchmark memory pool.");
+        return -1;
+    }
+
+    // Hardware counters are optional; suites still report wall time without them.
+    ProfilerConfig profilerConfig = {0};
+    profilerConfig.hardwareCounters = true;
+    profilerConfig.reportInterval = -1.0;
+    profiler_init(&profilerConfig);
+
+    for (u32 i = 0; i < ENGINE_ARRAY_COUNT(suites); ++i) {
+        b8 selected = argc < 2;
+        for (i32 arg = 1; arg < argc; ++arg) {
+            selected |= strcmp(argv[arg], suites[i].name) == 0;
+        }
+
+        if (selected) {
+            printf("=== %s ===\n", suites[i].name);
+            PlatformPerfCounterValues begin;
+            profiler_read_counters(&begin);
+            suites[i].run(&pool);
+            bench_print_counters(&begin, 1);
+        }
+    }
+
+    profiler_shutdown();
+    memory_pool_shutdown(&pool);
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "benchmarks.h"
+#include <engine/job_system.h>
+#include <engine/logging.h>
+#include <engine/parallel.h>
+#include <engine/platform.h>
+#include <stdio.h>
+
+#define BENCH_BODY_COUNT (1024 * 1024)
+#define BENCH_BODY_REPEATS 10
+#define BENCH_BODY_DELTA_TIME (1.0f / 60.0f)
+
+// Matches the layout of the reference physics Rigidbody.
+typedef struct BenchBody {
+    f32 x, y, z;
+    f32 mass;
+    f32 vx, vy, vz;
+} BenchBody;
+
+typedef struct BenchIntegrateContext {
+    BenchBody *bodies; /**< Bodies to integrate. */
+    f32 deltaTime;     /**< Step length in seconds. */
+} BenchIntegrateContext;
+
+static void integrate_range(u32 begin, u32 end, void *userData) {
+    BenchIntegrateContext *context = (BenchIntegrateContext *)userData;
+    BenchBody *bodies = context->bodies;
+    f32 dt = context->deltaTime;
+
+    for (u32 i = begin; i < end; ++i) {
+        bodies[i].vy -= 9.81f * dt;
+        bodies[i].x += bodies[i].vx * dt;
+        bodies[i].y += bodies[i].vy * dt;
+        bodies[i].z += bodies[i].vz * dt;
+    }
+}
+
+static void energy_range(u32 begin, u32 end, void *partial, void *userData) {
+    const BenchBody *bodies = ((BenchIntegrateContext *)userData)->bodies;
+    f64 sum = *(f64 *)partial;
+
+    for (u32 i = begin; i < end; ++i) {
+        f32 speedSq = bodies[i].vx * bodies[i].vx + bodies[i].vy * bodies[i].vy + bodies[i].vz * bodies[i].vz;
+        sum += 0.5 * bodies[i].mass * speedSq;
+    }
+
+    *(f64 *)partial = sum;
+}
+
+static void energy_combine(void *result, const void *partial, void *userData) {
+    ENGINE_UNUSED(userData);
+    *(f64 *)result += *(const f64 *)partial;
+}
+
+static void reset_bodies(BenchBody *bodies) {
+    for (u32 i = 0; i < BENCH_BODY_COUNT; ++i) {
+        bodies[i] = (BenchBody){0.0f, 100.0f, 0.0f, 1.0f + (f32)(i % 7), (f32)(i % 13) * 0.1f, 0.0f, (f32)(i % 5) * 0.2f};
+    }
+}
+
+void bench_parallel(MemoryPool *pool) {
+    BenchBody *bodies = (BenchBody *)memory_allocate_aligned(pool, sizeof(BenchBody) * BENCH_BODY_COUNT, ENGINE_CACHE_LINE_SIZE, MEMORY_TAG_ENGINE);
+    if (!bodies) {
+        log_error("Failed to allocate %u benchmark bodies.", BENCH_BODY_COUNT);
+        return;
+    }
+
+    BenchIntegrateContext context = {bodies, BENCH_BODY_DELTA_TIME};
+
+    // Serial baseline: the reference physics_update loop.
+    reset_bodies(bodies);
+    f64 start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_BODY_REPEATS; ++repeat) {
+        integrate_range(0, BENCH_BODY_COUNT, &context);
+    }
+    f64 serial = (bench_now() - start) / BENCH_BODY_REPEATS;
+    printf("serial integrate of %u bodies: %.3f ms\n", BENCH_BODY_COUNT, serial * 1000.0);
+
+    printf("%-8s %16s %10s %16s %22s\n", "workers", "integrate (ms)", "speedup", "reduce (ms)", "energy");
+    u32 maxWorkers = platform_get_processor_count();
+    for (u32 workers = 1; workers <= maxWorkers; ++workers) {
+        JobSystemConfig config = {0};
+        config.workerCount = workers;
+        if (job_system_init(pool, &config) != ENGINE_SUCCESS) {
+            log_error("Failed to initialize job system with %u workers.", workers);
+            break;
+        }
+
+        reset_bodies(bodies);
+        start = bench_now();
+        for (u32 repeat = 0; repeat < BENCH_BODY_REPEATS; ++repeat) {
+            parallel_for(BENCH_BODY_COUNT, 0, integrate_range, &context);
+        }
+        f64 integrate = (bench_now() - start) / BENCH_BODY_REPEATS;
+
+        f64 energy = 0.0;
+        start = bench_now();
+        for (u32 repeat = 0; repeat < BENCH_BODY_REPEATS; ++repeat) {
+            energy = 0.0;
+            parallel_reduce(BENCH_BODY_COUNT, 0, energy_range, energy_combine, &energy, sizeof(energy), &context);
+        }
+        f64 reduce = (bench_now() - start) / BENCH_BODY_REPEATS;
+
+        // The energy column must be identical on every row: the reduction
+        // partition does not depend on the worker count.
+        printf("%-8u %16.3f %9.2fx %16.3f %22.10f\n", workers, integrate * 1000.0, serial / integrate, reduce * 1000.0, energy);
+
+        job_system_shutdown();
+    }
+
+    memory_free_aligned(pool, bodies, MEMORY_TAG_ENGINE);
+}
@@ -0,0 +1,133 @@
+#include "benchmarks.h"
+#include <engine/components/position.h>
+#include <engine/components/velocity.h>
+#include <engine/ecs/ecs.h>
+#include <engine/ecs/prefab.h>
+#include <engine/logging.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define BENCH_PREFAB_INSTANCE_COUNT (100 * 1000)
+#define BENCH_PREFAB_CHILD_COUNT 3
+#define BENCH_PREFAB_ENTITY_COUNT (1 + BENCH_PREFAB_CHILD_COUNT)
+
+/** @brief Bench-local component on the root. */
+typedef struct BenchPrefabHealth {
+    f32 value; /**< The current health. */
+    f32 max;   /**< The maximum health. */
+} BenchPrefabHealth;
+
+/** @brief Bench-local component tying a child to the root. */
+typedef struct BenchPrefabMount {
+    Entity owner; /**< The root the child is mounted on. */
+    f32 angle;    /**< Mount angle. */
+} BenchPrefabMount;
+
+/**
+ * @brief The component types of the benchmark's ship: a root with Position,
+ * Velocity and Health, and children with Position and Mount.
+ */
+typedef struct BenchPrefabTypes {
+    ComponentType position; /**< Position. */
+    ComponentType velocity; /**< Velocity. */
+    ComponentType health;   /**< BenchPrefabHealth. */
+    ComponentType mount;    /**< BenchPrefabMount. */
+} BenchPrefabTypes;
+
+/**
+ * @brief Spawns the ship BENCH_PREFAB_INSTANCE_COUNT times with one
+ * create and one add per component, as spawning code does without prefabs.
+ *
+ * @param ecs A pointer to the ECS.
+ * @param types A pointer to the component types.
+ * @return void
+ */
+static void bench_prefab_by_hand(ECSManager *ecs, const BenchPrefabTypes *types) {
+    for (u32 i = 0; i < BENCH_PREFAB_INSTANCE_COUNT; ++i) {
+        Entity root = ecs_create_entity(ecs);
+        ecs_add_component(ecs, root, types->position, &(Position){(f32)i, 0.0f, 0.0f});
+        ecs_add_component(ecs, root, types->velocity, &(Velocity){1.0f, 0.0f, 0.0f});
+        ecs_add_component(ecs, root, types->health, &(BenchPrefabHealth){100.0f, 100.0f});
+        for (u32 child = 0; child < BENCH_PREFAB_CHILD_COUNT; ++child) {
+            Entity mounted = ecs_create_entity(ecs);
+            ecs_add_component(ecs, mounted, types->position, &(Position){(f32)child, 0.0f, 0.0f});
+            ecs_add_component(ecs, mounted, types->mount, &(BenchPrefabMount){root, (f32)child});
+        }
+    }
+}
+
+/**
+ * @brief Times spawning BENCH_PREFAB_INSTANCE_COUNT ships by hand and from a
+ * prefab in one storage layout and prints one row.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param storage The storage layout.
+ * @return void
+ */
+static void bench_prefab_row(MemoryPool *pool, ECSStorage storage) {
+    f64 seconds[2] = {0.0, 0.0};
+    for (u32 mode = 0; mode < 2; ++mode) {
+        ECSManager ecs;
+        ECSConfig config = {0};
+        config.storage = storage;
+        if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+            log_error("Failed to initialize the ECS.");
+            return;
+        }
+
+        BenchPrefabTypes types;
+        types.position = ecs_register_component(&ecs, sizeof(Position));
+        types.velocity = ecs_register_component(&ecs, sizeof(Velocity));
+        types.health = ecs_register_component(&ecs, sizeof(BenchPrefabHealth));
+        types.mount = ecs_register_component(&ecs, sizeof(BenchPrefabMount));
+
+        if (mode == 0) {
+            f64 start = bench_now();
+            bench_prefab_by_hand(&ecs, &types);
+            seconds[mode] = bench_now() - start;
+        } else {
+            EcsPrefab prefab;
+            ecs_prefab_init(&prefab, &ecs);
+            ecs_prefab_entity_field(&prefab, types.mount, offsetof(BenchPrefabMount, owner));
+            u32 root = ecs_prefab_add_entity(&prefab, INVALID_ID_U32, NULL);
+            ecs_prefab_set(&prefab, root, types.position, &(Position){0.0f, 0.0f, 0.0f});
+            ecs_prefab_set(&prefab, root, types.velocity, &(Velocity){1.0f, 0.0f, 0.0f});
+            ecs_prefab_set(&prefab, root, types.health, &(BenchPrefabHealth){100.0f, 100.0f});
+            for (u32 child = 0; child < BENCH_PREFAB_CHILD_COUNT; ++child) {
+                u32 mounted = ecs_prefab_add_entity(&prefab, root, NULL);
+                ecs_prefab_set(&prefab, mounted, types.position, &(Position){(f32)child, 0.0f, 0.0f});
+                ecs_prefab_set(&prefab, mounted, types.mount, &(BenchPrefabMount){ecs_prefab_ref(root), (f32)child});
+            }
+
+            Entity *entities = (Entity *)memory_allocate(pool, sizeof(Entity) * BENCH_PREFAB_INSTANCE_COUNT * BENCH_PREFAB_ENTITY_COUNT, MEMORY_TAG_ECS);
+            if (!entities) {
+                log_error("Failed to allocate prefab instance handles.");
+                ecs_prefab_shutdown(&prefab);
+                ecs_shutdown(&ecs);
+                return;
+            }
+            f64 start = bench_now();
+            if (ecs_prefab_instantiate(&prefab, BENCH_PREFAB_INSTANCE_COUNT, NULL, entities) != ENGINE_SUCCESS) {
+                log_error("Failed to instantiate the ship prefab.");
+            }
+            seconds[mode] = bench_now() - start;
+            memory_free(pool, entities, MEMORY_TAG_ECS);
+            ecs_prefab_shutdown(&prefab);
+        }
+
+        if (ecs_component_count(&ecs, types.position) != BENCH_PREFAB_INSTANCE_COUNT * BENCH_PREFAB_ENTITY_COUNT) {
+            log_error("Spawned %u positions, expected %u.", ecs_component_count(&ecs, types.position), BENCH_PREFAB_INSTANCE_COUNT * BENCH_PREFAB_ENTITY_COUNT);
+        }
+        ecs_shutdown(&ecs);
+    }
+
+    printf("%-11s %12.2f %12.2f %12.2f %12.2f %9.2fx\n", storage == ECS_STORAGE_ARCHETYPE ? "archetype" : "sparse set", seconds[0] * 1e3, BENCH_PREFAB_INSTANCE_COUNT / seconds[0] / 1e6,
+           seconds[1] * 1e3, BENCH_PREFAB_INSTANCE_COUNT / seconds[1] / 1e6, seconds[0] / seconds[1]);
+}
+
+void bench_prefabs(MemoryPool *pool) {
+    printf("%u spawns of a %u-entity ship (root: Position, Velocity, Health; children: Position, Mount -> root)\n", BENCH_PREFAB_INSTANCE_COUNT, BENCH_PREFAB_ENTITY_COUNT);
+    printf("%-11s %12s %12s %12s %12s %10s\n", "storage", "by hand ms", "M spawns/s", "prefab ms", "M spawns/s", "speedup");
+    bench_prefab_row(pool, ECS_STORAGE_SPARSE_SET);
+    bench_prefab_row(pool, ECS_STORAGE_ARCHETYPE);
+}
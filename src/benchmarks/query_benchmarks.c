@@ -0,0 +1,251 @@
+#include "benchmarks.h"
+#include <engine/components/position.h>
+#include <engine/components/velocity.h>
+#include <engine/ecs/ecs.h>
+#include <engine/logging.h>
+#include <stdio.h>
+
+#define BENCH_QUERY_ENTITY_COUNT (1000 * 1000)
+#define BENCH_QUERY_REPEATS 10
+#define BENCH_QUERY_DELTA_TIME (1.0f / 60.0f)
+
+// Entities moved between extraction passes, one contiguous range per pass.
+#define BENCH_QUERY_MOVED_COUNT (BENCH_QUERY_ENTITY_COUNT / 100)
+
+/**
+ * @brief Component types of the benchmark ECS.
+ */
+typedef struct BenchQueryTypes {
+    ComponentType position; /**< Position, on every entity. */
+    ComponentType velocity; /**< Velocity, on every entity. */
+    ComponentType frozen;   /**< Excluded by the movement query, on every fourth entity. */
+    ComponentType rare;     /**< On one entity in a hundred. */
+} BenchQueryTypes;
+
+// The reference movement system: walk positions and look velocity up per entity.
+static void lookup_movement(ECSManager *ecs, const BenchQueryTypes *types, f32 dt) {
+    Position *positions = (Position *)ecs_component_data(ecs, types->position);
+    const Entity *entities = ecs_component_entities(ecs, types->position);
+    u32 count = ecs_component_count(ecs, types->position);
+    for (u32 i = 0; i < count; ++i) {
+        if (ecs_has_component(ecs, entities[i], types->frozen)) {
+            continue;
+        }
+        const Velocity *velocity = (const Velocity *)ecs_get_component(ecs, entities[i], types->velocity);
+        if (velocity) {
+            positions[i].x += velocity->vx * dt;
+            positions[i].y += velocity->vy * dt;
+            positions[i].z += velocity->vz * dt;
+        }
+    }
+}
+
+static void query_movement(const EcsView *view, void *userData) {
+    f32 dt = *(const f32 *)userData;
+    Position *positions = (Position *)view->columns[0];
+    const Velocity *velocities = (const Velocity *)view->columns[1];
+    if (!view->rows[0]) {
+        for (u32 i = 0; i < view->count; ++i) {
+            positions[i].x += velocities[i].vx * dt;
+            positions[i].y += velocities[i].vy * dt;
+            positions[i].z += velocities[i].vz * dt;
+        }
+        return;
+    }
+
+    const u32 *positionRows = view->rows[0];
+    const u32 *velocityRows = view->rows[1];
+    for (u32 i = 0; i < view->count; ++i) {
+        Position *position = &positions[positionRows[i]];
+        const Velocity *velocity = &velocities[velocityRows[i]];
+        position->x += velocity->vx * dt;
+        position->y += velocity->vy * dt;
+        position->z += velocity->vz * dt;
+    }
+}
+
+/**
+ * @brief What an extraction pass copied out.
+ */
+typedef struct BenchQueryExtract {
+    f64 sum;  /**< Sum of the extracted x coordinates, so the loads are kept. */
+    u32 rows; /**< Rows visited. */
+} BenchQueryExtract;
+
+// Render extraction stand-in: read every position of the view.
+static void query_extract(const EcsView *view, void *userData) {
+    BenchQueryExtract *extract = (BenchQueryExtract *)userData;
+    const Position *positions = (const Position *)view->columns[0];
+    for (u32 i = 0; i < view->count; ++i) {
+        extract->sum += positions[ecs_view_row(view, 0, i)].x;
+    }
+    extract->rows += view->count;
+}
+
+/**
+ * @brief Moves one contiguous range of entities through ecs_get_component,
+ * then runs an extraction pass.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param query A pointer to the extraction query.
+ * @param position The Position component type.
+ * @param repeat The pass index, which picks the range.
+ * @param extract A pointer to the extraction totals.
+ * @return void
+ */
+static void bench_query_extract_pass(ECSManager *ecs, EcsQuery *query, ComponentType position, u32 repeat, BenchQueryExtract *extract) {
+    // Nothing was destroyed, so entity i still has generation 0.
+    u32 first = (repeat * 37 % 100) * BENCH_QUERY_MOVED_COUNT;
+    for (u32 i = first; i < first + BENCH_QUERY_MOVED_COUNT; ++i) {
+        ((Position *)ecs_get_component(ecs, ecs_entity_make(i, 0), position))->y += 1.0f;
+    }
+    ecs_query_each(query, query_extract, extract);
+}
+
+/**
+ * @brief Times one pass function and prints its row.
+ *
+ * @param label The row label.
+ * @param seconds Total seconds over BENCH_QUERY_REPEATS passes.
+ * @param matched The number of entities each pass updated.
+ * @return void
+ */
+static void bench_query_row(const char *label, f64 seconds, u32 matched) {
+    printf("%-48s %10.3f %10u\n", label, seconds * 1e3 / BENCH_QUERY_REPEATS, matched);
+}
+
+/**
+ * @brief Builds an ECS, then times the reference lookup loop against cached
+ * queries, fresh and rebuilt after a structural change every pass.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param storage The storage layout to benchmark.
+ * @return void
+ */
+static void bench_query_storage(MemoryPool *pool, ECSStorage storage) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS.");
+        return;
+    }
+
+    BenchQueryTypes types;
+    types.position = ecs_register_component(&ecs, sizeof(Position));
+    types.velocity = ecs_register_component(&ecs, sizeof(Velocity));
+    types.frozen = ecs_register_component(&ecs, sizeof(u32));
+    types.rare = ecs_register_component(&ecs, sizeof(u32));
+
+    Entity toggled[2] = {INVALID_ENTITY, INVALID_ENTITY};
+    for (u32 i = 0; i < BENCH_QUERY_ENTITY_COUNT; ++i) {
+        Entity entity = ecs_create_entity(&ecs);
+        if (i < ENGINE_ARRAY_COUNT(toggled)) {
+            toggled[i] = entity;
+        }
+        ecs_add_component(&ecs, entity, types.position, &(Position){(f32)i, 0.0f, 0.0f});
+        ecs_add_component(&ecs, entity, types.velocity, &(Velocity){1.0f, 0.0f, (f32)(i % 5)});
+        if (i % 4 == 0) {
+            ecs_add_component(&ecs, entity, types.frozen, NULL);
+        }
+        if (i % 100 == 1) {
+            ecs_add_component(&ecs, entity, types.rare, NULL);
+        }
+    }
+
+    ComponentType moving[] = {types.position, types.velocity};
+    ComponentType rareMoving[] = {types.position, types.velocity, types.rare};
+    EcsQuery movers;
+    EcsQuery rareMovers;
+    ecs_query_init(&movers, &ecs, &(EcsQueryDesc){.required = moving, .requiredCount = 2, .excluded = &types.frozen, .excludedCount = 1});
+    ecs_query_init(&rareMovers, &ecs, &(EcsQueryDesc){.required = rareMoving, .requiredCount = 3});
+    u32 matched = ecs_query_count(&movers);
+    u32 rareMatched = ecs_query_count(&rareMovers);
+
+    const char *name = storage == ECS_STORAGE_ARCHETYPE ? "archetype" : "sparse set";
+    char label[64];
+    f32 dt = BENCH_QUERY_DELTA_TIME;
+    f64 start;
+
+    if (storage == ECS_STORAGE_SPARSE_SET) {
+        start = bench_now();
+        for (u32 repeat = 0; repeat < BENCH_QUERY_REPEATS; ++repeat) {
+            lookup_movement(&ecs, &types, dt);
+        }
+        snprintf(label, sizeof(label), "%s: per-entity lookups", name);
+        bench_query_row(label, bench_now() - start, matched);
+    }
+
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_QUERY_REPEATS; ++repeat) {
+        ecs_query_each(&movers, query_movement, &dt);
+    }
+    snprintf(label, sizeof(label), "%s: cached query", name);
+    bench_query_row(label, bench_now() - start, matched);
+
+    // Toggle Frozen on one entity per pass, so every pass follows a
+    // structural change to a type the query mentions.
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_QUERY_REPEATS; ++repeat) {
+        if (repeat % 2 == 0) {
+            ecs_remove_component(&ecs, toggled[0], types.frozen);
+        } else {
+            ecs_add_component(&ecs, toggled[0], types.frozen, NULL);
+        }
+        ecs_query_each(&movers, query_movement, &dt);
+    }
+    snprintf(label, sizeof(label), "%s: query after structural change", name);
+    bench_query_row(label, bench_now() - start, matched);
+
+    // The rare type is the smallest set, so rebuilding walks 1% of entities.
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_QUERY_REPEATS; ++repeat) {
+        if (repeat % 2 == 0) {
+            ecs_remove_component(&ecs, toggled[1], types.rare);
+        } else {
+            ecs_add_component(&ecs, toggled[1], types.rare, NULL);
+        }
+        ecs_query_each(&rareMovers, query_movement, &dt);
+    }
+    snprintf(label, sizeof(label), "%s: rare query after structural change", name);
+    bench_query_row(label, bench_now() - start, rareMatched);
+
+    // Extraction of every position against only the chunks or blocks written
+    // since the last pass. Each query runs once first so both start caught up.
+    EcsQuery extractAll;
+    EcsQuery extractChanged;
+    ecs_query_init(&extractAll, &ecs, &(EcsQueryDesc){.required = &types.position, .requiredCount = 1});
+    ecs_query_init(&extractChanged, &ecs, &(EcsQueryDesc){.required = &types.position, .requiredCount = 1, .changed = &types.position, .changedCount = 1});
+    BenchQueryExtract extract = {0};
+    ecs_query_each(&extractAll, query_extract, &extract);
+    ecs_query_each(&extractChanged, query_extract, &extract);
+
+    extract = (BenchQueryExtract){0};
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_QUERY_REPEATS; ++repeat) {
+        bench_query_extract_pass(&ecs, &extractAll, types.position, repeat, &extract);
+    }
+    snprintf(label, sizeof(label), "%s: extract all, 1%% moved", name);
+    bench_query_row(label, bench_now() - start, extract.rows / BENCH_QUERY_REPEATS);
+
+    extract = (BenchQueryExtract){0};
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_QUERY_REPEATS; ++repeat) {
+        bench_query_extract_pass(&ecs, &extractChanged, types.position, repeat, &extract);
+    }
+    snprintf(label, sizeof(label), "%s: extract changed, 1%% moved", name);
+    bench_query_row(label, bench_now() - start, extract.rows / BENCH_QUERY_REPEATS);
+
+    ecs_query_destroy(&extractAll);
+    ecs_query_destroy(&extractChanged);
+    ecs_query_destroy(&movers);
+    ecs_query_destroy(&rareMovers);
+    ecs_shutdown(&ecs);
+}
+
+void bench_queries(MemoryPool *pool) {
+    printf("%u entities, Position+Velocity without Frozen (3 in 4), ms per pass\n", BENCH_QUERY_ENTITY_COUNT);
+    printf("%-48s %10s %10s\n", "system", "ms", "matched");
+    bench_query_storage(pool, ECS_STORAGE_SPARSE_SET);
+    bench_query_storage(pool, ECS_STORAGE_ARCHETYPE);
+}
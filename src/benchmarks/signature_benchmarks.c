@@ -0,0 +1,373 @@
+#include "benchmarks.h"
+#include <engine/ecs/ecs.h>
+#include <engine/logging.h>
+#include <stdio.h>
+
+#define BENCH_SIGNATURE_TYPE_COUNT 256
+#define BENCH_SIGNATURE_ARCHETYPE_COUNT 4096
+#define BENCH_SIGNATURE_QUERY_COUNT 256
+#define BENCH_SIGNATURE_ENTITY_COUNT (100 * 1000)
+#define BENCH_SIGNATURE_ENTITY_TYPES 16
+#define BENCH_SIGNATURE_ENTITY_QUERIES 64
+#define BENCH_SIGNATURE_REPEATS 10
+
+/**
+ * @brief A query reduced to its terms and masks.
+ */
+typedef struct BenchSignatureQuery {
+    ComponentType required[4]; /**< Required types. */
+    u32 requiredCount;         /**< The number of required types. */
+    ComponentType excluded[2]; /**< Excluded types. */
+    u32 excludedCount;         /**< The number of excluded types. */
+    EcsSignature requiredMask; /**< Required types as a signature. */
+    EcsSignature excludedMask; /**< Excluded types as a signature. */
+} BenchSignatureQuery;
+
+/**
+ * @brief An archetype reduced to its sorted type list.
+ */
+typedef struct BenchSignatureArchetype {
+    ComponentType types[BENCH_SIGNATURE_TYPE_COUNT]; /**< Component types in ascending order. */
+    u32 typeCount;                                   /**< The number of types. */
+} BenchSignatureArchetype;
+
+/**
+ * @brief Advances a xorshift state and returns the next value.
+ *
+ * @param state A pointer to the generator state.
+ * @return u32 The next pseudo-random value.
+ */
+static u32 bench_signature_random(u32 *state) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Makes a query of 2 to 4 required and 0 to 2 excluded distinct types
+ * drawn from the first typeCount types.
+ *
+ * @param query A pointer to the query to fill.
+ * @param typeCount The number of types to draw from.
+ * @param seed A pointer to the generator state.
+ * @return void
+ */
+static void bench_signature_make_query(BenchSignatureQuery *query, u32 typeCount, u32 *seed) {
+    *query = (BenchSignatureQuery){0};
+    u32 required = 2 + bench_signature_random(seed) % 3;
+    u32 excluded = bench_signature_random(seed) % 3;
+    while (query->requiredCount + query->excludedCount < required + excluded) {
+        ComponentType type = bench_signature_random(seed) % typeCount;
+        if (ecs_signature_has(&query->requiredMask, type) || ecs_signature_has(&query->excludedMask, type)) {
+            continue;
+        }
+        if (query->requiredCount < required) {
+            query->required[query->requiredCount++] = type;
+            ecs_signature_set(&query->requiredMask, type);
+        } else {
+            query->excluded[query->excludedCount++] = type;
+            ecs_signature_set(&query->excludedMask, type);
+        }
+    }
+}
+
+/**
+ * @brief Baseline: checks whether a sorted type list holds a type by binary
+ * search, as probing an archetype's column list per term does.
+ *
+ * @param archetype A pointer to the archetype.
+ * @param type The component type.
+ * @return b8 True if the archetype has the type.
+ */
+static b8 bench_signature_archetype_has(const BenchSignatureArchetype *archetype, ComponentType type) {
+    u32 low = 0;
+    u32 high = archetype->typeCount;
+    while (low < high) {
+        u32 middle = (low + high) / 2;
+        if (archetype->types[middle] < type) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low < archetype->typeCount && archetype->types[low] == type;
+}
+
+/**
+ * @brief Baseline: checks whether a sparse set holds an entity index by
+ * reading its sparse page, as per-term entity matching does.
+ *
+ * @param componentArray A pointer to the component array.
+ * @param index The entity index.
+ * @return b8 True if the entity has the component.
+ */
+static b8 bench_signature_sparse_has(const ComponentArray *componentArray, u32 index) {
+    u32 page = index / ECS_SPARSE_PAGE_SIZE;
+    return page < componentArray->sparsePageCount && componentArray->sparsePages[page] && componentArray->sparsePages[page][index % ECS_SPARSE_PAGE_SIZE] != INVALID_ID_U32;
+}
+
+/**
+ * @brief Baseline: counts the archetypes matching a query by searching each
+ * archetype's type list once per term.
+ *
+ * @param archetypes The archetypes.
+ * @param count The number of archetypes.
+ * @param query A pointer to the query.
+ * @return u64 The number of matches.
+ */
+static u64 bench_signature_count_search(const BenchSignatureArchetype *archetypes, u32 count, const BenchSignatureQuery *query) {
+    u64 found = 0;
+    for (u32 a = 0; a < count; ++a) {
+        b8 match = true;
+        for (u32 t = 0; t < query->requiredCount && match; ++t) {
+            match = bench_signature_archetype_has(&archetypes[a], query->required[t]);
+        }
+        for (u32 t = 0; t < query->excludedCount && match; ++t) {
+            match = !bench_signature_archetype_has(&archetypes[a], query->excluded[t]);
+        }
+        found += match;
+    }
+    return found;
+}
+
+/**
+ * @brief Baseline: counts the entities matching a query by probing each
+ * term's sparse page.
+ *
+ * @param ecs A pointer to the ECS.
+ * @param count The number of entity indices.
+ * @param query A pointer to the query.
+ * @return u64 The number of matches.
+ */
+static u64 bench_signature_count_probes(const ECSManager *ecs, u32 count, const BenchSignatureQuery *query) {
+    u64 found = 0;
+    for (u32 index = 0; index < count; ++index) {
+        b8 match = true;
+        for (u32 t = 0; t < query->requiredCount && match; ++t) {
+            match = bench_signature_sparse_has(&ecs->componentArrays[query->required[t]], index);
+        }
+        for (u32 t = 0; t < query->excludedCount && match; ++t) {
+            match = !bench_signature_sparse_has(&ecs->componentArrays[query->excluded[t]], index);
+        }
+        found += match;
+    }
+    return found;
+}
+
+/**
+ * @brief Baseline: counts the signatures matching a query, comparing one
+ * 64-bit word at a time and stopping at the first mismatch.
+ *
+ * @param signatures The signatures.
+ * @param count The number of signatures.
+ * @param query A pointer to the query.
+ * @return u64 The number of matches.
+ */
+static u64 bench_signature_count_words(const EcsSignature *signatures, u32 count, const BenchSignatureQuery *query) {
+    u64 found = 0;
+    for (u32 i = 0; i < count; ++i) {
+        b8 match = true;
+        for (u32 word = 0; word < ECS_SIGNATURE_WORDS && match; ++word) {
+            match = !(query->requiredMask.bits[word] & ~signatures[i].bits[word]) && !(query->excludedMask.bits[word] & signatures[i].bits[word]);
+        }
+        found += match;
+    }
+    return found;
+}
+
+/**
+ * @brief Counts the signatures matching a query with ecs_signature_matches.
+ *
+ * @param signatures The signatures.
+ * @param count The number of signatures.
+ * @param query A pointer to the query.
+ * @return u64 The number of matches.
+ */
+static u64 bench_signature_count_vector(const EcsSignature *signatures, u32 count, const BenchSignatureQuery *query) {
+    u64 found = 0;
+    for (u32 i = 0; i < count; ++i) {
+        found += ecs_signature_matches(&signatures[i], &query->requiredMask, &query->excludedMask);
+    }
+    return found;
+}
+
+/**
+ * @brief Prints one row: time per pass, matches per second and speedup over
+ * the first method.
+ *
+ * @param label The method's name.
+ * @param seconds Seconds per pass.
+ * @param tests Signature tests per pass.
+ * @param matches Matches found per pass.
+ * @param baseline Seconds per pass of the first method.
+ * @return void
+ */
+static void bench_signature_row(const char *label, f64 seconds, u64 tests, u64 matches, f64 baseline) {
+    printf("%-22s %10.3f %12.1f %10llu %9.2fx\n", label, seconds * 1e3, tests / seconds / 1e6, (unsigned long long)matches, baseline / seconds);
+}
+
+/**
+ * @brief Matches BENCH_SIGNATURE_ARCHETYPE_COUNT archetypes of 3 to 10 types
+ * against BENCH_SIGNATURE_QUERY_COUNT queries by per-term lookups, by a
+ * word-at-a-time compare and by ecs_signature_matches.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @return void
+ */
+static void bench_signature_archetypes(MemoryPool *pool) {
+    BenchSignatureArchetype *archetypes = (BenchSignatureArchetype *)memory_allocate(pool, sizeof(BenchSignatureArchetype) * BENCH_SIGNATURE_ARCHETYPE_COUNT, MEMORY_TAG_ECS);
+    EcsSignature *signatures = (EcsSignature *)memory_allocate(pool, sizeof(EcsSignature) * BENCH_SIGNATURE_ARCHETYPE_COUNT, MEMORY_TAG_ECS);
+    BenchSignatureQuery *queries = (BenchSignatureQuery *)memory_allocate(pool, sizeof(BenchSignatureQuery) * BENCH_SIGNATURE_QUERY_COUNT, MEMORY_TAG_ECS);
+    if (!archetypes || !signatures || !queries) {
+        log_error("Failed to allocate the archetype benchmark.");
+        return;
+    }
+
+    u32 seed = 0x2545F491u;
+    for (u32 i = 0; i < BENCH_SIGNATURE_ARCHETYPE_COUNT; ++i) {
+        BenchSignatureArchetype *archetype = &archetypes[i];
+        EcsSignature *signature = &signatures[i];
+        *signature = (EcsSignature){0};
+        u32 typeCount = 3 + bench_signature_random(&seed) % 8;
+        for (u32 t = 0; t < typeCount; ++t) {
+            ecs_signature_set(signature, bench_signature_random(&seed) % BENCH_SIGNATURE_TYPE_COUNT);
+        }
+        archetype->typeCount = 0;
+        for (ComponentType type = 0; type < BENCH_SIGNATURE_TYPE_COUNT; ++type) {
+            if (ecs_signature_has(signature, type)) {
+                archetype->types[archetype->typeCount++] = type;
+            }
+        }
+    }
+    for (u32 i = 0; i < BENCH_SIGNATURE_QUERY_COUNT; ++i) {
+        bench_signature_make_query(&queries[i], BENCH_SIGNATURE_TYPE_COUNT, &seed);
+    }
+
+    u64 tests = (u64)BENCH_SIGNATURE_ARCHETYPE_COUNT * BENCH_SIGNATURE_QUERY_COUNT;
+    f64 seconds[3];
+    u64 matches[3] = {0, 0, 0};
+    for (u32 method = 0; method < 3; ++method) {
+        f64 start = bench_now();
+        for (u32 repeat = 0; repeat < BENCH_SIGNATURE_REPEATS; ++repeat) {
+            u64 found = 0;
+            for (u32 q = 0; q < BENCH_SIGNATURE_QUERY_COUNT; ++q) {
+                if (method == 0) {
+                    found += bench_signature_count_search(archetypes, BENCH_SIGNATURE_ARCHETYPE_COUNT, &queries[q]);
+                } else if (method == 1) {
+                    found += bench_signature_count_words(signatures, BENCH_SIGNATURE_ARCHETYPE_COUNT, &queries[q]);
+                } else {
+                    found += bench_signature_count_vector(signatures, BENCH_SIGNATURE_ARCHETYPE_COUNT, &queries[q]);
+                }
+            }
+            matches[method] = found;
+        }
+        seconds[method] = (bench_now() - start) / BENCH_SIGNATURE_REPEATS;
+    }
+
+    printf("%u archetypes of 3-10 of %u types x %u queries (2-4 required, 0-2 excluded)\n", BENCH_SIGNATURE_ARCHETYPE_COUNT, BENCH_SIGNATURE_TYPE_COUNT, BENCH_SIGNATURE_QUERY_COUNT);
+    printf("%-22s %10s %12s %10s %10s\n", "method", "ms/pass", "M tests/s", "matches", "speedup");
+    bench_signature_row("per-term search", seconds[0], tests, matches[0], seconds[0]);
+    bench_signature_row("scalar words", seconds[1], tests, matches[1], seconds[0]);
+    bench_signature_row("signature (" ECS_SIGNATURE_SIMD ")", seconds[2], tests, matches[2], seconds[0]);
+    if (matches[0] != matches[1] || matches[0] != matches[2]) {
+        log_error("Archetype matching methods disagree: %llu, %llu, %llu.", (unsigned long long)matches[0], (unsigned long long)matches[1], (unsigned long long)matches[2]);
+    }
+
+    memory_free(pool, queries, MEMORY_TAG_ECS);
+    memory_free(pool, signatures, MEMORY_TAG_ECS);
+    memory_free(pool, archetypes, MEMORY_TAG_ECS);
+}
+
+/**
+ * @brief Matches BENCH_SIGNATURE_ENTITY_COUNT sparse-set entities with random
+ * sets of BENCH_SIGNATURE_ENTITY_TYPES types against
+ * BENCH_SIGNATURE_ENTITY_QUERIES queries by probing each term's sparse page,
+ * by a word-at-a-time compare and by ecs_signature_matches on the entity
+ * signatures.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @return void
+ */
+static void bench_signature_entities(MemoryPool *pool) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS.");
+        return;
+    }
+
+    ComponentType types[BENCH_SIGNATURE_ENTITY_TYPES];
+    for (u32 t = 0; t < BENCH_SIGNATURE_ENTITY_TYPES; ++t) {
+        types[t] = ecs_register_component(&ecs, sizeof(u32));
+    }
+
+    // Each entity has each type with probability 1/2.
+    u32 seed = 0x9E3779B9u;
+    for (u32 i = 0; i < BENCH_SIGNATURE_ENTITY_COUNT; ++i) {
+        Entity entity = ecs_create_entity(&ecs);
+        u32 bits = bench_signature_random(&seed);
+        for (u32 t = 0; t < BENCH_SIGNATURE_ENTITY_TYPES; ++t) {
+            if (bits & (1u << t)) {
+                ecs_add_component(&ecs, entity, types[t], NULL);
+            }
+        }
+    }
+
+    BenchSignatureQuery queries[BENCH_SIGNATURE_ENTITY_QUERIES];
+    for (u32 q = 0; q < BENCH_SIGNATURE_ENTITY_QUERIES; ++q) {
+        bench_signature_make_query(&queries[q], BENCH_SIGNATURE_ENTITY_TYPES, &seed);
+        BenchSignatureQuery *query = &queries[q];
+        query->requiredMask = (EcsSignature){0};
+        query->excludedMask = (EcsSignature){0};
+        for (u32 t = 0; t < query->requiredCount; ++t) {
+            query->required[t] = types[query->required[t]];
+            ecs_signature_set(&query->requiredMask, query->required[t]);
+        }
+        for (u32 t = 0; t < query->excludedCount; ++t) {
+            query->excluded[t] = types[query->excluded[t]];
+            ecs_signature_set(&query->excludedMask, query->excluded[t]);
+        }
+    }
+
+    u32 entityCount = ecs.entityManager.nextIndex;
+    u64 tests = (u64)entityCount * BENCH_SIGNATURE_ENTITY_QUERIES;
+    f64 seconds[3];
+    u64 matches[3] = {0, 0, 0};
+    for (u32 method = 0; method < 3; ++method) {
+        f64 start = bench_now();
+        for (u32 repeat = 0; repeat < BENCH_SIGNATURE_REPEATS; ++repeat) {
+            u64 found = 0;
+            for (u32 q = 0; q < BENCH_SIGNATURE_ENTITY_QUERIES; ++q) {
+                if (method == 0) {
+                    found += bench_signature_count_probes(&ecs, entityCount, &queries[q]);
+                } else if (method == 1) {
+                    found += bench_signature_count_words(ecs.signatures, entityCount, &queries[q]);
+                } else {
+                    found += bench_signature_count_vector(ecs.signatures, entityCount, &queries[q]);
+                }
+            }
+            matches[method] = found;
+        }
+        seconds[method] = (bench_now() - start) / BENCH_SIGNATURE_REPEATS;
+    }
+
+    printf("%u sparse-set entities with random sets of %u types x %u queries\n", entityCount, BENCH_SIGNATURE_ENTITY_TYPES, BENCH_SIGNATURE_ENTITY_QUERIES);
+    printf("%-22s %10s %12s %10s %10s\n", "method", "ms/pass", "M tests/s", "matches", "speedup");
+    bench_signature_row("sparse page probes", seconds[0], tests, matches[0], seconds[0]);
+    bench_signature_row("scalar words", seconds[1], tests, matches[1], seconds[0]);
+    bench_signature_row("signature (" ECS_SIGNATURE_SIMD ")", seconds[2], tests, matches[2], seconds[0]);
+    if (matches[0] != matches[1] || matches[0] != matches[2]) {
+        log_error("Entity matching methods disagree: %llu, %llu, %llu.", (unsigned long long)matches[0], (unsigned long long)matches[1], (unsigned long long)matches[2]);
+    }
+
+    ecs_shutdown(&ecs);
+}
+
+void bench_signatures(MemoryPool *pool) {
+    bench_signature_archetypes(pool);
+    printf("\n");
+    bench_signature_entities(pool);
+}
@@ -0,0 +1,122 @@
+#include "benchmarks.h"
+#include <engine/components/position.h>
+#include <engine/components/velocity.h>
+#include <engine/ecs/ecs.h>
+#include <engine/logging.h>
+#include <stdio.h>
+
+#define BENCH_SNAPSHOT_ENTITY_COUNT (100 * 1000)
+#define BENCH_SNAPSHOT_REPEATS 50
+
+/** @brief Bench-local component on every other entity. */
+typedef struct BenchSnapshotHealth {
+    f32 value; /**< The current health. */
+    f32 max;   /**< The maximum health. */
+} BenchSnapshotHealth;
+
+/**
+ * @brief Builds a world of BENCH_SNAPSHOT_ENTITY_COUNT entities with Position
+ * and Velocity, every other one with Health, and destroys every tenth.
+ *
+ * @param ecs A pointer to the initialized ECS.
+ * @param healthType The Health component type.
+ * @return void
+ */
+static void bench_snapshot_build(ECSManager *ecs, ComponentType healthType) {
+    for (u32 i = 0; i < BENCH_SNAPSHOT_ENTITY_COUNT; ++i) {
+        Entity entity = ecs_create_entity(ecs);
+        ecs_add_component(ecs, entity, ECS_ID(Position), &(Position){(f32)i, 0.0f, 0.0f});
+        ecs_add_component(ecs, entity, ECS_ID(Velocity), &(Velocity){1.0f, 0.0f, 0.0f});
+        if (i % 2 == 0) {
+            ecs_add_component(ecs, entity, healthType, &(BenchSnapshotHealth){100.0f, 100.0f});
+        }
+        if (i % 10 == 9) {
+            ecs_destroy_entity(ecs, entity);
+        }
+    }
+}
+
+/**
+ * @brief Times snapshots of the world, restores of it into the same ECS after
+ * a frame of changes (rollback), and loads into a fresh ECS, and prints one
+ * row.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param storage The storage layout.
+ * @return void
+ */
+static void bench_snapshot_row(MemoryPool *pool, ECSStorage storage) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS.");
+        return;
+    }
+    ComponentType healthType = ecs_register_component(&ecs, sizeof(BenchSnapshotHealth));
+    bench_snapshot_build(&ecs, healthType);
+
+    u64 size = ecs_snapshot_size(&ecs);
+    void *snapshot = memory_allocate(pool, size, MEMORY_TAG_ECS);
+    if (!snapshot) {
+        log_error("Failed to allocate a %llu-byte snapshot.", (unsigned long long)size);
+        ecs_shutdown(&ecs);
+        return;
+    }
+
+    f64 start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_SNAPSHOT_REPEATS; ++repeat) {
+        ecs_snapshot(&ecs, snapshot, size);
+    }
+    f64 write = (bench_now() - start) / BENCH_SNAPSHOT_REPEATS;
+
+    // Each rollback undoes a frame that moved everything and spawned a few entities.
+    f64 restore = 0.0;
+    for (u32 repeat = 0; repeat < BENCH_SNAPSHOT_REPEATS; ++repeat) {
+        Position *positions = (Position *)ecs_component_data(&ecs, ECS_ID(Position));
+        if (storage == ECS_STORAGE_SPARSE_SET) {
+            for (u32 i = 0; i < ecs_component_count(&ecs, ECS_ID(Position)); ++i) {
+                positions[i].x += 1.0f;
+            }
+        }
+        for (u32 i = 0; i < 64; ++i) {
+            ecs_add_component(&ecs, ecs_create_entity(&ecs), ECS_ID(Position), NULL);
+        }
+        start = bench_now();
+        if (ecs_restore(&ecs, snapshot, size) != ENGINE_SUCCESS) {
+            log_error("Failed to restore the snapshot.");
+        }
+        restore += bench_now() - start;
+    }
+    restore /= BENCH_SNAPSHOT_REPEATS;
+    u32 entityCount = ecs_component_count(&ecs, ECS_ID(Position));
+    ecs_shutdown(&ecs);
+
+    // Loading allocates all storage in a fresh ECS.
+    f64 load = 0.0;
+    for (u32 repeat = 0; repeat < BENCH_SNAPSHOT_REPEATS / 10; ++repeat) {
+        if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+            log_error("Failed to initialize the ECS.");
+            break;
+        }
+        ecs_register_component(&ecs, sizeof(BenchSnapshotHealth));
+        start = bench_now();
+        if (ecs_restore(&ecs, snapshot, size) != ENGINE_SUCCESS) {
+            log_error("Failed to load the snapshot.");
+        }
+        load += bench_now() - start;
+        ecs_shutdown(&ecs);
+    }
+    load /= BENCH_SNAPSHOT_REPEATS / 10;
+    memory_free(pool, snapshot, MEMORY_TAG_ECS);
+
+    printf("%-11s %10u %12.2f %12.3f %12.3f %12.3f %10.2f\n", storage == ECS_STORAGE_ARCHETYPE ? "archetype" : "sparse set", entityCount, size / (1024.0 * 1024.0), write * 1e3, restore * 1e3, load * 1e3,
+           size / write / (1024.0 * 1024.0 * 1024.0));
+}
+
+void bench_snapshots(MemoryPool *pool) {
+    printf("%u entities with Position and Velocity, half with Health, 1 in 10 destroyed\n", BENCH_SNAPSHOT_ENTITY_COUNT);
+    printf("%-11s %10s %12s %12s %12s %12s %10s\n", "storage", "entities", "size MB", "snapshot ms", "rollback ms", "load ms", "GB/s");
+    bench_snapshot_row(pool, ECS_STORAGE_SPARSE_SET);
+    bench_snapshot_row(pool, ECS_STORAGE_ARCHETYPE);
+}
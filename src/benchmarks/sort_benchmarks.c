@@ -0,0 +1,118 @@
+#include "benchmarks.h"
+#include <engine/ecs/ecs.h>
+#include <engine/logging.h>
+#include <stdio.h>
+
+#define BENCH_SORT_SPRITE_COUNT (100 * 1000)
+#define BENCH_SORT_FRAMES 20
+
+/** @brief Bench-local sprite, drawn in layer then texture order. */
+typedef struct BenchSortSprite {
+    u32 layer;   /**< Draw layer. */
+    u32 texture; /**< Texture handle, batched within a layer. */
+    f32 x;       /**< Screen position. */
+    f32 y;       /**< Screen position. */
+} BenchSortSprite;
+
+/**
+ * @brief Sorts sprites by layer, then texture.
+ *
+ * @param component A pointer to the sprite.
+ * @return u64 The sprite's key.
+ */
+static u64 bench_sort_key(const void *component) {
+    const BenchSortSprite *sprite = (const BenchSortSprite *)component;
+    return (u64)sprite->layer << 32 | sprite->texture;
+}
+
+/**
+ * @brief Advances a xorshift state and returns the next value.
+ *
+ * @param state A pointer to the generator state.
+ * @return u32 The next pseudo-random value.
+ */
+static u32 bench_sort_random(u32 *state) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Runs BENCH_SORT_FRAMES frames that each move a number of random
+ * sprites to a new texture, or to a new layer and texture, then sort. Prints
+ * the average sort time of each frame done incrementally and by sorting the
+ * array again from scratch.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param changes The number of sprites changed per frame.
+ * @param relayer Whether changed sprites also move to a random layer.
+ * @return void
+ */
+static void bench_sort_row(MemoryPool *pool, u32 changes, b8 relayer) {
+    f64 seconds[2] = {0.0, 0.0};
+    for (u32 mode = 0; mode < 2; ++mode) {
+        ECSManager ecs;
+        ECSConfig config = {0};
+        config.storage = ECS_STORAGE_SPARSE_SET;
+        if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+            log_error("Failed to initialize the ECS.");
+            return;
+        }
+
+        ComponentType spriteType = ecs_register_component(&ecs, sizeof(BenchSortSprite));
+        Entity *entities = (Entity *)memory_allocate(pool, sizeof(Entity) * BENCH_SORT_SPRITE_COUNT, MEMORY_TAG_ECS);
+        if (!entities || ecs_create_batch(&ecs, BENCH_SORT_SPRITE_COUNT, &spriteType, 1, NULL, entities) != ENGINE_SUCCESS) {
+            log_error("Failed to create %u sprites.", BENCH_SORT_SPRITE_COUNT);
+            if (entities) {
+                memory_free(pool, entities, MEMORY_TAG_ECS);
+            }
+            ecs_shutdown(&ecs);
+            return;
+        }
+
+        // 8 layers of 256 textures.
+        u32 seed = 0x2545F491u;
+        BenchSortSprite *sprites = (BenchSortSprite *)ecs_component_data(&ecs, spriteType);
+        for (u32 i = 0; i < BENCH_SORT_SPRITE_COUNT; ++i) {
+            sprites[i] = (BenchSortSprite){bench_sort_random(&seed) % 8, bench_sort_random(&seed) % 256, (f32)i, 0.0f};
+        }
+        ecs_sort_by(&ecs, spriteType, bench_sort_key);
+
+        for (u32 frame = 0; frame < BENCH_SORT_FRAMES; ++frame) {
+            for (u32 i = 0; i < changes; ++i) {
+                BenchSortSprite *sprite = (BenchSortSprite *)ecs_get_component(&ecs, entities[bench_sort_random(&seed) % BENCH_SORT_SPRITE_COUNT], spriteType);
+                sprite->texture = bench_sort_random(&seed) % 256;
+                sprite->layer = relayer ? bench_sort_random(&seed) % 8 : sprite->layer;
+            }
+
+            f64 start = bench_now();
+            if (mode == 1) {
+                ecs_sort_by(&ecs, spriteType, NULL);
+            }
+            if ((mode == 0 ? ecs_sort(&ecs, spriteType) : ecs_sort_by(&ecs, spriteType, bench_sort_key)) != ENGINE_SUCCESS) {
+                log_error("Failed to sort the sprites.");
+            }
+            seconds[mode] += bench_now() - start;
+        }
+
+        memory_free(pool, entities, MEMORY_TAG_ECS);
+        ecs_shutdown(&ecs);
+    }
+
+    printf("%10u %-9s %12.3f %12.3f %9.2fx\n", changes, relayer ? "layer" : "texture", seconds[0] / BENCH_SORT_FRAMES * 1e3, seconds[1] / BENCH_SORT_FRAMES * 1e3, seconds[1] / seconds[0]);
+}
+
+void bench_sorting(MemoryPool *pool) {
+    printf("%u sprites sorted by (layer, texture), %u frames of random changes\n", BENCH_SORT_SPRITE_COUNT, BENCH_SORT_FRAMES);
+    printf("%10s %-9s %12s %12s %10s\n", "changes", "moved by", "kept ms", "re-sort ms", "speedup");
+    const u32 changes[] = {1, 10, 100, 1000, 10000};
+    for (u32 i = 0; i < sizeof(changes) / sizeof(changes[0]); ++i) {
+        bench_sort_row(pool, changes[i], false);
+    }
+    for (u32 i = 0; i < sizeof(changes) / sizeof(changes[0]); ++i) {
+        bench_sort_row(pool, changes[i], true);
+    }
+}
@@ -0,0 +1,274 @@
+#include "benchmarks.h"
+#include <engine/components/position.h>
+#include <engine/components/velocity.h>
+#include <engine/ecs/command_buffer.h>
+#include <engine/ecs/ecs.h>
+#include <engine/ecs/system.h>
+#include <engine/job_system.h>
+#include <engine/logging.h>
+#include <stdio.h>
+
+#define BENCH_SYSTEM_ENTITY_COUNT (1000 * 1000)
+#define BENCH_SYSTEM_REPEATS 10
+#define BENCH_SYSTEM_DELTA_TIME (1.0f / 60.0f)
+#define BENCH_SYSTEM_COUNT 5
+#define BENCH_COMMAND_COUNT (256 * 1024)
+
+/** @brief Bench-local spin component. */
+typedef struct BenchSpin {
+    f32 angle; /**< The current angle in radians. */
+    f32 rate;  /**< Radians per second. */
+} BenchSpin;
+
+/** @brief Bench-local lifetime component. */
+typedef struct BenchLifetime {
+    f32 age;      /**< Seconds alive. */
+    f32 lifespan; /**< Seconds until the entity expires. */
+} BenchLifetime;
+
+/**
+ * @brief Shared state of the benchmark systems.
+ */
+typedef struct BenchSystemState {
+    PlatformAtomicI32 outOfBounds; /**< Entities the bounds system found past the limit. */
+} BenchSystemState;
+
+static void move_system(const EcsView *view, const EcsSystemContext *context) {
+    Position *positions = (Position *)view->columns[0];
+    const Velocity *velocities = (const Velocity *)view->columns[1];
+    for (u32 i = 0; i < view->count; ++i) {
+        positions[i].x += velocities[i].vx * context->deltaTime;
+        positions[i].y += velocities[i].vy * context->deltaTime;
+        positions[i].z += velocities[i].vz * context->deltaTime;
+    }
+}
+
+static void spin_system(const EcsView *view, const EcsSystemContext *context) {
+    BenchSpin *spins = (BenchSpin *)view->columns[0];
+    for (u32 i = 0; i < view->count; ++i) {
+        spins[i].angle += spins[i].rate * context->deltaTime;
+    }
+}
+
+static void age_system(const EcsView *view, const EcsSystemContext *context) {
+    BenchLifetime *lifetimes = (BenchLifetime *)view->columns[0];
+    for (u32 i = 0; i < view->count; ++i) {
+        lifetimes[i].age += context->deltaTime;
+    }
+}
+
+static void damp_system(const EcsView *view, const EcsSystemContext *context) {
+    (void)context;
+    Velocity *velocities = (Velocity *)view->columns[0];
+    for (u32 i = 0; i < view->count; ++i) {
+        velocities[i].vx *= 0.99f;
+        velocities[i].vy *= 0.99f;
+        velocities[i].vz *= 0.99f;
+    }
+}
+
+static void bounds_system(const EcsView *view, const EcsSystemContext *context) {
+    BenchSystemState *state = (BenchSystemState *)context->userData;
+    const Position *positions = (const Position *)view->columns[0];
+    i32 outside = 0;
+    for (u32 i = 0; i < view->count; ++i) {
+        outside += positions[i].x > 1e6f || positions[i].y > 1e6f || positions[i].z > 1e6f;
+    }
+    platform_atomic_fetch_add_i32(&state->outOfBounds, outside);
+}
+
+/**
+ * @brief Adapts a system callback to ecs_query_each for the serial baseline.
+ */
+typedef struct BenchSerialCall {
+    EcsSystemEachFunc each;          /**< The system callback. */
+    const EcsSystemContext *context; /**< The context to pass it. */
+} BenchSerialCall;
+
+static void serial_view(const EcsView *view, void *userData) {
+    const BenchSerialCall *call = (const BenchSerialCall *)userData;
+    call->each(view, call->context);
+}
+
+/**
+ * @brief Advances a xorshift state and returns the next value.
+ *
+ * @param state A pointer to the generator state.
+ * @return u32 The next pseudo-random value.
+ */
+static u32 bench_command_random(u32 *state) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Adds then removes a component on entities visited in random order,
+ * once immediately and once through a command queue, and prints both.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param storage The storage layout to benchmark.
+ * @return void
+ */
+static void bench_system_commands(MemoryPool *pool, ECSStorage storage) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS.");
+        return;
+    }
+
+    ComponentType position = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocity = ecs_register_component(&ecs, sizeof(Velocity));
+    for (u32 i = 0; i < BENCH_COMMAND_COUNT; ++i) {
+        ecs_add_component(&ecs, ecs_create_entity(&ecs), position, NULL);
+    }
+
+    Entity *order = (Entity *)memory_allocate(pool, sizeof(Entity) * BENCH_COMMAND_COUNT, MEMORY_TAG_ECS);
+    u32 seed = 0x1234567u;
+    for (u32 i = 0; i < BENCH_COMMAND_COUNT; ++i) {
+        order[i] = ecs_entity_make(i, 0);
+    }
+    for (u32 i = BENCH_COMMAND_COUNT - 1; i > 0; --i) {
+        u32 j = bench_command_random(&seed) % (i + 1);
+        Entity swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+
+    Velocity initial = {1.0f, 0.0f, 0.0f};
+    f64 start = bench_now();
+    for (u32 i = 0; i < BENCH_COMMAND_COUNT; ++i) {
+        ecs_add_component(&ecs, order[i], velocity, &initial);
+    }
+    for (u32 i = 0; i < BENCH_COMMAND_COUNT; ++i) {
+        ecs_remove_component(&ecs, order[i], velocity);
+    }
+    f64 immediate = bench_now() - start;
+
+    EcsCommandQueue queue;
+    ecs_command_queue_init(&queue, &ecs);
+    EcsCommandBuffer *buffer = ecs_command_queue_get_buffer(&queue);
+    f64 record = 0.0;
+    start = bench_now();
+    for (u32 pass = 0; pass < 2; ++pass) {
+        f64 recordStart = bench_now();
+        for (u32 i = 0; i < BENCH_COMMAND_COUNT; ++i) {
+            if (pass == 0) {
+                ecs_command_add_component(buffer, 0, order[i], velocity, &initial);
+            } else {
+                ecs_command_remove_component(buffer, 0, order[i], velocity);
+            }
+        }
+        record += bench_now() - recordStart;
+        ecs_command_queue_flush(&queue);
+    }
+    f64 deferred = bench_now() - start;
+
+    printf("%-11s %14.2f %14.2f %14.2f\n", storage == ECS_STORAGE_ARCHETYPE ? "archetype" : "sparse set", immediate * 1e9 / (2 * BENCH_COMMAND_COUNT),
+           deferred * 1e9 / (2 * BENCH_COMMAND_COUNT), record * 1e9 / (2 * BENCH_COMMAND_COUNT));
+
+    ecs_command_queue_shutdown(&queue);
+    memory_free(pool, order, MEMORY_TAG_ECS);
+    ecs_shutdown(&ecs);
+}
+
+void bench_systems(MemoryPool *pool) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = ECS_STORAGE_ARCHETYPE;
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS.");
+        return;
+    }
+
+    ComponentType position = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocity = ecs_register_component(&ecs, sizeof(Velocity));
+    ComponentType spin = ecs_register_component(&ecs, sizeof(BenchSpin));
+    ComponentType lifetime = ecs_register_component(&ecs, sizeof(BenchLifetime));
+    for (u32 i = 0; i < BENCH_SYSTEM_ENTITY_COUNT; ++i) {
+        Entity entity = ecs_create_entity(&ecs);
+        ecs_add_component(&ecs, entity, position, &(Position){(f32)i, 0.0f, 0.0f});
+        ecs_add_component(&ecs, entity, velocity, &(Velocity){1.0f, 0.0f, (f32)(i % 5)});
+        ecs_add_component(&ecs, entity, spin, &(BenchSpin){0.0f, (f32)(i % 7)});
+        ecs_add_component(&ecs, entity, lifetime, &(BenchLifetime){0.0f, 60.0f});
+    }
+
+    // Move, Spin and Age touch disjoint types and start together. Damp writes
+    // what Move reads and Bounds reads what Move writes, so both follow Move.
+    ComponentType moving[] = {position, velocity};
+    EcsQuery queries[BENCH_SYSTEM_COUNT];
+    ecs_query_init(&queries[0], &ecs, &(EcsQueryDesc){.required = moving, .requiredCount = 2});
+    ecs_query_init(&queries[1], &ecs, &(EcsQueryDesc){.required = &spin, .requiredCount = 1});
+    ecs_query_init(&queries[2], &ecs, &(EcsQueryDesc){.required = &lifetime, .requiredCount = 1});
+    ecs_query_init(&queries[3], &ecs, &(EcsQueryDesc){.required = &velocity, .requiredCount = 1});
+    ecs_query_init(&queries[4], &ecs, &(EcsQueryDesc){.required = &position, .requiredCount = 1});
+
+    BenchSystemState state = {0};
+    const EcsSystemDesc descs[BENCH_SYSTEM_COUNT] = {
+        {.name = "BenchMove", .reads = &velocity, .readCount = 1, .writes = &position, .writeCount = 1, .query = &queries[0], .each = move_system},
+        {.name = "BenchSpin", .writes = &spin, .writeCount = 1, .query = &queries[1], .each = spin_system},
+        {.name = "BenchAge", .writes = &lifetime, .writeCount = 1, .query = &queries[2], .each = age_system},
+        {.name = "BenchDamp", .writes = &velocity, .writeCount = 1, .query = &queries[3], .each = damp_system},
+        {.name = "BenchBounds", .reads = &position, .readCount = 1, .query = &queries[4], .each = bounds_system, .userData = &state},
+    };
+
+    // Serial baseline: every system in registration order on one thread.
+    f64 start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_SYSTEM_REPEATS; ++repeat) {
+        for (u32 i = 0; i < BENCH_SYSTEM_COUNT; ++i) {
+            EcsSystemContext context = {&ecs, BENCH_SYSTEM_DELTA_TIME, descs[i].userData, NULL, 0};
+            BenchSerialCall call = {descs[i].each, &context};
+            ecs_query_each(descs[i].query, serial_view, &call);
+        }
+    }
+    f64 serial = (bench_now() - start) / BENCH_SYSTEM_REPEATS;
+    printf("%u entities, %u systems, serial: %.3f ms per frame\n", BENCH_SYSTEM_ENTITY_COUNT, BENCH_SYSTEM_COUNT, serial * 1000.0);
+
+    printf("%-8s %12s %10s %12s %12s %14s\n", "workers", "frame (ms)", "speedup", "work (ms)", "parallelism", "critical (ms)");
+    u32 maxWorkers = platform_get_processor_count();
+    for (u32 workers = 1; workers <= maxWorkers; ++workers) {
+        JobSystemConfig jobConfig = {0};
+        jobConfig.workerCount = workers;
+        if (job_system_init(pool, &jobConfig) != ENGINE_SUCCESS) {
+            log_error("Failed to initialize job system with %u workers.", workers);
+            break;
+        }
+
+        EcsScheduler *scheduler = (EcsScheduler *)memory_allocate(pool, sizeof(EcsScheduler), MEMORY_TAG_ECS);
+        ecs_scheduler_init(scheduler, &ecs);
+        for (u32 i = 0; i < BENCH_SYSTEM_COUNT; ++i) {
+            ecs_scheduler_add_system(scheduler, &descs[i]);
+        }
+
+        f64 work = 0.0;
+        f64 parallelism = 0.0;
+        f64 critical = 0.0;
+        start = bench_now();
+        for (u32 repeat = 0; repeat < BENCH_SYSTEM_REPEATS; ++repeat) {
+            ecs_scheduler_run(scheduler, BENCH_SYSTEM_DELTA_TIME);
+            work += scheduler->lastWorkSeconds;
+            parallelism += ecs_scheduler_parallelism(scheduler);
+            critical += scheduler->lastCriticalPathSeconds;
+        }
+        f64 frame = (bench_now() - start) / BENCH_SYSTEM_REPEATS;
+        printf("%-8u %12.3f %9.2fx %12.3f %12.2f %14.3f\n", workers, frame * 1000.0, serial / frame, work * 1000.0 / BENCH_SYSTEM_REPEATS,
+               parallelism / BENCH_SYSTEM_REPEATS, critical * 1000.0 / BENCH_SYSTEM_REPEATS);
+
+        memory_free(pool, scheduler, MEMORY_TAG_ECS);
+        job_system_shutdown();
+    }
+
+    for (u32 i = 0; i < BENCH_SYSTEM_COUNT; ++i) {
+        ecs_query_destroy(&queries[i]);
+    }
+    ecs_shutdown(&ecs);
+    printf("\n%u adds then removes in random entity order, ns per operation\n", BENCH_COMMAND_COUNT);
+    printf("%-11s %14s %14s %14s\n", "storage", "immediate", "deferred", "of which record");
+    bench_system_commands(pool, ECS_STORAGE_SPARSE_SET);
+    bench_system_commands(pool, ECS_STORAGE_ARCHETYPE);
+}
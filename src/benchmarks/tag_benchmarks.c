@@ -0,0 +1,125 @@
+#include "benchmarks.h"
+#include <engine/components/position.h>
+#include <engine/components/velocity.h>
+#include <engine/ecs/ecs.h>
+#include <engine/logging.h>
+#include <stdio.h>
+
+#define BENCH_TAG_ENTITY_COUNT (100 * 1000)
+#define BENCH_TAG_MARKER_COUNT 8
+#define BENCH_TAG_REPEATS 20
+
+/**
+ * @brief Advances a xorshift state and returns the next value.
+ *
+ * @param state A pointer to the generator state.
+ * @return u32 The next pseudo-random value.
+ */
+static u32 bench_tag_random(u32 *state) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Moves every view's positions by their velocities.
+ *
+ * @param view A pointer to the view.
+ * @param userData Unused.
+ * @return void
+ */
+static void bench_tag_move(const EcsView *view, void *userData) {
+    (void)userData;
+    Position *positions = (Position *)view->columns[0];
+    const Velocity *velocities = (const Velocity *)view->columns[1];
+    for (u32 i = 0; i < view->count; ++i) {
+        Position *position = &positions[ecs_view_row(view, 0, i)];
+        const Velocity *velocity = &velocities[ecs_view_row(view, 1, i)];
+        position->x += velocity->vx;
+        position->y += velocity->vy;
+    }
+}
+
+/**
+ * @brief Builds a scene of BENCH_TAG_ENTITY_COUNT moving entities, each with
+ * every one of BENCH_TAG_MARKER_COUNT markers at probability 1/2, registered
+ * either as one-byte components or as tags. Prints the scene's memory, the
+ * time to build it and the time of a query pass over enemies that are not
+ * frozen.
+ *
+ * @param pool A pointer to the memory pool to allocate from.
+ * @param storage The storage layout.
+ * @param tags Whether the markers are tags.
+ * @return void
+ */
+static void bench_tag_scene(MemoryPool *pool, ECSStorage storage, b8 tags) {
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    if (ecs_init(&ecs, pool, &config) != ENGINE_SUCCESS) {
+        log_error("Failed to initialize the ECS.");
+        return;
+    }
+
+    ComponentType types[2 + BENCH_TAG_MARKER_COUNT] = {ECS_ID(Position), ECS_ID(Velocity)};
+    for (u32 m = 0; m < BENCH_TAG_MARKER_COUNT; ++m) {
+        types[2 + m] = tags ? ecs_register_tag(&ecs) : ecs_register_component(&ecs, 1);
+    }
+
+    f64 start = bench_now();
+    u32 seed = 0x2545F491u;
+    for (u32 i = 0; i < BENCH_TAG_ENTITY_COUNT; ++i) {
+        ComponentType entityTypes[2 + BENCH_TAG_MARKER_COUNT] = {types[0], types[1]};
+        u32 typeCount = 2;
+        u32 bits = bench_tag_random(&seed);
+        for (u32 m = 0; m < BENCH_TAG_MARKER_COUNT; ++m) {
+            if (bits & (1u << m)) {
+                entityTypes[typeCount++] = types[2 + m];
+            }
+        }
+        Entity entity;
+        const void *initData[2 + BENCH_TAG_MARKER_COUNT] = {&(Position){(f32)i, 0.0f, 0.0f}, &(Velocity){1.0f, 1.0f, 0.0f}};
+        if (ecs_create_batch(&ecs, 1, entityTypes, typeCount, initData, &entity) != ENGINE_SUCCESS) {
+            log_error("Failed to create entity %u.", i);
+            break;
+        }
+    }
+    f64 build = bench_now() - start;
+
+    // Enemies (marker 0) that are not frozen (marker 1).
+    EcsQuery query;
+    EcsQueryDesc desc = {0};
+    ComponentType required[] = {types[0], types[1], types[2]};
+    desc.required = required;
+    desc.requiredCount = 3;
+    desc.excluded = &types[3];
+    desc.excludedCount = 1;
+    if (ecs_query_init(&query, &ecs, &desc) != ENGINE_SUCCESS) {
+        log_error("Failed to create the tag query.");
+        ecs_shutdown(&ecs);
+        return;
+    }
+    u32 matched = ecs_query_count(&query);
+    start = bench_now();
+    for (u32 repeat = 0; repeat < BENCH_TAG_REPEATS; ++repeat) {
+        ecs_query_each(&query, bench_tag_move, NULL);
+    }
+    f64 pass = (bench_now() - start) / BENCH_TAG_REPEATS;
+
+    printf("%-11s %-8s %12.2f %12.2f %12.2f %10u\n", storage == ECS_STORAGE_ARCHETYPE ? "archetype" : "sparse set", tags ? "tags" : "bytes", ecs_memory_usage(&ecs) / (1024.0 * 1024.0), build * 1e3, pass * 1e3,
+           matched);
+    ecs_query_destroy(&query);
+    ecs_shutdown(&ecs);
+}
+
+void bench_tags(MemoryPool *pool) {
+    printf("%u moving entities, each with each of %u markers at probability 1/2; query: enemy and not frozen\n", BENCH_TAG_ENTITY_COUNT, BENCH_TAG_MARKER_COUNT);
+    printf("%-11s %-8s %12s %12s %12s %10s\n", "storage", "markers", "memory MB", "build ms", "pass ms", "matched");
+    bench_tag_scene(pool, ECS_STORAGE_SPARSE_SET, false);
+    bench_tag_scene(pool, ECS_STORAGE_SPARSE_SET, true);
+    bench_tag_scene(pool, ECS_STORAGE_ARCHETYPE, false);
+    bench_tag_scene(pool, ECS_STORAGE_ARCHETYPE, true);
+}
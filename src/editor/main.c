@@ -12,8 +12,8 @@ void application_update(f32 deltaTime) {
     log_debug("Editor updating with deltaTime %.3f seconds.", deltaTime);
 }
 
-void application_render(void) {
-    log_debug("Editor rendering.");
+void application_render(f32 alpha) {
+    log_debug("Editor rendering with alpha %.3f.", alpha);
 }
 
 int main(void) {
@@ -39,6 +39,8 @@ int main(void) {
     appConfig.renderer = rendererConfig;
     appConfig.update = application_update;
     appConfig.render = application_render;
+    appConfig.redrawMode = APPLICATION_REDRAW_ON_DEMAND; // Don't spin a core while the editor sits idle.
+    appConfig.idleTimeoutMs = 500;                      // Still tick periodically for time-driven UI.
 
     // Initialize the engine.
     Engine engine = {0};
@@ -3,6 +3,7 @@
 #include "engine/logging.h"
 #include "engine/memory.h"
 #include "engine/platform.h"
+#include "engine/profiler.h"
 #include "engine/window.h"
 
 ENGINE_API EngineResult application_init(Engine *engine, const ApplicationConfig *config, Application *app) {
@@ -51,10 +52,66 @@ ENGINE_API EngineResult application_init(Engine *engine, const ApplicationConfig
     app->update = config->update;
     app->render = config->render;
 
+    // Store frame pacing settings.
+    app->redrawMode = config->redrawMode;
+    app->idleTimeoutMs = config->idleTimeoutMs;
+    app->continuousUpdateRequests = 0;
+    platform_atomic_store_i32(&app->redrawRequested, 1); // Always draw the first frame.
+
+    // Configure the fixed-timestep simulation.
+    u32 fixedUpdateRate = config->fixedUpdateRate ? config->fixedUpdateRate : APPLICATION_DEFAULT_FIXED_UPDATE_RATE;
+    app->fixedUpdate = config->fixedUpdate;
+    app->fixedDeltaTime = 1.0 / (f64)fixedUpdateRate;
+    app->fixedAccumulator = 0.0;
+    app->maxFixedStepsPerFrame = config->maxFixedStepsPerFrame ? config->maxFixedStepsPerFrame : APPLICATION_DEFAULT_MAX_FIXED_STEPS;
+    app->interpolationAlpha = 1.0f;
+
     log_info("Application initialized successfully.");
     return ENGINE_SUCCESS;
 }
 
+/**
+ * @brief Checks whether the run loop may sleep instead of producing a frame.
+ *
+ * @param app A pointer to the application structure.
+ * @return b8 True if the application is in on-demand mode with nothing to draw.
+ */
+static b8 application_is_idle(const Application *app) {
+    return app->redrawMode == APPLICATION_REDRAW_ON_DEMAND &&
+           app->continuousUpdateRequests == 0 &&
+           !platform_atomic_load_i32(&app->redrawRequested);
+}
+
+/**
+ * @brief Advances the fixed-timestep simulation by the given frame time.
+ *
+ * Runs whole fixed steps out of the accumulator, capped at
+ * maxFixedStepsPerFrame so a slow frame cannot trigger ever more catch-up work
+ * (the "spiral of death"). Time beyond the cap is dropped and the simulation
+ * runs slower than real time until the load recovers.
+ *
+ * @param app A pointer to the application structure.
+ * @param frameTime The real time elapsed since the previous frame in seconds.
+ * @return void
+ */
+static void application_step_fixed(Application *app, f64 frameTime) {
+    app->fixedAccumulator += frameTime;
+
+    u32 steps = 0;
+    while (app->fixedAccumulator >= app->fixedDeltaTime && steps < app->maxFixedStepsPerFrame) {
+        app->fixedUpdate((f32)app->fixedDeltaTime);
+        app->fixedAccumulator -= app->fixedDeltaTime;
+        steps++;
+    }
+
+    if (app->fixedAccumulator >= app->fixedDeltaTime) {
+        log_debug("Fixed update fell behind; dropping %.3f seconds of simulation time.", app->fixedAccumulator);
+        app->fixedAccumulator = 0.0;
+    }
+
+    app->interpolationAlpha = (f32)(app->fixedAccumulator / app->fixedDeltaTime);
+}
+
 ENGINE_API void application_run(Application *app) {
     if (!app) {
         log_error("Invalid application provided to application_run.");
@@ -63,24 +120,55 @@ ENGINE_API void application_run(Application *app) {
 
     log_info("Starting application run loop.");
 
+    f64 secondsPerTick = 1.0 / (f64)platform_get_performance_frequency();
+    u64 lastCounter = platform_get_performance_counter();
+
     while (platform_is_running(app->platform)) {
-        // Poll platform-specific events.
-        platform_poll_events(app->platform);
+        b8 slept = false;
+
+        if (application_is_idle(app)) {
+            // Nothing wants a frame; sleep until input, the idle timeout, or
+            // application_request_redraw wakes us.
+            platform_wait_events(app->platform, app->idleTimeoutMs);
+            slept = true;
+
+            if (!platform_is_running(app->platform)) {
+                break;
+            }
+        } else {
+            // Poll platform-specific events.
+            platform_poll_events(app->platform);
+        }
 
-        // Calculate deltaTime.
-        static u64 lastTime = 0;
-        u64 currentTime = platform_get_absolute_time(app->platform);
-        f32 deltaTime = (f32)(currentTime - lastTime) * 0.001f; // Convert to milliseconds.
-        lastTime = currentTime;
+        platform_atomic_store_i32(&app->redrawRequested, 0);
+
+        // Calculate deltaTime in seconds, clamped so a long stall (debugger,
+        // window drag) is not replayed as one huge step.
+        u64 currentCounter = platform_get_performance_counter();
+        f64 frameTime = (f64)(currentCounter - lastCounter) * secondsPerTick;
+        lastCounter = currentCounter;
+        if (frameTime > APPLICATION_MAX_FRAME_TIME) {
+            frameTime = APPLICATION_MAX_FRAME_TIME;
+        }
 
         // Update logic.
         if (app->update) {
-            app->update(deltaTime);
+            PROFILER_ZONE_BEGIN(updateZone, "Update");
+            app->update((f32)frameTime);
+            PROFILER_ZONE_END(updateZone);
+        }
+
+        // Fixed-timestep simulation.
+        if (app->fixedUpdate) {
+            PROFILER_ZONE_BEGIN(fixedUpdateZone, "FixedUpdate");
+            application_step_fixed(app, slept ? 0.0 : frameTime);
+            PROFILER_ZONE_END(fixedUpdateZone);
         }
 
         // Render.
+        PROFILER_ZONE_BEGIN(renderZone, "Render");
         if (app->render) {
-            app->render();
+            app->render(app->interpolationAlpha);
         }
 
         // Clear the renderer.
@@ -88,11 +176,60 @@ ENGINE_API void application_run(Application *app) {
 
         // Present the renderer.
         renderer_present(app->renderer, app->platform);
+        PROFILER_ZONE_END(renderZone);
+
+        PROFILER_FRAME_END();
     }
 
     log_info("Exiting application run loop.");
 }
 
+ENGINE_API f32 application_get_interpolation_alpha(const Application *app) {
+    if (!app) {
+        log_error("Invalid Application pointer provided to application_get_interpolation_alpha.");
+        return 1.0f;
+    }
+
+    return app->interpolationAlpha;
+}
+
+ENGINE_API void application_request_redraw(Application *app) {
+    if (!app) {
+        log_error("Invalid Application pointer provided to application_request_redraw.");
+        return;
+    }
+
+    if (app->redrawMode != APPLICATION_REDRAW_ON_DEMAND) {
+        return;
+    }
+
+    platform_atomic_store_i32(&app->redrawRequested, 1);
+    platform_wake(app->platform);
+}
+
+ENGINE_API void application_begin_continuous_updates(Application *app) {
+    if (!app) {
+        log_error("Invalid Application pointer provided to application_begin_continuous_updates.");
+        return;
+    }
+
+    app->continuousUpdateRequests++;
+}
+
+ENGINE_API void application_end_continuous_updates(Application *app) {
+    if (!app) {
+        log_error("Invalid Application pointer provided to application_end_continuous_updates.");
+        return;
+    }
+
+    if (app->continuousUpdateRequests == 0) {
+        log_warning("application_end_continuous_updates called without a matching begin.");
+        return;
+    }
+
+    app->continuousUpdateRequests--;
+}
+
 ENGINE_API void application_shutdown(Application *app) {
     if (!app) {
         log_error("Invalid Application pointer provided to application_shutdown.");
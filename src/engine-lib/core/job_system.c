@@ -0,0 +1,790 @@
+#include "engine/job_system.h"
+#include "engine/logging.h"
+
+// Number of failed attempts to find work before a worker goes to sleep.
+#define JOB_SYSTEM_SPIN_COUNT 64
+
+// =============================================================================
+#pragma region Types
+
+/**
+ * @brief A job as stored in a worker deque.
+ */
+typedef struct Job {
+    JobFunc func;        /**< The function to run. */
+    void *userData;      /**< User data passed to the function. */
+    JobCounter *counter; /**< Counter to decrement on completion, may be NULL. */
+} Job;
+
+/**
+ * @brief Chase-Lev work-stealing deque.
+ *
+ * The owning worker pushes and pops at the bottom (LIFO, so it works on the
+ * hottest data), while thieves take from the top (FIFO, so they take the
+ * oldest and usually largest pieces of work). top and bottom live on separate
+ * cache lines to avoid false sharing between owner and thieves.
+ */
+typedef struct JobQueue {
+    PlatformAtomicI64 top;                                           /**< Next index thieves steal from. */
+    u8 padding0[ENGINE_CACHE_LINE_SIZE - sizeof(PlatformAtomicI64)]; /**< Keeps top and bottom on separate lines. */
+    PlatformAtomicI64 bottom;                                        /**< Next index the owner pushes to. */
+    u8 padding1[ENGINE_CACHE_LINE_SIZE - sizeof(PlatformAtomicI64)]; /**< Keeps bottom and buffer on separate lines. */
+    Job *buffer;                                                     /**< Ring buffer of JOB_SYSTEM_QUEUE_CAPACITY jobs. */
+} JobQueue;
+
+/**
+ * @brief What a fiber asks its worker to do with it once it has switched away.
+ */
+typedef enum JobFiberAction {
+    JOB_FIBER_ACTION_NONE = 0, /**< Nothing pending. */
+    JOB_FIBER_ACTION_FREE,     /**< The job finished; return the fiber to the pool. */
+    JOB_FIBER_ACTION_WAIT,     /**< The job is waiting; park the fiber on its counter. */
+} JobFiberAction;
+
+/**
+ * @brief A pooled fiber that runs one job at a time.
+ */
+typedef struct JobFiber {
+    void *handle;            /**< Platform fiber handle. */
+    Job job;                 /**< The job the fiber is running. */
+    JobCounter *waitCounter; /**< Counter the fiber is parked on, NULL when not waiting. */
+} JobFiber;
+
+/**
+ * @brief Per-worker state.
+ */
+typedef struct JobWorker {
+    JobQueue queue;               /**< The worker's own deque. */
+    void *thread;                 /**< Thread handle, NULL for worker 0 (the main thread). */
+    u32 index;                    /**< Worker index. */
+    u32 rngState;                 /**< Xorshift state for picking steal victims. */
+    void *schedulerFiber;         /**< Fiber handle for the worker thread's own stack (fiber mode). */
+    JobFiber *currentFiber;       /**< Fiber running on this worker, NULL on the worker's own stack. */
+    JobFiber *pendingFiber;       /**< Fiber that just switched back to the worker. */
+    JobFiberAction pendingAction; /**< What to do with pendingFiber. */
+} ENGINE_ALIGN(ENGINE_CACHE_LINE_SIZE) JobWorker;
+
+/**
+ * @brief Global job system state.
+ */
+typedef struct JobSystemState {
+    MemoryPool *pool;           /**< Pool the workers were allocated from. */
+    JobWorker *workers;         /**< Array of workerCount workers. */
+    u32 workerCount;            /**< Number of workers including the main thread. */
+    PlatformAtomicI32 running;  /**< Non-zero while workers should keep running. */
+    PlatformAtomicI32 sleepers; /**< Number of workers asleep on wakeSemaphore. */
+    void *wakeSemaphore;        /**< Signalled when work is pushed and someone sleeps. */
+    b8 initialized;             /**< True between init and shutdown. */
+
+    b8 useFibers;                    /**< True when jobs run on pooled fibers. */
+    JobFiber *fibers;                /**< Array of fiberCount fibers. */
+    u32 fiberCount;                  /**< Number of fibers in the pool. */
+    JobFiber **freeFibers;           /**< Stack of idle fibers. */
+    u32 freeFiberCount;              /**< Number of entries in freeFibers. */
+    JobFiber **waitingFibers;        /**< Fibers parked in job_wait. */
+    PlatformAtomicI32 waitingCount;  /**< Number of entries in waitingFibers. */
+    PlatformFastMutex fiberLock;     /**< Guards the free and waiting lists. */
+} JobSystemState;
+
+ENGINE_GLOBAL JobSystemState state = {0};
+
+// Index of the worker running on this thread, INVALID_ID_U32 for other threads.
+ENGINE_GLOBAL ENGINE_THREAD_LOCAL u32 currentWorkerIndex = INVALID_ID_U32;
+
+#pragma endregion
+// =============================================================================
+#pragma region Queue
+
+/**
+ * @brief Pushes a job onto the bottom of a worker's own deque.
+ *
+ * @param queue A pointer to the calling worker's queue.
+ * @param job A pointer to the job to push.
+ * @return b8 True if the job was pushed, false if the queue is full.
+ */
+static b8 job_queue_push(JobQueue *queue, const Job *job) {
+    i64 bottom = queue->bottom.value; // Only the owner writes bottom.
+    i64 top = platform_atomic_load_i64(&queue->top);
+
+    if (bottom - top >= JOB_SYSTEM_QUEUE_CAPACITY) {
+        return false;
+    }
+
+    queue->buffer[bottom & (JOB_SYSTEM_QUEUE_CAPACITY - 1)] = *job;
+
+    // Release: the job contents become visible before the new bottom does.
+    platform_atomic_store_i64(&queue->bottom, bottom + 1);
+    return true;
+}
+
+/**
+ * @brief Pops the most recently pushed job from a worker's own deque.
+ *
+ * @param queue A pointer to the calling worker's queue.
+ * @param job A pointer that receives the popped job.
+ * @return b8 True if a job was popped, false if the queue is empty.
+ */
+static b8 job_queue_pop(JobQueue *queue, Job *job) {
+    i64 bottom = queue->bottom.value - 1;
+    platform_atomic_store_i64(&queue->bottom, bottom);
+
+    // The store to bottom must be visible before top is read, otherwise the
+    // owner and a thief could both take the last job.
+    platform_atomic_fence();
+
+    i64 top = platform_atomic_load_i64(&queue->top);
+    if (top > bottom) {
+        // Empty; restore bottom.
+        platform_atomic_store_i64(&queue->bottom, bottom + 1);
+        return false;
+    }
+
+    *job = queue->buffer[bottom & (JOB_SYSTEM_QUEUE_CAPACITY - 1)];
+    if (top != bottom) {
+        // More than one job left; no thief can race us for this one.
+        return true;
+    }
+
+    // Last job: race thieves for it by advancing top.
+    b8 won = platform_atomic_compare_exchange_i64(&queue->top, &top, top + 1);
+    platform_atomic_store_i64(&queue->bottom, bottom + 1);
+    return won;
+}
+
+/**
+ * @brief Steals the oldest job from another worker's deque.
+ *
+ * @param queue A pointer to the victim's queue.
+ * @param job A pointer that receives the stolen job.
+ * @return b8 True if a job was stolen, false if the queue was empty or the race was lost.
+ */
+static b8 job_queue_steal(JobQueue *queue, Job *job) {
+    i64 top = platform_atomic_load_i64(&queue->top);
+    platform_atomic_fence();
+    i64 bottom = platform_atomic_load_i64(&queue->bottom);
+
+    if (top >= bottom) {
+        return false;
+    }
+
+    // Copy before claiming; if the claim fails the copy may be torn and is
+    // discarded.
+    *job = queue->buffer[top & (JOB_SYSTEM_QUEUE_CAPACITY - 1)];
+    return platform_atomic_compare_exchange_i64(&queue->top, &top, top + 1);
+}
+
+/**
+ * @brief Checks whether a deque appears to hold any jobs.
+ *
+ * @param queue A pointer to the queue to check.
+ * @return b8 True if the queue is non-empty at the time of the check.
+ */
+static b8 job_queue_has_jobs(JobQueue *queue) {
+    return platform_atomic_load_i64(&queue->top) < platform_atomic_load_i64(&queue->bottom);
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Worker
+
+/**
+ * @brief Runs a job and signals its counter.
+ *
+ * @param job A pointer to the job to run.
+ * @return void
+ */
+static void job_execute(const Job *job) {
+    job->func(job->userData);
+
+    if (job->counter) {
+        platform_atomic_fetch_add_i32(&job->counter->value, -1);
+    }
+}
+
+/**
+ * @brief Finds a job for a worker: its own queue first, then a steal.
+ *
+ * @param worker A pointer to the calling worker.
+ * @param job A pointer that receives the job.
+ * @return b8 True if a job was found.
+ */
+static b8 job_worker_find_job(JobWorker *worker, Job *job) {
+    if (job_queue_pop(&worker->queue, job)) {
+        return true;
+    }
+
+    if (state.workerCount < 2) {
+        return false;
+    }
+
+    // Start stealing at a random victim so thieves spread across the pool.
+    worker->rngState ^= worker->rngState << 13;
+    worker->rngState ^= worker->rngState >> 17;
+    worker->rngState ^= worker->rngState << 5;
+    u32 start = worker->rngState % state.workerCount;
+
+    for (u32 i = 0; i < state.workerCount; ++i) {
+        u32 victim = (start + i) % state.workerCount;
+        if (victim == worker->index) {
+            continue;
+        }
+
+        if (job_queue_steal(&state.workers[victim].queue, job)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Fibers
+
+/**
+ * @brief Gets the worker running on the calling thread.
+ *
+ * Never inlined: a fiber can resume on a different thread than it was
+ * suspended on, so the thread-local address must not be cached across a
+ * fiber switch.
+ *
+ * @return JobWorker* The calling thread's worker.
+ */
+static ENGINE_NOINLINE JobWorker *job_current_worker(void) {
+    return &state.workers[currentWorkerIndex];
+}
+
+/**
+ * @brief Takes an idle fiber from the pool.
+ *
+ * @return JobFiber* An idle fiber, or NULL if every fiber is busy.
+ */
+static JobFiber *job_fiber_acquire(void) {
+    JobFiber *fiber = NULL;
+
+    platform_fast_mutex_lock(&state.fiberLock);
+    if (state.freeFiberCount > 0) {
+        fiber = state.freeFibers[--state.freeFiberCount];
+    }
+    platform_fast_mutex_unlock(&state.fiberLock);
+
+    return fiber;
+}
+
+/**
+ * @brief Removes a parked fiber whose counter has reached zero.
+ *
+ * @return JobFiber* A fiber ready to resume, or NULL if none is ready.
+ */
+static JobFiber *job_fiber_take_ready(void) {
+    if (platform_atomic_load_i32(&state.waitingCount) == 0) {
+        return NULL;
+    }
+
+    JobFiber *fiber = NULL;
+
+    platform_fast_mutex_lock(&state.fiberLock);
+    u32 waitingCount = (u32)state.waitingCount.value;
+    for (u32 i = 0; i < waitingCount; ++i) {
+        if (job_is_complete(state.waitingFibers[i]->waitCounter)) {
+            fiber = state.waitingFibers[i];
+            state.waitingFibers[i] = state.waitingFibers[waitingCount - 1];
+            platform_atomic_store_i32(&state.waitingCount, (i32)waitingCount - 1);
+            break;
+        }
+    }
+    platform_fast_mutex_unlock(&state.fiberLock);
+
+    if (fiber) {
+        fiber->waitCounter = NULL;
+    }
+
+    return fiber;
+}
+
+/**
+ * @brief Checks whether a parked fiber is ready to resume, without taking it.
+ *
+ * @return b8 True if some parked fiber's counter has reached zero.
+ */
+static b8 job_fiber_has_ready(void) {
+    if (platform_atomic_load_i32(&state.waitingCount) == 0) {
+        return false;
+    }
+
+    b8 ready = false;
+
+    platform_fast_mutex_lock(&state.fiberLock);
+    for (u32 i = 0; i < (u32)state.waitingCount.value && !ready; ++i) {
+        ready = job_is_complete(state.waitingFibers[i]->waitCounter);
+    }
+    platform_fast_mutex_unlock(&state.fiberLock);
+
+    return ready;
+}
+
+/**
+ * @brief Switches from the worker's own stack to a fiber, then handles
+ * whatever the fiber asked for when it switched back.
+ *
+ * The fiber is only returned to the pool or parked after it has switched
+ * away, so no other worker can resume it while it is still on its stack.
+ *
+ * @param worker A pointer to the calling worker.
+ * @param fiber A pointer to the fiber to run.
+ * @return void
+ */
+static void job_fiber_resume(JobWorker *worker, JobFiber *fiber) {
+    worker->currentFiber = fiber;
+    platform_fiber_switch(worker->schedulerFiber, fiber->handle);
+
+    JobFiber *pending = worker->pendingFiber;
+    JobFiberAction action = worker->pendingAction;
+    worker->pendingFiber = NULL;
+    worker->pendingAction = JOB_FIBER_ACTION_NONE;
+
+    platform_fast_mutex_lock(&state.fiberLock);
+    if (action == JOB_FIBER_ACTION_FREE) {
+        state.freeFibers[state.freeFiberCount++] = pending;
+    } else if (action == JOB_FIBER_ACTION_WAIT) {
+        i32 waitingCount = state.waitingCount.value;
+        state.waitingFibers[waitingCount] = pending;
+        platform_atomic_store_i32(&state.waitingCount, waitingCount + 1);
+    }
+    platform_fast_mutex_unlock(&state.fiberLock);
+}
+
+/**
+ * @brief Switches from a job fiber back to the worker's own stack.
+ *
+ * @param fiber A pointer to the fiber that is running.
+ * @param action What the worker should do with the fiber.
+ * @return void
+ */
+static void job_fiber_yield(JobFiber *fiber, JobFiberAction action) {
+    JobWorker *worker = job_current_worker();
+    worker->currentFiber = NULL;
+    worker->pendingFiber = fiber;
+    worker->pendingAction = action;
+    platform_fiber_switch(fiber->handle, worker->schedulerFiber);
+}
+
+/**
+ * @brief Entry point of every pooled fiber. Runs the assigned job, hands the
+ * fiber back, and repeats when the fiber is reused.
+ *
+ * @param data A pointer to the JobFiber.
+ * @return void
+ */
+static void job_fiber_main(void *data) {
+    JobFiber *fiber = (JobFiber *)data;
+
+    for (;;) {
+        job_execute(&fiber->job);
+        job_fiber_yield(fiber, JOB_FIBER_ACTION_FREE);
+    }
+}
+
+/**
+ * @brief Creates the fiber pool and a scheduler fiber for every worker.
+ *
+ * @param fiberCount The number of fibers to create.
+ * @param stackSize The stack size of each fiber.
+ * @return ENGINE_SUCCESS if every fiber was created, otherwise an error code.
+ */
+static EngineResult job_fibers_create(u32 fiberCount, u32 stackSize) {
+    platform_fast_mutex_init(&state.fiberLock);
+    platform_fast_mutex_set_name(&state.fiberLock, "JobFibers");
+
+    state.fibers = (JobFiber *)memory_allocate(state.pool, sizeof(JobFiber) * fiberCount, MEMORY_TAG_ENGINE);
+    state.freeFibers = (JobFiber **)memory_allocate(state.pool, sizeof(JobFiber *) * fiberCount, MEMORY_TAG_ENGINE);
+    state.waitingFibers = (JobFiber **)memory_allocate(state.pool, sizeof(JobFiber *) * fiberCount, MEMORY_TAG_ENGINE);
+    if (!state.fibers || !state.freeFibers || !state.waitingFibers) {
+        log_error("Failed to allocate memory for %u job fibers.", fiberCount);
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+    memory_zero(state.fibers, sizeof(JobFiber) * fiberCount);
+
+    for (u32 i = 0; i < fiberCount; ++i) {
+        if (platform_fiber_create(job_fiber_main, &state.fibers[i], stackSize, &state.fibers[i].handle) != ENGINE_SUCCESS) {
+            log_error("Failed to create job fiber %u.", i);
+            return ENGINE_ERROR;
+        }
+
+        // Pushed in reverse so fiber 0 is handed out first.
+        state.freeFibers[fiberCount - 1 - i] = &state.fibers[i];
+        state.fiberCount++;
+    }
+    state.freeFiberCount = fiberCount;
+
+    for (u32 i = 0; i < state.workerCount; ++i) {
+        if (platform_fiber_create_from_thread(&state.workers[i].schedulerFiber) != ENGINE_SUCCESS) {
+            log_error("Failed to create scheduler fiber for worker %u.", i);
+            return ENGINE_ERROR;
+        }
+    }
+
+    return ENGINE_SUCCESS;
+}
+
+/**
+ * @brief Destroys the fiber pool and the workers' scheduler fibers.
+ *
+ * @return void
+ */
+static void job_fibers_destroy(void) {
+    for (u32 i = 0; i < state.fiberCount; ++i) {
+        platform_fiber_destroy(state.fibers[i].handle);
+    }
+
+    for (u32 i = 0; i < state.workerCount; ++i) {
+        if (state.workers[i].schedulerFiber) {
+            platform_fiber_destroy(state.workers[i].schedulerFiber);
+            state.workers[i].schedulerFiber = NULL;
+        }
+    }
+
+    if (state.fibers) {
+        memory_free(state.pool, state.fibers, MEMORY_TAG_ENGINE);
+    }
+    if (state.freeFibers) {
+        memory_free(state.pool, state.freeFibers, MEMORY_TAG_ENGINE);
+    }
+    if (state.waitingFibers) {
+        memory_free(state.pool, state.waitingFibers, MEMORY_TAG_ENGINE);
+    }
+
+    state.fibers = NULL;
+    state.freeFibers = NULL;
+    state.waitingFibers = NULL;
+    state.fiberCount = 0;
+    state.freeFiberCount = 0;
+}
+
+/**
+ * @brief Frees every worker's job queue and the worker array.
+ *
+ * @return void
+ */
+static void job_workers_destroy(void) {
+    for (u32 i = 0; i < state.workerCount; ++i) {
+        memory_free_aligned(state.pool, state.workers[i].queue.buffer, MEMORY_TAG_ENGINE);
+    }
+    memory_free_aligned(state.pool, state.workers, MEMORY_TAG_ENGINE);
+    state.workers = NULL;
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Scheduling
+
+/**
+ * @brief Does one unit of work on the calling worker: resumes a fiber whose
+ * wait has completed, or runs a new job (on a fiber in fiber mode).
+ *
+ * @param worker A pointer to the calling worker, which must be on its own stack.
+ * @return b8 True if any work was done.
+ */
+static b8 job_worker_run_one(JobWorker *worker) {
+    if (state.useFibers) {
+        JobFiber *ready = job_fiber_take_ready();
+        if (ready) {
+            job_fiber_resume(worker, ready);
+            return true;
+        }
+    }
+
+    Job job;
+    if (!job_worker_find_job(worker, &job)) {
+        return false;
+    }
+
+    if (state.useFibers) {
+        JobFiber *fiber = job_fiber_acquire();
+        if (fiber) {
+            fiber->job = job;
+            job_fiber_resume(worker, fiber);
+            return true;
+        }
+    }
+
+    // Thread mode, or every fiber is busy: run on the worker's own stack.
+    job_execute(&job);
+    return true;
+}
+
+/**
+ * @brief Checks whether any worker has queued jobs.
+ *
+ * @return b8 True if any queue is non-empty.
+ */
+static b8 job_system_has_jobs(void) {
+    for (u32 i = 0; i < state.workerCount; ++i) {
+        if (job_queue_has_jobs(&state.workers[i].queue)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Wakes sleeping workers after new jobs were pushed.
+ *
+ * @param count The number of jobs that were pushed.
+ * @return void
+ */
+static void job_system_wake_workers(u32 count) {
+    // Pairs with the sleeper increment in job_worker_thread: either we see the
+    // sleeper here, or the sleeper sees our job before it waits.
+    platform_atomic_fence();
+
+    i32 sleepers = platform_atomic_load_i32(&state.sleepers);
+    for (i32 i = 0; i < sleepers && (u32)i < count; ++i) {
+        platform_semaphore_signal(state.wakeSemaphore);
+    }
+}
+
+/**
+ * @brief Worker thread entry point.
+ *
+ * @param data A pointer to the JobWorker owned by this thread.
+ * @return i32 Always 0.
+ */
+static i32 job_worker_thread(void *data) {
+    JobWorker *worker = (JobWorker *)data;
+    currentWorkerIndex = worker->index;
+
+    while (platform_atomic_load_i32(&state.running)) {
+        // Spin briefly before sleeping; jobs tend to arrive in bursts.
+        b8 found = false;
+        for (u32 spin = 0; spin < JOB_SYSTEM_SPIN_COUNT; ++spin) {
+            if (job_worker_run_one(worker)) {
+                found = true;
+                break;
+            }
+            platform_cpu_relax();
+        }
+
+        if (found) {
+            continue;
+        }
+
+        platform_atomic_fetch_add_i32(&state.sleepers, 1);
+        platform_atomic_fence();
+        if (!job_system_has_jobs() && !(state.useFibers && job_fiber_has_ready()) && platform_atomic_load_i32(&state.running)) {
+            platform_semaphore_wait(state.wakeSemaphore);
+        }
+        platform_atomic_fetch_add_i32(&state.sleepers, -1);
+    }
+
+    return 0;
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Job System
+
+ENGINE_API EngineResult job_system_init(MemoryPool *pool, const JobSystemConfig *config) {
+    if (!pool || !config) {
+        log_error("Invalid MemoryPool or JobSystemConfig provided to job_system_init.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (state.initialized) {
+        log_error("job_system_init called while the job system is already running.");
+        return ENGINE_ERROR;
+    }
+
+    u32 workerCount = config->workerCount ? config->workerCount : platform_get_processor_count();
+    if (workerCount > JOB_SYSTEM_MAX_WORKERS) {
+        workerCount = JOB_SYSTEM_MAX_WORKERS;
+    }
+
+    state.pool = pool;
+    state.workerCount = workerCount;
+    state.workers = (JobWorker *)memory_allocate_aligned(pool, sizeof(JobWorker) * workerCount, ENGINE_CACHE_LINE_SIZE, MEMORY_TAG_ENGINE);
+    if (!state.workers) {
+        log_error("Failed to allocate memory for %u job workers.", workerCount);
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+    memory_zero(state.workers, sizeof(JobWorker) * workerCount);
+
+    for (u32 i = 0; i < workerCount; ++i) {
+        JobWorker *worker = &state.workers[i];
+        worker->index = i;
+        worker->rngState = 0x9E3779B9u * (i + 1);
+        worker->queue.buffer = (Job *)memory_allocate_aligned(pool, sizeof(Job) * JOB_SYSTEM_QUEUE_CAPACITY, ENGINE_CACHE_LINE_SIZE, MEMORY_TAG_ENGINE);
+        if (!worker->queue.buffer) {
+            log_error("Failed to allocate job queue for worker %u.", i);
+            for (u32 j = 0; j < i; ++j) {
+                memory_free_aligned(pool, state.workers[j].queue.buffer, MEMORY_TAG_ENGINE);
+            }
+            memory_free_aligned(pool, state.workers, MEMORY_TAG_ENGINE);
+            state.workers = NULL;
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+    }
+
+    if (config->useFibers) {
+        if (platform_fiber_supported()) {
+            u32 fiberCount = config->fiberCount ? config->fiberCount : JOB_SYSTEM_DEFAULT_FIBER_COUNT;
+            u32 stackSize = config->fiberStackSize ? config->fiberStackSize : JOB_SYSTEM_DEFAULT_FIBER_STACK_SIZE;
+            EngineResult result = job_fibers_create(fiberCount, stackSize);
+            if (result != ENGINE_SUCCESS) {
+                job_fibers_destroy();
+                job_workers_destroy();
+                return result;
+            }
+            state.useFibers = true;
+        } else {
+            log_warning("Fibers are not supported on this platform; job waits will nest on worker stacks.");
+        }
+    }
+
+    platform_semaphore_create(&state.wakeSemaphore, 0);
+    if (!state.wakeSemaphore) {
+        log_error("Failed to create the job system's wake semaphore.");
+        if (state.useFibers) {
+            job_fibers_destroy();
+            state.useFibers = false;
+        }
+        job_workers_destroy();
+        return ENGINE_ERROR;
+    }
+    platform_atomic_store_i32(&state.sleepers, 0);
+    platform_atomic_store_i32(&state.running, 1);
+    state.initialized = true;
+
+    // The calling thread is worker 0.
+    currentWorkerIndex = 0;
+
+    for (u32 i = 1; i < workerCount; ++i) {
+        if (platform_thread_create(job_worker_thread, &state.workers[i], "JobWorker", &state.workers[i].thread) != ENGINE_SUCCESS) {
+            // The worker's queue stays empty and is skipped by thieves, so
+            // the pool just runs with fewer threads.
+            log_error("Failed to start job worker %u.", i);
+            state.workers[i].thread = NULL;
+        }
+    }
+
+    log_info("Job system initialized with %u workers%s.", state.workerCount, state.useFibers ? " on fibers" : "");
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void job_system_shutdown(void) {
+    if (!state.initialized) {
+        log_warning("job_system_shutdown called while the job system is not running.");
+        return;
+    }
+
+    // Stop and wake every worker, then wait for them to exit.
+    platform_atomic_store_i32(&state.running, 0);
+    for (u32 i = 1; i < state.workerCount; ++i) {
+        platform_semaphore_signal(state.wakeSemaphore);
+    }
+
+    for (u32 i = 1; i < state.workerCount; ++i) {
+        if (state.workers[i].thread) {
+            platform_thread_join(state.workers[i].thread);
+        }
+    }
+
+    if (state.useFibers) {
+        job_fibers_destroy();
+    }
+
+    job_workers_destroy();
+    platform_semaphore_destroy(state.wakeSemaphore);
+
+    currentWorkerIndex = INVALID_ID_U32;
+    state = (JobSystemState){0};
+
+    log_info("Job system shutdown completed.");
+}
+
+ENGINE_API u32 job_system_get_worker_count(void) {
+    return state.initialized ? state.workerCount : 1;
+}
+
+ENGINE_API u32 job_system_get_worker_index(void) {
+    return currentWorkerIndex;
+}
+
+ENGINE_API b8 job_system_uses_fibers(void) {
+    return state.useFibers;
+}
+
+ENGINE_API void job_run(const JobDecl *jobs, u32 count, JobCounter *counter) {
+    if (!jobs || count == 0) {
+        return;
+    }
+
+    if (counter) {
+        platform_atomic_fetch_add_i32(&counter->value, (i32)count);
+    }
+
+    // Threads outside the pool have no queue of their own; run inline.
+    if (!state.initialized || currentWorkerIndex == INVALID_ID_U32) {
+        for (u32 i = 0; i < count; ++i) {
+            Job job = {jobs[i].func, jobs[i].userData, counter};
+            job_execute(&job);
+        }
+        return;
+    }
+
+    JobWorker *worker = &state.workers[currentWorkerIndex];
+    for (u32 i = 0; i < count; ++i) {
+        Job job = {jobs[i].func, jobs[i].userData, counter};
+        if (!job_queue_push(&worker->queue, &job)) {
+            // Queue full: running the job now keeps progress bounded.
+            job_execute(&job);
+        }
+    }
+
+    job_system_wake_workers(count);
+}
+
+ENGINE_API void job_wait(JobCounter *counter) {
+    if (!counter) {
+        log_error("Invalid JobCounter provided to job_wait.");
+        return;
+    }
+
+    if (!state.initialized || currentWorkerIndex == INVALID_ID_U32) {
+        while (platform_atomic_load_i32(&counter->value) > 0) {
+            platform_thread_yield();
+        }
+        return;
+    }
+
+    JobWorker *worker = job_current_worker();
+    if (worker->currentFiber) {
+        if (platform_atomic_load_i32(&counter->value) > 0) {
+            // Park this fiber; a worker resumes it once the counter is zero.
+            JobFiber *fiber = worker->currentFiber;
+            fiber->waitCounter = counter;
+            job_fiber_yield(fiber, JOB_FIBER_ACTION_WAIT);
+        }
+        return;
+    }
+
+    // Help out while waiting so nested waits cannot deadlock the pool.
+    while (platform_atomic_load_i32(&counter->value) > 0) {
+        if (!job_worker_run_one(worker)) {
+            platform_cpu_relax();
+        }
+    }
+}
+
+ENGINE_API b8 job_is_complete(JobCounter *counter) {
+    if (!counter) {
+        log_error("Invalid JobCounter provided to job_is_complete.");
+        return true;
+    }
+
+    return platform_atomic_load_i32(&counter->value) <= 0;
+}
+
+#pragma endregion
+// =============================================================================
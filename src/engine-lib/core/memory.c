@@ -2,48 +2,9 @@
 #include "engine/logging.h"
 #include "engine/platform.h"
 
-// =============================================================================
-#pragma region Mutex
-
-typedef struct Mutex {
-    void *handle;
-} Mutex;
-
-static void mutex_init_internal(Mutex *mutex) {
-    if (!mutex) {
-        log_error("Attempted to initialize a NULL mutex.");
-        return;
-    }
-
-    platform_mutex_create(&mutex->handle);
-}
-
-static void mutex_destroy_internal(Mutex *mutex) {
-    if (!mutex) {
-        log_error("Attempted to destroy a NULL mutex.");
-        return;
-    }
-
-    platform_mutex_destroy(mutex->handle);
-}
-
-static void mutex_lock_internal(Mutex *mutex) {
-    if (!mutex) {
-        log_error("Attempted to lock a NULL mutex.");
-        return;
-    }
-
-    platform_mutex_lock(mutex->handle);
-}
-
-static void mutex_unlock_internal(Mutex *mutex) {
-    if (!mutex) {
-        log_error("Attempted to unlock a NULL mutex.");
-        return;
-    }
-
-    platform_mutex_unlock(mutex->handle);
-}
+// Forward declarations.
+static EngineResult allocation_record_pool_acquire(void);
+static void allocation_record_pool_release(void);
 
 // =============================================================================
 #pragma region Memory Pool
@@ -71,16 +32,15 @@ ENGINE_API EngineResult memory_pool_init(MemoryPool *pool, u64 size) {
         pool->allocations[tag] = NULL;
     }
 
-    // Initialize mutex.
-    Mutex *mutex = (Mutex *)platform_memory_allocate_aligned(sizeof(Mutex), ENGINE_STANDARD_ALIGNMENT);
-    if (!mutex) {
-        log_error("Failed to allocate memory for mutex.");
-        platform_memory_free(pool->memory);
+    // Allocation records are shared by every pool.
+    if (allocation_record_pool_acquire() != ENGINE_SUCCESS) {
+        platform_memory_free_aligned(pool->memory);
+        pool->memory = NULL;
         return ENGINE_ERROR_ALLOCATION_FAILED;
     }
 
-    mutex_init_internal(mutex);
-    pool->lock = mutex;
+    platform_fast_mutex_init(&pool->lock);
+    platform_fast_mutex_set_name(&pool->lock, "MemoryPool");
 
     log_info("Memory pool initialized with size %zu bytes.", size);
     return ENGINE_SUCCESS;
@@ -98,13 +58,7 @@ ENGINE_API void memory_pool_shutdown(MemoryPool *pool) {
     // Free all allocations (if any) - In this simple pool, we don't track individual allocations beyond.
     // More sophisticated systems can iterate through the allocations array and free them appropriately.
 
-    // Destroy mutex.
-    Mutex *mutex = (Mutex *)pool->lock;
-    if (mutex) {
-        mutex_destroy_internal(mutex);
-        platform_memory_free(mutex);
-        pool->lock = NULL;
-    }
+    allocation_record_pool_release();
 
     // Free the memory pool.
     if (pool->memory) {
@@ -121,63 +75,94 @@ ENGINE_API void memory_pool_shutdown(MemoryPool *pool) {
 
 // Separate allocation tracking for AllocationRecord instances to prevent infinite recursion.
 typedef struct AllocationRecordPool {
-    AllocationRecord *head;
-    Mutex lock;
+    AllocationRecord *records; /**< Backing array of MEMORY_MAX_ALLOCATION_RECORDS records. */
+    AllocationRecord *head;    /**< Free list of records. */
+    u32 poolCount;             /**< Number of memory pools using the records. */
+    PlatformFastMutex lock;    /**< Guards the free list. */
 } AllocationRecordPool;
 
 static AllocationRecordPool allocationRecordPool = {0};
 
-// Initialize the allocation record pool.
-static EngineResult allocation_record_pool_init(u64 size) {
+// Initialize the allocation record pool for the first memory pool, or add a user.
+static EngineResult allocation_record_pool_acquire(void) {
+    platform_fast_mutex_lock(&allocationRecordPool.lock);
+
+    if (allocationRecordPool.poolCount++ > 0) {
+        platform_fast_mutex_unlock(&allocationRecordPool.lock);
+        return ENGINE_SUCCESS;
+    }
+
+    // Named while held, so this first hold is not timed.
+    platform_fast_mutex_set_name(&allocationRecordPool.lock, "AllocationRecords");
+
     // Preallocate a fixed number of AllocationRecords to avoid dynamic allocations during tracking.
-    // For simplicity, allocate a separate memory pool for AllocationRecords.
-    AllocationRecord *base = (AllocationRecord *)platform_memory_allocate_aligned(size * sizeof(AllocationRecord), ENGINE_STANDARD_ALIGNMENT);
+    AllocationRecord *base = (AllocationRecord *)platform_memory_allocate_aligned(MEMORY_MAX_ALLOCATION_RECORDS * sizeof(AllocationRecord), ENGINE_STANDARD_ALIGNMENT);
     if (!base) {
+        allocationRecordPool.poolCount = 0;
+        platform_fast_mutex_unlock(&allocationRecordPool.lock);
         log_error("Failed to allocate memory for AllocationRecord pool.");
         return ENGINE_ERROR_ALLOCATION_FAILED;
     }
 
-    // Initialize the AllocationRecordPool.
-    allocationRecordPool.head = NULL;
-    mutex_init_internal(&allocationRecordPool.lock);
-
     // Populate the AllocationRecordPool with preallocated records.
-    for (u64 i = 0; i < size; ++i) {
+    allocationRecordPool.records = base;
+    allocationRecordPool.head = NULL;
+    for (u64 i = 0; i < MEMORY_MAX_ALLOCATION_RECORDS; ++i) {
         base[i].ptr = NULL;
         base[i].size = 0;
         base[i].next = allocationRecordPool.head;
         allocationRecordPool.head = &base[i];
     }
 
-    log_info("AllocationRecord pool initialized with %zu records.", size);
+    platform_fast_mutex_unlock(&allocationRecordPool.lock);
+
+    log_info("AllocationRecord pool initialized with %u records.", MEMORY_MAX_ALLOCATION_RECORDS);
     return ENGINE_SUCCESS;
 }
 
-// Shutdown the AllocationRecordPool.
-static void allocation_record_pool_shutdown(void) {
-    // Destroy mutex.
-    mutex_destroy_internal(&allocationRecordPool.lock);
-    allocationRecordPool.head = NULL;
+// Release a memory pool's use of the allocation record pool, freeing it after the last one.
+static void allocation_record_pool_release(void) {
+    platform_fast_mutex_lock(&allocationRecordPool.lock);
+
+    if (allocationRecordPool.poolCount > 0 && --allocationRecordPool.poolCount == 0) {
+        platform_memory_free_aligned(allocationRecordPool.records);
+        allocationRecordPool.records = NULL;
+        allocationRecordPool.head = NULL;
+    }
+
+    platform_fast_mutex_unlock(&allocationRecordPool.lock);
 }
 
 // Allocate an AllocationRecord from the AllocationRecordPool.
 static AllocationRecord *allocate_allocation_record(void) {
-    mutex_lock_internal(&allocationRecordPool.lock);
+    platform_fast_mutex_lock(&allocationRecordPool.lock);
 
     if (!allocationRecordPool.head) {
+        platform_fast_mutex_unlock(&allocationRecordPool.lock);
         log_error("AllocationRecord pool exhausted.");
-        mutex_unlock_internal(&allocationRecordPool.lock);
         return NULL;
     }
 
     AllocationRecord *record = allocationRecordPool.head;
     allocationRecordPool.head = record->next;
 
-    mutex_unlock_internal(&allocationRecordPool.lock);
+    platform_fast_mutex_unlock(&allocationRecordPool.lock);
 
     return record;
 }
 
+// Return an AllocationRecord to the AllocationRecordPool.
+static void free_allocation_record(AllocationRecord *record) {
+    platform_fast_mutex_lock(&allocationRecordPool.lock);
+
+    record->ptr = NULL;
+    record->size = 0;
+    record->next = allocationRecordPool.head;
+    allocationRecordPool.head = record;
+
+    platform_fast_mutex_unlock(&allocationRecordPool.lock);
+}
+
 ENGINE_API void *memory_allocate(MemoryPool *pool, u64 size, MemoryTag tag) {
     // Allocate memory with the standard alignment.
     return memory_allocate_aligned(pool, size, ENGINE_STANDARD_ALIGNMENT, tag);
@@ -185,96 +170,99 @@ ENGINE_API void *memory_allocate(MemoryPool *pool, u64 size, MemoryTag tag) {
 
 ENGINE_API void *memory_allocate_aligned(MemoryPool *pool, u64 size, u16 alignment, MemoryTag tag) {
 
-    if (!pool || size == 0 || tag >= MEMORY_TAG_MAX) {
-        log_error("Invalid MemoryPool pointer, size, or tag in memory_allocate_aligned.");
+    if (!pool || size == 0 || tag >= MEMORY_TAG_MAX || (alignment & (alignment - 1)) != 0) {
+        log_error("Invalid MemoryPool pointer, size, alignment, or tag in memory_allocate_aligned.");
         return NULL;
     }
 
-    // Memory layout [Header][Padding][Data]
-    // - Header: MemoryBlockHeader
+    // Memory layout [Padding][Header][Data]
     // - Padding: To align the data to the specified boundary.
+    // - Header: MemoryBlockHeader, immediately before the data so it can be found on free.
     // - Data: The actual memory requested.
+    // The header's size spans from the header to the end of the data.
+    if (alignment < ENGINE_STANDARD_ALIGNMENT) {
+        alignment = ENGINE_STANDARD_ALIGNMENT;
+    }
 
-    // Calculate total size needed.
-    u64 totalSize = sizeof(MemoryBlockHeader) + size + alignment;
+    AllocationRecord *record = allocate_allocation_record();
+    if (!record) {
+        log_error("Failed to allocate AllocationRecord.");
+        return NULL;
+    }
 
-    mutex_lock(pool->lock);
+    platform_fast_mutex_lock(&pool->lock);
 
-    // Search free list for a suitable block.
+    // Search free list for a suitable block. Free blocks have their header at
+    // their start and are kept in address order, so neighbours can be merged.
+    MemoryBlockHeader *block = NULL;
+    u64 alignedAddress = 0;
     MemoryBlockHeader **current = &pool->freeList;
     while (*current) {
-        if ((*current)->size >= totalSize) {
-            // Suitable block found.
-            MemoryBlockHeader *block = *current;
-            *current = block->next;
-
-            // Set magic number.
-            block->magic = MEMORY_BLOCK_MAGIC;
-            block->tag = tag;
-
-            // Calculate aligned address after header.
-            u64 alignedAddress = ((u64)block + sizeof(MemoryBlockHeader) + alignment - 1) & ~(alignment - 1);
-            u64 padding = alignedAddress - (u64)block;
-
-            // Update used size.
-            pool->used += padding + size;
-
-            // Track allocation.
-            AllocationRecord *record = (AllocationRecord *)memory_allocate(pool, sizeof(AllocationRecord), MEMORY_TAG_ENGINE);
-            if (!record) {
-                log_error("Failed to allocate AllocationRecord.");
-                mutex_unlock(pool->lock);
-                return NULL;
+        u64 blockStart = (u64)*current;
+        u64 blockEnd = blockStart + (*current)->size;
+        u64 candidate = (blockStart + sizeof(MemoryBlockHeader) + alignment - 1) & ~((u64)alignment - 1);
+        if (candidate + size <= blockEnd) {
+            // Suitable block found. A remainder big enough for another
+            // allocation is split off and stays on the free list.
+            MemoryBlockHeader *next = (*current)->next;
+            u64 end = (candidate + size + ENGINE_STANDARD_ALIGNMENT - 1) & ~((u64)ENGINE_STANDARD_ALIGNMENT - 1);
+            if (end + MEMORY_MIN_SPLIT_SIZE <= blockEnd) {
+                MemoryBlockHeader *remainder = (MemoryBlockHeader *)end;
+                remainder->size = blockEnd - end;
+                remainder->padding = 0;
+                remainder->magic = 0;
+                remainder->next = next;
+                next = remainder;
+                blockEnd = end;
             }
-            record->ptr = (void *)alignedAddress;
-            record->size = size;
-            record->next = pool->allocations[tag];
-            pool->allocations[tag] = record;
+            *current = next;
 
-            mutex_unlock(pool->lock);
+            alignedAddress = candidate;
+            block = (MemoryBlockHeader *)(alignedAddress - sizeof(MemoryBlockHeader));
+            block->size = blockEnd - (u64)block;
+            block->padding = (u64)block - blockStart;
             log_debug("Reused free block for allocation of size %zu bytes with alignment %d.", size, alignment);
-            return (void *)alignedAddress;
+            break;
         }
 
         current = &((*current)->next);
     }
 
-    // No suitable free block found; check if there's enough space.
-    if (pool->used + totalSize > pool->totalSize) {
-        log_error("Memory pool exhausted. Cannot allocate %zu bytes with alignment %d.", size, alignment);
-        mutex_unlock((Mutex *)pool->lock);
-        return NULL;
+    if (!block) {
+        // No suitable free block found; carve a new one from the end of the pool.
+        u64 start = (u64)pool->memory + pool->used;
+        alignedAddress = (start + sizeof(MemoryBlockHeader) + alignment - 1) & ~((u64)alignment - 1);
+        u64 end = (alignedAddress + size + ENGINE_STANDARD_ALIGNMENT - 1) & ~((u64)ENGINE_STANDARD_ALIGNMENT - 1);
+        u64 totalSize = end - start;
+
+        if (pool->used + totalSize > pool->totalSize) {
+            platform_fast_mutex_unlock(&pool->lock);
+            free_allocation_record(record);
+            log_error("Memory pool exhausted. Cannot allocate %zu bytes with alignment %d.", size, alignment);
+            return NULL;
+        }
+
+        // used is the end of the carved region. Freeing the block at the end
+        // gives its memory back.
+        pool->used += totalSize;
+
+        block = (MemoryBlockHeader *)(alignedAddress - sizeof(MemoryBlockHeader));
+        block->size = end - (u64)block;
+        block->padding = (u64)block - start;
+        log_debug("Allocated %zu bytes with alignment %d.", size, alignment);
     }
 
-    // Allocate new block.
-    MemoryBlockHeader *block = (MemoryBlockHeader *)((char *)pool->memory + pool->used);
-    block->size = totalSize;
     block->tag = tag;
-    block->magic = MEMORY_BLOCK_MAGIC;
+    block->magic = MEMORY_MAGIC_NUMBER;
     block->next = NULL;
 
-    // Calculate aligned address after header.
-    u64 alignedAddress = ((u64)block + sizeof(MemoryBlockHeader) + alignment - 1) & ~(alignment - 1);
-    u64 padding = alignedAddress - (u64)block;
-
-    // Update used size.
-    pool->used += padding + size;
-
     // Track allocation.
-    AllocationRecord *newRecord = (AllocationRecord *)memory_allocate(pool, sizeof(AllocationRecord), MEMORY_TAG_ENGINE);
-    if (!newRecord) {
-        log_error("Failed to allocate AllocationRecord.");
-        mutex_unlock(pool->lock);
-        return NULL;
-    }
-    newRecord->ptr = (void *)alignedAddress;
-    newRecord->size = size;
-    newRecord->next = pool->allocations[tag];
-    pool->allocations[tag] = newRecord;
+    record->ptr = (void *)alignedAddress;
+    record->size = size;
+    record->next = pool->allocations[tag];
+    pool->allocations[tag] = record;
 
-    mutex_unlock(pool->lock);
-
-    log_debug("Allocated %zu bytes with alignment %d.", size, alignment);
+    platform_fast_mutex_unlock(&pool->lock);
 
     return (void *)alignedAddress;
 }
@@ -293,35 +281,69 @@ ENGINE_API void memory_free_aligned(MemoryPool *pool, void *ptr, MemoryTag tag)
 
     // Retrieve the block header.
     MemoryBlockHeader *block = (MemoryBlockHeader *)(ptrAddress - sizeof(MemoryBlockHeader));
-    if (block->magic != MEMORY_BLOCK_MAGIC) {
-        log_error("Memory corruption detected during free. Magic number mismatch.");
+    if (block->magic != MEMORY_MAGIC_NUMBER) {
+        log_error("Memory corruption or double free detected during free. Magic number mismatch.");
         return;
     }
 
-    mutex_lock(pool->lock);
+    platform_fast_mutex_lock(&pool->lock);
 
     // Remove allocation record from tracking.
+    AllocationRecord *toFree = NULL;
     AllocationRecord **current = &pool->allocations[tag];
     while (*current) {
         if ((*current)->ptr == ptr) {
-            AllocationRecord *toFree = *current;
+            toFree = *current;
             *current = (*current)->next;
-            memory_free(pool, toFree, MEMORY_TAG_ENGINE);
             break;
         }
         current = &((*current)->next);
     }
 
-    // Add the block to the free list.
-    block->next = pool->freeList;
-    pool->freeList = block;
+    // Return the block's whole region, padding included, to the free list.
+    u64 blockSize = block->size;
+    u64 start = (u64)block - block->padding;
+    u64 end = (u64)block + block->size;
+    block->magic = 0;
+
+    // Find the free blocks either side, merging with them if they touch.
+    MemoryBlockHeader **link = &pool->freeList;
+    MemoryBlockHeader **previousLink = NULL;
+    while (*link && (u64)*link < start) {
+        previousLink = link;
+        link = &(*link)->next;
+    }
+    MemoryBlockHeader *next = *link;
+    if (next && (u64)next == end) {
+        end += next->size;
+        next = next->next;
+    }
+    if (previousLink && (u64)*previousLink + (*previousLink)->size == start) {
+        start = (u64)*previousLink;
+        link = previousLink;
+    }
 
-    // Update used size.
-    pool->used -= block->size;
+    if (end == (u64)pool->memory + pool->used) {
+        // The last block goes back to the end of the pool; nothing free follows it.
+        pool->used = start - (u64)pool->memory;
+        *link = NULL;
+    } else {
+        MemoryBlockHeader *freed = (MemoryBlockHeader *)start;
+        freed->size = end - start;
+        freed->padding = 0;
+        freed->magic = 0;
+        freed->next = next;
+        *link = freed;
+    }
+
+    platform_fast_mutex_unlock(&pool->lock);
 
-    mutex_unlock(pool->lock);
+    if (toFree) {
+        free_allocation_record(toFree);
+    }
 
-    log_debug("Freed memory block of size %zu bytes with tag %d.", block->size, tag);
+    ENGINE_UNUSED(blockSize);
+    log_debug("Freed memory block of size %zu bytes with tag %d.", blockSize, tag);
 }
 
 ENGINE_API void *memory_copy(void *dest, const void *src, u64 size) {
@@ -346,7 +368,7 @@ ENGINE_API void memory_pool_detect_leaks(MemoryPool *pool) {
         return;
     }
 
-    mutex_lock(pool->lock);
+    platform_fast_mutex_lock(&pool->lock);
 
     // Iterate through the allocations and log any leaks.
     b8 leaksDetected = false;
@@ -361,7 +383,7 @@ ENGINE_API void memory_pool_detect_leaks(MemoryPool *pool) {
         log_info("No memory leaks detected.");
     }
 
-    mutex_unlock(pool->lock);
+    platform_fast_mutex_unlock(&pool->lock);
 
     log_info("Memory leak detection completed.");
 }
@@ -0,0 +1,188 @@
+#include "engine/parallel.h"
+#include "engine/job_system.h"
+#include "engine/logging.h"
+#include "engine/memory.h"
+
+// Forward declaration.
+typedef struct ParallelContext ParallelContext;
+
+/**
+ * @brief A contiguous slice of a parallel loop handed to one job.
+ */
+typedef struct ParallelChunk {
+    u32 begin;                      /**< First element of the chunk. */
+    u32 end;                        /**< One past the last element of the chunk. */
+    u32 index;                      /**< Position of the chunk in the partition. */
+    const ParallelContext *context; /**< The loop this chunk belongs to. */
+} ParallelChunk;
+
+/**
+ * @brief Shared description of a parallel loop.
+ */
+typedef struct ParallelContext {
+    ParallelForFunc forFn;       /**< Body for parallel_for. */
+    ParallelReduceFunc reduceFn; /**< Body for parallel_reduce. */
+    void *userData;              /**< User data passed to the body. */
+    u8 *partials;                /**< Partial results, one cache line per chunk. */
+    u32 resultSize;              /**< Size of a partial result in bytes. */
+    const void *identity;        /**< Initial value of each partial. */
+} ParallelContext;
+
+/**
+ * @brief Splits [0, count) into chunks of grainSize, clamped to PARALLEL_MAX_CHUNKS.
+ *
+ * @param count The number of elements.
+ * @param grainSize The requested elements per chunk (non-zero).
+ * @param chunks The array of at least PARALLEL_MAX_CHUNKS chunks to fill.
+ * @param context The loop the chunks belong to.
+ * @return u32 The number of chunks written.
+ */
+static u32 parallel_partition(u32 count, u32 grainSize, ParallelChunk *chunks, const ParallelContext *context) {
+    // In u64, so neither the rounding nor the last step past count wraps.
+    u64 grain = grainSize;
+    u64 minimumGrain = ((u64)count + PARALLEL_MAX_CHUNKS - 1) / PARALLEL_MAX_CHUNKS;
+    if (grain < minimumGrain) {
+        grain = minimumGrain;
+    }
+
+    u32 chunkCount = 0;
+    for (u64 begin = 0; begin < count && chunkCount < PARALLEL_MAX_CHUNKS; begin += grain) {
+        u64 end = begin + grain < count ? begin + grain : count;
+        chunks[chunkCount] = (ParallelChunk){(u32)begin, (u32)end, chunkCount, context};
+        chunkCount++;
+    }
+
+    return chunkCount;
+}
+
+/**
+ * @brief Runs one job per chunk and waits for all of them.
+ *
+ * @param chunks The chunks to run.
+ * @param chunkCount The number of chunks.
+ * @param func The job entry point receiving a ParallelChunk.
+ * @return void
+ */
+static void parallel_run_chunks(ParallelChunk *chunks, u32 chunkCount, JobFunc func) {
+    JobDecl jobs[PARALLEL_MAX_CHUNKS];
+    for (u32 i = 0; i < chunkCount; ++i) {
+        jobs[i] = (JobDecl){func, &chunks[i]};
+    }
+
+    JobCounter counter = {0};
+    job_run(jobs, chunkCount, &counter);
+    job_wait(&counter);
+}
+
+/**
+ * @brief Job entry point for a parallel_for chunk.
+ *
+ * @param userData A pointer to the ParallelChunk to process.
+ * @return void
+ */
+static void parallel_for_job(void *userData) {
+    const ParallelChunk *chunk = (const ParallelChunk *)userData;
+    chunk->context->forFn(chunk->begin, chunk->end, chunk->context->userData);
+}
+
+/**
+ * @brief Job entry point for a parallel_reduce chunk.
+ *
+ * @param userData A pointer to the ParallelChunk to process.
+ * @return void
+ */
+static void parallel_reduce_job(void *userData) {
+    const ParallelChunk *chunk = (const ParallelChunk *)userData;
+    const ParallelContext *context = chunk->context;
+
+    void *partial = context->partials + (u64)chunk->index * PARALLEL_MAX_RESULT_SIZE;
+    memory_copy(partial, context->identity, context->resultSize);
+    context->reduceFn(chunk->begin, chunk->end, partial, context->userData);
+}
+
+ENGINE_API void parallel_for(u32 count, u32 grainSize, ParallelForFunc fn, void *userData) {
+    if (!fn) {
+        log_error("Invalid function provided to parallel_for.");
+        return;
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    u32 workerCount = job_system_get_worker_count();
+    if (count < PARALLEL_SERIAL_THRESHOLD || workerCount < 2) {
+        fn(0, count, userData);
+        return;
+    }
+
+    if (grainSize == 0) {
+        // A few chunks per worker lets stealing even out uneven chunk costs.
+        grainSize = count / (workerCount * 4);
+        if (grainSize < PARALLEL_MIN_GRAIN_SIZE) {
+            grainSize = PARALLEL_MIN_GRAIN_SIZE;
+        }
+    }
+
+    ParallelContext context = {0};
+    context.forFn = fn;
+    context.userData = userData;
+
+    ParallelChunk chunks[PARALLEL_MAX_CHUNKS];
+    u32 chunkCount = parallel_partition(count, grainSize, chunks, &context);
+    if (chunkCount == 1) {
+        fn(0, count, userData);
+        return;
+    }
+
+    parallel_run_chunks(chunks, chunkCount, parallel_for_job);
+}
+
+ENGINE_API void parallel_reduce(u32 count, u32 grainSize, ParallelReduceFunc reduceFn, ParallelCombineFunc combineFn, void *result, u32 resultSize, void *userData) {
+    if (!reduceFn || !combineFn || !result || resultSize == 0 || resultSize > PARALLEL_MAX_RESULT_SIZE) {
+        log_error("Invalid function, result, or result size provided to parallel_reduce.");
+        return;
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    if (grainSize == 0) {
+        grainSize = (count + PARALLEL_REDUCE_CHUNKS - 1) / PARALLEL_REDUCE_CHUNKS;
+        if (grainSize < PARALLEL_MIN_GRAIN_SIZE) {
+            grainSize = PARALLEL_MIN_GRAIN_SIZE;
+        }
+    }
+
+    // Keep a copy of the identity; result is overwritten by the combine pass.
+    u8 identity[PARALLEL_MAX_RESULT_SIZE];
+    memory_copy(identity, result, resultSize);
+
+    u8 partials[PARALLEL_MAX_CHUNKS * PARALLEL_MAX_RESULT_SIZE] ENGINE_ALIGN(ENGINE_CACHE_LINE_SIZE);
+
+    ParallelContext context = {0};
+    context.reduceFn = reduceFn;
+    context.userData = userData;
+    context.partials = partials;
+    context.resultSize = resultSize;
+    context.identity = identity;
+
+    ParallelChunk chunks[PARALLEL_MAX_CHUNKS];
+    u32 chunkCount = parallel_partition(count, grainSize, chunks, &context);
+
+    // The serial fallback walks the same partition, so small inputs and
+    // single-threaded runs produce exactly the same result as parallel ones.
+    if (count < PARALLEL_SERIAL_THRESHOLD || chunkCount == 1 || job_system_get_worker_count() < 2) {
+        for (u32 i = 0; i < chunkCount; ++i) {
+            parallel_reduce_job(&chunks[i]);
+        }
+    } else {
+        parallel_run_chunks(chunks, chunkCount, parallel_reduce_job);
+    }
+
+    // Combine in chunk order for a deterministic result.
+    for (u32 i = 0; i < chunkCount; ++i) {
+        combineFn(result, partials + (u64)i * PARALLEL_MAX_RESULT_SIZE, userData);
+    }
+}
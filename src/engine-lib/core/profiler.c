@@ -0,0 +1,591 @@
+#include "engine/profiler.h"
+#include "engine/logging.h"
+#include "engine/memory.h"
+#include <stdio.h>
+#include <string.h>
+
+// =============================================================================
+#pragma region Types
+
+/**
+ * @brief Hardware counter state of a thread.
+ */
+typedef enum ProfilerCounterState {
+    PROFILER_COUNTERS_UNTRIED = 0, /**< Not opened yet. */
+    PROFILER_COUNTERS_OPEN,        /**< Open and readable. */
+    PROFILER_COUNTERS_UNAVAILABLE, /**< Opening failed or counters are disabled. */
+} ProfilerCounterState;
+
+/**
+ * @brief Global profiler state.
+ */
+typedef struct ProfilerState {
+    b8 initialized;         /**< True between init and shutdown. */
+    b8 hardwareCounters;    /**< True if threads should open hardware counters. */
+    b8 countersUnavailable; /**< Set after the first failed open so other threads do not retry. */
+    f64 reportInterval;     /**< Seconds between frame reports, 0 if disabled. */
+    f64 secondsPerTick;     /**< Performance counter period. */
+    PlatformFastMutex lock; /**< Guards zones and threadCounters. */
+
+    ProfilerZoneStats zones[PROFILER_MAX_ZONES]; /**< Statistics per zone name. */
+    u32 zoneCount;                               /**< Number of zones in use. */
+    void *threadCounters[PROFILER_MAX_THREADS];  /**< Every open counter handle, closed at shutdown. */
+    u32 threadCount;                             /**< Number of open counter handles. */
+
+    u64 frameStartTicks;                          /**< Performance counter at the end of the previous frame. */
+    u64 frameCount;                               /**< Frames since the last report. */
+    f64 frameSeconds;                             /**< Total frame time since the last report. */
+    f64 frameMaxSeconds;                          /**< Longest frame since the last report. */
+    PlatformPerfCounterValues frameStartCounters; /**< Main thread counters at the last report. */
+} ProfilerState;
+
+ENGINE_GLOBAL ProfilerState state = {0};
+
+// Counter handle of the calling thread.
+ENGINE_GLOBAL ENGINE_THREAD_LOCAL void *threadCounters = NULL;
+ENGINE_GLOBAL ENGINE_THREAD_LOCAL ProfilerCounterState threadCounterState = PROFILER_COUNTERS_UNTRIED;
+
+// Short names used in reports, indexed by PlatformPerfCounter.
+ENGINE_GLOBAL const char *counterNames[PLATFORM_PERF_COUNTER_COUNT] = {
+    "cycles",
+    "instructions",
+    "L1D miss",
+    "LLC miss",
+    "branch miss",
+};
+
+#if ENGINE_ENABLE_LOCK_PROFILER
+/**
+ * @brief Contention record shared by every lock with the same name. Updated
+ * atomically because differently named instances (e.g. two memory pools) can
+ * be held at the same time.
+ */
+typedef struct ProfilerLock {
+    const char *name;               /**< Lock name. */
+    PlatformAtomicI64 acquisitions; /**< Number of acquisitions. */
+    PlatformAtomicI64 contentions;  /**< Acquisitions that waited. */
+    PlatformAtomicI64 waitTicks;    /**< Total ticks spent waiting. */
+    PlatformAtomicI64 maxWaitTicks; /**< Longest single wait in ticks. */
+    PlatformAtomicI64 holdTicks;    /**< Total ticks held. */
+    PlatformAtomicI64 maxHoldTicks; /**< Longest single hold in ticks. */
+} ENGINE_ALIGN(ENGINE_CACHE_LINE_SIZE) ProfilerLock;
+
+// Lock records outlive profiler_init/shutdown: locks are named when memory
+// pools are created, before the engine starts the profiler.
+ENGINE_GLOBAL ProfilerLock locks[PROFILER_MAX_LOCKS];
+ENGINE_GLOBAL PlatformAtomicI32 lockCount = {0};
+ENGINE_GLOBAL PlatformFastMutex lockRegistryLock = {0};
+#endif
+
+#pragma endregion
+// =============================================================================
+#pragma region Helpers
+
+/**
+ * @brief Gets the calling thread's counters, opening them on first use.
+ *
+ * @return void* The counter handle, or NULL if counters are unavailable.
+ */
+static void *profiler_thread_counters(void) {
+    if (threadCounterState == PROFILER_COUNTERS_OPEN) {
+        return threadCounters;
+    }
+
+    if (threadCounterState == PROFILER_COUNTERS_UNAVAILABLE || !state.hardwareCounters || state.countersUnavailable) {
+        threadCounterState = PROFILER_COUNTERS_UNAVAILABLE;
+        return NULL;
+    }
+
+    if (platform_perf_counters_open(&threadCounters) != ENGINE_SUCCESS) {
+        state.countersUnavailable = true;
+        threadCounterState = PROFILER_COUNTERS_UNAVAILABLE;
+        log_warning("Profiling without hardware counters.");
+        return NULL;
+    }
+
+    platform_fast_mutex_lock(&state.lock);
+    b8 registered = state.threadCount < PROFILER_MAX_THREADS;
+    if (registered) {
+        state.threadCounters[state.threadCount++] = threadCounters;
+    }
+    platform_fast_mutex_unlock(&state.lock);
+
+    if (!registered) {
+        log_warning("Too many profiled threads; thread %llu runs without hardware counters.", platform_thread_get_id());
+        platform_perf_counters_close(threadCounters);
+        threadCounters = NULL;
+        threadCounterState = PROFILER_COUNTERS_UNAVAILABLE;
+        return NULL;
+    }
+
+    threadCounterState = PROFILER_COUNTERS_OPEN;
+    return threadCounters;
+}
+
+/**
+ * @brief Finds or registers a zone by name. The profiler lock must be held.
+ *
+ * @param name The zone name.
+ * @return u32 The zone index, or INVALID_ID_U32 if the zone table is full.
+ */
+static u32 profiler_find_zone(const char *name) {
+    // Names are nearly always the same literal, so compare pointers first.
+    for (u32 i = 0; i < state.zoneCount; ++i) {
+        if (state.zones[i].name == name) {
+            return i;
+        }
+    }
+
+    for (u32 i = 0; i < state.zoneCount; ++i) {
+        if (strcmp(state.zones[i].name, name) == 0) {
+            return i;
+        }
+    }
+
+    if (state.zoneCount == PROFILER_MAX_ZONES) {
+        return INVALID_ID_U32;
+    }
+
+    ProfilerZoneStats *zone = &state.zones[state.zoneCount];
+    memory_zero(zone, sizeof(ProfilerZoneStats));
+    zone->name = name;
+    zone->counterMask = MAX_U32;
+    return state.zoneCount++;
+}
+
+/**
+ * @brief Formats a count with a K/M/G suffix.
+ *
+ * @param value The value to format.
+ * @param buffer A pointer to the buffer that receives the text.
+ * @param bufferSize The size of the buffer in bytes.
+ * @return void
+ */
+static void profiler_format_count(f64 value, char *buffer, u32 bufferSize) {
+    if (value >= 1e9) {
+        snprintf(buffer, bufferSize, "%.2fG", value / 1e9);
+    } else if (value >= 1e6) {
+        snprintf(buffer, bufferSize, "%.2fM", value / 1e6);
+    } else if (value >= 1e3) {
+        snprintf(buffer, bufferSize, "%.1fK", value / 1e3);
+    } else {
+        snprintf(buffer, bufferSize, "%.0f", value);
+    }
+}
+
+/**
+ * @brief Formats per-call counters from accumulated totals.
+ *
+ * @param counters The counter totals, indexed by PlatformPerfCounter.
+ * @param mask Bit (1 << counter) set for each valid counter.
+ * @param divisor Divides each count (0 is treated as 1).
+ * @param buffer A pointer to the buffer that receives the text.
+ * @param bufferSize The size of the buffer in bytes.
+ * @return u32 The number of characters written.
+ */
+static u32 profiler_format_totals(const u64 *counters, u32 mask, u64 divisor, char *buffer, u32 bufferSize) {
+    u32 cyclesBit = 1u << PLATFORM_PERF_COUNTER_CYCLES;
+    u32 instructionsBit = 1u << PLATFORM_PERF_COUNTER_INSTRUCTIONS;
+    f64 scale = 1.0 / (f64)(divisor ? divisor : 1);
+    u32 length = 0;
+
+    if (bufferSize == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+
+    if ((mask & cyclesBit) && (mask & instructionsBit) && counters[PLATFORM_PERF_COUNTER_CYCLES] > 0) {
+        f64 ipc = (f64)counters[PLATFORM_PERF_COUNTER_INSTRUCTIONS] / (f64)counters[PLATFORM_PERF_COUNTER_CYCLES];
+        length += (u32)snprintf(buffer + length, bufferSize - length, "IPC %.2f", ipc);
+    }
+
+    for (u32 counter = 0; counter < PLATFORM_PERF_COUNTER_COUNT && length < bufferSize; ++counter) {
+        if (!(mask & (1u << counter))) {
+            continue;
+        }
+
+        char value[32];
+        profiler_format_count((f64)counters[counter] * scale, value, sizeof(value));
+        length += (u32)snprintf(buffer + length, bufferSize - length, "%s%s %s", length ? " | " : "", counterNames[counter], value);
+    }
+
+    return length < bufferSize ? length : bufferSize - 1;
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Profiler
+
+ENGINE_API EngineResult profiler_init(const ProfilerConfig *config) {
+    if (!config) {
+        log_error("Invalid ProfilerConfig provided to profiler_init.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (state.initialized) {
+        log_error("profiler_init called while the profiler is already running.");
+        return ENGINE_ERROR;
+    }
+
+    memory_zero(&state, sizeof(ProfilerState));
+    platform_fast_mutex_init(&state.lock);
+    platform_fast_mutex_set_name(&state.lock, "ProfilerZones");
+    state.hardwareCounters = config->hardwareCounters;
+    state.reportInterval = config->reportInterval == 0.0 ? PROFILER_DEFAULT_REPORT_INTERVAL : (config->reportInterval > 0.0 ? config->reportInterval : 0.0);
+    state.secondsPerTick = 1.0 / (f64)platform_get_performance_frequency();
+    state.initialized = true;
+
+    // Open the main thread's counters now so a missing PMU is reported once, up front.
+    threadCounterState = PROFILER_COUNTERS_UNTRIED;
+    profiler_thread_counters();
+
+    log_info("Profiler initialized%s.", profiler_has_hardware_counters() ? " with hardware counters" : "");
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void profiler_shutdown(void) {
+    if (!state.initialized) {
+        log_warning("profiler_shutdown called while the profiler is not running.");
+        return;
+    }
+
+    profiler_report();
+    profiler_report_locks(PROFILER_LOCK_REPORT_COUNT);
+
+    // Counters of other threads are closed here as well; those threads must
+    // no longer be profiling.
+    for (u32 i = 0; i < state.threadCount; ++i) {
+        platform_perf_counters_close(state.threadCounters[i]);
+    }
+
+    threadCounters = NULL;
+    threadCounterState = PROFILER_COUNTERS_UNTRIED;
+    memory_zero(&state, sizeof(ProfilerState));
+
+    log_info("Profiler shutdown completed.");
+}
+
+ENGINE_API b8 profiler_has_hardware_counters(void) {
+    return state.initialized && profiler_thread_counters() != NULL;
+}
+
+ENGINE_API void profiler_read_counters(PlatformPerfCounterValues *values) {
+    if (!values) {
+        log_error("Invalid PlatformPerfCounterValues provided to profiler_read_counters.");
+        return;
+    }
+
+    void *counters = state.initialized ? profiler_thread_counters() : NULL;
+    if (!counters || !platform_perf_counters_read(counters, values)) {
+        memory_zero(values, sizeof(PlatformPerfCounterValues));
+    }
+}
+
+ENGINE_API u32 profiler_format_counters(const PlatformPerfCounterValues *begin, const PlatformPerfCounterValues *end, u64 divisor, char *buffer, u32 bufferSize) {
+    if (!begin || !end || !buffer || bufferSize == 0) {
+        log_error("Invalid counters or buffer provided to profiler_format_counters.");
+        return 0;
+    }
+
+    u64 deltas[PLATFORM_PERF_COUNTER_COUNT];
+    for (u32 counter = 0; counter < PLATFORM_PERF_COUNTER_COUNT; ++counter) {
+        deltas[counter] = end->values[counter] - begin->values[counter];
+    }
+
+    return profiler_format_totals(deltas, begin->validMask & end->validMask, divisor, buffer, bufferSize);
+}
+
+ENGINE_API void profiler_zone_begin(ProfilerZone *zone, const char *name) {
+    if (!zone || !name) {
+        log_error("Invalid ProfilerZone or name provided to profiler_zone_begin.");
+        return;
+    }
+
+    zone->zoneId = INVALID_ID_U32;
+    if (!state.initialized) {
+        return;
+    }
+
+    platform_fast_mutex_lock(&state.lock);
+    zone->zoneId = profiler_find_zone(name);
+    platform_fast_mutex_unlock(&state.lock);
+
+    // Counters are read last so registration is not counted in the zone.
+    profiler_read_counters(&zone->startCounters);
+    zone->startTicks = platform_get_performance_counter();
+}
+
+ENGINE_API void profiler_zone_end(ProfilerZone *zone) {
+    u64 endTicks = platform_get_performance_counter();
+
+    if (!zone || zone->zoneId == INVALID_ID_U32 || !state.initialized) {
+        return;
+    }
+
+    PlatformPerfCounterValues endCounters;
+    profiler_read_counters(&endCounters);
+
+    f64 seconds = (f64)(endTicks - zone->startTicks) * state.secondsPerTick;
+    u32 validMask = zone->startCounters.validMask & endCounters.validMask;
+
+    platform_fast_mutex_lock(&state.lock);
+
+    ProfilerZoneStats *stats = &state.zones[zone->zoneId];
+    stats->calls++;
+    stats->totalSeconds += seconds;
+    if (seconds > stats->maxSeconds) {
+        stats->maxSeconds = seconds;
+    }
+
+    stats->counterMask &= validMask;
+    for (u32 counter = 0; counter < PLATFORM_PERF_COUNTER_COUNT; ++counter) {
+        stats->counters[counter] += endCounters.values[counter] - zone->startCounters.values[counter];
+    }
+
+    platform_fast_mutex_unlock(&state.lock);
+}
+
+ENGINE_API void profiler_zone_add_work(ProfilerZone *zone, f64 seconds) {
+    if (!zone || zone->zoneId == INVALID_ID_U32 || !state.initialized) {
+        return;
+    }
+
+    platform_fast_mutex_lock(&state.lock);
+    state.zones[zone->zoneId].workSeconds += seconds;
+    platform_fast_mutex_unlock(&state.lock);
+}
+
+ENGINE_API void profiler_frame_end(void) {
+    if (!state.initialized) {
+        return;
+    }
+
+    u64 now = platform_get_performance_counter();
+    if (state.frameStartTicks == 0) {
+        // First frame: only start the clock.
+        state.frameStartTicks = now;
+        profiler_read_counters(&state.frameStartCounters);
+        return;
+    }
+
+    f64 seconds = (f64)(now - state.frameStartTicks) * state.secondsPerTick;
+    state.frameStartTicks = now;
+    state.frameCount++;
+    state.frameSeconds += seconds;
+    if (seconds > state.frameMaxSeconds) {
+        state.frameMaxSeconds = seconds;
+    }
+
+    if (state.reportInterval <= 0.0 || state.frameSeconds < state.reportInterval) {
+        return;
+    }
+
+    PlatformPerfCounterValues endCounters;
+    profiler_read_counters(&endCounters);
+
+    char counters[256];
+    u32 length = profiler_format_counters(&state.frameStartCounters, &endCounters, state.frameCount, counters, sizeof(counters));
+
+    f64 average = state.frameSeconds / (f64)state.frameCount;
+    log_info("Frame: %.2f ms avg, %.2f ms max, %.1f fps over %llu frames%s%s", average * 1000.0, state.frameMaxSeconds * 1000.0,
+             1.0 / average, state.frameCount, length ? " | per frame: " : "", length ? counters : "");
+
+    state.frameCount = 0;
+    state.frameSeconds = 0.0;
+    state.frameMaxSeconds = 0.0;
+    state.frameStartCounters = endCounters;
+}
+
+ENGINE_API u32 profiler_get_zone_stats(ProfilerZoneStats *stats, u32 maxStats) {
+    if (!stats) {
+        log_error("Invalid ProfilerZoneStats array provided to profiler_get_zone_stats.");
+        return 0;
+    }
+
+    ProfilerZoneStats sorted[PROFILER_MAX_ZONES];
+
+    platform_fast_mutex_lock(&state.lock);
+    u32 zoneCount = state.zoneCount;
+    memory_copy(sorted, state.zones, sizeof(ProfilerZoneStats) * zoneCount);
+    platform_fast_mutex_unlock(&state.lock);
+
+    // Insertion sort by total time; the zone table is small.
+    for (u32 i = 1; i < zoneCount; ++i) {
+        ProfilerZoneStats zone = sorted[i];
+        u32 position = i;
+        while (position > 0 && sorted[position - 1].totalSeconds < zone.totalSeconds) {
+            sorted[position] = sorted[position - 1];
+            position--;
+        }
+        sorted[position] = zone;
+    }
+
+    u32 count = zoneCount < maxStats ? zoneCount : maxStats;
+    memory_copy(stats, sorted, sizeof(ProfilerZoneStats) * count);
+    return count;
+}
+
+ENGINE_API void profiler_report(void) {
+    ProfilerZoneStats stats[PROFILER_MAX_ZONES];
+    u32 count = profiler_get_zone_stats(stats, PROFILER_MAX_ZONES);
+    if (count == 0) {
+        return;
+    }
+
+    log_info("Profiler zones (by total time):");
+    for (u32 i = 0; i < count; ++i) {
+        const ProfilerZoneStats *zone = &stats[i];
+        if (zone->calls == 0) {
+            continue;
+        }
+
+        char counters[256];
+        u32 length = profiler_format_totals(zone->counters, zone->counterMask, zone->calls, counters, sizeof(counters));
+
+        // Zones that fan work out to jobs report how many threads were busy on average.
+        char parallelism[32] = "";
+        if (zone->workSeconds > 0.0 && zone->totalSeconds > 0.0) {
+            snprintf(parallelism, sizeof(parallelism), " | parallelism %.2f", zone->workSeconds / zone->totalSeconds);
+        }
+        log_info("  %-24s %8llu calls %10.3f ms total %9.3f us avg %9.3f us max%s%s%s", zone->name, zone->calls, zone->totalSeconds * 1000.0,
+                 zone->totalSeconds * 1e6 / (f64)zone->calls, zone->maxSeconds * 1e6, parallelism, length ? " | per call: " : "", length ? counters : "");
+    }
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Lock Contention
+
+#if ENGINE_ENABLE_LOCK_PROFILER
+/**
+ * @brief Raises a maximum to value if it is larger.
+ *
+ * @param maximum A pointer to the running maximum.
+ * @param value The candidate value.
+ * @return void
+ */
+static void profiler_lock_update_max(PlatformAtomicI64 *maximum, i64 value) {
+    i64 current = platform_atomic_load_i64(maximum);
+    while (value > current && !platform_atomic_compare_exchange_i64(maximum, &current, value)) {
+    }
+}
+
+ENGINE_API ProfilerLock *profiler_lock_register(const char *name) {
+    if (!name) {
+        log_error("Invalid name provided to profiler_lock_register.");
+        return NULL;
+    }
+
+    // The registry lock is never named, so this cannot recurse.
+    platform_fast_mutex_lock(&lockRegistryLock);
+
+    i32 count = platform_atomic_load_i32(&lockCount);
+    for (i32 i = 0; i < count; ++i) {
+        if (locks[i].name == name || strcmp(locks[i].name, name) == 0) {
+            platform_fast_mutex_unlock(&lockRegistryLock);
+            return &locks[i];
+        }
+    }
+
+    ProfilerLock *lock = NULL;
+    if (count < PROFILER_MAX_LOCKS) {
+        lock = &locks[count];
+        memory_zero(lock, sizeof(ProfilerLock));
+        lock->name = name;
+        platform_atomic_store_i32(&lockCount, count + 1);
+    }
+
+    platform_fast_mutex_unlock(&lockRegistryLock);
+
+    if (!lock) {
+        log_warning("Lock profiler table is full; lock '%s' is not profiled.", name);
+    }
+    return lock;
+}
+
+ENGINE_API void profiler_lock_acquired(ProfilerLock *lock, u64 waitTicks) {
+    platform_atomic_fetch_add_i64(&lock->acquisitions, 1);
+    if (waitTicks == 0) {
+        return;
+    }
+
+    platform_atomic_fetch_add_i64(&lock->contentions, 1);
+    platform_atomic_fetch_add_i64(&lock->waitTicks, (i64)waitTicks);
+    profiler_lock_update_max(&lock->maxWaitTicks, (i64)waitTicks);
+}
+
+ENGINE_API void profiler_lock_released(ProfilerLock *lock, u64 holdTicks) {
+    platform_atomic_fetch_add_i64(&lock->holdTicks, (i64)holdTicks);
+    profiler_lock_update_max(&lock->maxHoldTicks, (i64)holdTicks);
+}
+#endif
+
+ENGINE_API u32 profiler_get_lock_stats(ProfilerLockStats *stats, u32 maxStats) {
+    if (!stats) {
+        log_error("Invalid ProfilerLockStats array provided to profiler_get_lock_stats.");
+        return 0;
+    }
+
+#if ENGINE_ENABLE_LOCK_PROFILER
+    f64 secondsPerTick = 1.0 / (f64)platform_get_performance_frequency();
+    u32 count = (u32)platform_atomic_load_i32(&lockCount);
+
+    ProfilerLockStats sorted[PROFILER_MAX_LOCKS];
+    for (u32 i = 0; i < count; ++i) {
+        ProfilerLock *lock = &locks[i];
+        sorted[i].name = lock->name;
+        sorted[i].acquisitions = (u64)platform_atomic_load_i64(&lock->acquisitions);
+        sorted[i].contentions = (u64)platform_atomic_load_i64(&lock->contentions);
+        sorted[i].waitSeconds = (f64)platform_atomic_load_i64(&lock->waitTicks) * secondsPerTick;
+        sorted[i].maxWaitSeconds = (f64)platform_atomic_load_i64(&lock->maxWaitTicks) * secondsPerTick;
+        sorted[i].holdSeconds = (f64)platform_atomic_load_i64(&lock->holdTicks) * secondsPerTick;
+        sorted[i].maxHoldSeconds = (f64)platform_atomic_load_i64(&lock->maxHoldTicks) * secondsPerTick;
+    }
+
+    // Insertion sort by wait time; the lock table is small.
+    for (u32 i = 1; i < count; ++i) {
+        ProfilerLockStats lock = sorted[i];
+        u32 position = i;
+        while (position > 0 && sorted[position - 1].waitSeconds < lock.waitSeconds) {
+            sorted[position] = sorted[position - 1];
+            position--;
+        }
+        sorted[position] = lock;
+    }
+
+    count = count < maxStats ? count : maxStats;
+    memory_copy(stats, sorted, sizeof(ProfilerLockStats) * count);
+    return count;
+#else
+    ENGINE_UNUSED(maxStats);
+    return 0;
+#endif
+}
+
+ENGINE_API void profiler_report_locks(u32 maxLocks) {
+#if ENGINE_ENABLE_LOCK_PROFILER
+    ProfilerLockStats stats[PROFILER_MAX_LOCKS];
+    u32 count = profiler_get_lock_stats(stats, PROFILER_MAX_LOCKS);
+    if (count == 0) {
+        return;
+    }
+
+    if (stats[0].contentions == 0) {
+        log_info("Lock profiler: no contention across %u named locks.", count);
+        return;
+    }
+
+    log_info("Most contended locks (by total wait time):");
+    for (u32 i = 0; i < count && i < maxLocks && stats[i].contentions > 0; ++i) {
+        const ProfilerLockStats *lock = &stats[i];
+        log_info("  %-24s %10llu acquired %9.2f%% contended %10.3f ms waited %9.3f us max wait %10.3f ms held %9.3f us avg hold",
+                 lock->name, lock->acquisitions, 100.0 * (f64)lock->contentions / (f64)lock->acquisitions, lock->waitSeconds * 1000.0,
+                 lock->maxWaitSeconds * 1e6, lock->holdSeconds * 1000.0, lock->holdSeconds * 1e6 / (f64)lock->acquisitions);
+    }
+#else
+    ENGINE_UNUSED(maxLocks);
+#endif
+}
+
+#pragma endregion
+// =============================================================================
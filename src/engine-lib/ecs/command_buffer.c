@@ -0,0 +1,467 @@
+#include "engine/ecs/command_buffer.h"
+#include "engine/logging.h"
+#include "engine/memory.h"
+#include "engine/profiler.h"
+
+// Bytes reserved for a block header, keeping the block's memory 16-byte aligned.
+#define ECS_COMMAND_BLOCK_HEADER_SIZE ((sizeof(EcsCommandBlock) + 15) & ~(u64)15)
+
+// =============================================================================
+#pragma region Arena
+
+/**
+ * @brief Gets the memory that follows a block's header.
+ *
+ * @param block A pointer to the block.
+ * @return u8* The block's memory.
+ */
+static ENGINE_INLINE u8 *ecs_command_block_memory(EcsCommandBlock *block) {
+    return (u8 *)block + ECS_COMMAND_BLOCK_HEADER_SIZE;
+}
+
+/**
+ * @brief Checks whether a block has room for one more command and its data.
+ *
+ * @param block A pointer to the block.
+ * @param dataSize The aligned size of the command's data.
+ * @return b8 True if both fit.
+ */
+static ENGINE_INLINE b8 ecs_command_block_fits(const EcsCommandBlock *block, u32 dataSize) {
+    return (u64)(block->commandCount + 1) * sizeof(EcsCommand) + dataSize <= block->dataOffset;
+}
+
+/**
+ * @brief Allocates an empty arena block.
+ *
+ * @param pool A pointer to the memory pool.
+ * @param size The usable size of the block in bytes.
+ * @return EcsCommandBlock* The block, or NULL on failure.
+ */
+static EcsCommandBlock *ecs_command_block_create(MemoryPool *pool, u32 size) {
+    EcsCommandBlock *block = (EcsCommandBlock *)memory_allocate_aligned(pool, ECS_COMMAND_BLOCK_HEADER_SIZE + size, 16, MEMORY_TAG_ECS);
+    if (!block) {
+        log_error("Failed to allocate a %u byte command block.", size);
+        return NULL;
+    }
+
+    block->next = NULL;
+    block->size = size;
+    block->commandCount = 0;
+    block->dataOffset = size;
+    return block;
+}
+
+/**
+ * @brief Appends a command to a buffer, moving to the next kept block or
+ * allocating one when the active block is full.
+ *
+ * @param buffer A pointer to the buffer.
+ * @param dataSize The size of the command's component data, 0 for none.
+ * @param data Receives a pointer to the reserved data, if dataSize is non-zero.
+ * @return EcsCommand* The command to fill, or NULL on failure.
+ */
+static EcsCommand *ecs_command_push(EcsCommandBuffer *buffer, u32 dataSize, void **data) {
+    u32 alignedSize = (dataSize + 15) & ~15u;
+    EcsCommandBlock *block = buffer->active;
+    if (!block || !ecs_command_block_fits(block, alignedSize)) {
+        EcsCommandBlock *next = block ? block->next : buffer->first;
+        if (!next || !ecs_command_block_fits(next, alignedSize)) {
+            u32 size = (u32)sizeof(EcsCommand) + alignedSize;
+            EcsCommandBlock *created = ecs_command_block_create(buffer->ecs->pool, size > ECS_COMMAND_BLOCK_SIZE ? size : ECS_COMMAND_BLOCK_SIZE);
+            if (!created) {
+                return NULL;
+            }
+
+            // Blocks too small for this command stay in the chain for later ones.
+            created->next = next;
+            if (block) {
+                block->next = created;
+            } else {
+                buffer->first = created;
+            }
+            next = created;
+        }
+        block = next;
+        buffer->active = block;
+    }
+
+    u8 *memory = ecs_command_block_memory(block);
+    if (alignedSize) {
+        block->dataOffset -= alignedSize;
+        *data = memory + block->dataOffset;
+    }
+
+    EcsCommand *command = (EcsCommand *)memory + block->commandCount++;
+    buffer->commandCount++;
+    return command;
+}
+
+/**
+ * @brief Rewinds a buffer to its first block, keeping every block.
+ *
+ * @param buffer A pointer to the buffer.
+ * @return void
+ */
+static void ecs_command_buffer_rewind(EcsCommandBuffer *buffer) {
+    for (EcsCommandBlock *block = buffer->first; block; block = block->next) {
+        block->commandCount = 0;
+        block->dataOffset = block->size;
+    }
+    buffer->active = buffer->first;
+    buffer->commandCount = 0;
+    buffer->createCount = 0;
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Playback
+
+/**
+ * @brief Stable LSD radix sort of command references by key, one byte per
+ * pass. All byte histograms are built in one read, and bytes that are the
+ * same in every key are skipped, so small keys cost few passes. Input already
+ * in order, the common case for a single recording thread, is left alone.
+ *
+ * @param refs The references to sort.
+ * @param scratch Scratch space for count references.
+ * @param count The number of references.
+ * @return void
+ */
+static void ecs_command_sort(EcsCommandRef *refs, EcsCommandRef *scratch, u32 count) {
+    u32 sorted = 1;
+    while (sorted < count && refs[sorted - 1].key <= refs[sorted].key) {
+        sorted++;
+    }
+    if (sorted >= count) {
+        return;
+    }
+
+    u32 histograms[8][256];
+    memory_zero(histograms, sizeof(histograms));
+    for (u32 i = 0; i < count; ++i) {
+        u64 key = refs[i].key;
+        for (u32 digit = 0; digit < 8; ++digit) {
+            histograms[digit][(key >> (digit * 8)) & 0xff]++;
+        }
+    }
+
+    EcsCommandRef *from = refs;
+    EcsCommandRef *to = scratch;
+    for (u32 digit = 0; digit < 8; ++digit) {
+        u32 *histogram = histograms[digit];
+        if (histogram[(from[0].key >> (digit * 8)) & 0xff] == count) {
+            continue;
+        }
+
+        u32 offset = 0;
+        for (u32 bucket = 0; bucket < 256; ++bucket) {
+            u32 bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        for (u32 i = 0; i < count; ++i) {
+            to[histogram[(from[i].key >> (digit * 8)) & 0xff]++] = from[i];
+        }
+
+        EcsCommandRef *swap = from;
+        from = to;
+        to = swap;
+    }
+
+    if (from != refs) {
+        memory_copy(refs, from, sizeof(EcsCommandRef) * count);
+    }
+}
+
+/**
+ * @brief Grows the queue's scratch arrays to hold the commands and creates of
+ * one playback.
+ *
+ * @param queue A pointer to the queue.
+ * @param commandCount The number of commands to play back.
+ * @param createCount The number of entities to create.
+ * @return b8 True if the arrays are large enough.
+ */
+static b8 ecs_command_queue_reserve(EcsCommandQueue *queue, u32 commandCount, u32 createCount) {
+    MemoryPool *pool = queue->ecs->pool;
+    if (commandCount > queue->refCapacity) {
+        if (queue->refs) {
+            memory_free(pool, queue->refs, MEMORY_TAG_ECS);
+            memory_free(pool, queue->scratch, MEMORY_TAG_ECS);
+        }
+
+        u32 capacity = queue->refCapacity * 2 > commandCount ? queue->refCapacity * 2 : commandCount;
+        queue->refs = (EcsCommandRef *)memory_allocate(pool, sizeof(EcsCommandRef) * capacity, MEMORY_TAG_ECS);
+        queue->scratch = (EcsCommandRef *)memory_allocate(pool, sizeof(EcsCommandRef) * capacity, MEMORY_TAG_ECS);
+        queue->refCapacity = capacity;
+        if (!queue->refs || !queue->scratch) {
+            log_error("Failed to allocate playback scratch for %u commands.", commandCount);
+            if (queue->refs) {
+                memory_free(pool, queue->refs, MEMORY_TAG_ECS);
+            }
+            if (queue->scratch) {
+                memory_free(pool, queue->scratch, MEMORY_TAG_ECS);
+            }
+            queue->refs = NULL;
+            queue->scratch = NULL;
+            queue->refCapacity = 0;
+            return false;
+        }
+    }
+
+    if (createCount > queue->createdCapacity) {
+        if (queue->created) {
+            memory_free(pool, queue->created, MEMORY_TAG_ECS);
+        }
+
+        u32 capacity = queue->createdCapacity * 2 > createCount ? queue->createdCapacity * 2 : createCount;
+        queue->created = (Entity *)memory_allocate(pool, sizeof(Entity) * capacity, MEMORY_TAG_ECS);
+        queue->createdCapacity = queue->created ? capacity : 0;
+        if (!queue->created) {
+            log_error("Failed to allocate playback scratch for %u created entities.", createCount);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Maps a pending handle to the entity created for it in this playback.
+ * Live handles are returned unchanged.
+ *
+ * @param queue A pointer to the queue.
+ * @param entity The recorded entity handle.
+ * @return Entity The real entity, or INVALID_ENTITY if the handle is not from this playback.
+ */
+static Entity ecs_command_resolve(const EcsCommandQueue *queue, Entity entity) {
+    if (!ecs_entity_is_pending(entity)) {
+        return entity;
+    }
+
+    u32 buffer = ecs_entity_generation(entity) & ~ECS_COMMAND_PENDING_GENERATION;
+    u32 index = ecs_entity_index(entity);
+    if (buffer >= ECS_COMMAND_MAX_BUFFERS || index >= queue->buffers[buffer].createCount) {
+        return INVALID_ENTITY;
+    }
+    return queue->created[queue->createdOffsets[buffer] + index];
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Command Queue
+
+ENGINE_API EngineResult ecs_command_queue_init(EcsCommandQueue *queue, ECSManager *ecs) {
+    if (!queue || !ecs) {
+        log_error("Invalid EcsCommandQueue or ECSManager provided to ecs_command_queue_init.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    memory_zero(queue, sizeof(EcsCommandQueue));
+    queue->ecs = ecs;
+    for (u32 i = 0; i < ECS_COMMAND_MAX_BUFFERS; ++i) {
+        queue->buffers[i].ecs = ecs;
+        queue->buffers[i].index = i;
+    }
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void ecs_command_queue_shutdown(EcsCommandQueue *queue) {
+    if (!queue || !queue->ecs) {
+        log_error("Invalid EcsCommandQueue provided to ecs_command_queue_shutdown.");
+        return;
+    }
+
+    MemoryPool *pool = queue->ecs->pool;
+    for (u32 i = 0; i < ECS_COMMAND_MAX_BUFFERS; ++i) {
+        EcsCommandBlock *block = queue->buffers[i].first;
+        while (block) {
+            EcsCommandBlock *next = block->next;
+            memory_free_aligned(pool, block, MEMORY_TAG_ECS);
+            block = next;
+        }
+    }
+    if (queue->refs) {
+        memory_free(pool, queue->refs, MEMORY_TAG_ECS);
+        memory_free(pool, queue->scratch, MEMORY_TAG_ECS);
+    }
+    if (queue->created) {
+        memory_free(pool, queue->created, MEMORY_TAG_ECS);
+    }
+    memory_zero(queue, sizeof(EcsCommandQueue));
+}
+
+ENGINE_API EcsCommandBuffer *ecs_command_queue_get_buffer(EcsCommandQueue *queue) {
+    u32 worker = job_system_get_worker_index();
+    return &queue->buffers[worker < JOB_SYSTEM_MAX_WORKERS ? worker : JOB_SYSTEM_MAX_WORKERS];
+}
+
+ENGINE_API u32 ecs_command_queue_flush(EcsCommandQueue *queue) {
+    if (!queue || !queue->ecs) {
+        log_error("Invalid EcsCommandQueue provided to ecs_command_queue_flush.");
+        return 0;
+    }
+
+    u32 commandCount = 0;
+    u32 createCount = 0;
+    for (u32 i = 0; i < ECS_COMMAND_MAX_BUFFERS; ++i) {
+        queue->createdOffsets[i] = createCount;
+        commandCount += queue->buffers[i].commandCount;
+        createCount += queue->buffers[i].createCount;
+    }
+    if (commandCount == 0) {
+        return 0;
+    }
+
+    PROFILER_ZONE_BEGIN(zone, "EcsCommandFlush");
+    ECSManager *ecs = queue->ecs;
+    if (!ecs_command_queue_reserve(queue, commandCount, createCount)) {
+        log_error("Dropping %u ECS commands.", commandCount);
+        for (u32 i = 0; i < ECS_COMMAND_MAX_BUFFERS; ++i) {
+            ecs_command_buffer_rewind(&queue->buffers[i]);
+        }
+        PROFILER_ZONE_END(zone);
+        return 0;
+    }
+
+    // Gather buffer by buffer in recording order, then sort by key. The sort
+    // is stable, so commands with equal keys stay in recording order.
+    EcsCommandRef *refs = queue->refs;
+    u32 count = 0;
+    for (u32 i = 0; i < ECS_COMMAND_MAX_BUFFERS; ++i) {
+        EcsCommandBuffer *buffer = &queue->buffers[i];
+        for (EcsCommandBlock *block = buffer->first; block; block = block->next) {
+            const EcsCommand *commands = (const EcsCommand *)ecs_command_block_memory(block);
+            for (u32 c = 0; c < block->commandCount; ++c) {
+                refs[count++] = (EcsCommandRef){commands[c].sortKey, &commands[c], i, commands[c].entity};
+            }
+        }
+    }
+    ecs_command_sort(refs, queue->scratch, count);
+
+    // Creates, in key order, so pending handles map to the same entities
+    // whichever threads recorded them.
+    for (u32 i = 0; i < count; ++i) {
+        if (refs[i].command->type == ECS_COMMAND_CREATE) {
+            queue->created[queue->createdOffsets[refs[i].buffer] + ecs_entity_index(refs[i].entity)] = ecs_create_entity(ecs);
+        }
+    }
+
+    // Split the rest: destroys keep key order at the front of refs, adds and
+    // removes go to scratch keyed by where their writes land.
+    u32 destroyCount = 0;
+    u32 changeCount = 0;
+    for (u32 i = 0; i < count; ++i) {
+        EcsCommandRef ref = refs[i];
+        if (ref.command->type == ECS_COMMAND_CREATE) {
+            continue;
+        }
+
+        ref.entity = ecs_command_resolve(queue, ref.entity);
+        if (ref.command->type == ECS_COMMAND_DESTROY) {
+            refs[destroyCount++] = ref;
+            continue;
+        }
+
+        u32 index = ecs_entity_index(ref.entity);
+        u64 group = ref.command->component;
+        if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+            group = ref.entity != INVALID_ENTITY && index < ecs->recordCapacity ? ecs->records[index].archetype : INVALID_ID_U32;
+        }
+        ref.key = (group << 32) | index;
+        queue->scratch[changeCount++] = ref;
+    }
+
+    // The tail of refs past the destroys is free to use as sort scratch.
+    EcsCommandRef *changes = queue->scratch;
+    ecs_command_sort(changes, refs + destroyCount, changeCount);
+    for (u32 i = 0; i < changeCount; ++i) {
+        const EcsCommand *command = changes[i].command;
+        if (changes[i].entity == INVALID_ENTITY) {
+            log_error("Command on a pending entity from another playback dropped.");
+        } else if (command->type == ECS_COMMAND_ADD) {
+            ecs_add_component(ecs, changes[i].entity, command->component, command->data);
+        } else {
+            ecs_remove_component(ecs, changes[i].entity, command->component);
+        }
+    }
+
+    for (u32 i = 0; i < destroyCount; ++i) {
+        if (refs[i].entity != INVALID_ENTITY) {
+            ecs_destroy_entity(ecs, refs[i].entity);
+        }
+    }
+
+    for (u32 i = 0; i < ECS_COMMAND_MAX_BUFFERS; ++i) {
+        ecs_command_buffer_rewind(&queue->buffers[i]);
+    }
+    PROFILER_ZONE_END(zone);
+    return commandCount;
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Recording
+
+ENGINE_API Entity ecs_command_create_entity(EcsCommandBuffer *buffer, u64 sortKey) {
+    if (!buffer) {
+        log_error("Invalid EcsCommandBuffer provided to ecs_command_create_entity.");
+        return INVALID_ENTITY;
+    }
+
+    EcsCommand *command = ecs_command_push(buffer, 0, NULL);
+    if (!command) {
+        return INVALID_ENTITY;
+    }
+
+    // The pending handle names the buffer and the create's position in it.
+    Entity entity = ecs_entity_make(buffer->createCount++, ECS_COMMAND_PENDING_GENERATION | buffer->index);
+    *command = (EcsCommand){sortKey, entity, ECS_COMMAND_CREATE, INVALID_COMPONENT_TYPE, NULL};
+    return entity;
+}
+
+ENGINE_API void ecs_command_destroy_entity(EcsCommandBuffer *buffer, u64 sortKey, Entity entity) {
+    if (!buffer || entity == INVALID_ENTITY) {
+        log_error("Invalid EcsCommandBuffer or Entity provided to ecs_command_destroy_entity.");
+        return;
+    }
+
+    EcsCommand *command = ecs_command_push(buffer, 0, NULL);
+    if (command) {
+        *command = (EcsCommand){sortKey, entity, ECS_COMMAND_DESTROY, INVALID_COMPONENT_TYPE, NULL};
+    }
+}
+
+ENGINE_API void *ecs_command_add_component(EcsCommandBuffer *buffer, u64 sortKey, Entity entity, ComponentType type, const void *componentData) {
+    if (!buffer || entity == INVALID_ENTITY || type >= buffer->ecs->registeredComponents) {
+        log_error("Invalid EcsCommandBuffer, Entity or ComponentType provided to ecs_command_add_component.");
+        return NULL;
+    }
+
+    u32 size = componentData ? buffer->ecs->componentArrays[type].size : 0;
+    void *data = NULL;
+    EcsCommand *command = ecs_command_push(buffer, size, &data);
+    if (!command) {
+        return NULL;
+    }
+
+    if (data) {
+        memory_copy(data, componentData, size);
+    }
+    *command = (EcsCommand){sortKey, entity, ECS_COMMAND_ADD, type, data};
+    return data;
+}
+
+ENGINE_API void ecs_command_remove_component(EcsCommandBuffer *buffer, u64 sortKey, Entity entity, ComponentType type) {
+    if (!buffer || entity == INVALID_ENTITY || type >= buffer->ecs->registeredComponents) {
+        log_error("Invalid EcsCommandBuffer, Entity or ComponentType provided to ecs_command_remove_component.");
+        return;
+    }
+
+    EcsCommand *command = ecs_command_push(buffer, 0, NULL);
+    if (command) {
+        *command = (EcsCommand){sortKey, entity, ECS_COMMAND_REMOVE, type, NULL};
+    }
+}
+
+#pragma endregion
+// =============================================================================
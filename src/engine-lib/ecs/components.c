@@ -0,0 +1,6 @@
+#include "engine/components/position.h"
+#include "engine/components/velocity.h"
+
+// Static IDs of the engine's built-in component types.
+ECS_COMPONENT(Position)
+ECS_COMPONENT(Velocity)
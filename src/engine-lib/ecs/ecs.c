@@ -0,0 +1,3651 @@
+#include "engine/ecs/ecs.h"
+#include "engine/logging.h"
+
+/**
+ * @brief A component type declared with ECS_COMPONENT.
+ */
+typedef struct EcsComponentDecl {
+    const char *name; /**< The type's name. */
+    u32 size;         /**< The size of the component in bytes. */
+    u32 alignment;    /**< The alignment of the component in bytes. */
+} EcsComponentDecl;
+
+// Types declared at load time, in ID order. Written only by constructors.
+ENGINE_GLOBAL EcsComponentDecl declaredComponents[ECS_MAX_COMPONENTS];
+ENGINE_GLOBAL u32 declaredComponentCount = 0;
+
+#define ECS_SNAPSHOT_MAGIC 0x31534345u // "ECS1"
+#define ECS_SNAPSHOT_VERSION 1
+#define ECS_SNAPSHOT_ALIGNMENT 16
+
+/**
+ * @brief Header of an ECS snapshot. The blocks after it follow in a fixed
+ * order, each at an ECS_SNAPSHOT_ALIGNMENT offset: generations, free indices,
+ * the type table, then the storage's blocks.
+ */
+typedef struct EcsSnapshotHeader {
+    u32 magic;          /**< ECS_SNAPSHOT_MAGIC. */
+    u32 version;        /**< ECS_SNAPSHOT_VERSION. */
+    u64 size;           /**< The size of the whole snapshot in bytes. */
+    u32 storage;        /**< The ECSStorage the snapshot was taken from. */
+    u32 componentCount; /**< The number of registered component types. */
+    u32 nextIndex;      /**< The next never-used entity index. */
+    u32 freeCount;      /**< The number of reusable entity indices. */
+    u32 archetypeCount; /**< The number of archetypes (archetype storage only). */
+    u32 groupCount;     /**< The number of groups (sparse-set storage only). */
+    u32 chunkSize;      /**< ECS_CHUNK_SIZE of the build that took the snapshot. */
+    u32 pageSize;       /**< ECS_SPARSE_PAGE_SIZE of the build that took the snapshot. */
+} EcsSnapshotHeader;
+
+/**
+ * @brief Entry of a snapshot's type table.
+ */
+typedef struct EcsSnapshotType {
+    u32 size;      /**< The size of the component in bytes. */
+    u32 count;     /**< The number of entities with the component. */
+    u32 pageCount; /**< The number of sparse pages stored (sparse-set storage only). */
+    u32 reserved;  /**< Padding, 0. */
+} EcsSnapshotType;
+
+/**
+ * @brief Entry of a snapshot's archetype table. The archetype's chunks follow
+ * the table in order; all are full but the last.
+ */
+typedef struct EcsSnapshotArchetype {
+    EcsSignature signature; /**< Component types of the archetype. */
+    u32 capacity;           /**< Rows per chunk. */
+    u32 chunkCount;         /**< The number of chunks stored. */
+    u32 entityCount;        /**< The number of entities in the archetype. */
+    u32 reserved;           /**< Padding, 0. */
+} EcsSnapshotArchetype;
+
+// Column of every tag type. Tags have no data, but a present tag's column is
+// not NULL, so views and component pointers still report it.
+ENGINE_GLOBAL u8 tagColumn[ECS_COMPONENT_ALIGNMENT];
+
+// =============================================================================
+#pragma region Helpers
+
+/**
+ * @brief Checks that a component type is registered.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param type The component type to check.
+ * @return b8 True if the type is registered.
+ */
+static ENGINE_INLINE b8 ecs_is_valid_type(const ECSManager *ecs, ComponentType type) {
+    return type < ecs->registeredComponents;
+}
+
+/**
+ * @brief Checks that an entity handle is alive: its index has been handed out
+ * and its generation is the index's current one.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entity The entity handle to check.
+ * @return b8 True if the entity is alive.
+ */
+static ENGINE_INLINE b8 ecs_is_valid_entity(const ECSManager *ecs, Entity entity) {
+    u32 index = ecs_entity_index(entity);
+    return index < ecs->entityManager.nextIndex && ecs->entityManager.generations[index] == ecs_entity_generation(entity);
+}
+
+/**
+ * @brief Registers a component type with its metadata. Storage is allocated
+ * when the first component of the type is added; a tag's data points at
+ * tagColumn and is never allocated.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param name The type's name, or NULL.
+ * @param size The size of the component in bytes, 0 for a tag.
+ * @param alignment The alignment of the component in bytes.
+ * @return ComponentType The new component type, or INVALID_COMPONENT_TYPE if the ECS is full.
+ */
+static ComponentType ecs_register_type(ECSManager *ecs, const char *name, u32 size, u32 alignment) {
+    if (ecs->registeredComponents >= ECS_MAX_COMPONENTS) {
+        log_error("Maximum number of component types (%u) reached.", ECS_MAX_COMPONENTS);
+        return INVALID_COMPONENT_TYPE;
+    }
+
+    ComponentType type = ecs->registeredComponents++;
+    ComponentArray *componentArray = &ecs->componentArrays[type];
+    memory_zero(componentArray, sizeof(ComponentArray));
+    componentArray->data = size == 0 ? tagColumn : NULL;
+    componentArray->size = size;
+    componentArray->alignment = alignment;
+    componentArray->name = name;
+    componentArray->group = INVALID_ID_U32;
+    log_debug("Registered component type %u (%s) with size %u.", type, name ? name : "unnamed", size);
+    return type;
+}
+
+static ENGINE_INLINE b8 ecs_signature_empty(const EcsSignature *signature) {
+    for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+        if (signature->bits[word]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the version to stamp on columns mutated now.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @return u32 The current change version.
+ */
+static ENGINE_INLINE u32 ecs_change_version(const ECSManager *ecs) {
+    return (u32)platform_atomic_load_i32(&ecs->changeVersion);
+}
+
+/**
+ * @brief Checks whether a column changed within a query's current window:
+ * after its previous pass started and before its current one did. Versions
+ * wrap, so they are compared by signed difference.
+ *
+ * @param query A pointer to the query.
+ * @param version The column's change version.
+ * @return b8 True if the change passes the query's filter.
+ */
+static ENGINE_INLINE b8 ecs_query_version_changed(const EcsQuery *query, u32 version) {
+    return (i32)(version - query->changedSince) > 0 && (i32)(version - query->lastVersion) <= 0;
+}
+
+/**
+ * @brief Marks every query that mentions a component type as stale after a
+ * component of that type was added or removed in sparse-set storage.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param type The component type that changed.
+ * @return void
+ */
+static void ecs_queries_invalidate(ECSManager *ecs, ComponentType type) {
+    for (u32 i = 0; i < ecs->queryCount; ++i) {
+        if (ecs_signature_has(&ecs->queries[i]->watched, type)) {
+            ecs->queries[i]->stale = true;
+        }
+    }
+}
+
+/**
+ * @brief Grows an array allocated from the ECS pool, by doubling, until it
+ * holds at least a number of elements. Grows once however far it has to go.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param array The array to grow, or NULL.
+ * @param elementSize The size of an element in bytes.
+ * @param count The number of elements in use.
+ * @param capacity A pointer to the capacity, updated on success.
+ * @param needed The number of elements the array must hold.
+ * @return void* The array, possibly moved, or NULL if the allocation failed (the old array is kept).
+ */
+static void *ecs_reserve_array(ECSManager *ecs, void *array, u32 elementSize, u32 count, u32 *capacity, u32 needed) {
+    if (needed <= *capacity) {
+        return array;
+    }
+
+    u32 newCapacity = *capacity ? *capacity : 8;
+    while (newCapacity < needed) {
+        newCapacity = newCapacity > MAX_U32 / 2 ? needed : newCapacity * 2;
+    }
+
+    void *grown = memory_allocate(ecs->pool, (u64)elementSize * newCapacity, MEMORY_TAG_ECS);
+    if (!grown) {
+        return NULL;
+    }
+
+    if (array) {
+        memory_copy(grown, array, (u64)elementSize * count);
+        memory_free(ecs->pool, array, MEMORY_TAG_ECS);
+    }
+
+    *capacity = newCapacity;
+    return grown;
+}
+
+/**
+ * @brief Doubles the capacity of an array allocated from the ECS pool.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param array The array to grow, or NULL.
+ * @param elementSize The size of an element in bytes.
+ * @param count The number of elements in use.
+ * @param capacity A pointer to the capacity, updated on success.
+ * @return void* The new array, or NULL if the allocation failed (the old array is kept).
+ */
+static void *ecs_grow_array(ECSManager *ecs, void *array, u32 elementSize, u32 count, u32 *capacity) {
+    return ecs_reserve_array(ecs, array, elementSize, count, capacity, *capacity + 1);
+}
+
+/**
+ * @brief Bumps the generation of a destroyed entity's index, so every
+ * existing handle goes stale, and puts the index on the free list. The
+ * generation stays with the index while it is on the free list.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param index The entity index to free.
+ * @return void
+ */
+static void ecs_entity_release(ECSManager *ecs, u32 index) {
+    EntityManager *entityManager = &ecs->entityManager;
+    entityManager->generations[index]++;
+    if (entityManager->freeCount == entityManager->freeCapacity) {
+        u32 *freeIndices = (u32 *)ecs_grow_array(ecs, entityManager->freeIndices, sizeof(u32), entityManager->freeCount, &entityManager->freeCapacity);
+        if (!freeIndices) {
+            log_error("Failed to grow the entity free list; index %u will not be reused.", index);
+            return;
+        }
+        entityManager->freeIndices = freeIndices;
+    }
+    entityManager->freeIndices[entityManager->freeCount++] = index;
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Sparse Sets
+
+/**
+ * @brief Frees the storage of one component array.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array to free.
+ * @return void
+ */
+static void ecs_free_component_array(ECSManager *ecs, ComponentArray *componentArray) {
+    if (componentArray->data && componentArray->size > 0) {
+        memory_free_aligned(ecs->pool, componentArray->data, MEMORY_TAG_ECS);
+    }
+    if (componentArray->entities) {
+        memory_free(ecs->pool, componentArray->entities, MEMORY_TAG_ECS);
+    }
+    for (u32 page = 0; page < componentArray->sparsePageCount; ++page) {
+        if (componentArray->sparsePages[page]) {
+            memory_free(ecs->pool, componentArray->sparsePages[page], MEMORY_TAG_ECS);
+        }
+    }
+    if (componentArray->sparsePages) {
+        memory_free(ecs->pool, componentArray->sparsePages, MEMORY_TAG_ECS);
+    }
+    if (componentArray->versions) {
+        memory_free(ecs->pool, componentArray->versions, MEMORY_TAG_ECS);
+    }
+    if (componentArray->sortKeys) {
+        memory_free(ecs->pool, componentArray->sortKeys, MEMORY_TAG_ECS);
+    }
+    memory_zero(componentArray, sizeof(ComponentArray));
+}
+
+/**
+ * @brief Looks up the dense index of an entity's component.
+ *
+ * @param componentArray A pointer to the component array.
+ * @param index The entity index.
+ * @return u32 The dense index, or INVALID_ID_U32 if the entity has no component of the type.
+ */
+static ENGINE_INLINE u32 ecs_sparse_get(const ComponentArray *componentArray, u32 index) {
+    u32 page = index / ECS_SPARSE_PAGE_SIZE;
+    if (page >= componentArray->sparsePageCount || !componentArray->sparsePages[page]) {
+        return INVALID_ID_U32;
+    }
+    return componentArray->sparsePages[page][index % ECS_SPARSE_PAGE_SIZE];
+}
+
+/**
+ * @brief Marks the change block holding a packed row as changed now.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array.
+ * @param index The packed row.
+ * @return void
+ */
+static ENGINE_INLINE void ecs_sparse_touch(const ECSManager *ecs, ComponentArray *componentArray, u32 index) {
+    componentArray->versions[index / ECS_CHANGE_BLOCK_SIZE] = ecs_change_version(ecs);
+}
+
+/**
+ * @brief Marks the change blocks holding a run of packed rows as changed now.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array.
+ * @param begin The first packed row.
+ * @param count The number of rows.
+ * @return void
+ */
+static void ecs_sparse_touch_range(const ECSManager *ecs, ComponentArray *componentArray, u32 begin, u32 count) {
+    if (count == 0) {
+        return;
+    }
+
+    u32 version = ecs_change_version(ecs);
+    u32 lastBlock = (begin + count - 1) / ECS_CHANGE_BLOCK_SIZE;
+    for (u32 block = begin / ECS_CHANGE_BLOCK_SIZE; block <= lastBlock; ++block) {
+        componentArray->versions[block] = version;
+    }
+}
+
+/**
+ * @brief Marks every change block of a component array as changed now.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array.
+ * @return void
+ */
+static void ecs_sparse_touch_all(const ECSManager *ecs, ComponentArray *componentArray) {
+    ecs_sparse_touch_range(ecs, componentArray, 0, componentArray->count);
+}
+
+/**
+ * @brief Gets the sparse entry of an entity, allocating its page (and growing
+ * the page directory) if needed.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array.
+ * @param index The entity index.
+ * @return u32* A pointer to the sparse entry, or NULL if allocation failed.
+ */
+static u32 *ecs_sparse_slot(ECSManager *ecs, ComponentArray *componentArray, u32 index) {
+    u32 page = index / ECS_SPARSE_PAGE_SIZE;
+    if (page >= componentArray->sparsePageCount) {
+        u32 pageCount = componentArray->sparsePageCount ? componentArray->sparsePageCount : 1;
+        while (pageCount <= page) {
+            pageCount *= 2;
+        }
+
+        u32 **pages = (u32 **)memory_allocate(ecs->pool, sizeof(u32 *) * pageCount, MEMORY_TAG_ECS);
+        if (!pages) {
+            log_error("Failed to grow the sparse page directory to %u pages.", pageCount);
+            return NULL;
+        }
+
+        memory_zero(pages, sizeof(u32 *) * pageCount);
+        if (componentArray->sparsePages) {
+            memory_copy(pages, componentArray->sparsePages, sizeof(u32 *) * componentArray->sparsePageCount);
+            memory_free(ecs->pool, componentArray->sparsePages, MEMORY_TAG_ECS);
+        }
+        componentArray->sparsePages = pages;
+        componentArray->sparsePageCount = pageCount;
+    }
+
+    if (!componentArray->sparsePages[page]) {
+        componentArray->sparsePages[page] = (u32 *)memory_allocate(ecs->pool, sizeof(u32) * ECS_SPARSE_PAGE_SIZE, MEMORY_TAG_ECS);
+        if (!componentArray->sparsePages[page]) {
+            log_error("Failed to allocate a sparse page.");
+            return NULL;
+        }
+
+        // 0xFF bytes make every sparse entry INVALID_ID_U32.
+        memory_set(componentArray->sparsePages[page], 0xFF, sizeof(u32) * ECS_SPARSE_PAGE_SIZE);
+    }
+
+    return &componentArray->sparsePages[page][index % ECS_SPARSE_PAGE_SIZE];
+}
+
+/**
+ * @brief Grows a component array's packed arrays, by doubling, until they
+ * hold at least a number of components.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array.
+ * @param needed The number of components the arrays must hold.
+ * @return b8 True on success. On failure the old arrays are kept.
+ */
+static b8 ecs_sparse_reserve(ECSManager *ecs, ComponentArray *componentArray, u32 needed) {
+    if (needed <= componentArray->capacity) {
+        return true;
+    }
+
+    u32 capacity = componentArray->capacity ? componentArray->capacity : ECS_DENSE_INITIAL_CAPACITY;
+    while (capacity < needed) {
+        capacity = capacity > MAX_U32 / 2 ? needed : capacity * 2;
+    }
+    u32 blockCount = (capacity + ECS_CHANGE_BLOCK_SIZE - 1) / ECS_CHANGE_BLOCK_SIZE;
+    u8 *data = (u8 *)memory_allocate_aligned(ecs->pool, (u64)componentArray->size * capacity, ECS_COMPONENT_ALIGNMENT, MEMORY_TAG_ECS);
+    Entity *entities = (Entity *)memory_allocate(ecs->pool, sizeof(Entity) * capacity, MEMORY_TAG_ECS);
+    u32 *versions = (u32 *)memory_allocate(ecs->pool, sizeof(u32) * blockCount, MEMORY_TAG_ECS);
+    if (!data || !entities || !versions) {
+        log_error("Failed to grow component storage to %u components.", capacity);
+        if (data) {
+            memory_free_aligned(ecs->pool, data, MEMORY_TAG_ECS);
+        }
+        if (entities) {
+            memory_free(ecs->pool, entities, MEMORY_TAG_ECS);
+        }
+        if (versions) {
+            memory_free(ecs->pool, versions, MEMORY_TAG_ECS);
+        }
+        return false;
+    }
+
+    // Blocks get a version when their first row is added.
+    memory_zero(versions, sizeof(u32) * blockCount);
+    if (componentArray->data) {
+        memory_copy(data, componentArray->data, (u64)componentArray->size * componentArray->count);
+        memory_copy(entities, componentArray->entities, sizeof(Entity) * componentArray->count);
+        memory_copy(versions, componentArray->versions, sizeof(u32) * ((componentArray->capacity + ECS_CHANGE_BLOCK_SIZE - 1) / ECS_CHANGE_BLOCK_SIZE));
+        memory_free_aligned(ecs->pool, componentArray->data, MEMORY_TAG_ECS);
+        memory_free(ecs->pool, componentArray->entities, MEMORY_TAG_ECS);
+        memory_free(ecs->pool, componentArray->versions, MEMORY_TAG_ECS);
+    }
+
+    componentArray->data = data;
+    componentArray->entities = entities;
+    componentArray->versions = versions;
+    componentArray->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Swaps two packed rows of a sparse set, with their entities and
+ * sparse entries, and marks both rows changed.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array.
+ * @param a The first packed row.
+ * @param b The second packed row.
+ * @return void
+ */
+static void ecs_sparse_swap(const ECSManager *ecs, ComponentArray *componentArray, u32 a, u32 b) {
+    if (a == b) {
+        return;
+    }
+
+    // Swap through a small buffer so components of any size fit.
+    u8 *left = componentArray->data + (u64)a * componentArray->size;
+    u8 *right = componentArray->data + (u64)b * componentArray->size;
+    u8 buffer[64];
+    for (u32 offset = 0; offset < componentArray->size; offset += sizeof(buffer)) {
+        u32 bytes = componentArray->size - offset < sizeof(buffer) ? componentArray->size - offset : (u32)sizeof(buffer);
+        memory_copy(buffer, left + offset, bytes);
+        memory_copy(left + offset, right + offset, bytes);
+        memory_copy(right + offset, buffer, bytes);
+    }
+
+    Entity entityA = componentArray->entities[a];
+    Entity entityB = componentArray->entities[b];
+    componentArray->entities[a] = entityB;
+    componentArray->entities[b] = entityA;
+    u32 slotA = ecs_entity_index(entityA);
+    u32 slotB = ecs_entity_index(entityB);
+    componentArray->sparsePages[slotA / ECS_SPARSE_PAGE_SIZE][slotA % ECS_SPARSE_PAGE_SIZE] = b;
+    componentArray->sparsePages[slotB / ECS_SPARSE_PAGE_SIZE][slotB % ECS_SPARSE_PAGE_SIZE] = a;
+    ecs_sparse_touch(ecs, componentArray, a);
+    ecs_sparse_touch(ecs, componentArray, b);
+}
+
+/**
+ * @brief Moves an entity into the front of a group's arrays, just after the
+ * current members, if it has every owned type and is not a member yet.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param group A pointer to the group.
+ * @param entity The entity.
+ * @return b8 True if the entity joined the group.
+ */
+static b8 ecs_group_attach(ECSManager *ecs, EcsGroup *group, Entity entity) {
+    u32 index = ecs_entity_index(entity);
+    u32 rows[ECS_MAX_VIEW_COMPONENTS];
+    for (u32 t = 0; t < group->typeCount; ++t) {
+        rows[t] = ecs_sparse_get(&ecs->componentArrays[group->types[t]], index);
+        if (rows[t] == INVALID_ID_U32 || rows[t] < group->count) {
+            return false;
+        }
+    }
+
+    for (u32 t = 0; t < group->typeCount; ++t) {
+        ecs_sparse_swap(ecs, &ecs->componentArrays[group->types[t]], rows[t], group->count);
+    }
+    group->count++;
+    return true;
+}
+
+/**
+ * @brief Moves a member of a group to the row just past the group's shrunk
+ * prefix in every owned array.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param group A pointer to the group.
+ * @param entity The entity, which must be a member.
+ * @return void
+ */
+static void ecs_group_detach(ECSManager *ecs, EcsGroup *group, Entity entity) {
+    u32 last = --group->count;
+    for (u32 t = 0; t < group->typeCount; ++t) {
+        ComponentArray *componentArray = &ecs->componentArrays[group->types[t]];
+        ecs_sparse_swap(ecs, componentArray, ecs_sparse_get(componentArray, ecs_entity_index(entity)), last);
+    }
+}
+
+/**
+ * @brief Marks every query that mentions a type owned by a group as stale
+ * after the group's rows moved.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param group A pointer to the group.
+ * @return void
+ */
+static void ecs_group_invalidate(ECSManager *ecs, const EcsGroup *group) {
+    for (u32 t = 0; t < group->typeCount; ++t) {
+        ecs_queries_invalidate(ecs, group->types[t]);
+    }
+}
+
+/**
+ * @brief Finds the group that owns exactly a set of component types.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param types The component types, in any order.
+ * @param typeCount The number of types.
+ * @return u32 The group's index, or INVALID_ID_U32 if no group owns exactly these types.
+ */
+static u32 ecs_group_find(const ECSManager *ecs, const ComponentType *types, u32 typeCount) {
+    u32 group = ecs->componentArrays[types[0]].group;
+    if (group == INVALID_ID_U32 || ecs->groups[group].typeCount != typeCount) {
+        return INVALID_ID_U32;
+    }
+
+    for (u32 i = 0; i < typeCount; ++i) {
+        if (ecs->componentArrays[types[i]].group != group) {
+            return INVALID_ID_U32;
+        }
+        for (u32 j = 0; j < i; ++j) {
+            if (types[j] == types[i]) {
+                return INVALID_ID_U32;
+            }
+        }
+    }
+    return group;
+}
+
+static void *ecs_sparse_add(ECSManager *ecs, Entity entity, ComponentType type) {
+    ComponentArray *componentArray = &ecs->componentArrays[type];
+    if (componentArray->size == 0) {
+        // A tag's membership is the entity's signature bit; it has no sparse
+        // pages or packed arrays to update.
+        EcsSignature *signature = &ecs->signatures[ecs_entity_index(entity)];
+        if (ecs_signature_has(signature, type)) {
+            log_warning("Entity %u already has component type %u.", ecs_entity_index(entity), type);
+            return NULL;
+        }
+        ecs_signature_set(signature, type);
+        componentArray->count++;
+        ecs_queries_invalidate(ecs, type);
+        return componentArray->data;
+    }
+
+    u32 *slot = ecs_sparse_slot(ecs, componentArray, ecs_entity_index(entity));
+    if (!slot) {
+        return NULL;
+    }
+
+    if (*slot != INVALID_ID_U32) {
+        log_warning("Entity %u already has component type %u.", ecs_entity_index(entity), type);
+        return NULL;
+    }
+
+    if (!ecs_sparse_reserve(ecs, componentArray, componentArray->count + 1)) {
+        return NULL;
+    }
+
+    // Append to the end of the packed array.
+    u32 index = componentArray->count++;
+    componentArray->entities[index] = entity;
+    *slot = index;
+    ecs_signature_set(&ecs->signatures[ecs_entity_index(entity)], type);
+    ecs_sparse_touch(ecs, componentArray, index);
+    ecs_queries_invalidate(ecs, type);
+
+    // The last missing owned type swaps the entity into its group.
+    if (componentArray->group != INVALID_ID_U32) {
+        EcsGroup *group = &ecs->groups[componentArray->group];
+        if (ecs_group_attach(ecs, group, entity)) {
+            ecs_group_invalidate(ecs, group);
+            index = *slot;
+        }
+    }
+    return componentArray->data + (u64)index * componentArray->size;
+}
+
+/**
+ * @brief Removes an entity's component from a sparse set without marking
+ * queries stale. A member of the group owning the set leaves it first; a tag
+ * only clears its signature bit.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array.
+ * @param entity The entity.
+ * @param index The dense index of the entity's component.
+ * @return void
+ */
+static void ecs_sparse_erase(ECSManager *ecs, ComponentArray *componentArray, Entity entity, u32 index) {
+    if (componentArray->size == 0) {
+        componentArray->count--;
+        ecs_signature_clear(&ecs->signatures[ecs_entity_index(entity)], (ComponentType)(componentArray - ecs->componentArrays));
+        return;
+    }
+
+    if (componentArray->group != INVALID_ID_U32 && index < ecs->groups[componentArray->group].count) {
+        EcsGroup *group = &ecs->groups[componentArray->group];
+        ecs_group_detach(ecs, group, entity);
+        index = group->count;
+    }
+
+    // Move the last component's bytes into the hole to keep the array packed.
+    u32 lastIndex = --componentArray->count;
+    if (index != lastIndex) {
+        Entity lastEntity = componentArray->entities[lastIndex];
+        memory_copy(componentArray->data + (u64)index * componentArray->size, componentArray->data + (u64)lastIndex * componentArray->size, componentArray->size);
+        componentArray->entities[index] = lastEntity;
+        u32 lastSlot = ecs_entity_index(lastEntity);
+        componentArray->sparsePages[lastSlot / ECS_SPARSE_PAGE_SIZE][lastSlot % ECS_SPARSE_PAGE_SIZE] = index;
+        ecs_sparse_touch(ecs, componentArray, index);
+    }
+
+    u32 slot = ecs_entity_index(entity);
+    componentArray->sparsePages[slot / ECS_SPARSE_PAGE_SIZE][slot % ECS_SPARSE_PAGE_SIZE] = INVALID_ID_U32;
+    ecs_signature_clear(&ecs->signatures[slot], (ComponentType)(componentArray - ecs->componentArrays));
+}
+
+static void ecs_sparse_remove(ECSManager *ecs, Entity entity, ComponentType type) {
+    ComponentArray *componentArray = &ecs->componentArrays[type];
+    if (!ecs_signature_has(&ecs->signatures[ecs_entity_index(entity)], type)) {
+        log_warning("Entity %u does not have component type %u.", ecs_entity_index(entity), type);
+        return;
+    }
+    if (componentArray->size == 0) {
+        ecs_sparse_erase(ecs, componentArray, entity, 0);
+        ecs_queries_invalidate(ecs, type);
+        return;
+    }
+
+    u32 index = ecs_sparse_get(componentArray, ecs_entity_index(entity));
+    if (index == INVALID_ID_U32) {
+        log_warning("Entity %u does not have component type %u.", ecs_entity_index(entity), type);
+        return;
+    }
+
+    const EcsGroup *group = componentArray->group != INVALID_ID_U32 ? &ecs->groups[componentArray->group] : NULL;
+    b8 grouped = group && index < group->count;
+    ecs_sparse_erase(ecs, componentArray, entity, index);
+    ecs_queries_invalidate(ecs, type);
+    if (grouped) {
+        ecs_group_invalidate(ecs, group);
+    }
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Sorting
+
+/**
+ * @brief Stamps the change blocks holding a run of packed rows with a given
+ * version. Sorts stamp the version they ran at, so the rows they move count as
+ * changed for queries but not for the next sort.
+ *
+ * @param componentArray A pointer to the component array.
+ * @param begin The first packed row.
+ * @param end One past the last packed row.
+ * @param version The version to stamp.
+ * @return void
+ */
+static void ecs_sort_stamp(ComponentArray *componentArray, u32 begin, u32 end, u32 version) {
+    for (u32 block = begin / ECS_CHANGE_BLOCK_SIZE; block <= (end - 1) / ECS_CHANGE_BLOCK_SIZE; ++block) {
+        componentArray->versions[block] = version;
+    }
+}
+
+/**
+ * @brief Moves the row at from down to row to, shifting the rows between
+ * them up by one, with their entities, sparse entries and keys.
+ *
+ * @param componentArray A pointer to the component array.
+ * @param from The row to move.
+ * @param to The row it moves to, at most from.
+ * @param buffer Scratch space of one component.
+ * @return void
+ */
+static void ecs_sort_rotate(ComponentArray *componentArray, u32 from, u32 to, u8 *buffer) {
+    u64 size = componentArray->size;
+    u64 key = componentArray->sortKeys[from];
+    Entity entity = componentArray->entities[from];
+    memory_copy(buffer, componentArray->data + from * size, size);
+    for (u32 row = from; row > to; --row) {
+        memory_copy(componentArray->data + row * size, componentArray->data + (row - 1) * size, size);
+        Entity shifted = componentArray->entities[row - 1];
+        componentArray->entities[row] = shifted;
+        componentArray->sortKeys[row] = componentArray->sortKeys[row - 1];
+        u32 slot = ecs_entity_index(shifted);
+        componentArray->sparsePages[slot / ECS_SPARSE_PAGE_SIZE][slot % ECS_SPARSE_PAGE_SIZE] = row;
+    }
+    memory_copy(componentArray->data + (u64)to * size, buffer, size);
+    componentArray->entities[to] = entity;
+    componentArray->sortKeys[to] = key;
+    u32 slot = ecs_entity_index(entity);
+    componentArray->sparsePages[slot / ECS_SPARSE_PAGE_SIZE][slot % ECS_SPARSE_PAGE_SIZE] = to;
+}
+
+/**
+ * @brief Finds the first of a run of sorted keys that is greater than a key,
+ * or not less than it.
+ *
+ * @param keys The keys.
+ * @param low The first row of the run.
+ * @param high One past the last row of the run.
+ * @param key The key to look for.
+ * @param after Whether equal keys come before the result.
+ * @return u32 The row, high if there is none.
+ */
+static u32 ecs_sort_bound(const u64 *keys, u32 low, u32 high, u64 key, b8 after) {
+    while (low < high) {
+        u32 middle = low + (high - low) / 2;
+        if (keys[middle] < key || (after && keys[middle] == key)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief Insertion sorts the rows from first on, given that the rows before
+ * first are in order. Gives up once it has moved more rows than the array
+ * holds, leaving the array valid but unsorted.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array.
+ * @param first The first row that may be out of order.
+ * @param version The version to stamp moved rows with.
+ * @param moved A pointer that receives whether any row moved.
+ * @return b8 True if the array is sorted, false if it needs a radix sort.
+ */
+static b8 ecs_sort_insertion(ECSManager *ecs, ComponentArray *componentArray, u32 first, u32 version, b8 *moved) {
+    const u64 *keys = componentArray->sortKeys;
+    u64 budget = componentArray->count;
+    u8 *buffer = NULL;
+    b8 sorted = true;
+    for (u32 row = first > 0 ? first : 1; row < componentArray->count; ++row) {
+        if (keys[row - 1] <= keys[row]) {
+            continue;
+        }
+
+        u32 to = row - 1;
+        while (to > 0 && keys[to - 1] > keys[row]) {
+            to--;
+        }
+        if (row - to > budget) {
+            sorted = false;
+            break;
+        }
+        if (!buffer) {
+            buffer = (u8 *)memory_allocate(ecs->pool, componentArray->size, MEMORY_TAG_ECS);
+            if (!buffer) {
+                log_error("Failed to allocate sort scratch space for a %u-byte component.", componentArray->size);
+                sorted = false;
+                break;
+            }
+        }
+        budget -= row - to;
+        ecs_sort_rotate(componentArray, row, to, buffer);
+        ecs_sort_stamp(componentArray, to, row + 1, version);
+        *moved = true;
+    }
+
+    if (buffer) {
+        memory_free(ecs->pool, buffer, MEMORY_TAG_ECS);
+    }
+    return sorted;
+}
+
+/**
+ * @brief Sorts a whole array with a stable least-significant-digit radix sort
+ * over its cached keys, one byte at a time. Bytes every key shares are
+ * neither counted nor sorted on, so small keys such as a layer and a texture
+ * take one or two passes. The rows are then gathered into new packed arrays
+ * in key order.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array.
+ * @param version The version to stamp the rows with.
+ * @return b8 True on success. On failure the array is left as it was.
+ */
+static b8 ecs_sort_radix(ECSManager *ecs, ComponentArray *componentArray, u32 version) {
+    u32 count = componentArray->count;
+    u64 *keys = (u64 *)memory_allocate(ecs->pool, sizeof(u64) * count, MEMORY_TAG_ECS);
+    u32 *rows = (u32 *)memory_allocate(ecs->pool, sizeof(u32) * 2 * (u64)count, MEMORY_TAG_ECS);
+    u8 *data = (u8 *)memory_allocate_aligned(ecs->pool, (u64)componentArray->size * componentArray->capacity, ECS_COMPONENT_ALIGNMENT, MEMORY_TAG_ECS);
+    Entity *entities = (Entity *)memory_allocate(ecs->pool, sizeof(Entity) * componentArray->capacity, MEMORY_TAG_ECS);
+    if (!keys || !rows || !data || !entities) {
+        log_error("Failed to allocate radix sort space for %u components.", count);
+        if (keys) {
+            memory_free(ecs->pool, keys, MEMORY_TAG_ECS);
+        }
+        if (rows) {
+            memory_free(ecs->pool, rows, MEMORY_TAG_ECS);
+        }
+        if (data) {
+            memory_free_aligned(ecs->pool, data, MEMORY_TAG_ECS);
+        }
+        if (entities) {
+            memory_free(ecs->pool, entities, MEMORY_TAG_ECS);
+        }
+        return false;
+    }
+
+    // Find the bytes that differ between keys, then count only those.
+    u64 varying = 0;
+    for (u32 i = 1; i < count; ++i) {
+        varying |= componentArray->sortKeys[i] ^ componentArray->sortKeys[0];
+    }
+    u32 digits[8];
+    u32 digitCount = 0;
+    for (u32 digit = 0; digit < 8; ++digit) {
+        if ((varying >> (digit * 8)) & 0xFF) {
+            digits[digitCount++] = digit * 8;
+        }
+    }
+    u32 histograms[8][256];
+    memory_zero(histograms, sizeof(u32) * 256 * digitCount);
+    for (u32 i = 0; i < count; ++i) {
+        u64 key = componentArray->sortKeys[i];
+        for (u32 d = 0; d < digitCount; ++d) {
+            histograms[d][(key >> digits[d]) & 0xFF]++;
+        }
+    }
+
+    u64 *sourceKeys = componentArray->sortKeys;
+    u64 *targetKeys = keys;
+    u32 *sourceRows = rows;
+    u32 *targetRows = rows + count;
+    for (u32 i = 0; i < count; ++i) {
+        sourceRows[i] = i;
+    }
+    for (u32 d = 0; d < digitCount; ++d) {
+        u32 *histogram = histograms[d];
+        u32 shift = digits[d];
+        u32 offset = 0;
+        for (u32 byte = 0; byte < 256; ++byte) {
+            u32 bucket = histogram[byte];
+            histogram[byte] = offset;
+            offset += bucket;
+        }
+        for (u32 i = 0; i < count; ++i) {
+            u32 target = histogram[(sourceKeys[i] >> shift) & 0xFF]++;
+            targetKeys[target] = sourceKeys[i];
+            targetRows[target] = sourceRows[i];
+        }
+
+        u64 *swapKeys = sourceKeys;
+        sourceKeys = targetKeys;
+        targetKeys = swapKeys;
+        u32 *swapRows = sourceRows;
+        sourceRows = targetRows;
+        targetRows = swapRows;
+    }
+    if (sourceKeys != componentArray->sortKeys) {
+        memory_copy(componentArray->sortKeys, sourceKeys, sizeof(u64) * count);
+    }
+
+    u64 size = componentArray->size;
+    for (u32 i = 0; i < count; ++i) {
+        u32 row = sourceRows[i];
+        memory_copy(data + i * size, componentArray->data + row * size, size);
+        Entity entity = componentArray->entities[row];
+        entities[i] = entity;
+        u32 slot = ecs_entity_index(entity);
+        componentArray->sparsePages[slot / ECS_SPARSE_PAGE_SIZE][slot % ECS_SPARSE_PAGE_SIZE] = i;
+    }
+    memory_free_aligned(ecs->pool, componentArray->data, MEMORY_TAG_ECS);
+    memory_free(ecs->pool, componentArray->entities, MEMORY_TAG_ECS);
+    componentArray->data = data;
+    componentArray->entities = entities;
+    ecs_sort_stamp(componentArray, 0, count, version);
+
+    memory_free(ecs->pool, keys, MEMORY_TAG_ECS);
+    memory_free(ecs->pool, rows, MEMORY_TAG_ECS);
+    return true;
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Archetypes
+
+static b8 ecs_query_add_archetype(EcsQuery *query, u32 archetypeIndex);
+
+/**
+ * @brief Finds the column of a component type in an archetype.
+ *
+ * @param archetype A pointer to the archetype.
+ * @param type The component type.
+ * @return u32 The column index, or INVALID_ID_U32 if the archetype lacks the type.
+ */
+static u32 ecs_archetype_column(const EcsArchetype *archetype, ComponentType type) {
+    for (u32 column = 0; column < archetype->typeCount; ++column) {
+        if (archetype->types[column] == type) {
+            return column;
+        }
+    }
+    return INVALID_ID_U32;
+}
+
+/**
+ * @brief Gets the change version of each component column of a chunk.
+ *
+ * @param archetype A pointer to the archetype.
+ * @param chunk A pointer to one of its chunks.
+ * @return u32* The versions, one per column.
+ */
+static ENGINE_INLINE u32 *ecs_chunk_versions(const EcsArchetype *archetype, const EcsChunk *chunk) {
+    return (u32 *)(chunk->memory + archetype->versionOffset);
+}
+
+/**
+ * @brief Marks every component column of a chunk as changed now, after rows
+ * were moved into it.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param archetype A pointer to the archetype.
+ * @param chunk A pointer to one of its chunks.
+ * @return void
+ */
+static void ecs_chunk_touch_all(const ECSManager *ecs, const EcsArchetype *archetype, const EcsChunk *chunk) {
+    u32 version = ecs_change_version(ecs);
+    u32 *versions = ecs_chunk_versions(archetype, chunk);
+    for (u32 column = 0; column < archetype->typeCount; ++column) {
+        versions[column] = version;
+    }
+}
+
+/**
+ * @brief Lays out the columns of a chunk: as many rows as fit, backed off
+ * until the aligned columns and the column versions after them fit too.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param types The archetype's component types, ascending.
+ * @param typeCount The number of types.
+ * @param offsets Receives each column's byte offset, or NULL to only count rows.
+ * @param versionOffset Receives the byte offset of the column versions, or NULL.
+ * @return u32 The number of rows per chunk, or 0 if one row does not fit.
+ */
+static u32 ecs_archetype_layout(const ECSManager *ecs, const ComponentType *types, u32 typeCount, u32 *offsets, u32 *versionOffset) {
+    u32 rowSize = sizeof(Entity);
+    for (u32 column = 0; column < typeCount; ++column) {
+        rowSize += ecs->componentArrays[types[column]].size;
+    }
+
+    for (u32 capacity = ECS_CHUNK_SIZE / rowSize; capacity > 0; --capacity) {
+        u64 offset = sizeof(Entity) * (u64)capacity;
+        for (u32 column = 0; column < typeCount; ++column) {
+            // Tag columns take no bytes, so they need no padding either.
+            if (ecs->componentArrays[types[column]].size > 0) {
+                u64 alignment = ecs->componentArrays[types[column]].alignment;
+                alignment = alignment > ECS_COLUMN_ALIGNMENT ? alignment : ECS_COLUMN_ALIGNMENT;
+                offset = (offset + alignment - 1) & ~(alignment - 1);
+            }
+            if (offsets) {
+                offsets[column] = (u32)offset;
+            }
+            offset += (u64)ecs->componentArrays[types[column]].size * capacity;
+        }
+        offset = (offset + sizeof(u32) - 1) & ~(u64)(sizeof(u32) - 1);
+        if (versionOffset) {
+            *versionOffset = (u32)offset;
+        }
+        offset += sizeof(u32) * (u64)typeCount;
+        if (offset <= ECS_CHUNK_SIZE) {
+            return capacity;
+        }
+    }
+
+    log_error("An entity with these %u component types (%u bytes) does not fit in a %u byte chunk.", typeCount, rowSize, ECS_CHUNK_SIZE);
+    return 0;
+}
+
+/**
+ * @brief Finds the archetype with a signature without creating it.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param signature A pointer to the signature.
+ * @return u32 The archetype index, or INVALID_ID_U32 if there is none.
+ */
+static u32 ecs_archetype_find(const ECSManager *ecs, const EcsSignature *signature) {
+    for (u32 i = 0; i < ecs->archetypeCount; ++i) {
+        if (ecs_signature_equal(&ecs->archetypes[i].signature, signature)) {
+            return i;
+        }
+    }
+    return INVALID_ID_U32;
+}
+
+/**
+ * @brief Finds the archetype with a signature, creating it if needed.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param signature A pointer to the signature (must not be empty).
+ * @return u32 The archetype index, or INVALID_ID_U32 on failure.
+ */
+static u32 ecs_archetype_get(ECSManager *ecs, const EcsSignature *signature) {
+    u32 found = ecs_archetype_find(ecs, signature);
+    if (found != INVALID_ID_U32) {
+        return found;
+    }
+
+    if (ecs->archetypeCount == ecs->archetypeCapacity) {
+        EcsArchetype *grown = (EcsArchetype *)ecs_grow_array(ecs, ecs->archetypes, sizeof(EcsArchetype), ecs->archetypeCount, &ecs->archetypeCapacity);
+        if (!grown) {
+            log_error("Failed to grow the archetype array.");
+            return INVALID_ID_U32;
+        }
+        ecs->archetypes = grown;
+    }
+
+    EcsArchetype archetype = {0};
+    archetype.signature = *signature;
+    for (ComponentType type = 0; type < ecs->registeredComponents; ++type) {
+        archetype.typeCount += ecs_signature_has(signature, type);
+    }
+
+    // Types and offsets share one allocation.
+    archetype.types = (ComponentType *)memory_allocate(ecs->pool, sizeof(u32) * 2 * archetype.typeCount, MEMORY_TAG_ECS);
+    if (!archetype.types) {
+        log_error("Failed to allocate archetype with %u component types.", archetype.typeCount);
+        return INVALID_ID_U32;
+    }
+    archetype.offsets = archetype.types + archetype.typeCount;
+
+    u32 column = 0;
+    for (ComponentType type = 0; type < ecs->registeredComponents; ++type) {
+        if (ecs_signature_has(signature, type)) {
+            archetype.types[column++] = type;
+        }
+    }
+
+    archetype.capacity = ecs_archetype_layout(ecs, archetype.types, archetype.typeCount, archetype.offsets, &archetype.versionOffset);
+    if (archetype.capacity == 0) {
+        memory_free(ecs->pool, archetype.types, MEMORY_TAG_ECS);
+        return INVALID_ID_U32;
+    }
+
+    u32 index = ecs->archetypeCount++;
+    ecs->archetypes[index] = archetype;
+
+    // Existing queries pick up the new archetype here instead of rescanning.
+    for (u32 i = 0; i < ecs->queryCount; ++i) {
+        ecs_query_add_archetype(ecs->queries[i], index);
+    }
+    return index;
+}
+
+/**
+ * @brief Gets the last chunk of an archetype if it has a free row, otherwise
+ * appends a new one.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param archetype A pointer to the archetype.
+ * @return EcsChunk* The chunk to append rows to, or NULL if a chunk could not be allocated.
+ */
+static EcsChunk *ecs_archetype_open_chunk(ECSManager *ecs, EcsArchetype *archetype) {
+    if (archetype->chunkCount == 0 || archetype->chunks[archetype->chunkCount - 1].count == archetype->capacity) {
+        if (archetype->chunkCount == archetype->chunkCapacity) {
+            EcsChunk *grown = (EcsChunk *)ecs_grow_array(ecs, archetype->chunks, sizeof(EcsChunk), archetype->chunkCount, &archetype->chunkCapacity);
+            if (!grown) {
+                log_error("Failed to grow the chunk array of an archetype.");
+                return NULL;
+            }
+            archetype->chunks = grown;
+        }
+
+        u8 *memory = archetype->spareChunk;
+        archetype->spareChunk = NULL;
+        if (!memory) {
+            memory = (u8 *)memory_allocate_aligned(ecs->pool, ECS_CHUNK_SIZE, ECS_COMPONENT_ALIGNMENT, MEMORY_TAG_ECS);
+        }
+        if (!memory) {
+            log_error("Failed to allocate an archetype chunk.");
+            return NULL;
+        }
+
+        archetype->chunks[archetype->chunkCount++] = (EcsChunk){memory, 0};
+    }
+
+    return &archetype->chunks[archetype->chunkCount - 1];
+}
+
+/**
+ * @brief Appends a row for an entity to an archetype, adding a chunk if the
+ * last one is full. Component columns of the row are left uninitialized.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param archetype A pointer to the archetype.
+ * @param entity The entity that owns the row.
+ * @param chunkIndex A pointer that receives the chunk index.
+ * @param row A pointer that receives the row within the chunk.
+ * @return b8 True on success, false if a chunk could not be allocated.
+ */
+static b8 ecs_archetype_push_row(ECSManager *ecs, EcsArchetype *archetype, Entity entity, u32 *chunkIndex, u32 *row) {
+    EcsChunk *chunk = ecs_archetype_open_chunk(ecs, archetype);
+    if (!chunk) {
+        return false;
+    }
+
+    *chunkIndex = archetype->chunkCount - 1;
+    *row = chunk->count++;
+    ((Entity *)chunk->memory)[*row] = entity;
+    archetype->entityCount++;
+    ecs_chunk_touch_all(ecs, archetype, chunk);
+    return true;
+}
+
+/**
+ * @brief Removes a row from an archetype by moving the archetype's last row
+ * into it, and releases the last chunk once it is empty.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param archetypeIndex The archetype index.
+ * @param chunkIndex The chunk of the row to remove.
+ * @param row The row to remove.
+ * @return void
+ */
+static void ecs_archetype_remove_row(ECSManager *ecs, u32 archetypeIndex, u32 chunkIndex, u32 row) {
+    EcsArchetype *archetype = &ecs->archetypes[archetypeIndex];
+    EcsChunk *chunk = &archetype->chunks[chunkIndex];
+    EcsChunk *last = &archetype->chunks[archetype->chunkCount - 1];
+    u32 lastRow = last->count - 1;
+
+    if (chunk != last || row != lastRow) {
+        Entity moved = ((Entity *)last->memory)[lastRow];
+        ((Entity *)chunk->memory)[row] = moved;
+        for (u32 column = 0; column < archetype->typeCount; ++column) {
+            u32 size = ecs->componentArrays[archetype->types[column]].size;
+            u32 offset = archetype->offsets[column];
+            memory_copy(chunk->memory + offset + (u64)row * size, last->memory + offset + (u64)lastRow * size, size);
+        }
+        ecs->records[ecs_entity_index(moved)].chunk = chunkIndex;
+        ecs->records[ecs_entity_index(moved)].row = row;
+        ecs_chunk_touch_all(ecs, archetype, chunk);
+    }
+
+    last->count--;
+    archetype->entityCount--;
+    if (last->count == 0) {
+        // Keep one empty chunk so an entity passing through the archetype
+        // does not allocate and free a chunk each time.
+        if (archetype->spareChunk) {
+            memory_free_aligned(ecs->pool, archetype->spareChunk, MEMORY_TAG_ECS);
+        }
+        archetype->spareChunk = last->memory;
+        archetype->chunkCount--;
+    }
+}
+
+/**
+ * @brief Removes an entity's row and every component it holds, leaving the
+ * entity without an archetype.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param index The entity index.
+ * @return void
+ */
+static void ecs_archetype_detach(ECSManager *ecs, u32 index) {
+    EcsRecord *record = &ecs->records[index];
+    if (record->archetype == INVALID_ID_U32) {
+        return;
+    }
+
+    const EcsArchetype *archetype = &ecs->archetypes[record->archetype];
+    for (u32 column = 0; column < archetype->typeCount; ++column) {
+        ecs->componentArrays[archetype->types[column]].count--;
+    }
+    ecs_archetype_remove_row(ecs, record->archetype, record->chunk, record->row);
+    record->archetype = INVALID_ID_U32;
+}
+
+/**
+ * @brief Moves an entity's row to another archetype, copying the components
+ * both archetypes share. Columns only in the target are left uninitialized.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entity The entity to move.
+ * @param targetIndex The index of the archetype to move to.
+ * @return b8 True on success.
+ */
+static b8 ecs_archetype_move(ECSManager *ecs, Entity entity, u32 targetIndex) {
+    EcsRecord *record = &ecs->records[ecs_entity_index(entity)];
+    EcsArchetype *target = &ecs->archetypes[targetIndex];
+
+    u32 chunkIndex, row;
+    if (!ecs_archetype_push_row(ecs, target, entity, &chunkIndex, &row)) {
+        return false;
+    }
+
+    if (record->archetype != INVALID_ID_U32) {
+        const EcsArchetype *source = &ecs->archetypes[record->archetype];
+        const u8 *from = source->chunks[record->chunk].memory;
+        u8 *to = target->chunks[chunkIndex].memory;
+
+        // Both type lists are sorted, so shared columns are found in one pass.
+        u32 sourceColumn = 0;
+        for (u32 column = 0; column < target->typeCount; ++column) {
+            ComponentType type = target->types[column];
+            while (sourceColumn < source->typeCount && source->types[sourceColumn] < type) {
+                sourceColumn++;
+            }
+            if (sourceColumn < source->typeCount && source->types[sourceColumn] == type) {
+                u32 size = ecs->componentArrays[type].size;
+                memory_copy(to + target->offsets[column] + (u64)row * size, from + source->offsets[sourceColumn] + (u64)record->row * size, size);
+            }
+        }
+
+        ecs_archetype_remove_row(ecs, record->archetype, record->chunk, record->row);
+    }
+
+    record->archetype = targetIndex;
+    record->chunk = chunkIndex;
+    record->row = row;
+    return true;
+}
+
+/**
+ * @brief Gets a pointer to an entity's component in archetype storage and
+ * marks its column in the entity's chunk as changed.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param entity The entity.
+ * @param type The component type.
+ * @return void* A pointer to the component, or NULL if the entity does not have it.
+ */
+static void *ecs_archetype_component(ECSManager *ecs, Entity entity, ComponentType type) {
+    const EcsRecord *record = &ecs->records[ecs_entity_index(entity)];
+    if (record->archetype == INVALID_ID_U32) {
+        return NULL;
+    }
+
+    const EcsArchetype *archetype = &ecs->archetypes[record->archetype];
+    u32 column = ecs_archetype_column(archetype, type);
+    if (column == INVALID_ID_U32) {
+        return NULL;
+    }
+
+    const EcsChunk *chunk = &archetype->chunks[record->chunk];
+    ecs_chunk_versions(archetype, chunk)[column] = ecs_change_version(ecs);
+    return chunk->memory + archetype->offsets[column] + (u64)record->row * ecs->componentArrays[type].size;
+}
+
+static void *ecs_archetype_add(ECSManager *ecs, Entity entity, ComponentType type) {
+    const EcsRecord *record = &ecs->records[ecs_entity_index(entity)];
+    EcsSignature signature = {0};
+    if (record->archetype != INVALID_ID_U32) {
+        signature = ecs->archetypes[record->archetype].signature;
+    }
+
+    if (ecs_signature_has(&signature, type)) {
+        log_warning("Entity %u already has component type %u.", ecs_entity_index(entity), type);
+        return NULL;
+    }
+
+    ecs_signature_set(&signature, type);
+    u32 target = ecs_archetype_get(ecs, &signature);
+    if (target == INVALID_ID_U32 || !ecs_archetype_move(ecs, entity, target)) {
+        return NULL;
+    }
+
+    return ecs_archetype_component(ecs, entity, type);
+}
+
+static void ecs_archetype_remove(ECSManager *ecs, Entity entity, ComponentType type) {
+    EcsRecord *record = &ecs->records[ecs_entity_index(entity)];
+    if (record->archetype == INVALID_ID_U32 || !ecs_signature_has(&ecs->archetypes[record->archetype].signature, type)) {
+        log_warning("Entity %u does not have component type %u.", ecs_entity_index(entity), type);
+        return;
+    }
+
+    EcsSignature signature = ecs->archetypes[record->archetype].signature;
+    ecs_signature_clear(&signature, type);
+    if (ecs_signature_empty(&signature)) {
+        ecs_archetype_remove_row(ecs, record->archetype, record->chunk, record->row);
+        record->archetype = INVALID_ID_U32;
+    } else {
+        u32 target = ecs_archetype_get(ecs, &signature);
+        if (target == INVALID_ID_U32 || !ecs_archetype_move(ecs, entity, target)) {
+            log_error("Failed to remove component type %u from entity %u.", type, ecs_entity_index(entity));
+            return;
+        }
+    }
+
+    ecs->componentArrays[type].count--;
+}
+
+/**
+ * @brief Frees every chunk and array of an archetype.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param archetype A pointer to the archetype to free.
+ * @return void
+ */
+static void ecs_archetype_free(ECSManager *ecs, EcsArchetype *archetype) {
+    for (u32 i = 0; i < archetype->chunkCount; ++i) {
+        memory_free_aligned(ecs->pool, archetype->chunks[i].memory, MEMORY_TAG_ECS);
+    }
+    if (archetype->spareChunk) {
+        memory_free_aligned(ecs->pool, archetype->spareChunk, MEMORY_TAG_ECS);
+    }
+    if (archetype->chunks) {
+        memory_free(ecs->pool, archetype->chunks, MEMORY_TAG_ECS);
+    }
+    memory_free(ecs->pool, archetype->types, MEMORY_TAG_ECS);
+    memory_zero(archetype, sizeof(EcsArchetype));
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Queries
+
+/**
+ * @brief Appends an archetype to a query's cache if it matches the query.
+ *
+ * @param query A pointer to the query.
+ * @param archetypeIndex The index of the archetype to test.
+ * @return b8 False if the cache could not grow, otherwise true.
+ */
+static b8 ecs_query_add_archetype(EcsQuery *query, u32 archetypeIndex) {
+    ECSManager *ecs = query->ecs;
+    const EcsArchetype *archetype = &ecs->archetypes[archetypeIndex];
+    if (!ecs_signature_matches(&archetype->signature, &query->required, &query->excludedSignature)) {
+        return true;
+    }
+
+    if (query->archetypeCount == query->archetypeCapacity) {
+        // The archetype indices and the first view of each archetype share one block.
+        u32 capacity = query->archetypeCapacity ? query->archetypeCapacity * 2 : 8;
+        u32 *archetypes = (u32 *)memory_allocate(ecs->pool, sizeof(u32) * 2 * capacity, MEMORY_TAG_ECS);
+        // So do the column offsets and column indices of each term.
+        u32 *offsets = (u32 *)memory_allocate(ecs->pool, sizeof(u32) * 2 * capacity * query->termCount, MEMORY_TAG_ECS);
+        if (!archetypes || !offsets) {
+            log_error("Failed to grow the archetype cache of a query.");
+            if (archetypes) {
+                memory_free(ecs->pool, archetypes, MEMORY_TAG_ECS);
+            }
+            if (offsets) {
+                memory_free(ecs->pool, offsets, MEMORY_TAG_ECS);
+            }
+            return false;
+        }
+
+        if (query->archetypes) {
+            memory_copy(archetypes, query->archetypes, sizeof(u32) * query->archetypeCount);
+            memory_copy(offsets, query->offsets, sizeof(u32) * query->archetypeCount * query->termCount);
+            memory_copy(offsets + (u64)capacity * query->termCount, query->columns, sizeof(u32) * query->archetypeCount * query->termCount);
+            memory_free(ecs->pool, query->archetypes, MEMORY_TAG_ECS);
+            memory_free(ecs->pool, query->offsets, MEMORY_TAG_ECS);
+        }
+        query->archetypes = archetypes;
+        query->viewStarts = archetypes + capacity;
+        query->offsets = offsets;
+        query->columns = offsets + (u64)capacity * query->termCount;
+        query->archetypeCapacity = capacity;
+    }
+
+    u32 *offsets = query->offsets + (u64)query->archetypeCount * query->termCount;
+    u32 *columns = query->columns + (u64)query->archetypeCount * query->termCount;
+    for (u32 term = 0; term < query->termCount; ++term) {
+        u32 column = ecs_archetype_column(archetype, query->terms[term]);
+        offsets[term] = column == INVALID_ID_U32 ? INVALID_ID_U32 : archetype->offsets[column];
+        columns[term] = column;
+    }
+    query->archetypes[query->archetypeCount++] = archetypeIndex;
+    return true;
+}
+
+/**
+ * @brief Rebuilds a sparse-set query's entity cache by walking the smallest
+ * required component set and probing the others. A sorted required set is
+ * walked instead, so matches come out in its order. Tags have no entity list
+ * to walk, so a query whose required terms are all tags walks every entity
+ * index.
+ *
+ * @param query A pointer to the query.
+ * @return void
+ */
+static void ecs_query_rebuild(EcsQuery *query) {
+    ECSManager *ecs = query->ecs;
+    const EntityManager *entityManager = &ecs->entityManager;
+    const ComponentArray *driver = NULL;
+    query->driverTerm = 0;
+    for (u32 term = 0; term < query->requiredCount; ++term) {
+        const ComponentArray *componentArray = &ecs->componentArrays[query->terms[term]];
+        if (componentArray->size > 0 && (!driver || (componentArray->sortKey && !driver->sortKey) || (!driver->sortKey && componentArray->count < driver->count))) {
+            driver = componentArray;
+            query->driverTerm = term;
+        }
+    }
+    u32 walkCount = driver ? driver->count : entityManager->nextIndex;
+
+    query->count = 0;
+    if (walkCount > query->capacity) {
+        if (query->entities) {
+            memory_free(ecs->pool, query->entities, MEMORY_TAG_ECS);
+            memory_free(ecs->pool, query->rows, MEMORY_TAG_ECS);
+        }
+
+        // Every entity of the driving set may match, so that bounds the cache.
+        query->capacity = driver ? driver->capacity : entityManager->generationCapacity;
+        query->entities = (Entity *)memory_allocate(ecs->pool, sizeof(Entity) * query->capacity, MEMORY_TAG_ECS);
+        query->rows = (u32 *)memory_allocate(ecs->pool, sizeof(u32) * query->capacity * query->termCount, MEMORY_TAG_ECS);
+        if (!query->entities || !query->rows) {
+            log_error("Failed to allocate the entity cache of a query for %u entities.", query->capacity);
+            if (query->entities) {
+                memory_free(ecs->pool, query->entities, MEMORY_TAG_ECS);
+            }
+            if (query->rows) {
+                memory_free(ecs->pool, query->rows, MEMORY_TAG_ECS);
+            }
+            query->entities = NULL;
+            query->rows = NULL;
+            query->capacity = 0;
+            return;
+        }
+    }
+
+    // One signature compare rejects an entity; only matches probe the sparse
+    // pages, for their rows. A present tag's row is 0 into its column.
+    for (u32 i = 0; i < walkCount; ++i) {
+        u32 index = driver ? ecs_entity_index(driver->entities[i]) : i;
+        const EcsSignature *signature = &ecs->signatures[index];
+        if (!ecs_signature_matches(signature, &query->required, &query->excludedSignature)) {
+            continue;
+        }
+
+        for (u32 term = 0; term < query->termCount; ++term) {
+            const ComponentArray *componentArray = &ecs->componentArrays[query->terms[term]];
+            u32 row;
+            if (componentArray->size == 0) {
+                row = ecs_signature_has(signature, query->terms[term]) ? 0 : INVALID_ID_U32;
+            } else {
+                row = ecs_sparse_get(componentArray, index);
+            }
+            query->rows[(u64)term * query->capacity + query->count] = row;
+        }
+        query->entities[query->count++] = driver ? driver->entities[i] : ecs_entity_make(index, entityManager->generations[index]);
+    }
+
+    query->stale = false;
+}
+
+/**
+ * @brief Starts a pass of a change-filtered query. The pass sees changes made
+ * since the previous pass started, and advances the change version so writes
+ * made during this pass are left for the next one.
+ *
+ * @param query A pointer to the query.
+ * @return void
+ */
+static void ecs_query_begin_pass(EcsQuery *query) {
+    if (query->changedMask == 0) {
+        return;
+    }
+
+    query->changedSince = query->lastVersion;
+    query->lastVersion = (u32)platform_atomic_fetch_add_i32(&query->ecs->changeVersion, 1);
+    query->filtering = query->passed;
+    query->passed = true;
+}
+
+/**
+ * @brief Checks whether any filtered column of a chunk changed in the
+ * query's window.
+ *
+ * @param query A pointer to the query.
+ * @param archetype A pointer to the chunk's archetype.
+ * @param columns The archetype column of each term, INVALID_ID_U32 if absent.
+ * @param chunk A pointer to the chunk.
+ * @return b8 True if the chunk passes the change filter.
+ */
+static b8 ecs_query_chunk_changed(const EcsQuery *query, const EcsArchetype *archetype, const u32 *columns, const EcsChunk *chunk) {
+    const u32 *versions = ecs_chunk_versions(archetype, chunk);
+    for (u32 term = 0; term < query->termCount; ++term) {
+        if (((query->changedMask >> term) & 1) && columns[term] != INVALID_ID_U32 && ecs_query_version_changed(query, versions[columns[term]])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Marks the written columns of a chunk as changed now.
+ *
+ * @param query A pointer to the query.
+ * @param archetype A pointer to the chunk's archetype.
+ * @param columns The archetype column of each term, INVALID_ID_U32 if absent.
+ * @param chunk A pointer to the chunk.
+ * @return void
+ */
+static void ecs_query_chunk_touch(const EcsQuery *query, const EcsArchetype *archetype, const u32 *columns, const EcsChunk *chunk) {
+    u32 version = ecs_change_version(query->ecs);
+    u32 *versions = ecs_chunk_versions(archetype, chunk);
+    for (u32 term = 0; term < query->termCount; ++term) {
+        if (((query->writeMask >> term) & 1) && columns[term] != INVALID_ID_U32) {
+            versions[columns[term]] = version;
+        }
+    }
+}
+
+/**
+ * @brief Checks whether any filtered component of a cached sparse-set match
+ * changed in the query's window.
+ *
+ * @param query A pointer to the query.
+ * @param match The index of the match in the entity cache.
+ * @return b8 True if the match passes the change filter.
+ */
+static b8 ecs_query_match_changed(const EcsQuery *query, u32 match) {
+    const ECSManager *ecs = query->ecs;
+    for (u32 term = 0; term < query->termCount; ++term) {
+        if (!((query->changedMask >> term) & 1)) {
+            continue;
+        }
+        u32 row = query->rows[(u64)term * query->capacity + match];
+        if (row != INVALID_ID_U32 && ecs_query_version_changed(query, ecs->componentArrays[query->terms[term]].versions[row / ECS_CHANGE_BLOCK_SIZE])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Finds the next run of cached sparse-set matches that pass the change
+ * filter.
+ *
+ * Matches follow the driving set's packed order, so the matches whose driving
+ * component shares a change block are contiguous. When the driving type is
+ * filtered on, each block's matches are kept or skipped together; other
+ * filtered types are checked per match.
+ *
+ * @param query A pointer to the query.
+ * @param begin The first match to look at.
+ * @param limit The match to stop at.
+ * @param end A pointer that receives the end of the run.
+ * @return u32 The first match of the run, or limit if none is left.
+ */
+static u32 ecs_query_next_changed(const EcsQuery *query, u32 begin, u32 limit, u32 *end) {
+    const ECSManager *ecs = query->ecs;
+    const u32 *driverRows = query->rows + (u64)query->driverTerm * query->capacity;
+    const u32 *driverVersions = ecs->componentArrays[query->terms[query->driverTerm]].versions;
+    b8 driverFiltered = (query->changedMask >> query->driverTerm) & 1;
+    b8 othersFiltered = (query->changedMask & ~(1u << query->driverTerm)) != 0;
+
+    u32 first = limit;
+    u32 match = begin;
+    while (match < limit) {
+        // Driving rows strictly increase, so the block's matches end within
+        // as many matches as the block has rows left.
+        u32 block = driverRows[match] / ECS_CHANGE_BLOCK_SIZE;
+        u32 blockLimit = (block + 1) * ECS_CHANGE_BLOCK_SIZE;
+        u32 low = match + 1;
+        u32 high = match + (blockLimit - driverRows[match]);
+        high = high < limit ? high : limit;
+        while (low < high) {
+            u32 middle = low + (high - low) / 2;
+            if (driverRows[middle] < blockLimit) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        u32 blockEnd = low;
+
+        if (driverFiltered && ecs_query_version_changed(query, driverVersions[block])) {
+            first = first == limit ? match : first;
+            match = blockEnd;
+            continue;
+        }
+        if (!othersFiltered) {
+            if (first != limit) {
+                break;
+            }
+            match = blockEnd;
+            continue;
+        }
+        for (; match < blockEnd; ++match) {
+            if (ecs_query_match_changed(query, match)) {
+                first = first == limit ? match : first;
+            } else if (first != limit) {
+                *end = match;
+                return first;
+            }
+        }
+    }
+
+    *end = match;
+    return first;
+}
+
+/**
+ * @brief Marks the change blocks of the written components of a run of cached
+ * sparse-set matches as changed now.
+ *
+ * @param query A pointer to the query.
+ * @param begin The index of the first match.
+ * @param count The number of matches.
+ * @return void
+ */
+static void ecs_query_matches_touch(const EcsQuery *query, u32 begin, u32 count) {
+    ECSManager *ecs = query->ecs;
+    u32 version = ecs_change_version(ecs);
+    for (u32 term = 0; term < query->termCount; ++term) {
+        if (!((query->writeMask >> term) & 1)) {
+            continue;
+        }
+
+        // Matches follow the driving set's packed order, so consecutive rows
+        // mostly share a block and the store can be skipped.
+        u32 *versions = ecs->componentArrays[query->terms[term]].versions;
+        const u32 *rows = query->rows + (u64)term * query->capacity + begin;
+        u32 lastBlock = INVALID_ID_U32;
+        for (u32 i = 0; i < count; ++i) {
+            u32 block = rows[i] == INVALID_ID_U32 ? INVALID_ID_U32 : rows[i] / ECS_CHANGE_BLOCK_SIZE;
+            if (block != lastBlock && block != INVALID_ID_U32) {
+                versions[block] = version;
+                lastBlock = block;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Points a sparse-set query at the group that owns exactly its
+ * required terms, if it has no optional or excluded terms.
+ *
+ * @param query A pointer to the query.
+ * @return void
+ */
+static void ecs_query_use_group(EcsQuery *query) {
+    const ECSManager *ecs = query->ecs;
+    if (ecs->storage != ECS_STORAGE_SPARSE_SET || query->termCount != query->requiredCount || query->excludedCount > 0) {
+        query->group = INVALID_ID_U32;
+        return;
+    }
+    query->group = ecs_group_find(ecs, query->terms, query->requiredCount);
+}
+
+/**
+ * @brief Finds the next run of a group-backed query's rows that pass the
+ * change filter. Rows of every term line up, so whole change blocks are kept
+ * or skipped.
+ *
+ * @param query A pointer to the query.
+ * @param begin The first row to look at.
+ * @param limit The row to stop at.
+ * @param end A pointer that receives the end of the run.
+ * @return u32 The first row of the run, or limit if none is left.
+ */
+static u32 ecs_query_group_next_changed(const EcsQuery *query, u32 begin, u32 limit, u32 *end) {
+    const ECSManager *ecs = query->ecs;
+    u32 first = limit;
+    u32 row = begin;
+    while (row < limit) {
+        u32 block = row / ECS_CHANGE_BLOCK_SIZE;
+        b8 changed = false;
+        for (u32 term = 0; term < query->termCount && !changed; ++term) {
+            changed = ((query->changedMask >> term) & 1) && ecs_query_version_changed(query, ecs->componentArrays[query->terms[term]].versions[block]);
+        }
+        if (changed) {
+            first = first == limit ? row : first;
+        } else if (first != limit) {
+            break;
+        }
+
+        u32 blockEnd = (block + 1) * ECS_CHANGE_BLOCK_SIZE;
+        row = blockEnd < limit ? blockEnd : limit;
+    }
+
+    *end = row;
+    return first;
+}
+
+/**
+ * @brief Marks the written terms of a run of a group-backed query's rows as
+ * changed now.
+ *
+ * @param query A pointer to the query.
+ * @param begin The first row.
+ * @param count The number of rows.
+ * @return void
+ */
+static void ecs_query_group_touch(const EcsQuery *query, u32 begin, u32 count) {
+    ECSManager *ecs = query->ecs;
+    for (u32 term = 0; term < query->termCount; ++term) {
+        if ((query->writeMask >> term) & 1) {
+            ecs_sparse_touch_range(ecs, &ecs->componentArrays[query->terms[term]], begin, count);
+        }
+    }
+}
+
+/**
+ * @brief Fills a view with a run of a group-backed query's rows. Each column
+ * starts at the run, so rows are packed.
+ *
+ * @param query A pointer to the query.
+ * @param begin The first row.
+ * @param count The number of rows.
+ * @param view A pointer to the view to fill.
+ * @return void
+ */
+static void ecs_query_group_view(const EcsQuery *query, u32 begin, u32 count, EcsView *view) {
+    const ECSManager *ecs = query->ecs;
+    view->count = count;
+    view->entities = ecs->componentArrays[query->terms[0]].entities + begin;
+    for (u32 term = 0; term < query->termCount; ++term) {
+        const ComponentArray *componentArray = &ecs->componentArrays[query->terms[term]];
+        view->columns[term] = componentArray->data + (u64)begin * componentArray->size;
+        view->rows[term] = NULL;
+    }
+}
+
+/**
+ * @brief Frees the cache of a query.
+ *
+ * @param query A pointer to the query.
+ * @return void
+ */
+static void ecs_query_free(EcsQuery *query) {
+    MemoryPool *pool = query->ecs->pool;
+    if (query->archetypes) {
+        memory_free(pool, query->archetypes, MEMORY_TAG_ECS);
+        memory_free(pool, query->offsets, MEMORY_TAG_ECS);
+    }
+    if (query->entities) {
+        memory_free(pool, query->entities, MEMORY_TAG_ECS);
+        memory_free(pool, query->rows, MEMORY_TAG_ECS);
+    }
+    memory_zero(query, sizeof(EcsQuery));
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Snapshots
+
+/**
+ * @brief Sequential writer of snapshot blocks. With no buffer it only counts
+ * the bytes, so sizing and writing share one walk.
+ */
+typedef struct EcsSnapshotWriter {
+    u8 *data;      /**< The output buffer, or NULL to only measure. */
+    u64 capacity;  /**< The size of the output buffer in bytes. */
+    u64 offset;    /**< Bytes written so far. */
+    b8 overflowed; /**< Whether a block did not fit. */
+} EcsSnapshotWriter;
+
+/**
+ * @brief Sequential, bounds-checked reader of snapshot blocks.
+ */
+typedef struct EcsSnapshotReader {
+    const u8 *data; /**< The snapshot. */
+    u64 size;       /**< The size of the snapshot in bytes. */
+    u64 offset;     /**< Bytes read so far. */
+} EcsSnapshotReader;
+
+/**
+ * @brief Appends a block at the next aligned offset, zeroing the padding so
+ * snapshots of equal worlds are equal byte for byte.
+ *
+ * @param writer A pointer to the writer.
+ * @param source The bytes to copy, or NULL to leave the block for the caller.
+ * @param bytes The size of the block.
+ * @return void* The block in the output, or NULL when measuring or out of room.
+ */
+static void *ecs_snapshot_write(EcsSnapshotWriter *writer, const void *source, u64 bytes) {
+    u64 offset = (writer->offset + ECS_SNAPSHOT_ALIGNMENT - 1) & ~(u64)(ECS_SNAPSHOT_ALIGNMENT - 1);
+    u8 *block = NULL;
+    if (writer->data && !writer->overflowed) {
+        if (offset > writer->capacity || bytes > writer->capacity - offset) {
+            writer->overflowed = true;
+        } else {
+            memory_zero(writer->data + writer->offset, offset - writer->offset);
+            block = writer->data + offset;
+            if (source && bytes > 0) {
+                memory_copy(block, source, bytes);
+            }
+        }
+    }
+    writer->offset = offset + bytes;
+    return block;
+}
+
+/**
+ * @brief Takes the next block of a snapshot.
+ *
+ * @param reader A pointer to the reader.
+ * @param bytes The size of the block.
+ * @return const void* The block, or NULL if the snapshot ends first.
+ */
+static const void *ecs_snapshot_read(EcsSnapshotReader *reader, u64 bytes) {
+    u64 offset = (reader->offset + ECS_SNAPSHOT_ALIGNMENT - 1) & ~(u64)(ECS_SNAPSHOT_ALIGNMENT - 1);
+    if (offset > reader->size || bytes > reader->size - offset) {
+        return NULL;
+    }
+    reader->offset = offset + bytes;
+    return reader->data + offset;
+}
+
+/**
+ * @brief Writes, or measures, a snapshot of an ECS.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param writer A pointer to the writer.
+ * @return void
+ */
+static void ecs_snapshot_emit(const ECSManager *ecs, EcsSnapshotWriter *writer) {
+    const EntityManager *entityManager = &ecs->entityManager;
+    EcsSnapshotHeader *header = (EcsSnapshotHeader *)ecs_snapshot_write(writer, NULL, sizeof(EcsSnapshotHeader));
+    ecs_snapshot_write(writer, entityManager->generations, sizeof(u32) * (u64)entityManager->nextIndex);
+    ecs_snapshot_write(writer, entityManager->freeIndices, sizeof(u32) * (u64)entityManager->freeCount);
+
+    EcsSnapshotType *types = (EcsSnapshotType *)ecs_snapshot_write(writer, NULL, sizeof(EcsSnapshotType) * (u64)ecs->registeredComponents);
+    if (types) {
+        for (ComponentType type = 0; type < ecs->registeredComponents; ++type) {
+            const ComponentArray *componentArray = &ecs->componentArrays[type];
+            u32 pageCount = 0;
+            for (u32 page = 0; page < componentArray->sparsePageCount; ++page) {
+                pageCount += componentArray->sparsePages[page] != NULL;
+            }
+            types[type] = (EcsSnapshotType){componentArray->size, componentArray->count, pageCount, 0};
+        }
+    }
+
+    if (ecs->storage == ECS_STORAGE_SPARSE_SET) {
+        ecs_snapshot_write(writer, ecs->signatures, sizeof(EcsSignature) * (u64)entityManager->nextIndex);
+        u32 *groupCounts = (u32 *)ecs_snapshot_write(writer, NULL, sizeof(u32) * (u64)ecs->groupCount);
+        for (u32 group = 0; groupCounts && group < ecs->groupCount; ++group) {
+            groupCounts[group] = ecs->groups[group].count;
+        }
+
+        // Each type's packed arrays, then its allocated pages after their indices.
+        for (ComponentType type = 0; type < ecs->registeredComponents; ++type) {
+            const ComponentArray *componentArray = &ecs->componentArrays[type];
+            if (componentArray->size == 0) {
+                continue;
+            }
+            ecs_snapshot_write(writer, componentArray->data, (u64)componentArray->size * componentArray->count);
+            ecs_snapshot_write(writer, componentArray->entities, sizeof(Entity) * (u64)componentArray->count);
+            u32 pageCount = 0;
+            for (u32 page = 0; page < componentArray->sparsePageCount; ++page) {
+                pageCount += componentArray->sparsePages[page] != NULL;
+            }
+            u32 *pageIndices = (u32 *)ecs_snapshot_write(writer, NULL, sizeof(u32) * (u64)pageCount);
+            for (u32 page = 0, stored = 0; page < componentArray->sparsePageCount; ++page) {
+                if (componentArray->sparsePages[page]) {
+                    if (pageIndices) {
+                        pageIndices[stored++] = page;
+                    }
+                    ecs_snapshot_write(writer, componentArray->sparsePages[page], sizeof(u32) * ECS_SPARSE_PAGE_SIZE);
+                }
+            }
+        }
+    } else {
+        // Records name archetypes by their position in the table.
+        ecs_snapshot_write(writer, ecs->records, sizeof(EcsRecord) * (u64)entityManager->nextIndex);
+        EcsSnapshotArchetype *archetypes = (EcsSnapshotArchetype *)ecs_snapshot_write(writer, NULL, sizeof(EcsSnapshotArchetype) * (u64)ecs->archetypeCount);
+        for (u32 i = 0; i < ecs->archetypeCount; ++i) {
+            const EcsArchetype *archetype = &ecs->archetypes[i];
+            if (archetypes) {
+                archetypes[i] = (EcsSnapshotArchetype){archetype->signature, archetype->capacity, archetype->chunkCount, archetype->entityCount, 0};
+            }
+            for (u32 chunk = 0; chunk < archetype->chunkCount; ++chunk) {
+                ecs_snapshot_write(writer, archetype->chunks[chunk].memory, ECS_CHUNK_SIZE);
+            }
+        }
+    }
+
+    if (header) {
+        *header = (EcsSnapshotHeader){ECS_SNAPSHOT_MAGIC, ECS_SNAPSHOT_VERSION, writer->offset, (u32)ecs->storage, ecs->registeredComponents, entityManager->nextIndex, entityManager->freeCount, ecs->storage == ECS_STORAGE_ARCHETYPE ? ecs->archetypeCount : 0,
+                                      ecs->storage == ECS_STORAGE_SPARSE_SET ? ecs->groupCount : 0, ECS_CHUNK_SIZE, ECS_SPARSE_PAGE_SIZE};
+    }
+}
+
+/**
+ * @brief Checks that a signature has no types at or above a count.
+ *
+ * @param signature A pointer to the signature.
+ * @param typeCount The number of known types.
+ * @return b8 True if every type in the signature is below typeCount.
+ */
+static b8 ecs_restore_signature_known(const EcsSignature *signature, u32 typeCount) {
+    for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+        u32 first = word * 64;
+        u64 known = typeCount >= first + 64 ? MAX_U64 : typeCount <= first ? 0 : (1ull << (typeCount - first)) - 1;
+        if (signature->bits[word] & ~known) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks a sparse set's blocks in a snapshot before anything is
+ * copied: stored pages are ascending and in range, every page entry is empty
+ * or a row of the set, and every row's entity is a live handle of the
+ * snapshot with the type in its signature and a page entry pointing back at
+ * the row. With as many entries as rows, the pages and rows then match one to
+ * one.
+ *
+ * @param header A pointer to the snapshot's header.
+ * @param generations The snapshot's entity generations.
+ * @param type The set's component type.
+ * @param signatures The snapshot's entity signatures.
+ * @param stored A pointer to the set's entry in the type table.
+ * @param entities The set's stored entities.
+ * @param pageIndices Indices of the stored pages.
+ * @param pages The stored pages, ECS_SPARSE_PAGE_SIZE entries each, back to back.
+ * @return b8 True if the blocks are consistent.
+ */
+static b8 ecs_restore_check_sparse(const EcsSnapshotHeader *header, const u32 *generations, ComponentType type, const EcsSignature *signatures, const EcsSnapshotType *stored, const Entity *entities, const u32 *pageIndices, const u32 *pages) {
+    u32 pageLimit = (header->nextIndex + ECS_SPARSE_PAGE_SIZE - 1) / ECS_SPARSE_PAGE_SIZE;
+    if (stored->pageCount > pageLimit) {
+        return false;
+    }
+    for (u32 i = 0; i < stored->pageCount; ++i) {
+        if (pageIndices[i] >= pageLimit || (i > 0 && pageIndices[i] <= pageIndices[i - 1])) {
+            return false;
+        }
+    }
+    // Empty entries wrap to 0, so one compare covers them.
+    b8 outside = false;
+    u32 present = 0;
+    for (u64 i = 0; i < (u64)stored->pageCount * ECS_SPARSE_PAGE_SIZE; ++i) {
+        outside |= pages[i] + 1 > stored->count;
+        present += pages[i] != INVALID_ID_U32;
+    }
+    if (outside || present != stored->count) {
+        return false;
+    }
+
+    // Rows usually run in index order, so the last page found is tried first.
+    u32 position = 0;
+    for (u32 row = 0; row < stored->count; ++row) {
+        u32 index = ecs_entity_index(entities[row]);
+        if (index >= header->nextIndex || ecs_entity_generation(entities[row]) != generations[index] || !ecs_signature_has(&signatures[index], type)) {
+            return false;
+        }
+        u32 page = index / ECS_SPARSE_PAGE_SIZE;
+        if (position >= stored->pageCount || pageIndices[position] != page) {
+            u32 low = 0;
+            u32 high = stored->pageCount;
+            while (low < high) {
+                u32 middle = low + (high - low) / 2;
+                if (pageIndices[middle] < page) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            position = low;
+        }
+        if (position >= stored->pageCount || pageIndices[position] != page || pages[(u64)position * ECS_SPARSE_PAGE_SIZE + index % ECS_SPARSE_PAGE_SIZE] != row) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Makes a sparse set's pages match a snapshot's: stored pages are
+ * copied in, allocating them if needed, and pages the snapshot lacks are
+ * freed.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param componentArray A pointer to the component array.
+ * @param pageIndices Ascending indices of the stored pages.
+ * @param pages The stored pages, ECS_SPARSE_PAGE_SIZE entries each, back to back.
+ * @param pageCount The number of stored pages.
+ * @return b8 True on success, false if a page could not be allocated.
+ */
+static b8 ecs_restore_pages(ECSManager *ecs, ComponentArray *componentArray, const u32 *pageIndices, const u32 *pages, u32 pageCount) {
+    u32 next = 0;
+    for (u32 page = 0; page < componentArray->sparsePageCount; ++page) {
+        if (next < pageCount && pageIndices[next] == page) {
+            next++;
+        } else if (componentArray->sparsePages[page]) {
+            memory_free(ecs->pool, componentArray->sparsePages[page], MEMORY_TAG_ECS);
+            componentArray->sparsePages[page] = NULL;
+        }
+    }
+
+    for (u32 i = 0; i < pageCount; ++i) {
+        if (!ecs_sparse_slot(ecs, componentArray, pageIndices[i] * ECS_SPARSE_PAGE_SIZE)) {
+            return false;
+        }
+        memory_copy(componentArray->sparsePages[pageIndices[i]], pages + (u64)i * ECS_SPARSE_PAGE_SIZE, sizeof(u32) * ECS_SPARSE_PAGE_SIZE);
+    }
+    return true;
+}
+
+/**
+ * @brief Gives an archetype a number of chunks, reusing the chunks and spare
+ * chunk it has, allocating the rest and keeping one surplus chunk as spare.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param archetype A pointer to the archetype.
+ * @param chunkCount The number of chunks it needs.
+ * @return b8 True on success, false if a chunk could not be allocated.
+ */
+static b8 ecs_restore_chunks(ECSManager *ecs, EcsArchetype *archetype, u32 chunkCount) {
+    while (archetype->chunkCount > chunkCount) {
+        u8 *memory = archetype->chunks[--archetype->chunkCount].memory;
+        if (archetype->spareChunk) {
+            memory_free_aligned(ecs->pool, memory, MEMORY_TAG_ECS);
+        } else {
+            archetype->spareChunk = memory;
+        }
+    }
+
+    if (chunkCount > archetype->chunkCapacity) {
+        EcsChunk *chunks = (EcsChunk *)ecs_reserve_array(ecs, archetype->chunks, sizeof(EcsChunk), archetype->chunkCount, &archetype->chunkCapacity, chunkCount);
+        if (!chunks) {
+            log_error("Failed to grow the chunk array of an archetype to %u chunks.", chunkCount);
+            return false;
+        }
+        archetype->chunks = chunks;
+    }
+    while (archetype->chunkCount < chunkCount) {
+        u8 *memory = archetype->spareChunk;
+        archetype->spareChunk = NULL;
+        if (!memory) {
+            memory = (u8 *)memory_allocate_aligned(ecs->pool, ECS_CHUNK_SIZE, ECS_COMPONENT_ALIGNMENT, MEMORY_TAG_ECS);
+        }
+        if (!memory) {
+            log_error("Failed to allocate an archetype chunk.");
+            return false;
+        }
+        archetype->chunks[archetype->chunkCount++] = (EcsChunk){memory, 0};
+    }
+    return true;
+}
+
+/**
+ * @brief Replaces the contents of an ECS array with a snapshot block, growing
+ * the array if needed.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param array The array, or NULL.
+ * @param capacity A pointer to the array's capacity, updated if it grows.
+ * @param elementSize The size of an element in bytes.
+ * @param source The snapshot block.
+ * @param count The number of elements in the block.
+ * @return void* The array, possibly moved, or NULL if it had to grow and could not.
+ */
+static void *ecs_restore_array(ECSManager *ecs, void *array, u32 *capacity, u32 elementSize, const void *source, u32 count) {
+    if (count == 0) {
+        return array;
+    }
+    array = ecs_reserve_array(ecs, array, elementSize, 0, capacity, count);
+    if (!array) {
+        log_error("Failed to grow an ECS array to %u elements for a restore.", count);
+        return NULL;
+    }
+    memory_copy(array, source, (u64)elementSize * count);
+    return array;
+}
+
+/**
+ * @brief Walks the sparse-set blocks of a snapshot, first to check them and
+ * then again to copy them into the ECS.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param reader A pointer to a reader positioned after the type table.
+ * @param header A pointer to the snapshot's header.
+ * @param generations The snapshot's entity generations.
+ * @param freeIndices The snapshot's free entity indices.
+ * @param types The snapshot's type table.
+ * @param apply False to only check the blocks, true to restore them.
+ * @return EngineResult ENGINE_SUCCESS, or an error code.
+ */
+static EngineResult ecs_restore_sparse(ECSManager *ecs, EcsSnapshotReader *reader, const EcsSnapshotHeader *header, const u32 *generations, const u32 *freeIndices, const EcsSnapshotType *types, b8 apply) {
+    const EcsSignature *signatures = (const EcsSignature *)ecs_snapshot_read(reader, sizeof(EcsSignature) * (u64)header->nextIndex);
+    const u32 *groupCounts = (const u32 *)ecs_snapshot_read(reader, sizeof(u32) * (u64)header->groupCount);
+    if (!signatures || !groupCounts) {
+        log_error("Truncated ECS snapshot.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!apply) {
+        // Each type is in as many signatures as it has rows (or tagged entities).
+        u32 counts[ECS_MAX_COMPONENTS] = {0};
+        for (u32 index = 0; index < header->nextIndex; ++index) {
+            for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+                for (u64 bits = signatures[index].bits[word]; bits; bits &= bits - 1) {
+                    counts[word * 64 + (u32)__builtin_ctzll(bits)]++;
+                }
+            }
+        }
+        for (ComponentType type = 0; type < ECS_MAX_COMPONENTS; ++type) {
+            if (counts[type] != (type < header->componentCount ? types[type].count : 0)) {
+                log_error("Corrupt entity signatures for component type %u in ECS snapshot.", type);
+                return ENGINE_ERROR_INVALID_ARGUMENT;
+            }
+        }
+        // A free index belongs to no entity, so it has no components.
+        for (u32 i = 0; i < header->freeCount; ++i) {
+            if (!ecs_signature_empty(&signatures[freeIndices[i]])) {
+                log_error("Free entity index %u of the ECS snapshot still has components.", freeIndices[i]);
+                return ENGINE_ERROR_INVALID_ARGUMENT;
+            }
+        }
+        // A group's members are the first rows of each type it owns.
+        for (u32 group = 0; group < header->groupCount; ++group) {
+            for (u32 i = 0; i < ecs->groups[group].typeCount; ++i) {
+                ComponentType type = ecs->groups[group].types[i];
+                if (groupCounts[group] > (type < header->componentCount ? types[type].count : 0)) {
+                    log_error("Corrupt size of group %u in ECS snapshot.", group);
+                    return ENGINE_ERROR_INVALID_ARGUMENT;
+                }
+            }
+        }
+    } else {
+        EcsSignature *restored = (EcsSignature *)ecs_restore_array(ecs, ecs->signatures, &ecs->signatureCapacity, sizeof(EcsSignature), signatures, header->nextIndex);
+        if (!restored && header->nextIndex > 0) {
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+        ecs->signatures = restored;
+        for (u32 group = 0; group < header->groupCount; ++group) {
+            ecs->groups[group].count = groupCounts[group];
+        }
+    }
+
+    for (ComponentType type = 0; type < ecs->registeredComponents; ++type) {
+        ComponentArray *componentArray = &ecs->componentArrays[type];
+        if (componentArray->size == 0) {
+            // A tag is only its signature bits.
+            if (apply) {
+                componentArray->count = type < header->componentCount ? types[type].count : 0;
+            }
+            continue;
+        }
+        if (type >= header->componentCount) {
+            // Registered after the snapshot was taken, so no entity has it.
+            if (apply) {
+                componentArray->count = 0;
+                ecs_restore_pages(ecs, componentArray, NULL, NULL, 0);
+            }
+            continue;
+        }
+
+        // Pages are written back to back, so they are read as one block.
+        const EcsSnapshotType *stored = &types[type];
+        const u8 *data = (const u8 *)ecs_snapshot_read(reader, (u64)stored->size * stored->count);
+        const Entity *entities = (const Entity *)ecs_snapshot_read(reader, sizeof(Entity) * (u64)stored->count);
+        const u32 *pageIndices = (const u32 *)ecs_snapshot_read(reader, sizeof(u32) * (u64)stored->pageCount);
+        const u32 *pages = (const u32 *)ecs_snapshot_read(reader, sizeof(u32) * ECS_SPARSE_PAGE_SIZE * (u64)stored->pageCount);
+        if (!data || !entities || !pageIndices || !pages) {
+            log_error("Truncated ECS snapshot at component type %u.", type);
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+        if (!apply) {
+            if (!ecs_restore_check_sparse(header, generations, type, signatures, stored, entities, pageIndices, pages)) {
+                log_error("Corrupt sparse set of component type %u in ECS snapshot.", type);
+                return ENGINE_ERROR_INVALID_ARGUMENT;
+            }
+            continue;
+        }
+
+        componentArray->count = 0;
+        if (!ecs_restore_pages(ecs, componentArray, pageIndices, pages, stored->pageCount) || !ecs_sparse_reserve(ecs, componentArray, stored->count)) {
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+        if (stored->count > 0) {
+            memory_copy(componentArray->data, data, (u64)stored->size * stored->count);
+            memory_copy(componentArray->entities, entities, sizeof(Entity) * stored->count);
+        }
+        componentArray->count = stored->count;
+        componentArray->sortedCount = 0;
+        ecs_sparse_touch_all(ecs, componentArray);
+    }
+
+    if (apply) {
+        for (u32 i = 0; i < ecs->queryCount; ++i) {
+            ecs->queries[i]->stale = true;
+        }
+    }
+    return ENGINE_SUCCESS;
+}
+
+/**
+ * @brief Checks one archetype of a snapshot and finds the ECS archetype it
+ * maps to, without creating any: its types must be known, its entity count
+ * must fit its chunks, its rows per chunk must match the layout the ECS
+ * gives its types, and no earlier stored archetype may share its signature.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param stored The snapshot's archetype table.
+ * @param i The index of the archetype to check.
+ * @param componentCount The number of component types in the snapshot.
+ * @param remap The ECS archetype of each earlier stored archetype, INVALID_ID_U32 for ones still to create.
+ * @param seen One flag per ECS archetype, set once a stored archetype maps to it.
+ * @return u32 The ECS archetype, INVALID_ID_U32 if it does not exist yet, or INVALID_ID_U32 - 1 if the archetype is corrupt.
+ */
+static u32 ecs_restore_check_archetype(const ECSManager *ecs, const EcsSnapshotArchetype *stored, u32 i, u32 componentCount, const u32 *remap, u32 *seen) {
+    const EcsSnapshotArchetype *archetype = &stored[i];
+    u32 corrupt = INVALID_ID_U32 - 1;
+    if (ecs_signature_empty(&archetype->signature) || !ecs_restore_signature_known(&archetype->signature, componentCount) || archetype->capacity == 0 ||
+        (u64)archetype->chunkCount * archetype->capacity < archetype->entityCount || (archetype->chunkCount > 0 && (u64)(archetype->chunkCount - 1) * archetype->capacity >= archetype->entityCount)) {
+        return corrupt;
+    }
+
+    u32 index = ecs_archetype_find(ecs, &archetype->signature);
+    u32 capacity;
+    if (index != INVALID_ID_U32) {
+        if (seen[index]) {
+            return corrupt;
+        }
+        seen[index] = 1;
+        capacity = ecs->archetypes[index].capacity;
+    } else {
+        for (u32 j = 0; j < i; ++j) {
+            if (remap[j] == INVALID_ID_U32 && ecs_signature_equal(&stored[j].signature, &archetype->signature)) {
+                return corrupt;
+            }
+        }
+        ComponentType columns[ECS_MAX_COMPONENTS];
+        u32 typeCount = 0;
+        for (ComponentType type = 0; type < componentCount; ++type) {
+            if (ecs_signature_has(&archetype->signature, type)) {
+                columns[typeCount++] = type;
+            }
+        }
+        capacity = ecs_archetype_layout(ecs, columns, typeCount, NULL, NULL);
+    }
+    return capacity == archetype->capacity ? index : corrupt;
+}
+
+/**
+ * @brief Walks the archetype blocks of a snapshot, first to check them and
+ * map each stored archetype to an existing one of the ECS, and then again to
+ * create the missing archetypes and copy the blocks into the ECS.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param reader A pointer to a reader positioned after the type table.
+ * @param header A pointer to the snapshot's header.
+ * @param generations The snapshot's entity generations.
+ * @param freeIndices The snapshot's free entity indices.
+ * @param types The snapshot's type table.
+ * @param remap An array of header->archetypeCount entries for the ECS archetype
+ * of each stored archetype, followed by one zeroed entry per ECS archetype.
+ * @param apply False to only check the blocks, true to restore them.
+ * @return EngineResult ENGINE_SUCCESS, or an error code.
+ */
+static EngineResult ecs_restore_archetypes(ECSManager *ecs, EcsSnapshotReader *reader, const EcsSnapshotHeader *header, const u32 *generations, const u32 *freeIndices, const EcsSnapshotType *types, u32 *remap, b8 apply) {
+    const EcsRecord *records = (const EcsRecord *)ecs_snapshot_read(reader, sizeof(EcsRecord) * (u64)header->nextIndex);
+    const EcsSnapshotArchetype *archetypes = (const EcsSnapshotArchetype *)ecs_snapshot_read(reader, sizeof(EcsSnapshotArchetype) * (u64)header->archetypeCount);
+    if (!records || !archetypes) {
+        log_error("Truncated ECS snapshot.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!apply) {
+        u64 rows = 0;
+        u64 counts[ECS_MAX_COMPONENTS] = {0};
+        for (u32 i = 0; i < header->archetypeCount; ++i) {
+            const EcsSnapshotArchetype *stored = &archetypes[i];
+            remap[i] = ecs_restore_check_archetype(ecs, archetypes, i, header->componentCount, remap, remap + header->archetypeCount);
+            if (remap[i] == INVALID_ID_U32 - 1) {
+                log_error("Corrupt archetype %u in ECS snapshot.", i);
+                return ENGINE_ERROR_INVALID_ARGUMENT;
+            }
+
+            // Chunks are written back to back; each starts with its entities.
+            const u8 *chunks = (const u8 *)ecs_snapshot_read(reader, (u64)ECS_CHUNK_SIZE * stored->chunkCount);
+            if (!chunks) {
+                log_error("Truncated ECS snapshot.");
+                return ENGINE_ERROR_INVALID_ARGUMENT;
+            }
+            // Every row's entity must have a record pointing back at the row.
+            for (u32 row = 0; row < stored->entityCount; ++row) {
+                u32 chunk = row / stored->capacity;
+                const Entity *entity = (const Entity *)(chunks + (u64)ECS_CHUNK_SIZE * chunk) + row % stored->capacity;
+                u32 index = ecs_entity_index(*entity);
+                if (index >= header->nextIndex || ecs_entity_generation(*entity) != generations[index] || records[index].archetype != i || records[index].chunk != chunk || records[index].row != row % stored->capacity) {
+                    log_error("Corrupt entity in archetype %u of ECS snapshot.", i);
+                    return ENGINE_ERROR_INVALID_ARGUMENT;
+                }
+            }
+            rows += stored->entityCount;
+            for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+                for (u64 bits = stored->signature.bits[word]; bits; bits &= bits - 1) {
+                    counts[word * 64 + (u32)__builtin_ctzll(bits)] += stored->entityCount;
+                }
+            }
+        }
+
+        // Each type counts the rows of the archetypes that have it.
+        for (ComponentType type = 0; type < header->componentCount; ++type) {
+            if (counts[type] != types[type].count) {
+                log_error("ECS snapshot counts %u entities with component type %u, but its archetypes hold %llu.", types[type].count, type, (unsigned long long)counts[type]);
+                return ENGINE_ERROR_INVALID_ARGUMENT;
+            }
+        }
+        // A free index belongs to no entity, so it has no record.
+        for (u32 i = 0; i < header->freeCount; ++i) {
+            if (records[freeIndices[i]].archetype != INVALID_ID_U32) {
+                log_error("Free entity index %u of the ECS snapshot still has components.", freeIndices[i]);
+                return ENGINE_ERROR_INVALID_ARGUMENT;
+            }
+        }
+
+        // With as many records as rows, records and rows match one to one.
+        u64 recorded = 0;
+        for (u32 index = 0; index < header->nextIndex; ++index) {
+            recorded += records[index].archetype != INVALID_ID_U32;
+        }
+        if (recorded != rows) {
+            log_error("ECS snapshot has %llu entity records for %llu archetype rows.", (unsigned long long)recorded, (unsigned long long)rows);
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+        return ENGINE_SUCCESS;
+    }
+
+    // Archetypes the ECS lacks are created only now that the snapshot is known good.
+    for (u32 i = 0; i < header->archetypeCount; ++i) {
+        if (remap[i] == INVALID_ID_U32) {
+            remap[i] = ecs_archetype_get(ecs, &archetypes[i].signature);
+            if (remap[i] == INVALID_ID_U32) {
+                return ENGINE_ERROR_ALLOCATION_FAILED;
+            }
+        }
+    }
+
+    EcsRecord *restored = (EcsRecord *)ecs_restore_array(ecs, ecs->records, &ecs->recordCapacity, sizeof(EcsRecord), records, header->nextIndex);
+    if (!restored && header->nextIndex > 0) {
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+    ecs->records = restored;
+    for (u32 index = 0; index < header->nextIndex; ++index) {
+        if (restored[index].archetype != INVALID_ID_U32) {
+            restored[index].archetype = remap[restored[index].archetype];
+        }
+    }
+
+    // Archetypes the snapshot lacks are emptied; their chunks go to the spare.
+    for (u32 i = 0; i < ecs->archetypeCount; ++i) {
+        ecs->archetypes[i].entityCount = INVALID_ID_U32;
+    }
+    for (u32 i = 0; i < header->archetypeCount; ++i) {
+        ecs->archetypes[remap[i]].entityCount = 0;
+    }
+    for (u32 i = 0; i < ecs->archetypeCount; ++i) {
+        if (ecs->archetypes[i].entityCount == INVALID_ID_U32) {
+            ecs->archetypes[i].entityCount = 0;
+            ecs_restore_chunks(ecs, &ecs->archetypes[i], 0);
+        }
+    }
+
+    for (u32 i = 0; i < header->archetypeCount; ++i) {
+        const EcsSnapshotArchetype *stored = &archetypes[i];
+        EcsArchetype *archetype = &ecs->archetypes[remap[i]];
+        const u8 *chunks = (const u8 *)ecs_snapshot_read(reader, (u64)ECS_CHUNK_SIZE * stored->chunkCount);
+        if (!ecs_restore_chunks(ecs, archetype, stored->chunkCount)) {
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+        for (u32 chunk = 0; chunk < stored->chunkCount; ++chunk) {
+            EcsChunk *target = &archetype->chunks[chunk];
+            memory_copy(target->memory, chunks + (u64)ECS_CHUNK_SIZE * chunk, ECS_CHUNK_SIZE);
+            target->count = chunk + 1 < stored->chunkCount ? stored->capacity : stored->entityCount - chunk * stored->capacity;
+            ecs_chunk_touch_all(ecs, archetype, target);
+        }
+        archetype->entityCount = stored->entityCount;
+    }
+    return ENGINE_SUCCESS;
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region ECS
+
+ENGINE_API EngineResult ecs_init(ECSManager *ecs, MemoryPool *pool, const ECSConfig *config) {
+    if (!ecs || !pool || !config) {
+        log_error("Invalid ECSManager, MemoryPool or ECSConfig provided to ecs_init.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    memory_zero(ecs, sizeof(ECSManager));
+    ecs->pool = pool;
+    ecs->storage = config->storage;
+    platform_atomic_store_i32(&ecs->changeVersion, 1);
+
+    // Declared types take the same IDs in every ECS.
+    for (u32 i = 0; i < declaredComponentCount; ++i) {
+        ecs_register_type(ecs, declaredComponents[i].name, declaredComponents[i].size, declaredComponents[i].alignment);
+    }
+
+    log_info("ECS initialized with %s storage.", ecs->storage == ECS_STORAGE_ARCHETYPE ? "archetype" : "sparse-set");
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void ecs_shutdown(ECSManager *ecs) {
+    if (!ecs || !ecs->pool) {
+        log_error("Invalid ECSManager provided to ecs_shutdown.");
+        return;
+    }
+
+    if (ecs->queryCount > 0) {
+        log_warning("%u queries were not destroyed before ecs_shutdown.", ecs->queryCount);
+        for (u32 i = 0; i < ecs->queryCount; ++i) {
+            ecs_query_free(ecs->queries[i]);
+        }
+    }
+    if (ecs->queries) {
+        memory_free(ecs->pool, ecs->queries, MEMORY_TAG_ECS);
+    }
+    if (ecs->groups) {
+        memory_free(ecs->pool, ecs->groups, MEMORY_TAG_ECS);
+    }
+
+    for (ComponentType type = 0; type < ecs->registeredComponents; ++type) {
+        ecs_free_component_array(ecs, &ecs->componentArrays[type]);
+    }
+
+    for (u32 i = 0; i < ecs->archetypeCount; ++i) {
+        ecs_archetype_free(ecs, &ecs->archetypes[i]);
+    }
+    if (ecs->archetypes) {
+        memory_free(ecs->pool, ecs->archetypes, MEMORY_TAG_ECS);
+    }
+    if (ecs->records) {
+        memory_free(ecs->pool, ecs->records, MEMORY_TAG_ECS);
+    }
+    if (ecs->signatures) {
+        memory_free(ecs->pool, ecs->signatures, MEMORY_TAG_ECS);
+    }
+
+    if (ecs->entityManager.generations) {
+        memory_free(ecs->pool, ecs->entityManager.generations, MEMORY_TAG_ECS);
+    }
+    if (ecs->entityManager.freeIndices) {
+        memory_free(ecs->pool, ecs->entityManager.freeIndices, MEMORY_TAG_ECS);
+    }
+
+    memory_zero(ecs, sizeof(ECSManager));
+    log_info("ECS shutdown completed.");
+}
+
+ENGINE_API Entity ecs_create_entity(ECSManager *ecs) {
+    EntityManager *entityManager = &ecs->entityManager;
+    if (entityManager->freeCount > 0) {
+        // Reuse a free index. Its generation was bumped when it was destroyed.
+        u32 index = entityManager->freeIndices[--entityManager->freeCount];
+        if (ecs->records) {
+            ecs->records[index] = (EcsRecord){INVALID_ID_U32, 0, 0};
+        }
+        return ecs_entity_make(index, entityManager->generations[index]);
+    }
+
+    if (entityManager->nextIndex == INVALID_ID_U32) {
+        log_error("Entity indices exhausted.");
+        return INVALID_ENTITY;
+    }
+
+    u32 index = entityManager->nextIndex;
+    if (index == entityManager->generationCapacity) {
+        u32 *generations = (u32 *)ecs_grow_array(ecs, entityManager->generations, sizeof(u32), index, &entityManager->generationCapacity);
+        if (!generations) {
+            log_error("Failed to grow entity generations past %u entities.", index);
+            return INVALID_ENTITY;
+        }
+        entityManager->generations = generations;
+    }
+
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        if (index == ecs->recordCapacity) {
+            EcsRecord *records = (EcsRecord *)ecs_grow_array(ecs, ecs->records, sizeof(EcsRecord), index, &ecs->recordCapacity);
+            if (!records) {
+                log_error("Failed to grow entity records past %u entities.", index);
+                return INVALID_ENTITY;
+            }
+            ecs->records = records;
+        }
+        ecs->records[index] = (EcsRecord){INVALID_ID_U32, 0, 0};
+    } else {
+        if (index == ecs->signatureCapacity) {
+            EcsSignature *signatures = (EcsSignature *)ecs_grow_array(ecs, ecs->signatures, sizeof(EcsSignature), index, &ecs->signatureCapacity);
+            if (!signatures) {
+                log_error("Failed to grow entity signatures past %u entities.", index);
+                return INVALID_ENTITY;
+            }
+            ecs->signatures = signatures;
+        }
+        memory_zero(&ecs->signatures[index], sizeof(EcsSignature));
+    }
+
+    entityManager->generations[index] = 0;
+    entityManager->nextIndex++;
+    return ecs_entity_make(index, 0);
+}
+
+ENGINE_API void ecs_destroy_entity(ECSManager *ecs, Entity entity) {
+    if (!ecs_is_valid_entity(ecs, entity)) {
+        log_warning("Attempted to destroy stale or invalid entity %u:%u.", ecs_entity_index(entity), ecs_entity_generation(entity));
+        return;
+    }
+
+    // Remove all components associated with the entity.
+    u32 index = ecs_entity_index(entity);
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        ecs_archetype_detach(ecs, index);
+    } else {
+        // Only the types in the entity's signature are visited.
+        EcsSignature *signature = &ecs->signatures[index];
+        for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+            while (signature->bits[word]) {
+                ecs_sparse_remove(ecs, entity, word * 64 + (ComponentType)__builtin_ctzll(signature->bits[word]));
+            }
+        }
+    }
+
+    ecs_entity_release(ecs, index);
+}
+
+ENGINE_API EngineResult ecs_create_batch(ECSManager *ecs, u32 count, const ComponentType *types, u32 typeCount, const void *const *initData, Entity *entities) {
+    if (!ecs || (!types && typeCount > 0) || (!entities && count > 0)) {
+        log_error("Invalid ECSManager, component types or entity array provided to ecs_create_batch.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    EcsSignature signature = {0};
+    for (u32 i = 0; i < typeCount; ++i) {
+        if (!ecs_is_valid_type(ecs, types[i]) || ecs_signature_has(&signature, types[i])) {
+            log_error("Component type %u is not registered or is listed twice.", types[i]);
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+        ecs_signature_set(&signature, types[i]);
+    }
+    if (count == 0) {
+        return ENGINE_SUCCESS;
+    }
+
+    u32 archetypeIndex = INVALID_ID_U32;
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE && typeCount > 0) {
+        archetypeIndex = ecs_archetype_get(ecs, &signature);
+        if (archetypeIndex == INVALID_ID_U32) {
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+    }
+
+    // Reserve every index up front: free ones first, as ecs_create_entity
+    // takes them, then fresh ones, with one allocation per array.
+    EntityManager *entityManager = &ecs->entityManager;
+    u32 reused = entityManager->freeCount < count ? entityManager->freeCount : count;
+    u32 fresh = count - reused;
+    if (fresh > INVALID_ID_U32 - entityManager->nextIndex) {
+        log_error("Entity indices exhausted.");
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+
+    u32 end = entityManager->nextIndex + fresh;
+    u32 *generations = (u32 *)ecs_reserve_array(ecs, entityManager->generations, sizeof(u32), entityManager->nextIndex, &entityManager->generationCapacity, end);
+    if (!generations) {
+        log_error("Failed to grow entity generations past %u entities.", end);
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+    entityManager->generations = generations;
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        EcsRecord *records = (EcsRecord *)ecs_reserve_array(ecs, ecs->records, sizeof(EcsRecord), entityManager->nextIndex, &ecs->recordCapacity, end);
+        if (!records) {
+            log_error("Failed to grow entity records past %u entities.", end);
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+        ecs->records = records;
+    } else {
+        EcsSignature *signatures = (EcsSignature *)ecs_reserve_array(ecs, ecs->signatures, sizeof(EcsSignature), entityManager->nextIndex, &ecs->signatureCapacity, end);
+        if (!signatures) {
+            log_error("Failed to grow entity signatures past %u entities.", end);
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+        ecs->signatures = signatures;
+    }
+
+    for (u32 i = 0; i < reused; ++i) {
+        u32 index = entityManager->freeIndices[--entityManager->freeCount];
+        entities[i] = ecs_entity_make(index, entityManager->generations[index]);
+    }
+    for (u32 i = reused; i < count; ++i) {
+        u32 index = entityManager->nextIndex++;
+        entityManager->generations[index] = 0;
+        entities[i] = ecs_entity_make(index, 0);
+    }
+
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        for (u32 i = 0; i < count; ++i) {
+            ecs->records[ecs_entity_index(entities[i])] = (EcsRecord){INVALID_ID_U32, 0, 0};
+        }
+        if (archetypeIndex == INVALID_ID_U32) {
+            return ENGINE_SUCCESS;
+        }
+
+        // The argument index of each of the archetype's columns.
+        EcsArchetype *archetype = &ecs->archetypes[archetypeIndex];
+        u32 sources[ECS_MAX_COMPONENTS];
+        for (u32 column = 0; column < archetype->typeCount; ++column) {
+            u32 source = 0;
+            while (types[source] != archetype->types[column]) {
+                source++;
+            }
+            sources[column] = source;
+        }
+
+        // Fill the open chunk, then whole new ones, a column slice at a time.
+        u32 done = 0;
+        while (done < count) {
+            EcsChunk *chunk = ecs_archetype_open_chunk(ecs, archetype);
+            if (!chunk) {
+                ecs_destroy_batch(ecs, entities, count);
+                return ENGINE_ERROR_ALLOCATION_FAILED;
+            }
+
+            u32 chunkIndex = archetype->chunkCount - 1;
+            u32 row = chunk->count;
+            u32 rows = archetype->capacity - row < count - done ? archetype->capacity - row : count - done;
+            memory_copy((Entity *)chunk->memory + row, entities + done, sizeof(Entity) * rows);
+            for (u32 column = 0; column < archetype->typeCount; ++column) {
+                ComponentArray *componentArray = &ecs->componentArrays[archetype->types[column]];
+                u8 *destination = chunk->memory + archetype->offsets[column] + (u64)row * componentArray->size;
+                const u8 *source = initData ? (const u8 *)initData[sources[column]] : NULL;
+                if (source) {
+                    memory_copy(destination, source + (u64)done * componentArray->size, (u64)rows * componentArray->size);
+                } else {
+                    memory_zero(destination, (u64)rows * componentArray->size);
+                }
+                componentArray->count += rows;
+            }
+            for (u32 i = 0; i < rows; ++i) {
+                ecs->records[ecs_entity_index(entities[done + i])] = (EcsRecord){archetypeIndex, chunkIndex, row + i};
+            }
+
+            chunk->count += rows;
+            archetype->entityCount += rows;
+            ecs_chunk_touch_all(ecs, archetype, chunk);
+            done += rows;
+        }
+        return ENGINE_SUCCESS;
+    }
+
+    // Sparse sets: append each type's components as one packed run.
+    for (u32 i = 0; i < count; ++i) {
+        ecs->signatures[ecs_entity_index(entities[i])] = (EcsSignature){0};
+    }
+    for (u32 t = 0; t < typeCount; ++t) {
+        ComponentArray *componentArray = &ecs->componentArrays[types[t]];
+        if (componentArray->size == 0) {
+            for (u32 i = 0; i < count; ++i) {
+                ecs_signature_set(&ecs->signatures[ecs_entity_index(entities[i])], types[t]);
+            }
+            componentArray->count += count;
+            ecs_queries_invalidate(ecs, types[t]);
+            continue;
+        }
+        if (count > MAX_U32 - componentArray->count || !ecs_sparse_reserve(ecs, componentArray, componentArray->count + count)) {
+            ecs_destroy_batch(ecs, entities, count);
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+
+        u32 first = componentArray->count;
+        for (u32 i = 0; i < count; ++i) {
+            u32 *slot = ecs_sparse_slot(ecs, componentArray, ecs_entity_index(entities[i]));
+            if (!slot) {
+                // Components are only counted once every entry is written.
+                for (u32 j = 0; j < i; ++j) {
+                    *ecs_sparse_slot(ecs, componentArray, ecs_entity_index(entities[j])) = INVALID_ID_U32;
+                }
+                ecs_destroy_batch(ecs, entities, count);
+                return ENGINE_ERROR_ALLOCATION_FAILED;
+            }
+            *slot = first + i;
+        }
+
+        u8 *destination = componentArray->data + (u64)first * componentArray->size;
+        const u8 *source = initData ? (const u8 *)initData[t] : NULL;
+        if (source) {
+            memory_copy(destination, source, (u64)count * componentArray->size);
+        } else {
+            memory_zero(destination, (u64)count * componentArray->size);
+        }
+        memory_copy(componentArray->entities + first, entities, sizeof(Entity) * count);
+        componentArray->count += count;
+        for (u32 i = 0; i < count; ++i) {
+            ecs_signature_set(&ecs->signatures[ecs_entity_index(entities[i])], types[t]);
+        }
+        ecs_sparse_touch_range(ecs, componentArray, first, count);
+        ecs_queries_invalidate(ecs, types[t]);
+    }
+
+    // Entities that now have every type of a group join it, one group at a time.
+    for (u32 t = 0; t < typeCount; ++t) {
+        u32 groupIndex = ecs->componentArrays[types[t]].group;
+        b8 seen = groupIndex == INVALID_ID_U32;
+        for (u32 u = 0; u < t && !seen; ++u) {
+            seen = ecs->componentArrays[types[u]].group == groupIndex;
+        }
+        if (seen) {
+            continue;
+        }
+
+        EcsGroup *group = &ecs->groups[groupIndex];
+        b8 joined = false;
+        for (u32 i = 0; i < count; ++i) {
+            joined |= ecs_group_attach(ecs, group, entities[i]);
+        }
+        if (joined) {
+            ecs_group_invalidate(ecs, group);
+        }
+    }
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void ecs_destroy_batch(ECSManager *ecs, const Entity *entities, u32 count) {
+    if (!ecs || (!entities && count > 0)) {
+        log_error("Invalid ECSManager or entity array provided to ecs_destroy_batch.");
+        return;
+    }
+
+    // Room on the free list for every index, in one allocation.
+    EntityManager *entityManager = &ecs->entityManager;
+    if (count > MAX_U32 - entityManager->freeCount) {
+        log_error("Too many entities (%u) provided to ecs_destroy_batch.", count);
+        return;
+    }
+    u32 *freeIndices = (u32 *)ecs_reserve_array(ecs, entityManager->freeIndices, sizeof(u32), entityManager->freeCount, &entityManager->freeCapacity, entityManager->freeCount + count);
+    if (freeIndices) {
+        entityManager->freeIndices = freeIndices;
+    }
+
+    // Sparse sets are walked a type at a time, so each type's queries are
+    // marked stale once instead of per entity.
+    if (ecs->storage == ECS_STORAGE_SPARSE_SET) {
+        for (ComponentType type = 0; type < ecs->registeredComponents; ++type) {
+            ComponentArray *componentArray = &ecs->componentArrays[type];
+            u32 before = componentArray->count;
+            for (u32 i = 0; i < count && componentArray->count > 0; ++i) {
+                if (!ecs_is_valid_entity(ecs, entities[i])) {
+                    continue;
+                }
+                u32 index = ecs_entity_index(entities[i]);
+                if (ecs_signature_has(&ecs->signatures[index], type)) {
+                    ecs_sparse_erase(ecs, componentArray, entities[i], ecs_sparse_get(componentArray, index));
+                }
+            }
+            if (componentArray->count != before) {
+                ecs_queries_invalidate(ecs, type);
+            }
+        }
+    }
+
+    // A handle listed twice is stale by its second appearance.
+    u32 skipped = 0;
+    for (u32 i = 0; i < count; ++i) {
+        if (!ecs_is_valid_entity(ecs, entities[i])) {
+            skipped++;
+            continue;
+        }
+        if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+            ecs_archetype_detach(ecs, ecs_entity_index(entities[i]));
+        }
+        ecs_entity_release(ecs, ecs_entity_index(entities[i]));
+    }
+
+    if (skipped > 0) {
+        log_warning("Skipped %u stale or invalid entities in ecs_destroy_batch.", skipped);
+    }
+}
+
+ENGINE_API b8 ecs_entity_alive(const ECSManager *ecs, Entity entity) {
+    return ecs_is_valid_entity(ecs, entity);
+}
+
+ENGINE_API ComponentType ecs_register_component(ECSManager *ecs, u32 componentSize) {
+    if (componentSize == 0) {
+        log_error("Invalid component size provided to ecs_register_component.");
+        return INVALID_COMPONENT_TYPE;
+    }
+
+    // Any C type's alignment divides its size.
+    u32 alignment = 1;
+    while (alignment < ECS_COLUMN_ALIGNMENT && componentSize % (alignment * 2) == 0) {
+        alignment *= 2;
+    }
+    return ecs_register_type(ecs, NULL, componentSize, alignment);
+}
+
+ENGINE_API ComponentType ecs_register_tag(ECSManager *ecs) {
+    if (!ecs) {
+        log_error("Invalid ECSManager provided to ecs_register_tag.");
+        return INVALID_COMPONENT_TYPE;
+    }
+    return ecs_register_type(ecs, NULL, 0, 1);
+}
+
+ENGINE_API ComponentType ecs_component_declare(const char *name, u32 size, u32 alignment) {
+    if (!name || alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > ECS_COMPONENT_ALIGNMENT) {
+        log_error("Invalid name, size or alignment provided to ecs_component_declare.");
+        return INVALID_COMPONENT_TYPE;
+    }
+
+    if (declaredComponentCount >= ECS_MAX_COMPONENTS) {
+        log_error("Maximum number of component types (%u) reached declaring %s.", ECS_MAX_COMPONENTS, name);
+        return INVALID_COMPONENT_TYPE;
+    }
+
+    ComponentType type = declaredComponentCount++;
+    declaredComponents[type] = (EcsComponentDecl){name, size, alignment};
+    return type;
+}
+
+ENGINE_API u32 ecs_component_declared_count(void) {
+    return declaredComponentCount;
+}
+
+ENGINE_API void *ecs_add_component(ECSManager *ecs, Entity entity, ComponentType type, const void *componentData) {
+    if (!ecs_is_valid_type(ecs, type)) {
+        log_error("Component type %u is not registered.", type);
+        return NULL;
+    }
+
+    if (!ecs_is_valid_entity(ecs, entity)) {
+        log_error("Stale or invalid entity %u:%u provided to ecs_add_component.", ecs_entity_index(entity), ecs_entity_generation(entity));
+        return NULL;
+    }
+
+    void *component;
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        component = ecs_archetype_add(ecs, entity, type);
+        if (component) {
+            ecs->componentArrays[type].count++;
+        }
+    } else {
+        component = ecs_sparse_add(ecs, entity, type);
+    }
+
+    if (component) {
+        if (componentData) {
+            memory_copy(component, componentData, ecs->componentArrays[type].size);
+        } else {
+            memory_zero(component, ecs->componentArrays[type].size);
+        }
+    }
+    return component;
+}
+
+ENGINE_API void ecs_remove_component(ECSManager *ecs, Entity entity, ComponentType type) {
+    if (!ecs_is_valid_type(ecs, type)) {
+        log_error("Component type %u is not registered.", type);
+        return;
+    }
+
+    if (!ecs_is_valid_entity(ecs, entity)) {
+        log_error("Stale or invalid entity %u:%u provided to ecs_remove_component.", ecs_entity_index(entity), ecs_entity_generation(entity));
+        return;
+    }
+
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        ecs_archetype_remove(ecs, entity, type);
+    } else {
+        ecs_sparse_remove(ecs, entity, type);
+    }
+}
+
+ENGINE_API void *ecs_get_component(ECSManager *ecs, Entity entity, ComponentType type) {
+    if (!ecs_is_valid_type(ecs, type)) {
+        log_error("Component type %u is not registered.", type);
+        return NULL;
+    }
+
+    // Stale handles simply have no components.
+    if (!ecs_is_valid_entity(ecs, entity)) {
+        return NULL;
+    }
+
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        return ecs_archetype_component(ecs, entity, type);
+    }
+
+    ComponentArray *componentArray = &ecs->componentArrays[type];
+    if (componentArray->size == 0) {
+        return ecs_signature_has(&ecs->signatures[ecs_entity_index(entity)], type) ? componentArray->data : NULL;
+    }
+
+    u32 index = ecs_sparse_get(componentArray, ecs_entity_index(entity));
+    if (index == INVALID_ID_U32) {
+        return NULL;
+    }
+
+    ecs_sparse_touch(ecs, componentArray, index);
+    return componentArray->data + (u64)index * componentArray->size;
+}
+
+ENGINE_API b8 ecs_has_component(const ECSManager *ecs, Entity entity, ComponentType type) {
+    if (!ecs_is_valid_type(ecs, type) || !ecs_is_valid_entity(ecs, entity)) {
+        return false;
+    }
+
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        u32 archetype = ecs->records[ecs_entity_index(entity)].archetype;
+        return archetype != INVALID_ID_U32 && ecs_signature_has(&ecs->archetypes[archetype].signature, type);
+    }
+
+    return ecs_signature_has(&ecs->signatures[ecs_entity_index(entity)], type);
+}
+
+ENGINE_API const EcsSignature *ecs_entity_signature(const ECSManager *ecs, Entity entity) {
+    static const EcsSignature empty = {0};
+    if (!ecs || !ecs_is_valid_entity(ecs, entity)) {
+        return NULL;
+    }
+
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        u32 archetype = ecs->records[ecs_entity_index(entity)].archetype;
+        return archetype != INVALID_ID_U32 ? &ecs->archetypes[archetype].signature : &empty;
+    }
+    return &ecs->signatures[ecs_entity_index(entity)];
+}
+
+ENGINE_API u32 ecs_component_count(const ECSManager *ecs, ComponentType type) {
+    return ecs_is_valid_type(ecs, type) ? ecs->componentArrays[type].count : 0;
+}
+
+ENGINE_API void *ecs_component_data(ECSManager *ecs, ComponentType type) {
+    if (!ecs_is_valid_type(ecs, type)) {
+        return NULL;
+    }
+
+    if (ecs->storage == ECS_STORAGE_SPARSE_SET && ecs->componentArrays[type].size > 0) {
+        ecs_sparse_touch_all(ecs, &ecs->componentArrays[type]);
+    }
+    return ecs->componentArrays[type].data;
+}
+
+ENGINE_API const Entity *ecs_component_entities(const ECSManager *ecs, ComponentType type) {
+    return ecs_is_valid_type(ecs, type) ? ecs->componentArrays[type].entities : NULL;
+}
+
+ENGINE_API void ecs_each(ECSManager *ecs, const ComponentType *types, u32 typeCount, EcsViewFunc fn, void *userData) {
+    if (!ecs || !types || typeCount == 0 || typeCount > ECS_MAX_VIEW_COMPONENTS || !fn) {
+        log_error("Invalid ECSManager, component types or function provided to ecs_each.");
+        return;
+    }
+
+    EcsSignature required = {0};
+    for (u32 i = 0; i < typeCount; ++i) {
+        if (!ecs_is_valid_type(ecs, types[i])) {
+            log_error("Component type %u is not registered.", types[i]);
+            return;
+        }
+        ecs_signature_set(&required, types[i]);
+    }
+
+    EcsView view = {0};
+    if (ecs->storage == ECS_STORAGE_SPARSE_SET) {
+        u32 group = typeCount > 1 ? ecs_group_find(ecs, types, typeCount) : INVALID_ID_U32;
+        if (typeCount > 1 && group == INVALID_ID_U32) {
+            log_error("ecs_each can only iterate one component type, or the types of a group, in sparse-set storage.");
+            return;
+        }
+        if (ecs->componentArrays[types[0]].size == 0) {
+            log_error("Tag type %u has no packed entities to iterate in sparse-set storage; use a query.", types[0]);
+            return;
+        }
+
+        // A group's members are the first rows of each owned array.
+        view.count = group == INVALID_ID_U32 ? ecs->componentArrays[types[0]].count : ecs->groups[group].count;
+        view.entities = ecs->componentArrays[types[0]].entities;
+        for (u32 term = 0; term < typeCount; ++term) {
+            ComponentArray *componentArray = &ecs->componentArrays[types[term]];
+            view.columns[term] = componentArray->data;
+            ecs_sparse_touch_range(ecs, componentArray, 0, view.count);
+        }
+        if (view.count > 0) {
+            fn(&view, userData);
+        }
+        return;
+    }
+
+    for (u32 i = 0; i < ecs->archetypeCount; ++i) {
+        const EcsArchetype *archetype = &ecs->archetypes[i];
+        if (archetype->entityCount == 0 || !ecs_signature_contains(&archetype->signature, &required)) {
+            continue;
+        }
+
+        // Resolve columns once per archetype, not per entity.
+        u32 columns[ECS_MAX_VIEW_COMPONENTS];
+        for (u32 term = 0; term < typeCount; ++term) {
+            columns[term] = ecs_archetype_column(archetype, types[term]);
+        }
+
+        u32 version = ecs_change_version(ecs);
+        for (u32 chunkIndex = 0; chunkIndex < archetype->chunkCount; ++chunkIndex) {
+            const EcsChunk *chunk = &archetype->chunks[chunkIndex];
+            u32 *versions = ecs_chunk_versions(archetype, chunk);
+            view.count = chunk->count;
+            view.entities = (const Entity *)chunk->memory;
+            for (u32 term = 0; term < typeCount; ++term) {
+                view.columns[term] = chunk->memory + archetype->offsets[columns[term]];
+                versions[columns[term]] = version;
+            }
+            fn(&view, userData);
+        }
+    }
+}
+
+ENGINE_API u32 ecs_group_create(ECSManager *ecs, const ComponentType *types, u32 typeCount) {
+    if (!ecs || !types || typeCount == 0 || typeCount > ECS_MAX_VIEW_COMPONENTS) {
+        log_error("Invalid ECSManager or component types provided to ecs_group_create.");
+        return INVALID_ID_U32;
+    }
+
+    if (ecs->storage != ECS_STORAGE_SPARSE_SET) {
+        log_error("Groups are only supported in sparse-set storage; archetype chunks already keep components aligned.");
+        return INVALID_ID_U32;
+    }
+
+    EcsSignature signature = {0};
+    for (u32 i = 0; i < typeCount; ++i) {
+        if (!ecs_is_valid_type(ecs, types[i]) || ecs_signature_has(&signature, types[i])) {
+            log_error("Component type %u is not registered or is listed twice.", types[i]);
+            return INVALID_ID_U32;
+        }
+        if (ecs->componentArrays[types[i]].group != INVALID_ID_U32) {
+            log_error("Component type %u is already owned by group %u.", types[i], ecs->componentArrays[types[i]].group);
+            return INVALID_ID_U32;
+        }
+        if (ecs->componentArrays[types[i]].size == 0) {
+            log_error("Tag type %u has no packed array for a group to own.", types[i]);
+            return INVALID_ID_U32;
+        }
+        if (ecs->componentArrays[types[i]].sortKey) {
+            log_error("Component type %u is kept sorted and cannot be owned by a group.", types[i]);
+            return INVALID_ID_U32;
+        }
+        ecs_signature_set(&signature, types[i]);
+    }
+
+    if (ecs->groupCount == ecs->groupCapacity) {
+        EcsGroup *groups = (EcsGroup *)ecs_grow_array(ecs, ecs->groups, sizeof(EcsGroup), ecs->groupCount, &ecs->groupCapacity);
+        if (!groups) {
+            log_error("Failed to grow the group list.");
+            return INVALID_ID_U32;
+        }
+        ecs->groups = groups;
+    }
+
+    u32 index = ecs->groupCount++;
+    EcsGroup *group = &ecs->groups[index];
+    memory_zero(group, sizeof(EcsGroup));
+    memory_copy(group->types, types, sizeof(ComponentType) * typeCount);
+    group->typeCount = typeCount;
+
+    // Walk the smallest owned set and pull every entity that has all the
+    // types to the front. Rows swapped back into the walk were already seen.
+    ComponentArray *driver = &ecs->componentArrays[types[0]];
+    for (u32 i = 1; i < typeCount; ++i) {
+        if (ecs->componentArrays[types[i]].count < driver->count) {
+            driver = &ecs->componentArrays[types[i]];
+        }
+    }
+    for (u32 i = 0; i < driver->count; ++i) {
+        ecs_group_attach(ecs, group, driver->entities[i]);
+    }
+
+    for (u32 i = 0; i < typeCount; ++i) {
+        ecs->componentArrays[types[i]].group = index;
+    }
+    ecs_group_invalidate(ecs, group);
+    for (u32 i = 0; i < ecs->queryCount; ++i) {
+        ecs_query_use_group(ecs->queries[i]);
+    }
+
+    log_debug("Created group %u owning %u component types with %u entities.", index, typeCount, group->count);
+    return index;
+}
+
+ENGINE_API u32 ecs_group_count(const ECSManager *ecs, u32 group) {
+    return ecs && group < ecs->groupCount ? ecs->groups[group].count : 0;
+}
+
+ENGINE_API EngineResult ecs_sort_by(ECSManager *ecs, ComponentType type, EcsSortKeyFunc key) {
+    if (!ecs || !ecs_is_valid_type(ecs, type)) {
+        log_error("Invalid ECSManager or component type provided to ecs_sort_by.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    ComponentArray *componentArray = &ecs->componentArrays[type];
+    if (ecs->storage != ECS_STORAGE_SPARSE_SET || componentArray->size == 0 || componentArray->group != INVALID_ID_U32) {
+        log_error("Component type %u cannot be sorted: only untagged, ungrouped sparse-set types can.", type);
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Queries pick their driving set by whether it is sorted.
+    ecs_queries_invalidate(ecs, type);
+    componentArray->sortKey = key;
+    componentArray->sortedCount = 0;
+    if (!key) {
+        if (componentArray->sortKeys) {
+            memory_free(ecs->pool, componentArray->sortKeys, MEMORY_TAG_ECS);
+        }
+        componentArray->sortKeys = NULL;
+        componentArray->sortKeyCapacity = 0;
+        return ENGINE_SUCCESS;
+    }
+    return ecs_sort(ecs, type);
+}
+
+ENGINE_API EngineResult ecs_sort(ECSManager *ecs, ComponentType type) {
+    if (!ecs || !ecs_is_valid_type(ecs, type) || !ecs->componentArrays[type].sortKey) {
+        log_error("Invalid ECSManager or unsorted component type provided to ecs_sort.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    ComponentArray *componentArray = &ecs->componentArrays[type];
+    u32 count = componentArray->count;
+    u32 keyed = componentArray->sortedCount < count ? componentArray->sortedCount : count;
+    if (componentArray->sortKeyCapacity < componentArray->capacity) {
+        u64 *keys = (u64 *)memory_allocate(ecs->pool, sizeof(u64) * componentArray->capacity, MEMORY_TAG_ECS);
+        if (!keys) {
+            log_error("Failed to grow the sort keys of component type %u to %u.", type, componentArray->capacity);
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+        if (componentArray->sortKeys) {
+            memory_copy(keys, componentArray->sortKeys, sizeof(u64) * keyed);
+            memory_free(ecs->pool, componentArray->sortKeys, MEMORY_TAG_ECS);
+        }
+        componentArray->sortKeys = keys;
+        componentArray->sortKeyCapacity = componentArray->capacity;
+    }
+
+    // Advance the version so writes from now on are seen by the next sort.
+    u32 since = componentArray->sortedVersion;
+    u32 version = (u32)platform_atomic_fetch_add_i32(&ecs->changeVersion, 1);
+
+    // Re-key the blocks changed since the last sort and the rows added after
+    // it. Every other row kept its key and its place, so they are in order.
+    u32 first = count;
+    for (u32 begin = 0; begin < count; begin += ECS_CHANGE_BLOCK_SIZE) {
+        u32 end = begin + ECS_CHANGE_BLOCK_SIZE < count ? begin + ECS_CHANGE_BLOCK_SIZE : count;
+        if (end <= keyed && (i32)(componentArray->versions[begin / ECS_CHANGE_BLOCK_SIZE] - since) <= 0) {
+            continue;
+        }
+        for (u32 row = begin; row < end; ++row) {
+            componentArray->sortKeys[row] = componentArray->sortKey(componentArray->data + (u64)row * componentArray->size);
+        }
+        first = first < begin ? first : begin;
+    }
+
+    // Where a row is smaller than the one before it, either it fell or its
+    // predecessor rose. Searching the rest of the array for where each would
+    // go estimates the rows insertion has to shift, without shifting them.
+    const u64 *keys = componentArray->sortKeys;
+    u32 descents = 0;
+    u64 shifts = 0;
+    for (u32 row = first > 0 ? first : 1; row < count && descents <= count / ECS_SORT_RADIX_FRACTION && shifts <= count; ++row) {
+        if (keys[row - 1] > keys[row]) {
+            descents++;
+            shifts += row - ecs_sort_bound(keys, 0, row, keys[row], true);
+            shifts += ecs_sort_bound(keys, row, count, keys[row - 1], false) - row;
+        }
+    }
+
+    // The first sort knows nothing of the order, so it radix sorts outright.
+    b8 moved = false;
+    b8 sorted = keyed > 0 && descents <= count / ECS_SORT_RADIX_FRACTION && shifts <= count && ecs_sort_insertion(ecs, componentArray, first, version, &moved);
+    if (!sorted) {
+        if (!ecs_sort_radix(ecs, componentArray, version)) {
+            // The keys still match their rows, so the next sort can retry.
+            ecs_queries_invalidate(ecs, type);
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+        moved = true;
+    }
+    if (moved) {
+        ecs_queries_invalidate(ecs, type);
+    }
+    componentArray->sortedCount = count;
+    componentArray->sortedVersion = version;
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API EngineResult ecs_query_init(EcsQuery *query, ECSManager *ecs, const EcsQueryDesc *desc) {
+    if (!query || !ecs || !desc || desc->requiredCount == 0) {
+        log_error("Invalid EcsQuery, ECSManager or EcsQueryDesc provided to ecs_query_init.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (desc->requiredCount + desc->optionalCount > ECS_MAX_VIEW_COMPONENTS || desc->excludedCount > ECS_MAX_QUERY_EXCLUDED) {
+        log_error("Too many query terms (%u required, %u optional, %u excluded).", desc->requiredCount, desc->optionalCount, desc->excludedCount);
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    memory_zero(query, sizeof(EcsQuery));
+    query->ecs = ecs;
+    query->group = INVALID_ID_U32;
+    query->requiredCount = desc->requiredCount;
+    query->termCount = desc->requiredCount + desc->optionalCount;
+    query->excludedCount = desc->excludedCount;
+    for (u32 term = 0; term < query->termCount; ++term) {
+        ComponentType type = term < desc->requiredCount ? desc->required[term] : desc->optional[term - desc->requiredCount];
+        if (!ecs_is_valid_type(ecs, type)) {
+            log_error("Component type %u is not registered.", type);
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+        query->terms[term] = type;
+        ecs_signature_set(&query->watched, type);
+        if (term < desc->requiredCount) {
+            ecs_signature_set(&query->required, type);
+        }
+    }
+    for (u32 term = 0; term < desc->excludedCount; ++term) {
+        if (!ecs_is_valid_type(ecs, desc->excluded[term])) {
+            log_error("Component type %u is not registered.", desc->excluded[term]);
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+        query->excluded[term] = desc->excluded[term];
+        ecs_signature_set(&query->excludedSignature, desc->excluded[term]);
+        ecs_signature_set(&query->watched, desc->excluded[term]);
+    }
+
+    // Written and filtered types become bits over the terms they name.
+    for (u32 i = 0; i < desc->writeCount + desc->changedCount; ++i) {
+        ComponentType type = i < desc->writeCount ? desc->writes[i] : desc->changed[i - desc->writeCount];
+        u32 term = 0;
+        while (term < query->termCount && query->terms[term] != type) {
+            term++;
+        }
+        if (term == query->termCount) {
+            log_error("Component type %u is written or filtered on but is not a term of the query.", type);
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+        if (ecs->componentArrays[type].size == 0) {
+            log_error("Tag type %u has no data to write or filter changes on.", type);
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+        if (i < desc->writeCount) {
+            query->writeMask |= 1u << term;
+        } else {
+            query->changedMask |= 1u << term;
+        }
+    }
+
+    if (ecs->queryCount == ecs->queryCapacity) {
+        EcsQuery **queries = (EcsQuery **)ecs_grow_array(ecs, ecs->queries, sizeof(EcsQuery *), ecs->queryCount, &ecs->queryCapacity);
+        if (!queries) {
+            log_error("Failed to grow the query list.");
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+        ecs->queries = queries;
+    }
+    ecs->queries[ecs->queryCount++] = query;
+    ecs_query_use_group(query);
+
+    if (ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        for (u32 i = 0; i < ecs->archetypeCount; ++i) {
+            if (!ecs_query_add_archetype(query, i)) {
+                ecs_query_destroy(query);
+                return ENGINE_ERROR_ALLOCATION_FAILED;
+            }
+        }
+    } else {
+        query->stale = true;
+    }
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void ecs_query_destroy(EcsQuery *query) {
+    if (!query || !query->ecs) {
+        log_error("Invalid EcsQuery provided to ecs_query_destroy.");
+        return;
+    }
+
+    ECSManager *ecs = query->ecs;
+    for (u32 i = 0; i < ecs->queryCount; ++i) {
+        if (ecs->queries[i] == query) {
+            ecs->queries[i] = ecs->queries[--ecs->queryCount];
+            break;
+        }
+    }
+    ecs_query_free(query);
+}
+
+ENGINE_API u32 ecs_query_count(EcsQuery *query) {
+    ECSManager *ecs = query->ecs;
+    if (query->group != INVALID_ID_U32) {
+        return ecs->groups[query->group].count;
+    }
+    if (ecs->storage == ECS_STORAGE_SPARSE_SET) {
+        if (query->stale) {
+            ecs_query_rebuild(query);
+        }
+        return query->count;
+    }
+
+    u32 count = 0;
+    for (u32 i = 0; i < query->archetypeCount; ++i) {
+        count += ecs->archetypes[query->archetypes[i]].entityCount;
+    }
+    return count;
+}
+
+ENGINE_API b8 ecs_query_matches(const EcsQuery *query, Entity entity) {
+    const EcsSignature *signature = query ? ecs_entity_signature(query->ecs, entity) : NULL;
+    return signature && ecs_signature_matches(signature, &query->required, &query->excludedSignature);
+}
+
+ENGINE_API void ecs_query_each(EcsQuery *query, EcsViewFunc fn, void *userData) {
+    ECSManager *ecs = query->ecs;
+    EcsView view = {0};
+
+    if (query->group != INVALID_ID_U32) {
+        ecs_query_begin_pass(query);
+        u32 count = ecs->groups[query->group].count;
+        u32 end = count;
+        u32 begin = query->filtering ? ecs_query_group_next_changed(query, 0, count, &end) : 0;
+        while (begin < end) {
+            ecs_query_group_view(query, begin, end - begin, &view);
+            fn(&view, userData);
+            ecs_query_group_touch(query, begin, view.count);
+            if (!query->filtering) {
+                break;
+            }
+            begin = ecs_query_group_next_changed(query, end, count, &end);
+        }
+        return;
+    }
+
+    if (ecs->storage == ECS_STORAGE_SPARSE_SET) {
+        if (query->stale) {
+            ecs_query_rebuild(query);
+        }
+        ecs_query_begin_pass(query);
+        if (query->count == 0) {
+            return;
+        }
+
+        for (u32 term = 0; term < query->termCount; ++term) {
+            view.columns[term] = ecs->componentArrays[query->terms[term]].data;
+        }
+
+        // Unfiltered, every match is one view; filtered, each run of changed
+        // matches is.
+        u32 end = query->count;
+        u32 begin = query->filtering ? ecs_query_next_changed(query, 0, query->count, &end) : 0;
+        while (begin < end) {
+            view.count = end - begin;
+            view.entities = query->entities + begin;
+            for (u32 term = 0; term < query->termCount; ++term) {
+                view.rows[term] = query->rows + (u64)term * query->capacity + begin;
+            }
+            fn(&view, userData);
+            ecs_query_matches_touch(query, begin, view.count);
+            if (!query->filtering) {
+                break;
+            }
+            begin = ecs_query_next_changed(query, end, query->count, &end);
+        }
+        return;
+    }
+
+    ecs_query_begin_pass(query);
+    for (u32 i = 0; i < query->archetypeCount; ++i) {
+        const EcsArchetype *archetype = &ecs->archetypes[query->archetypes[i]];
+        const u32 *offsets = query->offsets + (u64)i * query->termCount;
+        const u32 *columns = query->columns + (u64)i * query->termCount;
+        for (u32 chunkIndex = 0; chunkIndex < archetype->chunkCount; ++chunkIndex) {
+            const EcsChunk *chunk = &archetype->chunks[chunkIndex];
+            if (query->filtering && !ecs_query_chunk_changed(query, archetype, columns, chunk)) {
+                continue;
+            }
+
+            view.count = chunk->count;
+            view.entities = (const Entity *)chunk->memory;
+            for (u32 term = 0; term < query->termCount; ++term) {
+                view.columns[term] = offsets[term] == INVALID_ID_U32 ? NULL : chunk->memory + offsets[term];
+            }
+            fn(&view, userData);
+            ecs_query_chunk_touch(query, archetype, columns, chunk);
+        }
+    }
+}
+
+ENGINE_API u32 ecs_query_prepare_views(EcsQuery *query, u32 grainSize) {
+    ECSManager *ecs = query->ecs;
+    if (ecs->storage == ECS_STORAGE_SPARSE_SET) {
+        if (query->group != INVALID_ID_U32) {
+            query->count = ecs->groups[query->group].count;
+        } else if (query->stale) {
+            ecs_query_rebuild(query);
+        }
+        ecs_query_begin_pass(query);
+        query->viewGrain = grainSize ? grainSize : MAX_U32;
+        query->viewCount = query->count / query->viewGrain + (query->count % query->viewGrain != 0);
+        return query->viewCount;
+    }
+
+    ecs_query_begin_pass(query);
+    query->viewCount = 0;
+    for (u32 i = 0; i < query->archetypeCount; ++i) {
+        query->viewStarts[i] = query->viewCount;
+        query->viewCount += ecs->archetypes[query->archetypes[i]].chunkCount;
+    }
+    return query->viewCount;
+}
+
+ENGINE_API void ecs_query_get_view(const EcsQuery *query, u32 index, EcsView *view) {
+    const ECSManager *ecs = query->ecs;
+    memory_zero(view, sizeof(EcsView));
+    if (ecs->storage == ECS_STORAGE_SPARSE_SET) {
+        u32 begin = index * query->viewGrain;
+        u32 count = query->count - begin < query->viewGrain ? query->count - begin : query->viewGrain;
+        u32 end;
+        if (query->group != INVALID_ID_U32) {
+            if (query->filtering && ecs_query_group_next_changed(query, begin, begin + count, &end) == begin + count) {
+                return;
+            }
+            ecs_query_group_view(query, begin, count, view);
+            ecs_query_group_touch(query, begin, count);
+            return;
+        }
+        if (query->filtering && ecs_query_next_changed(query, begin, begin + count, &end) == begin + count) {
+            return;
+        }
+
+        view->count = count;
+        view->entities = query->entities + begin;
+        for (u32 term = 0; term < query->termCount; ++term) {
+            view->columns[term] = ecs->componentArrays[query->terms[term]].data;
+            view->rows[term] = query->rows + (u64)term * query->capacity + begin;
+        }
+        ecs_query_matches_touch(query, begin, count);
+        return;
+    }
+
+    // Find the last archetype whose first view is at or before index. Empty
+    // archetypes share their start with the next one, so they are skipped.
+    u32 low = 0;
+    u32 high = query->archetypeCount;
+    while (high - low > 1) {
+        u32 middle = low + (high - low) / 2;
+        if (query->viewStarts[middle] <= index) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    const EcsArchetype *archetype = &ecs->archetypes[query->archetypes[low]];
+    const u32 *offsets = query->offsets + (u64)low * query->termCount;
+    const u32 *columns = query->columns + (u64)low * query->termCount;
+    const EcsChunk *chunk = &archetype->chunks[index - query->viewStarts[low]];
+    if (query->filtering && !ecs_query_chunk_changed(query, archetype, columns, chunk)) {
+        return;
+    }
+
+    view->count = chunk->count;
+    view->entities = (const Entity *)chunk->memory;
+    for (u32 term = 0; term < query->termCount; ++term) {
+        view->columns[term] = offsets[term] == INVALID_ID_U32 ? NULL : chunk->memory + offsets[term];
+    }
+    ecs_query_chunk_touch(query, archetype, columns, chunk);
+}
+
+ENGINE_API u64 ecs_snapshot_size(const ECSManager *ecs) {
+    if (!ecs) {
+        return 0;
+    }
+    EcsSnapshotWriter writer = {NULL, 0, 0, false};
+    ecs_snapshot_emit(ecs, &writer);
+    return writer.offset;
+}
+
+ENGINE_API EngineResult ecs_snapshot(const ECSManager *ecs, void *buffer, u64 capacity) {
+    if (!ecs || !buffer) {
+        log_error("Invalid ECSManager or buffer provided to ecs_snapshot.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    EcsSnapshotWriter writer = {(u8 *)buffer, capacity, 0, false};
+    ecs_snapshot_emit(ecs, &writer);
+    if (writer.overflowed) {
+        log_error("ECS snapshot needs %llu bytes, but the buffer holds %llu.", (unsigned long long)writer.offset, (unsigned long long)capacity);
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API EngineResult ecs_restore(ECSManager *ecs, const void *snapshot, u64 size) {
+    if (!ecs || !snapshot) {
+        log_error("Invalid ECSManager or snapshot provided to ecs_restore.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    EcsSnapshotReader reader = {(const u8 *)snapshot, size, 0};
+    const EcsSnapshotHeader *header = (const EcsSnapshotHeader *)ecs_snapshot_read(&reader, sizeof(EcsSnapshotHeader));
+    if (!header || header->magic != ECS_SNAPSHOT_MAGIC || header->version != ECS_SNAPSHOT_VERSION || header->size > size) {
+        log_error("Not an ECS snapshot, or a truncated one.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+    if (header->storage != (u32)ecs->storage || header->componentCount > ecs->registeredComponents || header->chunkSize != ECS_CHUNK_SIZE || header->pageSize != ECS_SPARSE_PAGE_SIZE ||
+        header->freeCount > header->nextIndex || (ecs->storage == ECS_STORAGE_SPARSE_SET && header->groupCount != ecs->groupCount)) {
+        log_error("ECS snapshot was taken with a different storage, component types, groups or build.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+    reader.size = header->size;
+
+    const u32 *generations = (const u32 *)ecs_snapshot_read(&reader, sizeof(u32) * (u64)header->nextIndex);
+    const u32 *freeIndices = (const u32 *)ecs_snapshot_read(&reader, sizeof(u32) * (u64)header->freeCount);
+    const EcsSnapshotType *types = (const EcsSnapshotType *)ecs_snapshot_read(&reader, sizeof(EcsSnapshotType) * (u64)header->componentCount);
+    if (!generations || !freeIndices || !types) {
+        log_error("Truncated ECS snapshot.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+    for (ComponentType type = 0; type < header->componentCount; ++type) {
+        if (types[type].size != ecs->componentArrays[type].size || types[type].count > header->nextIndex) {
+            log_error("Component type %u of the ECS snapshot has size %u, expected %u.", type, types[type].size, ecs->componentArrays[type].size);
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    // Each free index may be listed once; a bit per index finds repeats.
+    if (header->freeCount > 0) {
+        u64 wordCount = ((u64)header->nextIndex + 63) / 64;
+        u64 *freed = (u64 *)memory_allocate(ecs->pool, sizeof(u64) * wordCount, MEMORY_TAG_ECS);
+        if (!freed) {
+            log_error("Failed to allocate the free index check of an ECS restore.");
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+        memory_zero(freed, sizeof(u64) * wordCount);
+        b8 corrupt = false;
+        for (u32 i = 0; i < header->freeCount && !corrupt; ++i) {
+            u32 index = freeIndices[i];
+            corrupt = index >= header->nextIndex || (freed[index / 64] & (1ull << (index % 64)));
+            if (corrupt) {
+                log_error("Corrupt free entity index %u in ECS snapshot.", index);
+            } else {
+                freed[index / 64] |= 1ull << (index % 64);
+            }
+        }
+        memory_free(ecs->pool, freed, MEMORY_TAG_ECS);
+        if (corrupt) {
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    // Check every block first, then walk the same blocks again to copy them.
+    // The archetype map is followed by a flag per existing archetype.
+    u32 *remap = NULL;
+    if (header->archetypeCount > 0) {
+        u64 remapCount = (u64)header->archetypeCount + ecs->archetypeCount;
+        remap = (u32 *)memory_allocate(ecs->pool, sizeof(u32) * remapCount, MEMORY_TAG_ECS);
+        if (!remap) {
+            log_error("Failed to allocate the archetype map of an ECS restore.");
+            return ENGINE_ERROR_ALLOCATION_FAILED;
+        }
+        memory_zero(remap, sizeof(u32) * remapCount);
+    }
+    u64 blocks = reader.offset;
+    EngineResult result = ENGINE_SUCCESS;
+    for (u32 pass = 0; pass < 2 && result == ENGINE_SUCCESS; ++pass) {
+        b8 apply = pass == 1;
+        reader.offset = blocks;
+        if (apply) {
+            EntityManager *entityManager = &ecs->entityManager;
+            u32 *restoredGenerations = (u32 *)ecs_restore_array(ecs, entityManager->generations, &entityManager->generationCapacity, sizeof(u32), generations, header->nextIndex);
+            u32 *restoredFree = (u32 *)ecs_restore_array(ecs, entityManager->freeIndices, &entityManager->freeCapacity, sizeof(u32), freeIndices, header->freeCount);
+            if ((!restoredGenerations && header->nextIndex > 0) || (!restoredFree && header->freeCount > 0)) {
+                result = ENGINE_ERROR_ALLOCATION_FAILED;
+                break;
+            }
+            entityManager->generations = restoredGenerations;
+            entityManager->freeIndices = restoredFree;
+            entityManager->nextIndex = header->nextIndex;
+            entityManager->freeCount = header->freeCount;
+        }
+        result = ecs->storage == ECS_STORAGE_SPARSE_SET ? ecs_restore_sparse(ecs, &reader, header, generations, freeIndices, types, apply) : ecs_restore_archetypes(ecs, &reader, header, generations, freeIndices, types, remap, apply);
+    }
+
+    if (result == ENGINE_SUCCESS && ecs->storage == ECS_STORAGE_ARCHETYPE) {
+        for (ComponentType type = 0; type < ecs->registeredComponents; ++type) {
+            ecs->componentArrays[type].count = type < header->componentCount ? types[type].count : 0;
+        }
+    }
+    if (remap) {
+        memory_free(ecs->pool, remap, MEMORY_TAG_ECS);
+    }
+    return result;
+}
+
+ENGINE_API u64 ecs_memory_usage(const ECSManager *ecs) {
+    const EntityManager *entityManager = &ecs->entityManager;
+    u64 bytes = sizeof(u32) * ((u64)entityManager->generationCapacity + entityManager->freeCapacity) + sizeof(EcsRecord) * (u64)ecs->recordCapacity;
+    bytes += sizeof(EcsSignature) * (u64)ecs->signatureCapacity;
+
+    for (ComponentType type = 0; type < ecs->registeredComponents; ++type) {
+        const ComponentArray *componentArray = &ecs->componentArrays[type];
+        bytes += ((u64)componentArray->size + sizeof(Entity)) * componentArray->capacity;
+        bytes += sizeof(u32) * (u64)((componentArray->capacity + ECS_CHANGE_BLOCK_SIZE - 1) / ECS_CHANGE_BLOCK_SIZE);
+        bytes += sizeof(u32 *) * (u64)componentArray->sparsePageCount + sizeof(u64) * (u64)componentArray->sortKeyCapacity;
+        for (u32 page = 0; page < componentArray->sparsePageCount; ++page) {
+            bytes += componentArray->sparsePages[page] ? sizeof(u32) * ECS_SPARSE_PAGE_SIZE : 0;
+        }
+    }
+
+    bytes += sizeof(EcsArchetype) * (u64)ecs->archetypeCapacity;
+    for (u32 i = 0; i < ecs->archetypeCount; ++i) {
+        const EcsArchetype *archetype = &ecs->archetypes[i];
+        bytes += sizeof(u32) * 2 * (u64)archetype->typeCount + sizeof(EcsChunk) * (u64)archetype->chunkCapacity;
+        bytes += (u64)ECS_CHUNK_SIZE * (archetype->chunkCount + (archetype->spareChunk != NULL));
+    }
+
+    bytes += sizeof(EcsGroup) * (u64)ecs->groupCapacity;
+    bytes += sizeof(EcsQuery *) * (u64)ecs->queryCapacity;
+    for (u32 i = 0; i < ecs->queryCount; ++i) {
+        const EcsQuery *query = ecs->queries[i];
+        bytes += sizeof(u32) * (u64)query->archetypeCapacity * (2 + 2 * (u64)query->termCount);
+        bytes += (sizeof(Entity) + sizeof(u32) * (u64)query->termCount) * query->capacity;
+    }
+
+    return bytes;
+}
+
+#pragma endregion
+// =============================================================================
@@ -0,0 +1,604 @@
+#include "engine/ecs/hierarchy.h"
+#include "engine/job_system.h"
+#include "engine/logging.h"
+#include "engine/memory.h"
+
+/**
+ * @brief A contiguous range of roots handed to one job.
+ */
+typedef struct EcsHierarchyBatch {
+    EcsHierarchy *hierarchy; /**< The hierarchy being updated. */
+    u32 begin;               /**< First root of the batch. */
+    u32 end;                 /**< One past the last root of the batch. */
+    u32 updated;             /**< World transforms the batch recomputed. */
+} EcsHierarchyBatch;
+
+// =============================================================================
+#pragma region Helpers
+
+/**
+ * @brief Looks up the hierarchy component of an entity handle.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param entity The entity handle.
+ * @return EcsHierarchyNode* The entity's node, or NULL if the handle is not in the hierarchy.
+ */
+static EcsHierarchyNode *ecs_hierarchy_find(const EcsHierarchy *hierarchy, Entity entity) {
+    u32 index = ecs_entity_index(entity);
+    if (entity == INVALID_ENTITY || index >= hierarchy->nodeCapacity || hierarchy->nodes[index].entity != entity) {
+        return NULL;
+    }
+    return &hierarchy->nodes[index];
+}
+
+/**
+ * @brief Allocates every slot array for a capacity as one block and points
+ * the hierarchy's slot arrays into it. The old block is not freed.
+ *
+ * @param hierarchy A pointer to the hierarchy whose slot arrays are set.
+ * @param capacity The number of slots.
+ * @return b8 True on success; on failure the hierarchy is unchanged.
+ */
+static b8 ecs_hierarchy_allocate_slots(EcsHierarchy *hierarchy, u32 capacity) {
+    u64 slotSize = sizeof(WorldTransform) + sizeof(Transform) + sizeof(u32) * 3 + sizeof(u8);
+    u8 *memory = (u8 *)memory_allocate(hierarchy->ecs->pool, slotSize * capacity, MEMORY_TAG_ECS);
+    if (!memory) {
+        return false;
+    }
+
+    // Widest elements first, so every array stays aligned.
+    hierarchy->memory = memory;
+    hierarchy->worlds = (WorldTransform *)memory;
+    hierarchy->locals = (Transform *)(hierarchy->worlds + capacity);
+    hierarchy->entities = (u32 *)(hierarchy->locals + capacity);
+    hierarchy->parents = hierarchy->entities + capacity;
+    hierarchy->ends = hierarchy->parents + capacity;
+    hierarchy->flags = (u8 *)(hierarchy->ends + capacity);
+    hierarchy->slotCapacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Makes room for one more slot, doubling the slot arrays when full.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @return b8 True if a slot is free.
+ */
+static b8 ecs_hierarchy_reserve_slot(EcsHierarchy *hierarchy) {
+    if (hierarchy->slotCount < hierarchy->slotCapacity) {
+        return true;
+    }
+
+    EcsHierarchy grown = *hierarchy;
+    u32 capacity = hierarchy->slotCapacity ? hierarchy->slotCapacity * 2 : 64;
+    if (!ecs_hierarchy_allocate_slots(&grown, capacity)) {
+        log_error("Failed to grow the hierarchy to %u slots.", capacity);
+        return false;
+    }
+
+    if (hierarchy->memory) {
+        u32 count = hierarchy->slotCount;
+        memory_copy(grown.worlds, hierarchy->worlds, sizeof(WorldTransform) * count);
+        memory_copy(grown.locals, hierarchy->locals, sizeof(Transform) * count);
+        memory_copy(grown.entities, hierarchy->entities, sizeof(u32) * count);
+        memory_copy(grown.parents, hierarchy->parents, sizeof(u32) * count);
+        memory_copy(grown.ends, hierarchy->ends, sizeof(u32) * count);
+        memory_copy(grown.flags, hierarchy->flags, sizeof(u8) * count);
+        memory_free(hierarchy->ecs->pool, hierarchy->memory, MEMORY_TAG_ECS);
+    }
+    *hierarchy = grown;
+    return true;
+}
+
+/**
+ * @brief Grows the node array, by doubling, until it covers an entity index.
+ * New nodes are not in the hierarchy.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param index The entity index.
+ * @return b8 True on success. On failure the old array is kept.
+ */
+static b8 ecs_hierarchy_reserve_node(EcsHierarchy *hierarchy, u32 index) {
+    if (index < hierarchy->nodeCapacity) {
+        return true;
+    }
+
+    u32 capacity = hierarchy->nodeCapacity ? hierarchy->nodeCapacity : 64;
+    while (capacity <= index) {
+        capacity = capacity > MAX_U32 / 2 ? MAX_U32 : capacity * 2;
+    }
+
+    EcsHierarchyNode *nodes = (EcsHierarchyNode *)memory_allocate(hierarchy->ecs->pool, sizeof(EcsHierarchyNode) * capacity, MEMORY_TAG_ECS);
+    if (!nodes) {
+        log_error("Failed to grow the hierarchy's nodes to %u entities.", capacity);
+        return false;
+    }
+
+    // 0xFF bytes make every handle INVALID_ENTITY and every link INVALID_ID_U32.
+    memory_set(nodes + hierarchy->nodeCapacity, 0xFF, sizeof(EcsHierarchyNode) * (capacity - hierarchy->nodeCapacity));
+    if (hierarchy->nodes) {
+        memory_copy(nodes, hierarchy->nodes, sizeof(EcsHierarchyNode) * hierarchy->nodeCapacity);
+        memory_free(hierarchy->ecs->pool, hierarchy->nodes, MEMORY_TAG_ECS);
+    }
+    hierarchy->nodes = nodes;
+    hierarchy->nodeCapacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Appends a node to the children of a parent, or to the roots.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param index The node's entity index.
+ * @param parent The parent's entity index, or INVALID_ID_U32 for a root.
+ * @return void
+ */
+static void ecs_hierarchy_link(EcsHierarchy *hierarchy, u32 index, u32 parent) {
+    EcsHierarchyNode *node = &hierarchy->nodes[index];
+    u32 *first = parent == INVALID_ID_U32 ? &hierarchy->firstRoot : &hierarchy->nodes[parent].firstChild;
+    u32 *last = parent == INVALID_ID_U32 ? &hierarchy->lastRoot : &hierarchy->nodes[parent].lastChild;
+    node->parent = parent;
+    node->previousSibling = *last;
+    node->nextSibling = INVALID_ID_U32;
+    if (*last != INVALID_ID_U32) {
+        hierarchy->nodes[*last].nextSibling = index;
+    } else {
+        *first = index;
+    }
+    *last = index;
+}
+
+/**
+ * @brief Takes a node out of its parent's children, or out of the roots.
+ * The node keeps its own children.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param index The node's entity index.
+ * @return void
+ */
+static void ecs_hierarchy_unlink(EcsHierarchy *hierarchy, u32 index) {
+    EcsHierarchyNode *node = &hierarchy->nodes[index];
+    u32 *first = node->parent == INVALID_ID_U32 ? &hierarchy->firstRoot : &hierarchy->nodes[node->parent].firstChild;
+    u32 *last = node->parent == INVALID_ID_U32 ? &hierarchy->lastRoot : &hierarchy->nodes[node->parent].lastChild;
+    if (node->previousSibling != INVALID_ID_U32) {
+        hierarchy->nodes[node->previousSibling].nextSibling = node->nextSibling;
+    } else {
+        *first = node->nextSibling;
+    }
+    if (node->nextSibling != INVALID_ID_U32) {
+        hierarchy->nodes[node->nextSibling].previousSibling = node->previousSibling;
+    } else {
+        *last = node->previousSibling;
+    }
+}
+
+/**
+ * @brief Removes a node and its subtree, walking the subtree through its
+ * links. Their slots are left behind until the next update.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param index The node's entity index.
+ * @return void
+ */
+static void ecs_hierarchy_remove_index(EcsHierarchy *hierarchy, u32 index) {
+    EcsHierarchyNode *nodes = hierarchy->nodes;
+    ecs_hierarchy_unlink(hierarchy, index);
+
+    u32 current = index;
+    while (current != INVALID_ID_U32) {
+        hierarchy->entities[nodes[current].slot] = INVALID_ID_U32;
+        nodes[current].entity = INVALID_ENTITY;
+        hierarchy->nodeCount--;
+        if (nodes[current].firstChild != INVALID_ID_U32) {
+            current = nodes[current].firstChild;
+            continue;
+        }
+
+        // Climb to the nearest node with a sibling left, stopping at the top.
+        while (current != index && nodes[current].nextSibling == INVALID_ID_U32) {
+            current = nodes[current].parent;
+        }
+        current = current == index ? INVALID_ID_U32 : nodes[current].nextSibling;
+    }
+    hierarchy->structureDirty = true;
+}
+
+/**
+ * @brief Marks a slot's local transform as changed, and its ancestors as
+ * having a dirty descendant. While the order is stale, the next update works
+ * out the ancestors instead.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param slot The slot.
+ * @return void
+ */
+static void ecs_hierarchy_mark(EcsHierarchy *hierarchy, u32 slot) {
+    hierarchy->flags[slot] |= ECS_HIERARCHY_DIRTY;
+    if (hierarchy->structureDirty) {
+        return;
+    }
+
+    // Stop at the first ancestor already marked; everything above it is too.
+    for (u32 parent = hierarchy->parents[slot]; parent != INVALID_ID_U32 && !(hierarchy->flags[parent] & ECS_HIERARCHY_DESCENDANT_DIRTY); parent = hierarchy->parents[parent]) {
+        hierarchy->flags[parent] |= ECS_HIERARCHY_DESCENDANT_DIRTY;
+    }
+}
+
+/**
+ * @brief Puts the slots back in depth-first order by walking the links from
+ * the first root, dropping removed slots, and rebuilds the root list, subtree
+ * ends and dirty-descendant flags.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @return b8 True on success. On failure the old slots are kept.
+ */
+static b8 ecs_hierarchy_sort(EcsHierarchy *hierarchy) {
+    if (hierarchy->nodeCount > hierarchy->rootCapacity) {
+        u32 *roots = (u32 *)memory_allocate(hierarchy->ecs->pool, sizeof(u32) * hierarchy->nodeCount, MEMORY_TAG_ECS);
+        if (!roots) {
+            log_error("Failed to grow the hierarchy's roots to %u entries.", hierarchy->nodeCount);
+            return false;
+        }
+        if (hierarchy->roots) {
+            memory_free(hierarchy->ecs->pool, hierarchy->roots, MEMORY_TAG_ECS);
+        }
+        hierarchy->roots = roots;
+        hierarchy->rootCapacity = hierarchy->nodeCount;
+    }
+
+    if (hierarchy->nodeCount == 0) {
+        if (hierarchy->memory) {
+            memory_free(hierarchy->ecs->pool, hierarchy->memory, MEMORY_TAG_ECS);
+        }
+        hierarchy->memory = NULL;
+        hierarchy->worlds = NULL;
+        hierarchy->locals = NULL;
+        hierarchy->entities = NULL;
+        hierarchy->parents = NULL;
+        hierarchy->ends = NULL;
+        hierarchy->flags = NULL;
+        hierarchy->slotCount = 0;
+        hierarchy->slotCapacity = 0;
+        hierarchy->rootCount = 0;
+        hierarchy->structureDirty = false;
+        return true;
+    }
+
+    EcsHierarchy sorted = *hierarchy;
+    if (!ecs_hierarchy_allocate_slots(&sorted, hierarchy->slotCapacity)) {
+        log_error("Failed to allocate %u sorted hierarchy slots.", hierarchy->slotCapacity);
+        return false;
+    }
+
+    // A node's parent is visited before it, so the parent's new slot is known.
+    EcsHierarchyNode *nodes = hierarchy->nodes;
+    u32 next = 0;
+    u32 rootCount = 0;
+    u32 index = hierarchy->firstRoot;
+    while (index != INVALID_ID_U32) {
+        EcsHierarchyNode *node = &nodes[index];
+        u32 slot = next++;
+        sorted.worlds[slot] = hierarchy->worlds[node->slot];
+        sorted.locals[slot] = hierarchy->locals[node->slot];
+        sorted.flags[slot] = hierarchy->flags[node->slot] & ECS_HIERARCHY_DIRTY;
+        sorted.entities[slot] = index;
+        sorted.parents[slot] = node->parent == INVALID_ID_U32 ? INVALID_ID_U32 : nodes[node->parent].slot;
+        node->slot = slot;
+        if (node->parent == INVALID_ID_U32) {
+            hierarchy->roots[rootCount++] = slot;
+        }
+        if (node->firstChild != INVALID_ID_U32) {
+            index = node->firstChild;
+            continue;
+        }
+
+        // Close every subtree that ends here, up to the nearest next sibling.
+        while (index != INVALID_ID_U32) {
+            sorted.ends[nodes[index].slot] = next;
+            if (nodes[index].nextSibling != INVALID_ID_U32) {
+                index = nodes[index].nextSibling;
+                break;
+            }
+            index = nodes[index].parent;
+        }
+    }
+
+    // Children come after their parents, so one backwards pass carries
+    // dirtiness up to every ancestor.
+    for (u32 slot = next; slot-- > 0;) {
+        if (sorted.flags[slot] != 0 && sorted.parents[slot] != INVALID_ID_U32) {
+            sorted.flags[sorted.parents[slot]] |= ECS_HIERARCHY_DESCENDANT_DIRTY;
+        }
+    }
+
+    memory_free(hierarchy->ecs->pool, hierarchy->memory, MEMORY_TAG_ECS);
+    *hierarchy = sorted;
+    hierarchy->slotCount = next;
+    hierarchy->rootCount = rootCount;
+    hierarchy->structureDirty = false;
+    return true;
+}
+
+/**
+ * @brief Composes a parent's world transform with a local transform.
+ *
+ * @param world A pointer to the world transform to write.
+ * @param parent A pointer to the parent's world transform, or NULL for a root.
+ * @param local A pointer to the local transform.
+ * @return void
+ */
+static ENGINE_INLINE void ecs_hierarchy_compose(WorldTransform *world, const WorldTransform *parent, const Transform *local) {
+    f32 a = local->cosine * local->scaleX;
+    f32 b = local->sine * local->scaleX;
+    f32 c = -local->sine * local->scaleY;
+    f32 d = local->cosine * local->scaleY;
+    if (!parent) {
+        *world = (WorldTransform){a, b, c, d, local->x, local->y, local->z};
+        return;
+    }
+
+    world->a = parent->a * a + parent->c * b;
+    world->b = parent->b * a + parent->d * b;
+    world->c = parent->a * c + parent->c * d;
+    world->d = parent->b * c + parent->d * d;
+    world->x = parent->a * local->x + parent->c * local->y + parent->x;
+    world->y = parent->b * local->x + parent->d * local->y + parent->y;
+    world->z = parent->z + local->z;
+}
+
+/**
+ * @brief Updates one root's subtree in a single forward pass. A node is
+ * recomputed if it is dirty or its parent was recomputed; a clean node with
+ * no dirty descendants has its whole subtree skipped.
+ *
+ * @param hierarchy A pointer to the hierarchy.
+ * @param root The root's slot.
+ * @return u32 The number of world transforms recomputed.
+ */
+static u32 ecs_hierarchy_propagate(EcsHierarchy *hierarchy, u32 root) {
+    u8 *flags = hierarchy->flags;
+    if (flags[root] == 0) {
+        return 0;
+    }
+
+    const u32 *parents = hierarchy->parents;
+    const u32 *ends = hierarchy->ends;
+    const Transform *locals = hierarchy->locals;
+    WorldTransform *worlds = hierarchy->worlds;
+    u32 end = ends[root];
+    u32 updated = 0;
+    u32 slot = root;
+    while (slot < end) {
+        u8 nodeFlags = flags[slot];
+        u32 parent = parents[slot];
+        if ((nodeFlags & ECS_HIERARCHY_DIRTY) || (parent != INVALID_ID_U32 && (flags[parent] & ECS_HIERARCHY_UPDATED))) {
+            ecs_hierarchy_compose(&worlds[slot], parent == INVALID_ID_U32 ? NULL : &worlds[parent], &locals[slot]);
+            flags[slot] = nodeFlags | ECS_HIERARCHY_UPDATED;
+            updated++;
+            slot++;
+        } else if (nodeFlags & ECS_HIERARCHY_DESCENDANT_DIRTY) {
+            slot++;
+        } else {
+            slot = ends[slot];
+        }
+    }
+
+    memory_zero(flags + root, end - root);
+    return updated;
+}
+
+/**
+ * @brief Job entry point for a batch of roots.
+ *
+ * @param userData The batch.
+ * @return void
+ */
+static void ecs_hierarchy_batch_job(void *userData) {
+    EcsHierarchyBatch *batch = (EcsHierarchyBatch *)userData;
+    for (u32 root = batch->begin; root < batch->end; ++root) {
+        batch->updated += ecs_hierarchy_propagate(batch->hierarchy, batch->hierarchy->roots[root]);
+    }
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Hierarchy
+
+ENGINE_API EngineResult ecs_hierarchy_init(EcsHierarchy *hierarchy, ECSManager *ecs) {
+    if (!hierarchy || !ecs) {
+        log_error("Invalid EcsHierarchy or ECSManager provided to ecs_hierarchy_init.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    memory_zero(hierarchy, sizeof(EcsHierarchy));
+    hierarchy->ecs = ecs;
+    hierarchy->firstRoot = INVALID_ID_U32;
+    hierarchy->lastRoot = INVALID_ID_U32;
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void ecs_hierarchy_shutdown(EcsHierarchy *hierarchy) {
+    if (!hierarchy || !hierarchy->ecs) {
+        log_error("Invalid EcsHierarchy provided to ecs_hierarchy_shutdown.");
+        return;
+    }
+
+    MemoryPool *pool = hierarchy->ecs->pool;
+    if (hierarchy->nodes) {
+        memory_free(pool, hierarchy->nodes, MEMORY_TAG_ECS);
+    }
+    if (hierarchy->memory) {
+        memory_free(pool, hierarchy->memory, MEMORY_TAG_ECS);
+    }
+    if (hierarchy->roots) {
+        memory_free(pool, hierarchy->roots, MEMORY_TAG_ECS);
+    }
+    memory_zero(hierarchy, sizeof(EcsHierarchy));
+}
+
+ENGINE_API EngineResult ecs_hierarchy_add(EcsHierarchy *hierarchy, Entity entity, Entity parent, const Transform *local) {
+    if (!hierarchy || !ecs_entity_alive(hierarchy->ecs, entity)) {
+        log_error("Invalid EcsHierarchy or entity provided to ecs_hierarchy_add.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (ecs_hierarchy_find(hierarchy, entity)) {
+        log_error("Entity %u is already in the hierarchy.", ecs_entity_index(entity));
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    u32 parentIndex = INVALID_ID_U32;
+    if (parent != INVALID_ENTITY) {
+        if (!ecs_entity_alive(hierarchy->ecs, parent) || !ecs_hierarchy_find(hierarchy, parent)) {
+            log_error("Parent %u:%u is not an entity in the hierarchy.", ecs_entity_index(parent), ecs_entity_generation(parent));
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+        parentIndex = ecs_entity_index(parent);
+    }
+
+    u32 index = ecs_entity_index(entity);
+    if (!ecs_hierarchy_reserve_node(hierarchy, index) || !ecs_hierarchy_reserve_slot(hierarchy)) {
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+
+    // The index's last owner was destroyed without being removed.
+    if (hierarchy->nodes[index].entity != INVALID_ENTITY) {
+        log_warning("Entity index %u was destroyed while still in the hierarchy; removing its subtree.", index);
+        ecs_hierarchy_remove_index(hierarchy, index);
+    }
+
+    // New nodes go at the end; the next update moves them into place.
+    u32 slot = hierarchy->slotCount++;
+    hierarchy->locals[slot] = local ? *local : transform_identity();
+    hierarchy->entities[slot] = index;
+    hierarchy->parents[slot] = INVALID_ID_U32;
+    hierarchy->ends[slot] = slot + 1;
+    hierarchy->flags[slot] = ECS_HIERARCHY_DIRTY;
+
+    EcsHierarchyNode *node = &hierarchy->nodes[index];
+    node->entity = entity;
+    node->firstChild = INVALID_ID_U32;
+    node->lastChild = INVALID_ID_U32;
+    node->slot = slot;
+    ecs_hierarchy_link(hierarchy, index, parentIndex);
+    hierarchy->nodeCount++;
+    hierarchy->structureDirty = true;
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void ecs_hierarchy_remove(EcsHierarchy *hierarchy, Entity entity) {
+    if (!hierarchy || !ecs_hierarchy_find(hierarchy, entity)) {
+        log_warning("Entity %u:%u provided to ecs_hierarchy_remove is not in the hierarchy.", ecs_entity_index(entity), ecs_entity_generation(entity));
+        return;
+    }
+
+    ecs_hierarchy_remove_index(hierarchy, ecs_entity_index(entity));
+}
+
+ENGINE_API EngineResult ecs_hierarchy_set_parent(EcsHierarchy *hierarchy, Entity entity, Entity parent) {
+    EcsHierarchyNode *node = hierarchy ? ecs_hierarchy_find(hierarchy, entity) : NULL;
+    if (!node) {
+        log_error("Invalid EcsHierarchy or entity provided to ecs_hierarchy_set_parent.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    u32 index = ecs_entity_index(entity);
+    u32 parentIndex = INVALID_ID_U32;
+    if (parent != INVALID_ENTITY) {
+        if (!ecs_entity_alive(hierarchy->ecs, parent) || !ecs_hierarchy_find(hierarchy, parent)) {
+            log_error("Parent %u:%u is not an entity in the hierarchy.", ecs_entity_index(parent), ecs_entity_generation(parent));
+            return ENGINE_ERROR_INVALID_ARGUMENT;
+        }
+
+        parentIndex = ecs_entity_index(parent);
+        for (u32 ancestor = parentIndex; ancestor != INVALID_ID_U32; ancestor = hierarchy->nodes[ancestor].parent) {
+            if (ancestor == index) {
+                log_error("Entity %u cannot be parented to itself or one of its descendants.", index);
+                return ENGINE_ERROR_INVALID_ARGUMENT;
+            }
+        }
+    }
+
+    if (node->parent == parentIndex) {
+        return ENGINE_SUCCESS;
+    }
+
+    ecs_hierarchy_unlink(hierarchy, index);
+    ecs_hierarchy_link(hierarchy, index, parentIndex);
+    hierarchy->flags[node->slot] |= ECS_HIERARCHY_DIRTY;
+    hierarchy->structureDirty = true;
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API Entity ecs_hierarchy_parent(const EcsHierarchy *hierarchy, Entity entity) {
+    const EcsHierarchyNode *node = hierarchy ? ecs_hierarchy_find(hierarchy, entity) : NULL;
+    if (!node || node->parent == INVALID_ID_U32) {
+        return INVALID_ENTITY;
+    }
+    return hierarchy->nodes[node->parent].entity;
+}
+
+ENGINE_API Transform *ecs_hierarchy_local(EcsHierarchy *hierarchy, Entity entity) {
+    const EcsHierarchyNode *node = hierarchy ? ecs_hierarchy_find(hierarchy, entity) : NULL;
+    if (!node) {
+        return NULL;
+    }
+
+    ecs_hierarchy_mark(hierarchy, node->slot);
+    return &hierarchy->locals[node->slot];
+}
+
+ENGINE_API const WorldTransform *ecs_hierarchy_world(const EcsHierarchy *hierarchy, Entity entity) {
+    const EcsHierarchyNode *node = hierarchy ? ecs_hierarchy_find(hierarchy, entity) : NULL;
+    return node ? &hierarchy->worlds[node->slot] : NULL;
+}
+
+ENGINE_API u32 ecs_hierarchy_update(EcsHierarchy *hierarchy) {
+    if (!hierarchy || !hierarchy->ecs) {
+        log_error("Invalid EcsHierarchy provided to ecs_hierarchy_update.");
+        return 0;
+    }
+
+    if (hierarchy->structureDirty && !ecs_hierarchy_sort(hierarchy)) {
+        log_error("Failed to sort the hierarchy; world transforms were not updated.");
+        return 0;
+    }
+
+    // A few batches per worker lets stealing even out uneven trees.
+    u32 batchCount = job_system_get_worker_count() * 4;
+    batchCount = batchCount < ECS_HIERARCHY_MAX_BATCHES ? batchCount : ECS_HIERARCHY_MAX_BATCHES;
+    batchCount = batchCount < hierarchy->rootCount ? batchCount : hierarchy->rootCount;
+    if (batchCount < 2 || hierarchy->slotCount < ECS_HIERARCHY_SERIAL_THRESHOLD) {
+        EcsHierarchyBatch batch = {hierarchy, 0, hierarchy->rootCount, 0};
+        ecs_hierarchy_batch_job(&batch);
+        return batch.updated;
+    }
+
+    // Cut the slots into equal ranges and start each batch at the first root
+    // past its cut, so batches hold similar node counts however the roots vary.
+    EcsHierarchyBatch batches[ECS_HIERARCHY_MAX_BATCHES];
+    JobDecl jobs[ECS_HIERARCHY_MAX_BATCHES];
+    u32 root = 0;
+    for (u32 i = 0; i < batchCount; ++i) {
+        u32 begin = root;
+        u32 cut = (u32)((u64)hierarchy->slotCount * (i + 1) / batchCount);
+        while (root < hierarchy->rootCount && hierarchy->roots[root] < cut) {
+            root++;
+        }
+        batches[i] = (EcsHierarchyBatch){hierarchy, begin, root, 0};
+        jobs[i] = (JobDecl){ecs_hierarchy_batch_job, &batches[i]};
+    }
+
+    JobCounter counter = {0};
+    job_run(jobs, batchCount, &counter);
+    job_wait(&counter);
+
+    u32 updated = 0;
+    for (u32 i = 0; i < batchCount; ++i) {
+        updated += batches[i].updated;
+    }
+    return updated;
+}
+
+#pragma endregion
+// =============================================================================
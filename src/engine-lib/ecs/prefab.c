@@ -0,0 +1,451 @@
+#include "engine/ecs/prefab.h"
+#include "engine/logging.h"
+#include "engine/memory.h"
+
+// Alignment of each component value in a prefab's data.
+#define ECS_PREFAB_VALUE_ALIGNMENT 16
+
+// =============================================================================
+#pragma region Helpers
+
+/**
+ * @brief Finds the value of a component of a prefab entity.
+ *
+ * @param prefab A pointer to the prefab.
+ * @param entity The entity's prefab index.
+ * @param type The component type.
+ * @return EcsPrefabComponent* The value's entry, or NULL if the entity does not have the component.
+ */
+static EcsPrefabComponent *ecs_prefab_find(EcsPrefab *prefab, u32 entity, ComponentType type) {
+    for (u32 i = 0; i < prefab->componentCount; ++i) {
+        if (prefab->components[i].entity == entity && prefab->components[i].type == type) {
+            return &prefab->components[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Lists the component types of a prefab entity in ascending order.
+ *
+ * @param prefab A pointer to the prefab.
+ * @param entity The entity's prefab index.
+ * @param types Receives up to ECS_MAX_VIEW_COMPONENTS types.
+ * @return u32 The number of types.
+ */
+static u32 ecs_prefab_entity_types(const EcsPrefab *prefab, u32 entity, ComponentType *types) {
+    u32 count = 0;
+    for (u32 i = 0; i < prefab->componentCount; ++i) {
+        if (prefab->components[i].entity != entity) {
+            continue;
+        }
+
+        // Insertion sort; an entity has few types.
+        ComponentType type = prefab->components[i].type;
+        u32 at = count++;
+        while (at > 0 && types[at - 1] > type) {
+            types[at] = types[at - 1];
+            at--;
+        }
+        types[at] = type;
+    }
+    return count;
+}
+
+/**
+ * @brief Checks whether a part has exactly the given component types.
+ *
+ * @param part A pointer to the part.
+ * @param types Component types in ascending order.
+ * @param typeCount The number of types.
+ * @return b8 True if the part's types are the same.
+ */
+static b8 ecs_prefab_part_matches(const EcsPrefabPart *part, const ComponentType *types, u32 typeCount) {
+    if (part->typeCount != typeCount) {
+        return false;
+    }
+    for (u32 t = 0; t < typeCount; ++t) {
+        if (part->types[t] != types[t]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Frees the baked templates and fixups.
+ *
+ * @param prefab A pointer to the prefab.
+ * @return void
+ */
+static void ecs_prefab_release_baked(EcsPrefab *prefab) {
+    if (prefab->baked) {
+        memory_free(prefab->ecs->pool, prefab->baked, MEMORY_TAG_ECS);
+        prefab->baked = NULL;
+    }
+    if (prefab->fixups) {
+        memory_free(prefab->ecs->pool, prefab->fixups, MEMORY_TAG_ECS);
+        prefab->fixups = NULL;
+    }
+    prefab->partCount = 0;
+    prefab->fixupCount = 0;
+}
+
+/**
+ * @brief Groups the prefab's entities into parts by component set, lays out
+ * each part's templates and collects the relative handles to remap.
+ *
+ * @param prefab A pointer to the prefab.
+ * @return EngineResult ENGINE_SUCCESS if the prefab was baked, otherwise an error code.
+ */
+static EngineResult ecs_prefab_bake(EcsPrefab *prefab) {
+    ecs_prefab_release_baked(prefab);
+    const ComponentArray *arrays = prefab->ecs->componentArrays;
+
+    // Assign parts and members in prefab order.
+    for (u32 e = 0; e < prefab->entityCount; ++e) {
+        ComponentType types[ECS_MAX_VIEW_COMPONENTS];
+        u32 typeCount = ecs_prefab_entity_types(prefab, e, types);
+        u32 part = 0;
+        while (part < prefab->partCount && !ecs_prefab_part_matches(&prefab->parts[part], types, typeCount)) {
+            part++;
+        }
+        if (part == prefab->partCount) {
+            EcsPrefabPart *created = &prefab->parts[prefab->partCount++];
+            memory_zero(created, sizeof(EcsPrefabPart));
+            memory_copy(created->types, types, sizeof(ComponentType) * typeCount);
+            created->typeCount = typeCount;
+        }
+        prefab->entities[e].part = part;
+        prefab->entities[e].member = prefab->parts[part].memberCount++;
+    }
+
+    // Each type's template is memberCount consecutive components.
+    u64 bakedSize = 0;
+    for (u32 p = 0; p < prefab->partCount; ++p) {
+        EcsPrefabPart *part = &prefab->parts[p];
+        for (u32 t = 0; t < part->typeCount; ++t) {
+            u64 size = (u64)arrays[part->types[t]].size * part->memberCount;
+            part->templates[t] = (u32)bakedSize;
+            part->instanceSize += size;
+            bakedSize += size;
+        }
+    }
+    if (bakedSize > MAX_U32) {
+        log_error("Prefab templates exceed %u bytes.", MAX_U32);
+        prefab->partCount = 0;
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (bakedSize > 0) {
+        prefab->baked = (u8 *)memory_allocate(prefab->ecs->pool, bakedSize, MEMORY_TAG_ECS);
+    }
+    if (prefab->componentCount > 0 && prefab->fieldCount > 0) {
+        prefab->fixups = (EcsPrefabFixup *)memory_allocate(prefab->ecs->pool, sizeof(EcsPrefabFixup) * prefab->componentCount * prefab->fieldCount, MEMORY_TAG_ECS);
+    }
+    if ((bakedSize > 0 && !prefab->baked) || (prefab->componentCount > 0 && prefab->fieldCount > 0 && !prefab->fixups)) {
+        log_error("Failed to allocate %llu bytes of prefab templates.", (unsigned long long)bakedSize);
+        ecs_prefab_release_baked(prefab);
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+
+    for (u32 i = 0; i < prefab->componentCount; ++i) {
+        const EcsPrefabComponent *component = &prefab->components[i];
+        const EcsPrefabEntity *entity = &prefab->entities[component->entity];
+        const EcsPrefabPart *part = &prefab->parts[entity->part];
+        u32 size = arrays[component->type].size;
+        u32 t = 0;
+        while (part->types[t] != component->type) {
+            t++;
+        }
+        memory_copy(prefab->baked + part->templates[t] + (u64)entity->member * size, prefab->data + component->offset, size);
+
+        for (u32 f = 0; f < prefab->fieldCount; ++f) {
+            if (prefab->fields[f].type != component->type) {
+                continue;
+            }
+
+            Entity handle;
+            memory_copy(&handle, prefab->data + component->offset + prefab->fields[f].offset, sizeof(Entity));
+            if (!ecs_prefab_is_ref(handle)) {
+                continue;
+            }
+            if (ecs_entity_index(handle) >= prefab->entityCount) {
+                log_error("Prefab entity %u refers to prefab entity %u, which does not exist.", component->entity, ecs_entity_index(handle));
+                ecs_prefab_release_baked(prefab);
+                return ENGINE_ERROR_INVALID_ARGUMENT;
+            }
+            prefab->fixups[prefab->fixupCount++] = (EcsPrefabFixup){component->entity, component->type, prefab->fields[f].offset, ecs_entity_index(handle)};
+        }
+    }
+
+    prefab->dirty = false;
+    return ENGINE_SUCCESS;
+}
+
+/**
+ * @brief Creates one round of instances: each part with one ecs_create_batch
+ * from templates replicated into the staging memory, then remaps the round's
+ * relative handles.
+ *
+ * @param prefab A pointer to the baked prefab.
+ * @param count The number of instances in the round.
+ * @param staging Staging memory for the largest part's components.
+ * @param created Staging for the largest part's entities.
+ * @param entities Receives the round's count * entityCount handles, INVALID_ENTITY for any not created.
+ * @return EngineResult ENGINE_SUCCESS if every instance was created, otherwise an error code.
+ */
+static EngineResult ecs_prefab_round(EcsPrefab *prefab, u32 count, u8 *staging, Entity *created, Entity *entities) {
+    ECSManager *ecs = prefab->ecs;
+    u32 entityCount = prefab->entityCount;
+    memory_set(entities, 0xFF, sizeof(Entity) * count * entityCount);
+
+    for (u32 p = 0; p < prefab->partCount; ++p) {
+        const EcsPrefabPart *part = &prefab->parts[p];
+
+        // Replicate each template by doubling, so a round is a few large copies.
+        const void *initData[ECS_MAX_VIEW_COMPONENTS];
+        u8 *destination = staging;
+        for (u32 t = 0; t < part->typeCount; ++t) {
+            u64 run = (u64)ecs->componentArrays[part->types[t]].size * part->memberCount;
+            u64 total = run * count;
+            memory_copy(destination, prefab->baked + part->templates[t], run);
+            for (u64 filled = run; filled < total; filled *= 2) {
+                memory_copy(destination + filled, destination, filled < total - filled ? filled : total - filled);
+            }
+            initData[t] = destination;
+            destination += total;
+        }
+
+        EngineResult result = ecs_create_batch(ecs, count * part->memberCount, part->types, part->typeCount, initData, created);
+        if (result != ENGINE_SUCCESS) {
+            return result;
+        }
+
+        // Part entities are instance-major; scatter them into prefab order.
+        for (u32 e = 0; e < entityCount; ++e) {
+            if (prefab->entities[e].part != p) {
+                continue;
+            }
+            u32 member = prefab->entities[e].member;
+            for (u32 i = 0; i < count; ++i) {
+                entities[(u64)i * entityCount + e] = created[(u64)i * part->memberCount + member];
+            }
+        }
+    }
+
+    for (u32 i = 0; i < count; ++i) {
+        const Entity *instance = entities + (u64)i * entityCount;
+        for (u32 f = 0; f < prefab->fixupCount; ++f) {
+            const EcsPrefabFixup *fixup = &prefab->fixups[f];
+            u8 *component = (u8 *)ecs_get_component(ecs, instance[fixup->entity], fixup->type);
+            memory_copy(component + fixup->offset, &instance[fixup->target], sizeof(Entity));
+        }
+    }
+    return ENGINE_SUCCESS;
+}
+
+/**
+ * @brief Removes instances from a hierarchy by removing each of their roots.
+ *
+ * @param prefab A pointer to the prefab.
+ * @param hierarchy A pointer to the hierarchy.
+ * @param entities The instances' handles.
+ * @param count The number of instances fully added.
+ * @param partial Prefab entities of the next instance added before a failure.
+ * @return void
+ */
+static void ecs_prefab_unlink(const EcsPrefab *prefab, EcsHierarchy *hierarchy, const Entity *entities, u32 count, u32 partial) {
+    for (u32 i = 0; i <= count; ++i) {
+        u32 end = i < count ? prefab->entityCount : partial;
+        for (u32 e = 0; e < end; ++e) {
+            if (prefab->entities[e].parent == INVALID_ID_U32) {
+                ecs_hierarchy_remove(hierarchy, entities[(u64)i * prefab->entityCount + e]);
+            }
+        }
+    }
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Prefab
+
+ENGINE_API EngineResult ecs_prefab_init(EcsPrefab *prefab, ECSManager *ecs) {
+    if (!prefab || !ecs) {
+        log_error("Invalid EcsPrefab or ECSManager provided to ecs_prefab_init.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    memory_zero(prefab, sizeof(EcsPrefab));
+    prefab->ecs = ecs;
+    prefab->dirty = true;
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void ecs_prefab_shutdown(EcsPrefab *prefab) {
+    if (!prefab || !prefab->ecs) {
+        log_error("Invalid EcsPrefab provided to ecs_prefab_shutdown.");
+        return;
+    }
+
+    ecs_prefab_release_baked(prefab);
+    if (prefab->data) {
+        memory_free(prefab->ecs->pool, prefab->data, MEMORY_TAG_ECS);
+    }
+    memory_zero(prefab, sizeof(EcsPrefab));
+}
+
+ENGINE_API u32 ecs_prefab_add_entity(EcsPrefab *prefab, u32 parent, const Transform *local) {
+    if (!prefab || (parent != INVALID_ID_U32 && parent >= prefab->entityCount)) {
+        log_error("Invalid EcsPrefab or parent provided to ecs_prefab_add_entity.");
+        return INVALID_ID_U32;
+    }
+
+    if (prefab->entityCount == ECS_PREFAB_MAX_ENTITIES) {
+        log_error("Prefab entity limit of %u reached.", ECS_PREFAB_MAX_ENTITIES);
+        return INVALID_ID_U32;
+    }
+
+    EcsPrefabEntity *entity = &prefab->entities[prefab->entityCount];
+    entity->parent = parent;
+    entity->local = local ? *local : transform_identity();
+    prefab->dirty = true;
+    return prefab->entityCount++;
+}
+
+ENGINE_API void *ecs_prefab_set(EcsPrefab *prefab, u32 entity, ComponentType type, const void *componentData) {
+    if (!prefab || entity >= prefab->entityCount || type >= prefab->ecs->registeredComponents) {
+        log_error("Invalid EcsPrefab, entity or component type provided to ecs_prefab_set.");
+        return NULL;
+    }
+
+    u32 size = prefab->ecs->componentArrays[type].size;
+    EcsPrefabComponent *component = ecs_prefab_find(prefab, entity, type);
+    if (!component) {
+        ComponentType types[ECS_MAX_VIEW_COMPONENTS];
+        if (prefab->componentCount == ECS_PREFAB_MAX_COMPONENTS || ecs_prefab_entity_types(prefab, entity, types) == ECS_MAX_VIEW_COMPONENTS) {
+            log_error("Prefab component limit reached for prefab entity %u.", entity);
+            return NULL;
+        }
+
+        u32 offset = (prefab->dataSize + ECS_PREFAB_VALUE_ALIGNMENT - 1) & ~(u32)(ECS_PREFAB_VALUE_ALIGNMENT - 1);
+        // Tags take no bytes but still need data to point into.
+        if (offset + size > prefab->dataCapacity || !prefab->data) {
+            u32 capacity = prefab->dataCapacity ? prefab->dataCapacity : 256;
+            while (capacity < offset + size) {
+                capacity *= 2;
+            }
+            u8 *data = (u8 *)memory_allocate(prefab->ecs->pool, capacity, MEMORY_TAG_ECS);
+            if (!data) {
+                log_error("Failed to grow prefab data to %u bytes.", capacity);
+                return NULL;
+            }
+            if (prefab->data) {
+                memory_copy(data, prefab->data, prefab->dataSize);
+                memory_free(prefab->ecs->pool, prefab->data, MEMORY_TAG_ECS);
+            }
+            prefab->data = data;
+            prefab->dataCapacity = capacity;
+        }
+
+        component = &prefab->components[prefab->componentCount++];
+        *component = (EcsPrefabComponent){entity, type, offset};
+        prefab->dataSize = offset + size;
+    }
+
+    u8 *value = prefab->data + component->offset;
+    if (componentData) {
+        memory_copy(value, componentData, size);
+    } else {
+        memory_zero(value, size);
+    }
+    prefab->dirty = true;
+    return value;
+}
+
+ENGINE_API EngineResult ecs_prefab_entity_field(EcsPrefab *prefab, ComponentType type, u32 offset) {
+    if (!prefab || type >= prefab->ecs->registeredComponents || (u64)offset + sizeof(Entity) > prefab->ecs->componentArrays[type].size) {
+        log_error("Invalid EcsPrefab, component type or field offset provided to ecs_prefab_entity_field.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (u32 i = 0; i < prefab->fieldCount; ++i) {
+        if (prefab->fields[i].type == type && prefab->fields[i].offset == offset) {
+            return ENGINE_SUCCESS;
+        }
+    }
+    if (prefab->fieldCount == ECS_PREFAB_MAX_FIELDS) {
+        log_error("Prefab entity field limit of %u reached.", ECS_PREFAB_MAX_FIELDS);
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    prefab->fields[prefab->fieldCount++] = (EcsPrefabField){type, offset};
+    prefab->dirty = true;
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API EngineResult ecs_prefab_instantiate(EcsPrefab *prefab, u32 count, EcsHierarchy *hierarchy, Entity *entities) {
+    if (!prefab || !prefab->ecs || (!entities && count > 0) || (hierarchy && hierarchy->ecs != prefab->ecs)) {
+        log_error("Invalid EcsPrefab, hierarchy or entity array provided to ecs_prefab_instantiate.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (prefab->entityCount == 0 || count == 0) {
+        return ENGINE_SUCCESS;
+    }
+
+    if (prefab->dirty) {
+        EngineResult result = ecs_prefab_bake(prefab);
+        if (result != ENGINE_SUCCESS) {
+            return result;
+        }
+    }
+
+    // One staging area fits a round of the largest part.
+    u32 roundInstances = count < ECS_PREFAB_ROUND_INSTANCES ? count : ECS_PREFAB_ROUND_INSTANCES;
+    u64 stagingSize = 0;
+    u32 maxMembers = 0;
+    for (u32 p = 0; p < prefab->partCount; ++p) {
+        stagingSize = prefab->parts[p].instanceSize > stagingSize ? prefab->parts[p].instanceSize : stagingSize;
+        maxMembers = prefab->parts[p].memberCount > maxMembers ? prefab->parts[p].memberCount : maxMembers;
+    }
+    stagingSize = (stagingSize * roundInstances + ECS_PREFAB_VALUE_ALIGNMENT - 1) & ~(u64)(ECS_PREFAB_VALUE_ALIGNMENT - 1);
+    u8 *staging = (u8 *)memory_allocate(prefab->ecs->pool, stagingSize + sizeof(Entity) * maxMembers * roundInstances, MEMORY_TAG_ECS);
+    if (!staging) {
+        log_error("Failed to allocate prefab staging for %u instances.", roundInstances);
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+    Entity *created = (Entity *)(staging + stagingSize);
+
+    EngineResult result = ENGINE_SUCCESS;
+    u32 done = 0;
+    while (done < count && result == ENGINE_SUCCESS) {
+        u32 round = count - done < roundInstances ? count - done : roundInstances;
+        result = ecs_prefab_round(prefab, round, staging, created, entities + (u64)done * prefab->entityCount);
+        done += round;
+    }
+    memory_free(prefab->ecs->pool, staging, MEMORY_TAG_ECS);
+
+    // Parents precede their children in prefab order.
+    for (u32 i = 0; i < count && hierarchy && result == ENGINE_SUCCESS; ++i) {
+        const Entity *instance = entities + (u64)i * prefab->entityCount;
+        for (u32 e = 0; e < prefab->entityCount; ++e) {
+            const EcsPrefabEntity *entity = &prefab->entities[e];
+            Entity parent = entity->parent == INVALID_ID_U32 ? INVALID_ENTITY : instance[entity->parent];
+            result = ecs_hierarchy_add(hierarchy, instance[e], parent, &entity->local);
+            if (result != ENGINE_SUCCESS) {
+                ecs_prefab_unlink(prefab, hierarchy, entities, i, e);
+                break;
+            }
+        }
+    }
+
+    if (result != ENGINE_SUCCESS) {
+        log_error("Failed to instantiate %u prefab instances; destroying the ones created.", count);
+        ecs_destroy_batch(prefab->ecs, entities, done * prefab->entityCount);
+    }
+    return result;
+}
+
+#pragma endregion
+// =============================================================================
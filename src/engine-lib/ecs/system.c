@@ -0,0 +1,328 @@
+#include "engine/ecs/system.h"
+#include "engine/logging.h"
+#include "engine/memory.h"
+#include "engine/profiler.h"
+
+/**
+ * @brief A contiguous range of a query system's views handed to one job.
+ */
+typedef struct EcsSystemBatch {
+    const EcsSystem *system; /**< The system being run. */
+    u32 begin;               /**< First view of the batch. */
+    u32 end;                 /**< One past the last view of the batch. */
+} EcsSystemBatch;
+
+// =============================================================================
+#pragma region Helpers
+
+/**
+ * @brief Checks whether two signatures share a component type.
+ *
+ * @param a A pointer to the first signature.
+ * @param b A pointer to the second signature.
+ * @return b8 True if a type is in both.
+ */
+static b8 ecs_system_signatures_intersect(const EcsSignature *a, const EcsSignature *b) {
+    for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+        if (a->bits[word] & b->bits[word]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Builds a signature from a list of component types.
+ *
+ * @param signature A pointer to the signature to fill.
+ * @param types The component types.
+ * @param count The number of types.
+ * @return void
+ */
+static void ecs_system_signature_build(EcsSignature *signature, const ComponentType *types, u32 count) {
+    memory_zero(signature, sizeof(EcsSignature));
+    for (u32 i = 0; i < count; ++i) {
+        signature->bits[types[i] / 64] |= 1ull << (types[i] % 64);
+    }
+}
+
+/**
+ * @brief Checks whether a later system must wait for an earlier one: either
+ * writes a type the other reads or writes.
+ *
+ * @param earlier A pointer to the earlier system.
+ * @param later A pointer to the later system.
+ * @return b8 True if the systems conflict.
+ */
+static b8 ecs_system_conflicts(const EcsSystem *earlier, const EcsSystem *later) {
+    return ecs_system_signatures_intersect(&earlier->writes, &later->reads) || ecs_system_signatures_intersect(&earlier->writes, &later->writes) ||
+           ecs_system_signatures_intersect(&later->writes, &earlier->reads);
+}
+
+/**
+ * @brief Rebuilds the dependency graph. Only earlier systems can be
+ * dependencies, so registration order is a topological order.
+ *
+ * @param scheduler A pointer to the scheduler.
+ * @return void
+ */
+static void ecs_scheduler_build_graph(EcsScheduler *scheduler) {
+    scheduler->rootCount = 0;
+    for (u32 j = 0; j < scheduler->systemCount; ++j) {
+        EcsSystem *later = &scheduler->systems[j];
+        memory_zero(later->dependents, sizeof(later->dependents));
+        later->dependencyCount = 0;
+        for (u32 i = 0; i < j; ++i) {
+            EcsSystem *earlier = &scheduler->systems[i];
+            if (ecs_system_conflicts(earlier, later)) {
+                earlier->dependents[j / 64] |= 1ull << (j % 64);
+                later->dependencyCount++;
+            }
+        }
+        if (later->dependencyCount == 0) {
+            scheduler->roots[scheduler->rootCount++] = j;
+        }
+    }
+    scheduler->graphDirty = false;
+}
+
+/**
+ * @brief Finds the longest chain of dependent systems, using each system's
+ * last wall time.
+ *
+ * @param scheduler A pointer to the scheduler.
+ * @return f64 The seconds along the critical path.
+ */
+static f64 ecs_scheduler_critical_path(const EcsScheduler *scheduler) {
+    f64 starts[ECS_MAX_SYSTEMS] = {0};
+    f64 longest = 0.0;
+    for (u32 i = 0; i < scheduler->systemCount; ++i) {
+        const EcsSystem *system = &scheduler->systems[i];
+        f64 finish = starts[i] + system->lastSeconds;
+        longest = finish > longest ? finish : longest;
+        for (u32 j = i + 1; j < scheduler->systemCount; ++j) {
+            if ((system->dependents[j / 64] >> (j % 64)) & 1 && finish > starts[j]) {
+                starts[j] = finish;
+            }
+        }
+    }
+    return longest;
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Jobs
+
+/**
+ * @brief Job entry point for a batch of a query system's views.
+ *
+ * @param userData A pointer to the EcsSystemBatch to process.
+ * @return void
+ */
+static void ecs_system_batch_job(void *userData) {
+    u64 start = platform_get_performance_counter();
+    const EcsSystemBatch *batch = (const EcsSystemBatch *)userData;
+    const EcsSystem *system = batch->system;
+    EcsScheduler *scheduler = system->scheduler;
+
+    EcsSystemContext context = {scheduler->ecs, scheduler->deltaTime, system->desc.userData, scheduler->commands, 0};
+    u64 systemKey = (u64)(system - scheduler->systems) << 32;
+    EcsView view;
+    for (u32 i = batch->begin; i < batch->end; ++i) {
+        ecs_query_get_view(system->desc.query, i, &view);
+        if (view.count > 0) {
+            context.sortKey = systemKey | i;
+            system->desc.each(&view, &context);
+        }
+    }
+
+    platform_atomic_fetch_add_i64(&scheduler->workTicks, (i64)(platform_get_performance_counter() - start));
+}
+
+/**
+ * @brief Runs a query system, splitting its views into batches across jobs
+ * when there are workers to take them. Returns the ticks spent on the calling
+ * thread, not counting time waiting for the batches.
+ *
+ * @param system A pointer to the system.
+ * @param context A pointer to the run's context. Its sort key is set per view.
+ * @return u64 Ticks of work done by the caller.
+ */
+static u64 ecs_system_run_query(EcsSystem *system, EcsSystemContext *context) {
+    u64 start = platform_get_performance_counter();
+    u32 grainSize = system->desc.grainSize ? system->desc.grainSize : ECS_SYSTEM_DEFAULT_GRAIN_SIZE;
+    u32 viewCount = ecs_query_prepare_views(system->desc.query, grainSize);
+
+    // A few batches per worker lets stealing even out uneven views.
+    u32 batchCount = job_system_get_worker_count() * 4;
+    batchCount = batchCount < ECS_SYSTEM_MAX_BATCHES ? batchCount : ECS_SYSTEM_MAX_BATCHES;
+    batchCount = batchCount < viewCount ? batchCount : viewCount;
+    if (batchCount < 2) {
+        u64 systemKey = context->sortKey;
+        EcsView view;
+        for (u32 i = 0; i < viewCount; ++i) {
+            ecs_query_get_view(system->desc.query, i, &view);
+            if (view.count > 0) {
+                context->sortKey = systemKey | i;
+                system->desc.each(&view, context);
+            }
+        }
+        return platform_get_performance_counter() - start;
+    }
+
+    EcsSystemBatch batches[ECS_SYSTEM_MAX_BATCHES];
+    JobDecl jobs[ECS_SYSTEM_MAX_BATCHES];
+    for (u32 i = 0; i < batchCount; ++i) {
+        batches[i] = (EcsSystemBatch){system, (u32)((u64)viewCount * i / batchCount), (u32)((u64)viewCount * (i + 1) / batchCount)};
+        jobs[i] = (JobDecl){ecs_system_batch_job, &batches[i]};
+    }
+
+    u64 ticks = platform_get_performance_counter() - start;
+    JobCounter counter = {0};
+    job_run(jobs, batchCount, &counter);
+    job_wait(&counter);
+    return ticks;
+}
+
+/**
+ * @brief Job entry point for one system. Runs it, then starts every dependent
+ * whose last dependency this was.
+ *
+ * @param userData A pointer to the EcsSystem to run.
+ * @return void
+ */
+static void ecs_system_job(void *userData) {
+    EcsSystem *system = (EcsSystem *)userData;
+    EcsScheduler *scheduler = system->scheduler;
+    u64 start = platform_get_performance_counter();
+
+    PROFILER_ZONE_BEGIN(zone, system->desc.name);
+    EcsSystemContext context = {scheduler->ecs, scheduler->deltaTime, system->desc.userData, scheduler->commands, (u64)(system - scheduler->systems) << 32};
+    u64 work;
+    if (system->desc.update) {
+        system->desc.update(&context);
+        work = platform_get_performance_counter() - start;
+    } else {
+        work = ecs_system_run_query(system, &context);
+    }
+    PROFILER_ZONE_END(zone);
+
+    u64 end = platform_get_performance_counter();
+    system->lastSeconds = (f64)(end - start) / (f64)platform_get_performance_frequency();
+    platform_atomic_fetch_add_i64(&scheduler->workTicks, (i64)work);
+
+    for (u32 i = (u32)(system - scheduler->systems) + 1; i < scheduler->systemCount; ++i) {
+        if (!((system->dependents[i / 64] >> (i % 64)) & 1)) {
+            continue;
+        }
+        EcsSystem *dependent = &scheduler->systems[i];
+        if (platform_atomic_fetch_add_i32(&dependent->pending, -1) == 1) {
+            JobDecl job = {ecs_system_job, dependent};
+            job_run(&job, 1, &scheduler->counter);
+        }
+    }
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Scheduler
+
+ENGINE_API EngineResult ecs_scheduler_init(EcsScheduler *scheduler, ECSManager *ecs) {
+    if (!scheduler || !ecs) {
+        log_error("Invalid EcsScheduler or ECSManager provided to ecs_scheduler_init.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    memory_zero(scheduler, sizeof(EcsScheduler));
+    scheduler->ecs = ecs;
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API u32 ecs_scheduler_add_system(EcsScheduler *scheduler, const EcsSystemDesc *desc) {
+    if (!scheduler || !desc || (!desc->update && (!desc->query || !desc->each))) {
+        log_error("Invalid EcsScheduler or EcsSystemDesc provided to ecs_scheduler_add_system.");
+        return INVALID_ID_U32;
+    }
+
+    if (scheduler->systemCount == ECS_MAX_SYSTEMS) {
+        log_error("Maximum number of systems reached.");
+        return INVALID_ID_U32;
+    }
+
+    ECSManager *ecs = scheduler->ecs;
+    for (u32 i = 0; i < desc->readCount + desc->writeCount; ++i) {
+        ComponentType type = i < desc->readCount ? desc->reads[i] : desc->writes[i - desc->readCount];
+        if (type >= ecs->registeredComponents) {
+            log_error("Component type %u is not registered.", type);
+            return INVALID_ID_U32;
+        }
+    }
+
+    u32 index = scheduler->systemCount++;
+    EcsSystem *system = &scheduler->systems[index];
+    memory_zero(system, sizeof(EcsSystem));
+    system->desc = *desc;
+    if (!system->desc.name) {
+        system->desc.name = "EcsSystem";
+    }
+    system->scheduler = scheduler;
+    ecs_system_signature_build(&system->reads, desc->reads, desc->readCount);
+    ecs_system_signature_build(&system->writes, desc->writes, desc->writeCount);
+
+    // The type lists only need to live for the call; the signatures keep them.
+    system->desc.reads = NULL;
+    system->desc.writes = NULL;
+    scheduler->graphDirty = true;
+    return index;
+}
+
+ENGINE_API void ecs_scheduler_run(EcsScheduler *scheduler, f32 deltaTime) {
+    if (!scheduler) {
+        log_error("Invalid EcsScheduler provided to ecs_scheduler_run.");
+        return;
+    }
+
+    if (scheduler->graphDirty) {
+        ecs_scheduler_build_graph(scheduler);
+    }
+    if (scheduler->systemCount == 0) {
+        return;
+    }
+
+    PROFILER_ZONE_BEGIN(zone, "EcsScheduler");
+    u64 start = platform_get_performance_counter();
+    scheduler->deltaTime = deltaTime;
+    platform_atomic_store_i64(&scheduler->workTicks, 0);
+    for (u32 i = 0; i < scheduler->systemCount; ++i) {
+        platform_atomic_store_i32(&scheduler->systems[i].pending, (i32)scheduler->systems[i].dependencyCount);
+    }
+
+    JobDecl jobs[ECS_MAX_SYSTEMS];
+    for (u32 i = 0; i < scheduler->rootCount; ++i) {
+        jobs[i] = (JobDecl){ecs_system_job, &scheduler->systems[scheduler->roots[i]]};
+    }
+    job_run(jobs, scheduler->rootCount, &scheduler->counter);
+    job_wait(&scheduler->counter);
+
+    f64 secondsPerTick = 1.0 / (f64)platform_get_performance_frequency();
+    scheduler->lastWallSeconds = (f64)(platform_get_performance_counter() - start) * secondsPerTick;
+    scheduler->lastWorkSeconds = (f64)platform_atomic_load_i64(&scheduler->workTicks) * secondsPerTick;
+    scheduler->lastCriticalPathSeconds = ecs_scheduler_critical_path(scheduler);
+    PROFILER_ZONE_ADD_WORK(zone, scheduler->lastWorkSeconds);
+    PROFILER_ZONE_END(zone);
+
+    // The sync point: every system is done, so structural changes are safe.
+    if (scheduler->commands) {
+        ecs_command_queue_flush(scheduler->commands);
+    }
+}
+
+ENGINE_API f64 ecs_scheduler_parallelism(const EcsScheduler *scheduler) {
+    if (!scheduler || scheduler->lastWallSeconds <= 0.0) {
+        return 0.0;
+    }
+    return scheduler->lastWorkSeconds / scheduler->lastWallSeconds;
+}
+
+#pragma endregion
+// =============================================================================
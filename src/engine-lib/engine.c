@@ -1,6 +1,7 @@
 #include "engine/engine.h"
 #include "engine/application.h"
 #include "engine/logging.h"
+#include "engine/profiler.h"
 
 ENGINE_API EngineResult engine_init(const EngineConfig *config, Engine *engine) {
     if (!config || !engine) {
@@ -21,6 +22,27 @@ ENGINE_API EngineResult engine_init(const EngineConfig *config, Engine *engine)
         return ENGINE_FAILURE;
     }
 
+    // Initialize the profiler. Missing hardware counters are not an error.
+    ProfilerConfig profilerConfig = {0};
+    profilerConfig.hardwareCounters = config->profileHardwareCounters;
+    if (profiler_init(&profilerConfig) != ENGINE_SUCCESS) {
+        log_error("Profiler initialization failed.");
+        platform_shutdown(&engine->platform);
+        memory_pool_shutdown(&engine->memoryPool);
+        return ENGINE_FAILURE;
+    }
+
+    // Initialize the job system. The calling (main) thread becomes worker 0.
+    JobSystemConfig jobConfig = {0};
+    jobConfig.workerCount = config->jobWorkerCount;
+    if (job_system_init(&engine->memoryPool, &jobConfig) != ENGINE_SUCCESS) {
+        log_error("Job system initialization failed.");
+        profiler_shutdown();
+        platform_shutdown(&engine->platform);
+        memory_pool_shutdown(&engine->memoryPool);
+        return ENGINE_FAILURE;
+    }
+
     // TODO: Initialize other systems as needed.
     // e.g. renderer, audio, input, physics, etc.
 
@@ -37,6 +59,12 @@ ENGINE_API void engine_shutdown(Engine *engine) {
     // TODO: Shutdown other systems as needed.
     // e.g. renderer, audio, input, physics, etc.
 
+    // Shut down the job system.
+    job_system_shutdown();
+
+    // Shut down the profiler (logs the zone report).
+    profiler_shutdown();
+
     // Shut down platform.
     platform_shutdown(&engine->platform);
 
@@ -152,3 +152,297 @@ void platform_mutex_destroy(void *lock) {
 }
 
 #endif // PLATFORM_LINUX
+
+// =============================================================================
+// Linux services used alongside the SDL3 platform layer. SDL does not expose
+// these, so they are implemented directly against the OS.
+#if defined(PLATFORM_LINUX)
+#    include "engine/logging.h"
+#    include <errno.h>
+#    include <linux/futex.h>
+#    include <linux/perf_event.h>
+#    include <string.h>
+#    include <sys/ioctl.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <ucontext.h>
+#    include <unistd.h>
+
+// =============================================================================
+#    pragma region Fibers
+
+/**
+ * @brief Linux fiber: a ucontext plus the stack it runs on.
+ */
+typedef struct LinuxFiber {
+    ucontext_t context;     /**< Saved registers and signal mask. */
+    void *mapping;          /**< Stack mapping including the guard page, NULL for thread fibers. */
+    u64 mappingSize;        /**< Size of the mapping in bytes. */
+    PlatformFiberFunc func; /**< Entry point. */
+    void *data;             /**< User data passed to the entry point. */
+} LinuxFiber;
+
+/**
+ * @brief makecontext entry trampoline. makecontext only passes int arguments,
+ * so the fiber pointer arrives split into two halves.
+ *
+ * @param low The low 32 bits of the LinuxFiber pointer.
+ * @param high The high 32 bits of the LinuxFiber pointer.
+ * @return void
+ */
+static void linux_fiber_entry(u32 low, u32 high) {
+    LinuxFiber *fiber = (LinuxFiber *)(((u64)high << 32) | (u64)low);
+    fiber->func(fiber->data);
+
+    // Returning would exit the thread (uc_link is NULL).
+    log_fatal("Fiber entry point returned.");
+}
+
+ENGINE_API b8 platform_fiber_supported(void) {
+    return true;
+}
+
+ENGINE_API EngineResult platform_fiber_create(PlatformFiberFunc func, void *data, u64 stackSize, void **fiber) {
+    if (!func || !fiber || stackSize == 0) {
+        log_error("Invalid function, stack size, or fiber handle provided to platform_fiber_create.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    LinuxFiber *result = (LinuxFiber *)platform_memory_allocate(sizeof(LinuxFiber));
+    if (!result) {
+        log_error("Failed to allocate fiber.");
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+    platform_memory_set(result, 0, sizeof(LinuxFiber));
+
+    // One extra PROT_NONE page below the stack turns an overflow into a
+    // fault instead of silent corruption of a neighbouring fiber.
+    u64 pageSize = (u64)sysconf(_SC_PAGESIZE);
+    u64 usableSize = (stackSize + pageSize - 1) & ~(pageSize - 1);
+    result->mappingSize = usableSize + pageSize;
+    result->mapping = mmap(NULL, result->mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (result->mapping == MAP_FAILED) {
+        log_error("Failed to map %llu byte fiber stack.", (unsigned long long)result->mappingSize);
+        platform_memory_free(result);
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+    mprotect(result->mapping, pageSize, PROT_NONE);
+
+    result->func = func;
+    result->data = data;
+    getcontext(&result->context);
+    result->context.uc_stack.ss_sp = (u8 *)result->mapping + pageSize;
+    result->context.uc_stack.ss_size = usableSize;
+    result->context.uc_link = NULL;
+
+    u64 address = (u64)result;
+    makecontext(&result->context, (void (*)(void))linux_fiber_entry, 2, (u32)address, (u32)(address >> 32));
+
+    *fiber = result;
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API EngineResult platform_fiber_create_from_thread(void **fiber) {
+    if (!fiber) {
+        log_error("Invalid fiber handle provided to platform_fiber_create_from_thread.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    // The context is filled in by the first switch away from the thread.
+    LinuxFiber *result = (LinuxFiber *)platform_memory_allocate(sizeof(LinuxFiber));
+    if (!result) {
+        log_error("Failed to allocate thread fiber.");
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+    platform_memory_set(result, 0, sizeof(LinuxFiber));
+
+    *fiber = result;
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void platform_fiber_destroy(void *fiber) {
+    if (!fiber) {
+        log_error("Invalid fiber provided to platform_fiber_destroy.");
+        return;
+    }
+
+    LinuxFiber *linuxFiber = (LinuxFiber *)fiber;
+    if (linuxFiber->mapping) {
+        munmap(linuxFiber->mapping, linuxFiber->mappingSize);
+    }
+    platform_memory_free(linuxFiber);
+}
+
+ENGINE_API void platform_fiber_switch(void *from, void *to) {
+    swapcontext(&((LinuxFiber *)from)->context, &((LinuxFiber *)to)->context);
+}
+
+#    pragma endregion
+// =============================================================================
+#    pragma region Futex
+
+ENGINE_API void platform_futex_wait(PlatformAtomicI32 *address, i32 expected) {
+    // EAGAIN (value already changed) and EINTR are both treated as a wakeup.
+    syscall(SYS_futex, &address->value, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+ENGINE_API void platform_futex_wake(PlatformAtomicI32 *address, u32 count) {
+    i32 wakeCount = count > (u32)MAX_I32 ? MAX_I32 : (i32)count;
+    syscall(SYS_futex, &address->value, FUTEX_WAKE_PRIVATE, wakeCount, NULL, NULL, 0);
+}
+
+#    pragma endregion
+// =============================================================================
+#    pragma region Performance Counters
+
+/**
+ * @brief An open perf event group for one thread.
+ */
+typedef struct LinuxPerfCounters {
+    i32 leaderFd;                           /**< Group leader (cycles); reading it reads the whole group. */
+    i32 fds[PLATFORM_PERF_COUNTER_COUNT];   /**< Event file descriptors in group order. */
+    u32 kinds[PLATFORM_PERF_COUNTER_COUNT]; /**< PlatformPerfCounter of each event in group order. */
+    u32 count;                              /**< Number of events in the group. */
+    u32 validMask;                          /**< Bit (1 << counter) set for each open counter. */
+} LinuxPerfCounters;
+
+/**
+ * @brief Opens one perf event for the calling thread.
+ *
+ * @param counter The counter to open.
+ * @param groupFd The group leader, or -1 to open a new group.
+ * @return i32 The file descriptor, or -1 on failure.
+ */
+static i32 linux_perf_event_open(PlatformPerfCounter counter, i32 groupFd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = groupFd == -1; // The leader starts the whole group.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (counter) {
+        case PLATFORM_PERF_COUNTER_CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PLATFORM_PERF_COUNTER_INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PLATFORM_PERF_COUNTER_L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PLATFORM_PERF_COUNTER_LLC_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PLATFORM_PERF_COUNTER_BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        default:
+            return -1;
+    }
+
+    return (i32)syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+ENGINE_API EngineResult platform_perf_counters_open(void **counters) {
+    if (!counters) {
+        log_error("Invalid counter handle provided to platform_perf_counters_open.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+    *counters = NULL;
+
+    i32 leaderFd = linux_perf_event_open(PLATFORM_PERF_COUNTER_CYCLES, -1);
+    if (leaderFd < 0) {
+        // Common in containers and VMs, or with perf_event_paranoid > 2.
+        log_warning("Hardware performance counters unavailable: %s.", strerror(errno));
+        return ENGINE_ERROR;
+    }
+
+    LinuxPerfCounters *result = (LinuxPerfCounters *)platform_memory_allocate(sizeof(LinuxPerfCounters));
+    if (!result) {
+        close(leaderFd);
+        log_error("Failed to allocate performance counters.");
+        return ENGINE_ERROR_ALLOCATION_FAILED;
+    }
+    platform_memory_set(result, 0, sizeof(LinuxPerfCounters));
+
+    result->leaderFd = leaderFd;
+    result->fds[0] = leaderFd;
+    result->kinds[0] = PLATFORM_PERF_COUNTER_CYCLES;
+    result->count = 1;
+    result->validMask = 1u << PLATFORM_PERF_COUNTER_CYCLES;
+
+    // The remaining events are optional; PMUs (and hypervisors) differ in
+    // which generic events they support.
+    for (u32 counter = PLATFORM_PERF_COUNTER_CYCLES + 1; counter < PLATFORM_PERF_COUNTER_COUNT; ++counter) {
+        i32 fd = linux_perf_event_open((PlatformPerfCounter)counter, leaderFd);
+        if (fd < 0) {
+            log_warning("Hardware performance counter %u unavailable: %s.", counter, strerror(errno));
+            continue;
+        }
+
+        result->fds[result->count] = fd;
+        result->kinds[result->count] = counter;
+        result->count++;
+        result->validMask |= 1u << counter;
+    }
+
+    ioctl(leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    *counters = result;
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API void platform_perf_counters_close(void *counters) {
+    if (!counters) {
+        log_error("Invalid counters provided to platform_perf_counters_close.");
+        return;
+    }
+
+    LinuxPerfCounters *linuxCounters = (LinuxPerfCounters *)counters;
+    ioctl(linuxCounters->leaderFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // Close members before the leader.
+    for (u32 i = linuxCounters->count; i > 0; --i) {
+        close(linuxCounters->fds[i - 1]);
+    }
+    platform_memory_free(linuxCounters);
+}
+
+ENGINE_API b8 platform_perf_counters_read(void *counters, PlatformPerfCounterValues *values) {
+    if (!counters || !values) {
+        return false;
+    }
+
+    LinuxPerfCounters *linuxCounters = (LinuxPerfCounters *)counters;
+
+    // PERF_FORMAT_GROUP layout: nr, time enabled, time running, values[nr].
+    u64 buffer[3 + PLATFORM_PERF_COUNTER_COUNT];
+    ssize_t bytes = read(linuxCounters->leaderFd, buffer, sizeof(buffer));
+    if (bytes < (ssize_t)(3 * sizeof(u64)) || buffer[0] != linuxCounters->count || buffer[2] == 0) {
+        return false;
+    }
+
+    // Scale up if the group was only scheduled on the PMU part of the time.
+    f64 scale = buffer[2] < buffer[1] ? (f64)buffer[1] / (f64)buffer[2] : 1.0;
+
+    platform_memory_set(values, 0, sizeof(PlatformPerfCounterValues));
+    for (u32 i = 0; i < linuxCounters->count; ++i) {
+        values->values[linuxCounters->kinds[i]] = (u64)((f64)buffer[3 + i] * scale);
+    }
+    values->validMask = linuxCounters->validMask;
+
+    return true;
+}
+
+#    pragma endregion
+// =============================================================================
+
+#endif // PLATFORM_LINUX
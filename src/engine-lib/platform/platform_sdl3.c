@@ -1,6 +1,7 @@
 #include "engine/logging.h"
 #include "engine/memory.h"
 #include "engine/platform.h"
+#include "engine/window.h"
 #include <SDL3/SDL.h>
 
 // Platform-specific data structure.
@@ -9,6 +10,7 @@ typedef struct SDL3_PlatformData {
     SDL_Renderer *renderer; /**< The SDL renderer handle. */
     b8 isRunning;           /**< True if the platform is running. */
     u64 absoluteTime;       /**< The absolute time of the platform. */
+    u32 wakeEventType;      /**< User event type pushed to wake a blocked event wait. */
 } SDL3_PlatformData;
 
 // =============================================================================
@@ -64,6 +66,12 @@ static EngineResult sdl3_platform_init(Platform *platform, MemoryPool *pool) {
         return ENGINE_FAILURE;
     }
 
+    // Reserve a user event used to interrupt SDL_WaitEventTimeout from other threads.
+    data->wakeEventType = SDL_RegisterEvents(1);
+    if (data->wakeEventType == 0) {
+        log_warning("SDL_RegisterEvents Error: %s. Idle waits can only be woken by input.", SDL_GetError());
+    }
+
     data->isRunning = true;
     platform->data = data;
 
@@ -108,6 +116,26 @@ static void sdl3_platform_shutdown(Platform *platform) {
     log_info("SDL3 platform shutdown completed.");
 }
 
+/**
+ * @brief Handles a single SDL3 event.
+ *
+ * @param data A pointer to the SDL3 platform data.
+ * @param event A pointer to the event to handle.
+ * @return void
+ */
+static void sdl3_platform_handle_event(SDL3_PlatformData *data, const SDL_Event *event) {
+    switch (event->type) {
+        case SDL_EVENT_QUIT: {
+            data->isRunning = false;
+        } break;
+
+        default: {
+            // Wake events and unhandled input still count as activity; the
+            // caller decides whether that warrants a redraw.
+        } break;
+    }
+}
+
 /**
  * @brief Polls SDL3 platform-specific events.
  *
@@ -124,15 +152,65 @@ static void sdl3_platform_poll_events(Platform *platform) {
     SDL3_PlatformData *data = (SDL3_PlatformData *)platform->data;
 
     while (SDL_PollEvent(&event)) {
-        switch (event.type) {
-            case SDL_EVENT_QUIT: {
-                data->isRunning = false;
-            } break;
+        sdl3_platform_handle_event(data, &event);
+    }
+}
+
+/**
+ * @brief Blocks until an SDL3 event arrives or the timeout expires, then
+ * drains the event queue.
+ *
+ * @param platform A pointer to the Platform structure.
+ * @param timeoutMs The maximum time to wait in milliseconds, or 0 to wait indefinitely.
+ * @return b8 True if at least one event was processed, otherwise false.
+ */
+static b8 sdl3_platform_wait_events(Platform *platform, u32 timeoutMs) {
+    if (!platform || !platform->data) {
+        log_warning("sdl3_platform_wait_events called with invalid platform or data.");
+        return false;
+    }
+
+    SDL_Event event;
+    SDL3_PlatformData *data = (SDL3_PlatformData *)platform->data;
+
+    // SDL treats a negative timeout as "wait forever".
+    Sint32 timeout = timeoutMs == 0 ? -1 : (Sint32)timeoutMs;
+    if (!SDL_WaitEventTimeout(&event, timeout)) {
+        return false;
+    }
+
+    sdl3_platform_handle_event(data, &event);
+
+    // Drain anything else that queued up while we were asleep.
+    while (SDL_PollEvent(&event)) {
+        sdl3_platform_handle_event(data, &event);
+    }
 
-            default: {
-            } break;
-        }
+    return true;
+}
+
+/**
+ * @brief Wakes a thread blocked in sdl3_platform_wait_events by pushing the
+ * reserved wake event.
+ *
+ * @param platform A pointer to the Platform structure.
+ * @return void
+ */
+static void sdl3_platform_wake(Platform *platform) {
+    if (!platform || !platform->data) {
+        log_warning("sdl3_platform_wake called with invalid platform or data.");
+        return;
+    }
+
+    SDL3_PlatformData *data = (SDL3_PlatformData *)platform->data;
+    if (data->wakeEventType == 0) {
+        return;
     }
+
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = data->wakeEventType;
+    SDL_PushEvent(&event);
 }
 
 /**
@@ -182,6 +260,8 @@ ENGINE_API EngineResult platform_init(Platform *platform, MemoryPool *pool) {
     platform->init = sdl3_platform_init;
     platform->shutdown = sdl3_platform_shutdown;
     platform->pollEvents = sdl3_platform_poll_events;
+    platform->waitEvents = sdl3_platform_wait_events;
+    platform->wake = sdl3_platform_wake;
     platform->isRunning = sdl3_platform_is_running;
     platform->getAbsoluteTime = sdl3_platform_get_absolute_time;
 
@@ -207,6 +287,24 @@ ENGINE_API void platform_poll_events(Platform *platform) {
     platform->pollEvents(platform);
 }
 
+ENGINE_API b8 platform_wait_events(Platform *platform, u32 timeoutMs) {
+    if (!platform) {
+        log_error("Invalid Platform provided to platform_wait_events.");
+        return false;
+    }
+
+    return platform->waitEvents(platform, timeoutMs);
+}
+
+ENGINE_API void platform_wake(Platform *platform) {
+    if (!platform) {
+        log_error("Invalid Platform provided to platform_wake.");
+        return;
+    }
+
+    platform->wake(platform);
+}
+
 ENGINE_API b8 platform_is_running(Platform *platform) {
     if (!platform) {
         log_error("Invalid Platform provided to platform_is_running.");
@@ -225,6 +323,14 @@ ENGINE_API u64 platform_get_absolute_time(Platform *platform) {
     return platform->getAbsoluteTime(platform);
 }
 
+ENGINE_API u64 platform_get_performance_counter(void) {
+    return SDL_GetPerformanceCounter();
+}
+
+ENGINE_API u64 platform_get_performance_frequency(void) {
+    return SDL_GetPerformanceFrequency();
+}
+
 #pragma endregion
 // =============================================================================
 #pragma region Renderer
@@ -288,14 +394,87 @@ ENGINE_API void *platform_memory_set(void *dest, i32 value, u64 size) {
 }
 
 ENGINE_API void *platform_memory_zero(void *block, u64 size) {
-    ENGINE_UNUSED(size);
-    return SDL_zero(block);
+    return SDL_memset(block, 0, size);
 }
 
 #pragma endregion
 // =============================================================================
 #pragma region Threading
 
+#if ENGINE_ENABLE_LOCK_PROFILER
+// Mutex handle while lock profiling is enabled.
+typedef struct SDL3_ProfiledMutex {
+    SDL_Mutex *mutex;      /**< The SDL mutex. */
+    ProfilerLock *profile; /**< Contention record, NULL until the mutex is named. */
+    u64 acquiredTicks;     /**< Performance counter when the current owner acquired the mutex. */
+} SDL3_ProfiledMutex;
+
+ENGINE_API void platform_mutex_create(void **lock) {
+    SDL3_ProfiledMutex *profiled = (SDL3_ProfiledMutex *)SDL_calloc(1, sizeof(SDL3_ProfiledMutex));
+    if (!profiled) {
+        log_error("Failed to allocate profiled mutex.");
+        *lock = NULL;
+        return;
+    }
+
+    profiled->mutex = SDL_CreateMutex();
+    if (!profiled->mutex) {
+        log_error("Failed to create mutex: %s", SDL_GetError());
+        SDL_free(profiled);
+        profiled = NULL;
+    }
+
+    *lock = profiled;
+}
+
+ENGINE_API void platform_mutex_destroy(void *lock) {
+    if (!lock) {
+        log_error("Invalid lock provided to platform_mutex_destroy.");
+        return;
+    }
+
+    SDL3_ProfiledMutex *profiled = (SDL3_ProfiledMutex *)lock;
+    SDL_DestroyMutex(profiled->mutex);
+    SDL_free(profiled);
+}
+
+ENGINE_API void platform_mutex_set_name(void *lock, const char *name) {
+    if (!lock || !name) {
+        log_error("Invalid lock or name provided to platform_mutex_set_name.");
+        return;
+    }
+
+    SDL3_ProfiledMutex *profiled = (SDL3_ProfiledMutex *)lock;
+    profiled->profile = profiler_lock_register(name);
+    profiled->acquiredTicks = 0;
+}
+
+ENGINE_API void platform_mutex_lock(void *lock) {
+    SDL3_ProfiledMutex *profiled = (SDL3_ProfiledMutex *)lock;
+    if (!profiled->profile) {
+        SDL_LockMutex(profiled->mutex);
+        return;
+    }
+
+    u64 start = SDL_GetPerformanceCounter();
+    b8 contended = !SDL_TryLockMutex(profiled->mutex);
+    if (contended) {
+        SDL_LockMutex(profiled->mutex);
+    }
+
+    profiled->acquiredTicks = SDL_GetPerformanceCounter();
+    profiler_lock_acquired(profiled->profile, contended ? profiled->acquiredTicks - start : 0);
+}
+
+ENGINE_API void platform_mutex_unlock(void *lock) {
+    SDL3_ProfiledMutex *profiled = (SDL3_ProfiledMutex *)lock;
+    if (profiled->profile && profiled->acquiredTicks) {
+        profiler_lock_released(profiled->profile, SDL_GetPerformanceCounter() - profiled->acquiredTicks);
+    }
+
+    SDL_UnlockMutex(profiled->mutex);
+}
+#else
 ENGINE_API void platform_mutex_create(void **lock) {
     *lock = SDL_CreateMutex();
 
@@ -320,6 +499,166 @@ ENGINE_API void platform_mutex_lock(void *lock) {
 ENGINE_API void platform_mutex_unlock(void *lock) {
     SDL_UnlockMutex((SDL_Mutex *)lock);
 }
+#endif
+
+ENGINE_API EngineResult platform_thread_create(PlatformThreadFunc func, void *data, const char *name, void **thread) {
+    if (!func || !thread) {
+        log_error("Invalid function or thread handle provided to platform_thread_create.");
+        return ENGINE_ERROR_INVALID_ARGUMENT;
+    }
+
+    // PlatformThreadFunc matches SDL_ThreadFunction (int (*)(void *)).
+    *thread = SDL_CreateThread((SDL_ThreadFunction)func, name, data);
+    if (!*thread) {
+        log_error("Failed to create thread '%s': %s", name ? name : "", SDL_GetError());
+        return ENGINE_ERROR;
+    }
+
+    return ENGINE_SUCCESS;
+}
+
+ENGINE_API i32 platform_thread_join(void *thread) {
+    if (!thread) {
+        log_error("Invalid thread provided to platform_thread_join.");
+        return -1;
+    }
+
+    int status = 0;
+    SDL_WaitThread((SDL_Thread *)thread, &status);
+    return (i32)status;
+}
+
+ENGINE_API u64 platform_thread_get_id(void) {
+    return (u64)SDL_GetCurrentThreadID();
+}
+
+ENGINE_API void platform_thread_yield(void) {
+    SDL_Delay(0);
+}
+
+ENGINE_API void platform_sleep(u32 ms) {
+    SDL_Delay(ms);
+}
+
+ENGINE_API u32 platform_get_processor_count(void) {
+    int count = SDL_GetNumLogicalCPUCores();
+    return count > 0 ? (u32)count : 1;
+}
+
+ENGINE_API void platform_semaphore_create(void **semaphore, u32 initialValue) {
+    *semaphore = SDL_CreateSemaphore(initialValue);
+
+    if (!*semaphore) {
+        log_error("Failed to create semaphore: %s", SDL_GetError());
+    }
+}
+
+ENGINE_API void platform_semaphore_destroy(void *semaphore) {
+    if (!semaphore) {
+        log_error("Invalid semaphore provided to platform_semaphore_destroy.");
+        return;
+    }
+
+    SDL_DestroySemaphore((SDL_Semaphore *)semaphore);
+}
+
+ENGINE_API void platform_semaphore_wait(void *semaphore) {
+    SDL_WaitSemaphore((SDL_Semaphore *)semaphore);
+}
+
+ENGINE_API b8 platform_semaphore_wait_timeout(void *semaphore, u32 timeoutMs) {
+    return SDL_WaitSemaphoreTimeout((SDL_Semaphore *)semaphore, (Sint32)timeoutMs);
+}
+
+ENGINE_API void platform_semaphore_signal(void *semaphore) {
+    SDL_SignalSemaphore((SDL_Semaphore *)semaphore);
+}
+
+#pragma endregion
+// =============================================================================
+#pragma region Fibers
+
+// SDL has no fiber API; Linux provides ucontext fibers in platform_linux.c.
+#if !defined(PLATFORM_LINUX)
+
+ENGINE_API b8 platform_fiber_supported(void) {
+    return false;
+}
+
+ENGINE_API EngineResult platform_fiber_create(PlatformFiberFunc func, void *data, u64 stackSize, void **fiber) {
+    ENGINE_UNUSED(func);
+    ENGINE_UNUSED(data);
+    ENGINE_UNUSED(stackSize);
+    ENGINE_UNUSED(fiber);
+    log_error("Fibers are not supported on this platform.");
+    return ENGINE_ERROR;
+}
+
+ENGINE_API EngineResult platform_fiber_create_from_thread(void **fiber) {
+    ENGINE_UNUSED(fiber);
+    log_error("Fibers are not supported on this platform.");
+    return ENGINE_ERROR;
+}
+
+ENGINE_API void platform_fiber_destroy(void *fiber) {
+    ENGINE_UNUSED(fiber);
+}
+
+ENGINE_API void platform_fiber_switch(void *from, void *to) {
+    ENGINE_UNUSED(from);
+    ENGINE_UNUSED(to);
+}
+
+#endif // !PLATFORM_LINUX
+
+#pragma endregion
+// =============================================================================
+#pragma region Performance Counters
+
+// SDL has no hardware counter API; Linux reads them with perf_event_open in
+// platform_linux.c.
+#if !defined(PLATFORM_LINUX)
+
+ENGINE_API EngineResult platform_perf_counters_open(void **counters) {
+    if (counters) {
+        *counters = NULL;
+    }
+    return ENGINE_ERROR;
+}
+
+ENGINE_API void platform_perf_counters_close(void *counters) {
+    ENGINE_UNUSED(counters);
+}
+
+ENGINE_API b8 platform_perf_counters_read(void *counters, PlatformPerfCounterValues *values) {
+    ENGINE_UNUSED(counters);
+    ENGINE_UNUSED(values);
+    return false;
+}
+
+#endif // !PLATFORM_LINUX
+
+#pragma endregion
+// =============================================================================
+#pragma region Futex
+
+// SDL has no wait-on-address primitive; Linux uses a real futex in
+// platform_linux.c. Elsewhere waiters yield and re-check, which keeps the
+// lightweight locks correct at the cost of burning time slices under contention.
+#if !defined(PLATFORM_LINUX)
+
+ENGINE_API void platform_futex_wait(PlatformAtomicI32 *address, i32 expected) {
+    if (platform_atomic_load_i32(address) == expected) {
+        SDL_Delay(0);
+    }
+}
+
+ENGINE_API void platform_futex_wake(PlatformAtomicI32 *address, u32 count) {
+    ENGINE_UNUSED(address);
+    ENGINE_UNUSED(count);
+}
+
+#endif // !PLATFORM_LINUX
 
 #pragma endregion
 // =============================================================================
@@ -0,0 +1,1649 @@
+#include "tests.h"
+#include <assert.h>
+#include <engine/components/position.h>
+#include <engine/components/velocity.h>
+#include <engine/ecs/command_buffer.h>
+#include <engine/ecs/ecs.h>
+#include <engine/ecs/hierarchy.h>
+#include <engine/ecs/prefab.h>
+#include <engine/ecs/system.h>
+#include <engine/job_system.h>
+#include <engine/logging.h>
+#include <engine/memory.h>
+#include <stddef.h>
+
+#define TEST_ECS_ENTITY_COUNT 1000
+
+static void test_each_movement(const EcsView *view, void *userData) {
+    u32 *visited = (u32 *)userData;
+    Position *positions = (Position *)view->columns[0];
+    const Velocity *velocities = (const Velocity *)view->columns[1];
+    for (u32 i = 0; i < view->count; ++i) {
+        assert(positions[i].x == (f32)view->entities[i]);
+        positions[i].y += velocities[i].vy;
+    }
+    *visited += view->count;
+}
+
+/**
+ * @brief Runs the shared ECS tests against one storage layout.
+ *
+ * @param storage The storage layout to test.
+ * @return void
+ */
+static void test_ecs_storage(ECSStorage storage) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    assert(ecs_memory_usage(&ecs) == 0);
+
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+    assert(positionType != INVALID_COMPONENT_TYPE && velocityType != INVALID_COMPONENT_TYPE);
+
+    static Entity entities[TEST_ECS_ENTITY_COUNT];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        entities[i] = ecs_create_entity(&ecs);
+        assert(entities[i] != INVALID_ENTITY);
+
+        Position position = {(f32)i, 0.0f, 0.0f};
+        assert(ecs_add_component(&ecs, entities[i], positionType, &position));
+        if (i % 2 == 0) {
+            assert(ecs_add_component(&ecs, entities[i], velocityType, NULL));
+        }
+    }
+    assert(ecs_component_count(&ecs, positionType) == TEST_ECS_ENTITY_COUNT);
+    assert(ecs_component_count(&ecs, velocityType) == TEST_ECS_ENTITY_COUNT / 2);
+
+    // Removing from the middle moves the last component's bytes into the hole.
+    ecs_remove_component(&ecs, entities[10], positionType);
+    assert(!ecs_has_component(&ecs, entities[10], positionType));
+    assert(ecs_has_component(&ecs, entities[10], velocityType));
+    assert(ecs_component_count(&ecs, positionType) == TEST_ECS_ENTITY_COUNT - 1);
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        const Position *position = (const Position *)ecs_get_component(&ecs, entities[i], positionType);
+        assert(i == 10 ? position == NULL : position->x == (f32)i);
+    }
+
+    if (storage == ECS_STORAGE_SPARSE_SET) {
+        const Position *moved = (const Position *)ecs_get_component(&ecs, entities[TEST_ECS_ENTITY_COUNT - 1], positionType);
+        assert(moved == (const Position *)ecs_component_data(&ecs, positionType) + 10);
+
+        // The packed array stays consistent with its entity list.
+        const Position *positions = (const Position *)ecs_component_data(&ecs, positionType);
+        const Entity *owners = ecs_component_entities(&ecs, positionType);
+        for (u32 i = 0; i < ecs_component_count(&ecs, positionType); ++i) {
+            assert(positions[i].x == (f32)owners[i]);
+        }
+    } else {
+        // Moving between archetypes keeps the other components.
+        Velocity velocity = {0.0f, 1.0f, 0.0f};
+        for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; i += 2) {
+            memory_copy(ecs_get_component(&ecs, entities[i], velocityType), &velocity, sizeof(Velocity));
+        }
+
+        // Every entity with both components is visited once, a chunk at a time.
+        ComponentType types[] = {positionType, velocityType};
+        u32 visited = 0;
+        ecs_each(&ecs, types, 2, test_each_movement, &visited);
+        assert(visited == TEST_ECS_ENTITY_COUNT / 2 - 1);
+        assert(((const Position *)ecs_get_component(&ecs, entities[2], positionType))->y == 1.0f);
+        assert(((const Position *)ecs_get_component(&ecs, entities[1], positionType))->y == 0.0f);
+
+        // Removing the last component leaves the entity in no archetype.
+        ecs_remove_component(&ecs, entities[10], velocityType);
+        assert(!ecs_has_component(&ecs, entities[10], velocityType));
+        assert(ecs_component_count(&ecs, velocityType) == TEST_ECS_ENTITY_COUNT / 2 - 1);
+        assert(ecs_add_component(&ecs, entities[10], positionType, &(Position){10.0f, 0.0f, 0.0f}));
+    }
+
+    // Destroying removes every component and recycles the index under a new
+    // generation, so the old handle stays dead.
+    assert(ecs_entity_alive(&ecs, entities[20]));
+    ecs_destroy_entity(&ecs, entities[20]);
+    assert(!ecs_entity_alive(&ecs, entities[20]));
+    assert(!ecs_has_component(&ecs, entities[20], positionType));
+    assert(!ecs_has_component(&ecs, entities[20], velocityType));
+
+    Entity reused = ecs_create_entity(&ecs);
+    assert(ecs_entity_index(reused) == ecs_entity_index(entities[20]));
+    assert(ecs_entity_generation(reused) == ecs_entity_generation(entities[20]) + 1);
+    assert(ecs_entity_alive(&ecs, reused) && !ecs_entity_alive(&ecs, entities[20]));
+    assert(ecs_add_component(&ecs, reused, positionType, NULL));
+    assert(ecs_get_component(&ecs, entities[20], positionType) == NULL);
+    assert(!ecs_add_component(&ecs, entities[20], velocityType, NULL));
+
+    // Generations keep counting while an index sits on the free list.
+    for (u32 cycle = 0; cycle < 3; ++cycle) {
+        ecs_destroy_entity(&ecs, reused);
+        Entity next = ecs_create_entity(&ecs);
+        assert(ecs_entity_index(next) == ecs_entity_index(reused));
+        assert(ecs_entity_generation(next) == ecs_entity_generation(reused) + 1);
+        assert(!ecs_entity_alive(&ecs, reused));
+        reused = next;
+    }
+    ecs_destroy_entity(&ecs, entities[20]);
+    assert(ecs_entity_alive(&ecs, reused));
+
+    ecs_shutdown(&ecs);
+    memory_pool_shutdown(&pool);
+}
+
+/**
+ * @brief Totals of a query pass, checked against the expected matches.
+ */
+typedef struct TestQueryVisit {
+    u32 rows;     /**< Rows visited. */
+    u32 optional; /**< Rows that had the optional component. */
+} TestQueryVisit;
+
+static void test_query_visit(const EcsView *view, void *userData) {
+    TestQueryVisit *visit = (TestQueryVisit *)userData;
+    const Position *positions = (const Position *)view->columns[0];
+    const Velocity *velocities = (const Velocity *)view->columns[1];
+    for (u32 i = 0; i < view->count; ++i) {
+        assert(positions[ecs_view_row(view, 0, i)].x == (f32)ecs_entity_index(view->entities[i]));
+        u32 row = ecs_view_row(view, 1, i);
+        if (row != INVALID_ID_U32) {
+            assert(velocities[row].vx == (f32)ecs_entity_index(view->entities[i]));
+            visit->optional++;
+        }
+    }
+    visit->rows += view->count;
+}
+
+/**
+ * @brief Checks required, optional and excluded query terms, and that cached
+ * queries follow structural changes.
+ *
+ * @param storage The storage layout to test.
+ * @return void
+ */
+static void test_ecs_queries(ECSStorage storage) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+    ComponentType healthType = ecs_register_component(&ecs, sizeof(f32));
+
+    // Every entity has Position, even ones Velocity, multiples of 3 Health.
+    static Entity entities[TEST_ECS_ENTITY_COUNT];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        entities[i] = ecs_create_entity(&ecs);
+        assert(ecs_add_component(&ecs, entities[i], positionType, &(Position){(f32)i, 0.0f, 0.0f}));
+        if (i % 2 == 0) {
+            assert(ecs_add_component(&ecs, entities[i], velocityType, &(Velocity){(f32)i, 0.0f, 0.0f}));
+        }
+        if (i % 3 == 0) {
+            assert(ecs_add_component(&ecs, entities[i], healthType, NULL));
+        }
+    }
+
+    ComponentType moving[] = {positionType, velocityType};
+    EcsQuery movers;
+    assert(ecs_query_init(&movers, &ecs, &(EcsQueryDesc){.required = moving, .requiredCount = 2, .excluded = &healthType, .excludedCount = 1}) == ENGINE_SUCCESS);
+    EcsQuery everyone;
+    assert(ecs_query_init(&everyone, &ecs, &(EcsQueryDesc){.required = &positionType, .requiredCount = 1, .optional = &velocityType, .optionalCount = 1}) == ENGINE_SUCCESS);
+
+    // Even, not a multiple of 3.
+    u32 expected = TEST_ECS_ENTITY_COUNT / 2 - (TEST_ECS_ENTITY_COUNT + 5) / 6;
+    TestQueryVisit visit = {0};
+    ecs_query_each(&movers, test_query_visit, &visit);
+    assert(visit.rows == expected && visit.optional == expected);
+    assert(ecs_query_count(&movers) == expected);
+
+    visit = (TestQueryVisit){0};
+    ecs_query_each(&everyone, test_query_visit, &visit);
+    assert(visit.rows == TEST_ECS_ENTITY_COUNT && visit.optional == TEST_ECS_ENTITY_COUNT / 2);
+
+    // Structural changes update the cache: an excluded type added, a
+    // required type removed, an entity destroyed.
+    assert(ecs_add_component(&ecs, entities[2], healthType, NULL));
+    ecs_remove_component(&ecs, entities[4], velocityType);
+    ecs_destroy_entity(&ecs, entities[8]);
+    assert(ecs_query_count(&movers) == expected - 3);
+
+    // Types registered after the query, and the archetypes they create, are picked up too.
+    ComponentType tagType = ecs_register_component(&ecs, sizeof(u32));
+    assert(ecs_add_component(&ecs, entities[10], tagType, NULL));
+    visit = (TestQueryVisit){0};
+    ecs_query_each(&movers, test_query_visit, &visit);
+    assert(visit.rows == expected - 3);
+
+    ecs_query_destroy(&movers);
+    ecs_query_destroy(&everyone);
+    assert(ecs.queryCount == 0);
+    ecs_shutdown(&ecs);
+    memory_pool_shutdown(&pool);
+}
+
+/**
+ * @brief Rows and entities seen by a change-filtered query pass.
+ */
+typedef struct TestChangeVisit {
+    u32 rows;                           /**< Rows in all views. */
+    b8 seen[TEST_ECS_ENTITY_COUNT + 1]; /**< Whether each entity index was visited. */
+} TestChangeVisit;
+
+static void test_change_visit(const EcsView *view, void *userData) {
+    TestChangeVisit *visit = (TestChangeVisit *)userData;
+    for (u32 i = 0; i < view->count; ++i) {
+        visit->seen[ecs_entity_index(view->entities[i])] = true;
+    }
+    visit->rows += view->count;
+}
+
+/**
+ * @brief Runs one pass of a query and records what it visited.
+ *
+ * @param query A pointer to the query.
+ * @param visit A pointer to the visit to reset and fill.
+ * @return u32 The number of rows visited.
+ */
+static u32 test_change_pass(EcsQuery *query, TestChangeVisit *visit) {
+    memory_zero(visit, sizeof(TestChangeVisit));
+    ecs_query_each(query, test_change_visit, visit);
+    return visit->rows;
+}
+
+/**
+ * @brief Checks that change-filtered queries only visit data written since
+ * their last pass, through every kind of mutable access.
+ *
+ * @param storage The storage layout to test.
+ * @return void
+ */
+static void test_ecs_changes(ECSStorage storage) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+
+    static Entity entities[TEST_ECS_ENTITY_COUNT];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        entities[i] = ecs_create_entity(&ecs);
+        assert(ecs_add_component(&ecs, entities[i], positionType, &(Position){(f32)i, 0.0f, 0.0f}));
+        assert(ecs_add_component(&ecs, entities[i], velocityType, NULL));
+    }
+
+    ComponentType moving[] = {positionType, velocityType};
+    EcsQuery watcher;
+    EcsQuery movers;
+    EcsQuery self;
+    assert(ecs_query_init(&watcher, &ecs, &(EcsQueryDesc){.required = &positionType, .requiredCount = 1, .changed = &positionType, .changedCount = 1}) == ENGINE_SUCCESS);
+    assert(ecs_query_init(&movers, &ecs, &(EcsQueryDesc){.required = moving, .requiredCount = 2, .writes = &positionType, .writeCount = 1}) == ENGINE_SUCCESS);
+    assert(ecs_query_init(&self, &ecs, &(EcsQueryDesc){.required = &positionType, .requiredCount = 1, .writes = &positionType, .writeCount = 1, .changed = &positionType, .changedCount = 1}) == ENGINE_SUCCESS);
+    EcsQuery invalid;
+    assert(ecs_query_init(&invalid, &ecs, &(EcsQueryDesc){.required = &positionType, .requiredCount = 1, .changed = &velocityType, .changedCount = 1}) == ENGINE_ERROR_INVALID_ARGUMENT);
+
+    // The first pass sees everything, the next one nothing.
+    static TestChangeVisit visit;
+    assert(test_change_pass(&watcher, &visit) == TEST_ECS_ENTITY_COUNT);
+    assert(test_change_pass(&watcher, &visit) == 0);
+
+    // Mutable access marks the entity's chunk or block, reads of other types do not.
+    ecs_get_component(&ecs, entities[500], positionType);
+    u32 rows = test_change_pass(&watcher, &visit);
+    assert(rows > 0 && rows < TEST_ECS_ENTITY_COUNT && visit.seen[ecs_entity_index(entities[500])]);
+    ecs_get_component(&ecs, entities[10], velocityType);
+    assert(test_change_pass(&watcher, &visit) == 0);
+
+    // Filtering on a type other than the one the cache walks works per entity.
+    EcsQuery accelerated;
+    assert(ecs_query_init(&accelerated, &ecs, &(EcsQueryDesc){.required = moving, .requiredCount = 2, .changed = &velocityType, .changedCount = 1}) == ENGINE_SUCCESS);
+    assert(test_change_pass(&accelerated, &visit) == TEST_ECS_ENTITY_COUNT);
+    assert(test_change_pass(&accelerated, &visit) == 0);
+    ecs_get_component(&ecs, entities[7], velocityType);
+    rows = test_change_pass(&accelerated, &visit);
+    assert(rows > 0 && rows < TEST_ECS_ENTITY_COUNT && visit.seen[ecs_entity_index(entities[7])]);
+    ecs_query_destroy(&accelerated);
+
+    // Views handed out by a query that writes the type mark it.
+    ecs_query_each(&movers, test_change_visit, &visit);
+    assert(test_change_pass(&watcher, &visit) == TEST_ECS_ENTITY_COUNT);
+
+    // A query's own writes are left for its next pass.
+    assert(test_change_pass(&self, &visit) == TEST_ECS_ENTITY_COUNT);
+    assert(test_change_pass(&self, &visit) == TEST_ECS_ENTITY_COUNT);
+    assert(test_change_pass(&watcher, &visit) == TEST_ECS_ENTITY_COUNT);
+
+    // Parallel views of unchanged data come back empty.
+    Entity spawned = ecs_create_entity(&ecs);
+    assert(ecs_add_component(&ecs, spawned, positionType, NULL));
+    rows = 0;
+    b8 sawSpawned = false;
+    u32 viewCount = ecs_query_prepare_views(&watcher, 64);
+    u32 emptyViews = 0;
+    for (u32 i = 0; i < viewCount; ++i) {
+        EcsView view;
+        ecs_query_get_view(&watcher, i, &view);
+        emptyViews += view.count == 0;
+        rows += view.count;
+        for (u32 row = 0; row < view.count; ++row) {
+            sawSpawned |= view.entities[row] == spawned;
+        }
+    }
+    assert(sawSpawned && rows < TEST_ECS_ENTITY_COUNT + 1 && emptyViews > 0);
+    assert(test_change_pass(&watcher, &visit) == 0);
+
+    ecs_query_destroy(&watcher);
+    ecs_query_destroy(&movers);
+    ecs_query_destroy(&self);
+    ecs_shutdown(&ecs);
+    memory_pool_shutdown(&pool);
+}
+
+/**
+ * @brief Checks bulk creation and destruction against the per-entity calls.
+ *
+ * @param storage The storage layout to test.
+ * @return void
+ */
+static void test_ecs_batches(ECSStorage storage) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+    ComponentType types[] = {velocityType, positionType};
+
+    // An entity made the slow way first, so batches append after existing rows.
+    Entity single = ecs_create_entity(&ecs);
+    assert(ecs_add_component(&ecs, single, positionType, NULL));
+    assert(ecs_add_component(&ecs, single, velocityType, NULL));
+
+    static Position positions[TEST_ECS_ENTITY_COUNT];
+    static Entity entities[TEST_ECS_ENTITY_COUNT];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        positions[i] = (Position){(f32)i, 1.0f, 2.0f};
+    }
+    const void *initData[] = {NULL, positions};
+    EcsQuery movers;
+    assert(ecs_query_init(&movers, &ecs, &(EcsQueryDesc){.required = types, .requiredCount = 2}) == ENGINE_SUCCESS);
+    assert(ecs_create_batch(&ecs, TEST_ECS_ENTITY_COUNT, types, 2, initData, entities) == ENGINE_SUCCESS);
+    assert(ecs_component_count(&ecs, positionType) == TEST_ECS_ENTITY_COUNT + 1);
+    assert(ecs_query_count(&movers) == TEST_ECS_ENTITY_COUNT + 1);
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        assert(ecs_entity_alive(&ecs, entities[i]));
+        const Position *position = (const Position *)ecs_get_component(&ecs, entities[i], positionType);
+        const Velocity *velocity = (const Velocity *)ecs_get_component(&ecs, entities[i], velocityType);
+        assert(position && position->x == (f32)i && position->z == 2.0f);
+        assert(velocity && velocity->vx == 0.0f);
+    }
+
+    // Destroy every even entity, one of them twice.
+    static Entity doomed[TEST_ECS_ENTITY_COUNT / 2 + 1];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT / 2; ++i) {
+        doomed[i] = entities[i * 2];
+    }
+    doomed[TEST_ECS_ENTITY_COUNT / 2] = entities[0];
+    ecs_destroy_batch(&ecs, doomed, TEST_ECS_ENTITY_COUNT / 2 + 1);
+    assert(ecs_component_count(&ecs, velocityType) == TEST_ECS_ENTITY_COUNT / 2 + 1);
+    assert(ecs_query_count(&movers) == TEST_ECS_ENTITY_COUNT / 2 + 1);
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        assert(ecs_entity_alive(&ecs, entities[i]) == (i % 2 == 1));
+        if (i % 2 == 1) {
+            assert(((const Position *)ecs_get_component(&ecs, entities[i], positionType))->x == (f32)i);
+        }
+    }
+
+    // Freed indices are reused with new generations, then fresh ones follow.
+    static Entity reborn[TEST_ECS_ENTITY_COUNT];
+    assert(ecs_create_batch(&ecs, TEST_ECS_ENTITY_COUNT, &positionType, 1, NULL, reborn) == ENGINE_SUCCESS);
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        u32 index = ecs_entity_index(reborn[i]);
+        assert(i < TEST_ECS_ENTITY_COUNT / 2 ? index % 2 == 1 && ecs_entity_generation(reborn[i]) == 1 : index > TEST_ECS_ENTITY_COUNT);
+        assert(!ecs_has_component(&ecs, reborn[i], velocityType));
+        assert(((const Position *)ecs_get_component(&ecs, reborn[i], positionType))->x == 0.0f);
+    }
+    assert(ecs_component_count(&ecs, positionType) == TEST_ECS_ENTITY_COUNT * 3 / 2 + 1);
+
+    // Entities without components, and rejected type lists.
+    Entity bare[4];
+    assert(ecs_create_batch(&ecs, 4, NULL, 0, NULL, bare) == ENGINE_SUCCESS);
+    assert(ecs_entity_alive(&ecs, bare[3]) && !ecs_has_component(&ecs, bare[3], positionType));
+    ComponentType twice[] = {positionType, positionType};
+    assert(ecs_create_batch(&ecs, 4, twice, 2, NULL, bare) == ENGINE_ERROR_INVALID_ARGUMENT);
+
+    ecs_destroy_batch(&ecs, reborn, TEST_ECS_ENTITY_COUNT);
+    ecs_destroy_batch(&ecs, entities, TEST_ECS_ENTITY_COUNT);
+    assert(ecs_component_count(&ecs, positionType) == 1 && ecs_query_count(&movers) == 1);
+
+    ecs_query_destroy(&movers);
+    ecs_shutdown(&ecs);
+    memory_pool_shutdown(&pool);
+}
+
+/**
+ * @brief Checks that a Position+Velocity group holds exactly the entities
+ * with both types, in the same order at the front of both arrays, and that
+ * each member's components moved together (position x equals velocity vx).
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param group The group's index.
+ * @param positionType The Position component type.
+ * @param velocityType The Velocity component type.
+ * @return void
+ */
+static void test_group_check(ECSManager *ecs, u32 group, ComponentType positionType, ComponentType velocityType) {
+    u32 count = ecs_group_count(ecs, group);
+    const Entity *positionEntities = ecs_component_entities(ecs, positionType);
+    const Entity *velocityEntities = ecs_component_entities(ecs, velocityType);
+    const Position *positions = (const Position *)ecs_component_data(ecs, positionType);
+    const Velocity *velocities = (const Velocity *)ecs_component_data(ecs, velocityType);
+    for (u32 i = 0; i < count; ++i) {
+        assert(positionEntities[i] == velocityEntities[i]);
+        assert(positions[i].x == velocities[i].vx);
+    }
+    for (u32 i = count; i < ecs_component_count(ecs, positionType); ++i) {
+        assert(!ecs_has_component(ecs, positionEntities[i], velocityType));
+    }
+    for (u32 i = count; i < ecs_component_count(ecs, velocityType); ++i) {
+        assert(!ecs_has_component(ecs, velocityEntities[i], positionType));
+    }
+}
+
+/**
+ * @brief Checks that owning groups stay sorted through every structural
+ * change and that matching queries iterate them as packed columns.
+ *
+ * @return void
+ */
+static void test_ecs_groups(void) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = ECS_STORAGE_SPARSE_SET;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+    ComponentType types[] = {positionType, velocityType};
+
+    // Velocities are added in reverse, so the two arrays start out of step.
+    static Entity entities[TEST_ECS_ENTITY_COUNT];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        entities[i] = ecs_create_entity(&ecs);
+        assert(ecs_add_component(&ecs, entities[i], positionType, &(Position){(f32)i, 0.0f, 0.0f}));
+    }
+    for (u32 i = TEST_ECS_ENTITY_COUNT; i-- > 0;) {
+        if (i % 3 != 0) {
+            assert(ecs_add_component(&ecs, entities[i], velocityType, &(Velocity){(f32)i, 1.0f, 0.0f}));
+        }
+    }
+
+    // A query made before the group switches to it; one with an optional
+    // term keeps its cache, which the group's reordering must refresh.
+    EcsQuery movers;
+    EcsQuery optional;
+    assert(ecs_query_init(&movers, &ecs, &(EcsQueryDesc){.required = types, .requiredCount = 2, .changed = &types[1], .changedCount = 1}) == ENGINE_SUCCESS);
+    assert(ecs_query_init(&optional, &ecs, &(EcsQueryDesc){.required = &types[0], .requiredCount = 1, .optional = &types[1], .optionalCount = 1}) == ENGINE_SUCCESS);
+    assert(ecs_query_count(&optional) == TEST_ECS_ENTITY_COUNT);
+    TestChangeVisit *visit = (TestChangeVisit *)memory_allocate(&pool, sizeof(TestChangeVisit), MEMORY_TAG_ENGINE);
+    assert(visit);
+
+    u32 group = ecs_group_create(&ecs, types, 2);
+    assert(group != INVALID_ID_U32);
+    assert(ecs_group_count(&ecs, group) == TEST_ECS_ENTITY_COUNT * 2 / 3);
+    assert(ecs_query_count(&movers) == TEST_ECS_ENTITY_COUNT * 2 / 3);
+    test_group_check(&ecs, group, positionType, velocityType);
+    assert(test_change_pass(&optional, visit) == TEST_ECS_ENTITY_COUNT);
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        assert(visit->seen[ecs_entity_index(entities[i])]);
+    }
+
+    // Owned types can't be owned twice, and groups are sparse-set only.
+    assert(ecs_group_create(&ecs, &velocityType, 1) == INVALID_ID_U32);
+
+    // Members leave and join through removes, adds and destroys.
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; i += 4) {
+        if (ecs_has_component(&ecs, entities[i], velocityType)) {
+            ecs_remove_component(&ecs, entities[i], velocityType);
+        } else {
+            Velocity *velocity = (Velocity *)ecs_add_component(&ecs, entities[i], velocityType, NULL);
+            assert(velocity);
+            velocity->vx = (f32)i;
+        }
+    }
+    test_group_check(&ecs, group, positionType, velocityType);
+    for (u32 i = 1; i < TEST_ECS_ENTITY_COUNT; i += 5) {
+        ecs_destroy_entity(&ecs, entities[i]);
+    }
+    test_group_check(&ecs, group, positionType, velocityType);
+
+    // Group-backed queries see packed columns; the filter follows writes.
+    EcsView view;
+    assert(ecs_query_prepare_views(&movers, 0) == 1);
+    ecs_query_get_view(&movers, 0, &view);
+    assert(view.count == ecs_group_count(&ecs, group) && !view.rows[0] && !view.rows[1]);
+    assert(view.entities == ecs_component_entities(&ecs, positionType));
+    assert(test_change_pass(&movers, visit) == 0);
+    ecs_get_component(&ecs, entities[2], velocityType);
+    assert(test_change_pass(&movers, visit) > 0 && visit->seen[ecs_entity_index(entities[2])]);
+    assert(test_change_pass(&movers, visit) == 0);
+
+    // ecs_each takes the group's types in any order.
+    ComponentType reversed[] = {velocityType, positionType};
+    memory_zero(visit, sizeof(TestChangeVisit));
+    ecs_each(&ecs, reversed, 2, test_change_visit, visit);
+    assert(visit->rows == ecs_group_count(&ecs, group));
+
+    // Batches join the group as they are created and leave as they are destroyed.
+    static Position positions[TEST_ECS_ENTITY_COUNT];
+    static Velocity velocities[TEST_ECS_ENTITY_COUNT];
+    static Entity batch[TEST_ECS_ENTITY_COUNT];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        positions[i] = (Position){(f32)(TEST_ECS_ENTITY_COUNT + i), 0.0f, 0.0f};
+        velocities[i] = (Velocity){(f32)(TEST_ECS_ENTITY_COUNT + i), 0.0f, 0.0f};
+    }
+    u32 before = ecs_group_count(&ecs, group);
+    assert(ecs_create_batch(&ecs, TEST_ECS_ENTITY_COUNT, types, 2, (const void *[]){positions, velocities}, batch) == ENGINE_SUCCESS);
+    assert(ecs_group_count(&ecs, group) == before + TEST_ECS_ENTITY_COUNT);
+    test_group_check(&ecs, group, positionType, velocityType);
+    ecs_destroy_batch(&ecs, entities, TEST_ECS_ENTITY_COUNT);
+    assert(ecs_group_count(&ecs, group) == TEST_ECS_ENTITY_COUNT);
+    test_group_check(&ecs, group, positionType, velocityType);
+    ecs_destroy_batch(&ecs, batch, TEST_ECS_ENTITY_COUNT);
+    assert(ecs_group_count(&ecs, group) == 0 && ecs_query_count(&movers) == 0);
+
+    memory_free(&pool, visit, MEMORY_TAG_ENGINE);
+    ecs_query_destroy(&movers);
+    ecs_query_destroy(&optional);
+    ecs_shutdown(&ecs);
+
+    config.storage = ECS_STORAGE_ARCHETYPE;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    positionType = ecs_register_component(&ecs, sizeof(Position));
+    assert(ecs_group_create(&ecs, &positionType, 1) == INVALID_ID_U32);
+    ecs_shutdown(&ecs);
+    memory_pool_shutdown(&pool);
+}
+
+/**
+ * @brief Checks that sparse pages are only allocated for ID ranges in use and
+ * that there is no fixed entity cap.
+ *
+ * @return void
+ */
+static void test_ecs_sparse_pages(void) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+
+    ECSManager ecs;
+    ECSConfig config = {0};
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+    assert(ecs_memory_usage(&ecs) == 0);
+
+    // Only the last entity gets a component, so one page backs the whole range.
+    Entity last = INVALID_ENTITY;
+    for (u32 i = 0; i < ECS_SPARSE_PAGE_SIZE * 8; ++i) {
+        last = ecs_create_entity(&ecs);
+        assert(ecs_entity_index(last) == i && ecs_entity_generation(last) == 0);
+    }
+    assert(ecs_add_component(&ecs, last, positionType, &(Position){1.0f, 2.0f, 3.0f}));
+    const ComponentArray *positions = &ecs.componentArrays[positionType];
+    u32 pages = 0;
+    for (u32 page = 0; page < positions->sparsePageCount; ++page) {
+        pages += positions->sparsePages[page] != NULL;
+    }
+    assert(pages == 1);
+    assert(ecs.componentArrays[velocityType].sparsePageCount == 0);
+    assert(!ecs_has_component(&ecs, ecs_entity_make(0, 0), positionType));
+    assert(((const Position *)ecs_get_component(&ecs, last, positionType))->z == 3.0f);
+
+    // Dense arrays grow past their initial capacity without losing data.
+    for (u32 i = 0; i < ECS_DENSE_INITIAL_CAPACITY * 4; ++i) {
+        assert(ecs_add_component(&ecs, ecs_entity_make(i, 0), velocityType, &(Velocity){(f32)i, 0.0f, 0.0f}));
+    }
+    for (u32 i = 0; i < ECS_DENSE_INITIAL_CAPACITY * 4; ++i) {
+        assert(((const Velocity *)ecs_get_component(&ecs, ecs_entity_make(i, 0), velocityType))->vx == (f32)i);
+    }
+
+    ecs_shutdown(&ecs);
+    memory_pool_shutdown(&pool);
+}
+
+/**
+ * @brief Shared state of the scheduler test systems.
+ */
+typedef struct TestSystemState {
+    PlatformAtomicI32 rows; /**< Rows the integrate system has processed this run. */
+    PlatformAtomicI32 runs; /**< Update systems that have run this run. */
+} TestSystemState;
+
+static void test_system_integrate(const EcsView *view, const EcsSystemContext *context) {
+    TestSystemState *state = (TestSystemState *)context->userData;
+    Position *positions = (Position *)view->columns[0];
+    const Velocity *velocities = (const Velocity *)view->columns[1];
+    for (u32 i = 0; i < view->count; ++i) {
+        positions[ecs_view_row(view, 0, i)].x += velocities[ecs_view_row(view, 1, i)].vx * context->deltaTime;
+    }
+    platform_atomic_fetch_add_i32(&state->rows, (i32)view->count);
+}
+
+// Depends on the integrate system, so every one of its views must be done.
+static void test_system_after_integrate(const EcsSystemContext *context) {
+    TestSystemState *state = (TestSystemState *)context->userData;
+    assert(platform_atomic_load_i32(&state->rows) == TEST_ECS_ENTITY_COUNT / 2);
+    platform_atomic_fetch_add_i32(&state->runs, 1);
+}
+
+static void test_system_independent(const EcsSystemContext *context) {
+    TestSystemState *state = (TestSystemState *)context->userData;
+    platform_atomic_fetch_add_i32(&state->runs, 1);
+}
+
+/**
+ * @brief Checks the scheduler's dependency graph, that dependents run after
+ * every view of a split query system, and that the graph is reused across runs.
+ *
+ * @param storage The storage layout to test.
+ * @param workerCount Job system workers, or 0 to run without the job system.
+ * @return void
+ */
+static void test_ecs_systems(ECSStorage storage, u32 workerCount) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+    if (workerCount) {
+        JobSystemConfig jobConfig = {0};
+        jobConfig.workerCount = workerCount;
+        assert(job_system_init(&pool, &jobConfig) == ENGINE_SUCCESS);
+    }
+
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+    ComponentType healthType = ecs_register_component(&ecs, sizeof(f32));
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        Entity entity = ecs_create_entity(&ecs);
+        assert(ecs_add_component(&ecs, entity, positionType, &(Position){(f32)i, 0.0f, 0.0f}));
+        if (i % 2 == 0) {
+            assert(ecs_add_component(&ecs, entity, velocityType, &(Velocity){(f32)i, 0.0f, 0.0f}));
+        }
+        assert(ecs_add_component(&ecs, entity, healthType, NULL));
+    }
+
+    ComponentType moving[] = {positionType, velocityType};
+    EcsQuery movers;
+    assert(ecs_query_init(&movers, &ecs, &(EcsQueryDesc){.required = moving, .requiredCount = 2}) == ENGINE_SUCCESS);
+
+    // Views cover every match exactly once.
+    u32 viewCount = ecs_query_prepare_views(&movers, 100);
+    u32 rows = 0;
+    for (u32 i = 0; i < viewCount; ++i) {
+        EcsView view;
+        ecs_query_get_view(&movers, i, &view);
+        assert(view.count > 0);
+        rows += view.count;
+    }
+    assert(viewCount > 1 && rows == TEST_ECS_ENTITY_COUNT / 2);
+
+    TestSystemState state;
+    EcsScheduler scheduler;
+    assert(ecs_scheduler_init(&scheduler, &ecs) == ENGINE_SUCCESS);
+    u32 integrate = ecs_scheduler_add_system(&scheduler, &(EcsSystemDesc){.name = "TestIntegrate", .reads = &velocityType, .readCount = 1, .writes = &positionType, .writeCount = 1, .query = &movers, .each = test_system_integrate, .grainSize = 100, .userData = &state});
+    u32 damp = ecs_scheduler_add_system(&scheduler, &(EcsSystemDesc){.name = "TestDamp", .writes = &velocityType, .writeCount = 1, .update = test_system_after_integrate, .userData = &state});
+    u32 heal = ecs_scheduler_add_system(&scheduler, &(EcsSystemDesc){.name = "TestHeal", .writes = &healthType, .writeCount = 1, .update = test_system_independent, .userData = &state});
+    u32 render = ecs_scheduler_add_system(&scheduler, &(EcsSystemDesc){.name = "TestRender", .reads = moving, .readCount = 2, .update = test_system_after_integrate, .userData = &state});
+    assert(ecs_scheduler_add_system(&scheduler, &(EcsSystemDesc){.name = "TestInvalid"}) == INVALID_ID_U32);
+
+    for (u32 run = 1; run <= 2; ++run) {
+        memory_zero(&state, sizeof(state));
+        ecs_scheduler_run(&scheduler, 1.0f);
+        assert(platform_atomic_load_i32(&state.runs) == 3);
+        assert(scheduler.lastCriticalPathSeconds <= scheduler.lastWallSeconds);
+
+        viewCount = ecs_query_prepare_views(&movers, 0);
+        for (u32 i = 0; i < viewCount; ++i) {
+            EcsView view;
+            ecs_query_get_view(&movers, i, &view);
+            const Position *positions = (const Position *)view.columns[0];
+            for (u32 row = 0; row < view.count; ++row) {
+                assert(positions[ecs_view_row(&view, 0, row)].x == (f32)(ecs_entity_index(view.entities[row]) * (run + 1)));
+            }
+        }
+    }
+
+    // Integrate and Heal start the run. Damp writes what Integrate reads;
+    // Render reads what Integrate and Damp write.
+    assert(scheduler.rootCount == 2 && scheduler.roots[0] == integrate && scheduler.roots[1] == heal);
+    assert(scheduler.systems[damp].dependencyCount == 1 && scheduler.systems[render].dependencyCount == 2);
+    assert(scheduler.systems[heal].dependents[0] == 0);
+
+    ecs_query_destroy(&movers);
+    ecs_shutdown(&ecs);
+    if (workerCount) {
+        job_system_shutdown();
+    }
+    memory_pool_shutdown(&pool);
+}
+
+// Spawns one entity per row, carrying the source Position, and removes
+// Velocity from the source.
+static void test_system_spawn(const EcsView *view, const EcsSystemContext *context) {
+    const ComponentType *types = (const ComponentType *)context->userData;
+    EcsCommandBuffer *buffer = ecs_command_queue_get_buffer(context->commands);
+    const Position *positions = (const Position *)view->columns[0];
+    for (u32 i = 0; i < view->count; ++i) {
+        Entity spawned = ecs_command_create_entity(buffer, context->sortKey);
+        ecs_command_add_component(buffer, context->sortKey, spawned, types[0], &positions[ecs_view_row(view, 0, i)]);
+        ecs_command_remove_component(buffer, context->sortKey, view->entities[i], types[1]);
+    }
+}
+
+/**
+ * @brief Checks that recorded commands only apply at playback, that pending
+ * handles resolve, and that entities spawned from parallel systems come out
+ * in the same order as a serial walk of the query.
+ *
+ * @param storage The storage layout to test.
+ * @param workerCount Job system workers, or 0 to run without the job system.
+ * @return void
+ */
+static void test_ecs_commands(ECSStorage storage, u32 workerCount) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 8) == ENGINE_SUCCESS);
+    if (workerCount) {
+        JobSystemConfig jobConfig = {0};
+        jobConfig.workerCount = workerCount;
+        assert(job_system_init(&pool, &jobConfig) == ENGINE_SUCCESS);
+    }
+
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    ComponentType types[] = {ecs_register_component(&ecs, sizeof(Position)), ecs_register_component(&ecs, sizeof(Velocity))};
+    static Entity entities[TEST_ECS_ENTITY_COUNT];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        entities[i] = ecs_create_entity(&ecs);
+        assert(ecs_add_component(&ecs, entities[i], types[0], &(Position){(f32)i, 0.0f, 0.0f}));
+        if (i % 2 == 0) {
+            assert(ecs_add_component(&ecs, entities[i], types[1], NULL));
+        }
+    }
+
+    EcsCommandQueue queue;
+    assert(ecs_command_queue_init(&queue, &ecs) == ENGINE_SUCCESS);
+
+    // Nothing changes until playback; a pending handle works in later commands.
+    EcsCommandBuffer *buffer = ecs_command_queue_get_buffer(&queue);
+    Entity pending = ecs_command_create_entity(buffer, 0);
+    assert(ecs_entity_is_pending(pending) && !ecs_entity_alive(&ecs, pending));
+    Position *staged = (Position *)ecs_command_add_component(buffer, 0, pending, types[0], &(Position){1.0f, 2.0f, 3.0f});
+    staged->z = 4.0f;
+    ecs_command_add_component(buffer, 0, entities[1], types[1], &(Velocity){5.0f, 0.0f, 0.0f});
+    ecs_command_remove_component(buffer, 0, entities[2], types[1]);
+    ecs_command_destroy_entity(buffer, 0, entities[3]);
+    assert(ecs_component_count(&ecs, types[0]) == TEST_ECS_ENTITY_COUNT && ecs_entity_alive(&ecs, entities[3]));
+
+    assert(ecs_command_queue_flush(&queue) == 5);
+    Entity created = ecs_entity_make(TEST_ECS_ENTITY_COUNT, 0);
+    assert(ecs_entity_alive(&ecs, created) && ((const Position *)ecs_get_component(&ecs, created, types[0]))->z == 4.0f);
+    assert(((const Velocity *)ecs_get_component(&ecs, entities[1], types[1]))->vx == 5.0f);
+    assert(!ecs_has_component(&ecs, entities[2], types[1]));
+    assert(!ecs_entity_alive(&ecs, entities[3]));
+    assert(ecs_command_queue_flush(&queue) == 0);
+
+    // The order a serial walk of the query sees the movers in.
+    EcsQuery movers;
+    assert(ecs_query_init(&movers, &ecs, &(EcsQueryDesc){.required = types, .requiredCount = 2}) == ENGINE_SUCCESS);
+    static f32 expected[TEST_ECS_ENTITY_COUNT];
+    u32 expectedCount = 0;
+    u32 viewCount = ecs_query_prepare_views(&movers, 16);
+    for (u32 i = 0; i < viewCount; ++i) {
+        EcsView view;
+        ecs_query_get_view(&movers, i, &view);
+        for (u32 row = 0; row < view.count; ++row) {
+            expected[expectedCount++] = ((const Position *)view.columns[0])[ecs_view_row(&view, 0, row)].x;
+        }
+    }
+
+    static EcsScheduler scheduler;
+    assert(ecs_scheduler_init(&scheduler, &ecs) == ENGINE_SUCCESS);
+    scheduler.commands = &queue;
+    ecs_scheduler_add_system(&scheduler, &(EcsSystemDesc){.name = "TestSpawn", .reads = types, .readCount = 2, .query = &movers, .each = test_system_spawn, .grainSize = 16, .userData = types});
+    ecs_scheduler_run(&scheduler, 1.0f);
+
+    // Spawned entities take indices in key order, whichever worker recorded
+    // them: first the one freed by the destroy above, then fresh ones.
+    assert(ecs_query_count(&movers) == 0);
+    for (u32 i = 0; i < expectedCount; ++i) {
+        Entity spawned = i == 0 ? ecs_entity_make(ecs_entity_index(entities[3]), 1) : ecs_entity_make(TEST_ECS_ENTITY_COUNT + i, 0);
+        const Position *position = (const Position *)ecs_get_component(&ecs, spawned, types[0]);
+        assert(position && position->x == expected[i]);
+    }
+
+    ecs_query_destroy(&movers);
+    ecs_command_queue_shutdown(&queue);
+    ecs_shutdown(&ecs);
+    if (workerCount) {
+        job_system_shutdown();
+    }
+    memory_pool_shutdown(&pool);
+}
+
+/**
+ * @brief Checks that a hierarchy's slots are in depth-first order: every
+ * parent before its children and every subtree contiguous inside its
+ * parent's.
+ *
+ * @param hierarchy A pointer to the hierarchy, just updated.
+ * @return void
+ */
+static void test_hierarchy_order(const EcsHierarchy *hierarchy) {
+    assert(hierarchy->slotCount == hierarchy->nodeCount);
+    for (u32 slot = 0; slot < hierarchy->slotCount; ++slot) {
+        u32 parent = hierarchy->parents[slot];
+        assert(hierarchy->ends[slot] > slot && hierarchy->ends[slot] <= hierarchy->slotCount);
+        assert(parent == INVALID_ID_U32 || (parent < slot && hierarchy->ends[slot] <= hierarchy->ends[parent]));
+        assert(hierarchy->flags[slot] == 0);
+    }
+}
+
+/**
+ * @brief Checks transform composition, dirty-subtree skipping, reparenting
+ * and removal, and a forest large enough to update in parallel.
+ *
+ * @param workerCount Job system workers, or 0 to run without the job system.
+ * @return void
+ */
+static void test_ecs_hierarchy(u32 workerCount) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 8) == ENGINE_SUCCESS);
+    if (workerCount) {
+        JobSystemConfig jobConfig = {0};
+        jobConfig.workerCount = workerCount;
+        assert(job_system_init(&pool, &jobConfig) == ENGINE_SUCCESS);
+    }
+
+    ECSManager ecs;
+    ECSConfig config = {0};
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    EcsHierarchy hierarchy;
+    assert(ecs_hierarchy_init(&hierarchy, &ecs) == ENGINE_SUCCESS);
+
+    // A is turned a quarter turn at (10, 0); B doubles in size one unit along
+    // A's x axis, which A's rotation points up; C sits one unit along B's x.
+    Entity a = ecs_create_entity(&ecs);
+    Entity b = ecs_create_entity(&ecs);
+    Entity c = ecs_create_entity(&ecs);
+    Entity d = ecs_create_entity(&ecs);
+    assert(ecs_hierarchy_add(&hierarchy, c, INVALID_ENTITY, NULL) == ENGINE_SUCCESS);
+    assert(ecs_hierarchy_add(&hierarchy, a, INVALID_ENTITY, &(Transform){10.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f}) == ENGINE_SUCCESS);
+    assert(ecs_hierarchy_add(&hierarchy, b, a, &(Transform){1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 2.0f, 2.0f}) == ENGINE_SUCCESS);
+    assert(ecs_hierarchy_set_parent(&hierarchy, c, b) == ENGINE_SUCCESS);
+    *ecs_hierarchy_local(&hierarchy, c) = (Transform){1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f};
+    assert(ecs_hierarchy_add(&hierarchy, b, INVALID_ENTITY, NULL) != ENGINE_SUCCESS);
+    assert(ecs_hierarchy_add(&hierarchy, d, ecs_entity_make(ecs_entity_index(d) + 1, 0), NULL) != ENGINE_SUCCESS);
+    assert(ecs_hierarchy_set_parent(&hierarchy, a, c) != ENGINE_SUCCESS);
+    assert(ecs_hierarchy_set_parent(&hierarchy, a, a) != ENGINE_SUCCESS);
+
+    assert(ecs_hierarchy_update(&hierarchy) == 3);
+    test_hierarchy_order(&hierarchy);
+    assert(ecs_hierarchy_parent(&hierarchy, c) == b && ecs_hierarchy_parent(&hierarchy, a) == INVALID_ENTITY);
+    const WorldTransform *world = ecs_hierarchy_world(&hierarchy, b);
+    assert(world->x == 10.0f && world->y == 1.0f && world->a == 0.0f && world->b == 2.0f && world->c == -2.0f);
+    world = ecs_hierarchy_world(&hierarchy, c);
+    assert(world->x == 10.0f && world->y == 3.0f && world->z == 3.0f);
+
+    // Clean subtrees are skipped; a change recomputes the node and below.
+    assert(ecs_hierarchy_update(&hierarchy) == 0);
+    ecs_hierarchy_local(&hierarchy, c)->x = 2.0f;
+    assert(ecs_hierarchy_update(&hierarchy) == 1);
+    assert(ecs_hierarchy_world(&hierarchy, c)->y == 5.0f);
+    ecs_hierarchy_local(&hierarchy, a)->y = 1.0f;
+    assert(ecs_hierarchy_update(&hierarchy) == 3);
+    assert(ecs_hierarchy_world(&hierarchy, c)->y == 6.0f);
+
+    // Detached, C keeps its local transform; removing A takes B and D along.
+    assert(ecs_hierarchy_set_parent(&hierarchy, c, INVALID_ENTITY) == ENGINE_SUCCESS);
+    assert(ecs_hierarchy_add(&hierarchy, d, b, NULL) == ENGINE_SUCCESS);
+    assert(ecs_hierarchy_update(&hierarchy) == 2);
+    world = ecs_hierarchy_world(&hierarchy, c);
+    assert(world->x == 2.0f && world->y == 0.0f && world->z == 1.0f);
+    assert(ecs_hierarchy_world(&hierarchy, d)->x == 10.0f);
+    ecs_hierarchy_remove(&hierarchy, a);
+    assert(!ecs_hierarchy_world(&hierarchy, a) && !ecs_hierarchy_world(&hierarchy, b) && !ecs_hierarchy_world(&hierarchy, d));
+    assert(hierarchy.nodeCount == 1 && ecs_hierarchy_update(&hierarchy) == 0);
+    test_hierarchy_order(&hierarchy);
+
+    // An index reused by a new entity replaces the stale node.
+    ecs_destroy_entity(&ecs, c);
+    Entity reused = ecs_create_entity(&ecs);
+    assert(ecs_entity_index(reused) == ecs_entity_index(c));
+    assert(ecs_hierarchy_add(&hierarchy, reused, INVALID_ENTITY, NULL) == ENGINE_SUCCESS);
+    assert(hierarchy.nodeCount == 1 && ecs_hierarchy_update(&hierarchy) == 1);
+    ecs_hierarchy_remove(&hierarchy, reused);
+
+    // A forest of chains past the serial threshold: link k of chain i sits at
+    // x = i + k. Touching a link recomputes only the rest of its chain.
+    enum { CHAIN_COUNT = 64, CHAIN_LENGTH = 80 };
+    static Entity chains[CHAIN_COUNT][CHAIN_LENGTH];
+    for (u32 k = 0; k < CHAIN_LENGTH; ++k) {
+        for (u32 i = 0; i < CHAIN_COUNT; ++i) {
+            Transform local = transform_identity();
+            local.x = k == 0 ? (f32)i : 1.0f;
+            chains[i][k] = ecs_create_entity(&ecs);
+            assert(ecs_hierarchy_add(&hierarchy, chains[i][k], k == 0 ? INVALID_ENTITY : chains[i][k - 1], &local) == ENGINE_SUCCESS);
+        }
+    }
+    assert(hierarchy.nodeCount >= ECS_HIERARCHY_SERIAL_THRESHOLD);
+    assert(ecs_hierarchy_update(&hierarchy) == CHAIN_COUNT * CHAIN_LENGTH);
+    test_hierarchy_order(&hierarchy);
+    for (u32 i = 0; i < CHAIN_COUNT; ++i) {
+        for (u32 k = 0; k < CHAIN_LENGTH; ++k) {
+            assert(ecs_hierarchy_world(&hierarchy, chains[i][k])->x == (f32)(i + k));
+        }
+    }
+    ecs_hierarchy_local(&hierarchy, chains[3][CHAIN_LENGTH - 10])->x = 2.0f;
+    ecs_hierarchy_local(&hierarchy, chains[40][0])->y = 1.0f;
+    assert(ecs_hierarchy_update(&hierarchy) == 10 + CHAIN_LENGTH);
+    assert(ecs_hierarchy_world(&hierarchy, chains[3][CHAIN_LENGTH - 1])->x == (f32)(3 + CHAIN_LENGTH));
+    assert(ecs_hierarchy_world(&hierarchy, chains[40][CHAIN_LENGTH - 1])->y == 1.0f);
+    assert(ecs_hierarchy_world(&hierarchy, chains[41][CHAIN_LENGTH - 1])->y == 0.0f);
+
+    ecs_hierarchy_shutdown(&hierarchy);
+    ecs_shutdown(&ecs);
+    if (workerCount) {
+        job_system_shutdown();
+    }
+    memory_pool_shutdown(&pool);
+}
+
+/** @brief Test component referring to another entity. */
+typedef struct TestOwner {
+    f32 weight;   /**< Payload before the handle, so the field is not at offset 0. */
+    Entity owner; /**< The entity this one belongs to. */
+} TestOwner;
+
+/**
+ * @brief Checks that prefab instances get their template's components,
+ * relative handles remapped to their own entities, absolute handles kept,
+ * and their parent links in a hierarchy, across more than one round.
+ *
+ * @param storage The storage layout to test.
+ * @return void
+ */
+static void test_ecs_prefabs(ECSStorage storage) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 16) == ENGINE_SUCCESS);
+
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+    ComponentType ownerType = ecs_register_component(&ecs, sizeof(TestOwner));
+    Entity world = ecs_create_entity(&ecs);
+
+    // A root, two children owned by the root, a grandchild owned by the
+    // world entity, and a bare marker entity.
+    EcsPrefab prefab;
+    assert(ecs_prefab_init(&prefab, &ecs) == ENGINE_SUCCESS);
+    assert(ecs_prefab_entity_field(&prefab, ownerType, sizeof(TestOwner) - 4) != ENGINE_SUCCESS);
+    assert(ecs_prefab_entity_field(&prefab, ownerType, offsetof(TestOwner, owner)) == ENGINE_SUCCESS);
+    u32 root = ecs_prefab_add_entity(&prefab, INVALID_ID_U32, NULL);
+    u32 left = ecs_prefab_add_entity(&prefab, root, &(Transform){-1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f});
+    u32 right = ecs_prefab_add_entity(&prefab, root, &(Transform){1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f});
+    u32 grandchild = ecs_prefab_add_entity(&prefab, right, NULL);
+    u32 marker = ecs_prefab_add_entity(&prefab, INVALID_ID_U32, NULL);
+    assert(ecs_prefab_add_entity(&prefab, 9, NULL) == INVALID_ID_U32);
+    ecs_prefab_set(&prefab, root, positionType, &(Position){1.0f, 2.0f, 3.0f});
+    ecs_prefab_set(&prefab, root, velocityType, &(Velocity){4.0f, 0.0f, 0.0f});
+    ecs_prefab_set(&prefab, left, positionType, &(Position){5.0f, 0.0f, 0.0f});
+    ecs_prefab_set(&prefab, left, ownerType, &(TestOwner){0.5f, ecs_prefab_ref(root)});
+    ecs_prefab_set(&prefab, right, ownerType, &(TestOwner){0.25f, ecs_prefab_ref(root)});
+    ecs_prefab_set(&prefab, right, positionType, &(Position){6.0f, 0.0f, 0.0f});
+    ecs_prefab_set(&prefab, grandchild, ownerType, &(TestOwner){1.0f, world});
+    assert(ecs_prefab_set(&prefab, root, ECS_MAX_COMPONENTS, NULL) == NULL);
+
+    EcsHierarchy hierarchy;
+    assert(ecs_hierarchy_init(&hierarchy, &ecs) == ENGINE_SUCCESS);
+    enum { INSTANCE_COUNT = ECS_PREFAB_ROUND_INSTANCES + 100 };
+    Entity *instances = (Entity *)memory_allocate(&pool, sizeof(Entity) * INSTANCE_COUNT * 5, MEMORY_TAG_ENGINE);
+    assert(instances);
+    assert(ecs_prefab_instantiate(&prefab, INSTANCE_COUNT, &hierarchy, instances) == ENGINE_SUCCESS);
+    assert(prefab.partCount == 4);
+    assert(ecs_component_count(&ecs, positionType) == INSTANCE_COUNT * 3);
+    assert(ecs_component_count(&ecs, velocityType) == INSTANCE_COUNT);
+    assert(ecs_component_count(&ecs, ownerType) == INSTANCE_COUNT * 3);
+    assert(hierarchy.nodeCount == INSTANCE_COUNT * 5);
+    for (u32 i = 0; i < INSTANCE_COUNT; ++i) {
+        const Entity *instance = instances + i * 5;
+        for (u32 e = 0; e < 5; ++e) {
+            assert(ecs_entity_alive(&ecs, instance[e]));
+        }
+        assert(((const Position *)ecs_get_component(&ecs, instance[root], positionType))->z == 3.0f);
+        assert(((const Velocity *)ecs_get_component(&ecs, instance[root], velocityType))->vx == 4.0f);
+        assert(((const Position *)ecs_get_component(&ecs, instance[right], positionType))->x == 6.0f);
+        const TestOwner *owner = (const TestOwner *)ecs_get_component(&ecs, instance[left], ownerType);
+        assert(owner->owner == instance[root] && owner->weight == 0.5f);
+        assert(((const TestOwner *)ecs_get_component(&ecs, instance[right], ownerType))->owner == instance[root]);
+        assert(((const TestOwner *)ecs_get_component(&ecs, instance[grandchild], ownerType))->owner == world);
+        assert(!ecs_has_component(&ecs, instance[marker], positionType));
+        assert(ecs_hierarchy_parent(&hierarchy, instance[grandchild]) == instance[right]);
+        assert(ecs_hierarchy_parent(&hierarchy, instance[marker]) == INVALID_ENTITY);
+    }
+    assert(ecs_hierarchy_update(&hierarchy) == INSTANCE_COUNT * 5);
+    assert(ecs_hierarchy_world(&hierarchy, instances[right])->x == 1.0f);
+
+    // Editing the template re-bakes it for later instances only.
+    ecs_prefab_set(&prefab, left, ownerType, &(TestOwner){0.75f, ecs_prefab_ref(right)});
+    Entity single[5];
+    assert(ecs_prefab_instantiate(&prefab, 1, NULL, single) == ENGINE_SUCCESS);
+    assert(((const TestOwner *)ecs_get_component(&ecs, single[left], ownerType))->owner == single[right]);
+    assert(((const TestOwner *)ecs_get_component(&ecs, instances[left], ownerType))->owner == instances[root]);
+
+    // A handle to an entity the prefab does not have is rejected.
+    ecs_prefab_set(&prefab, left, ownerType, &(TestOwner){0.0f, ecs_prefab_ref(5)});
+    assert(ecs_prefab_instantiate(&prefab, 1, NULL, single) != ENGINE_SUCCESS);
+    assert(ecs_component_count(&ecs, ownerType) == (INSTANCE_COUNT + 1) * 3);
+
+    memory_free(&pool, instances, MEMORY_TAG_ENGINE);
+    ecs_prefab_shutdown(&prefab);
+    ecs_hierarchy_shutdown(&hierarchy);
+    ecs_shutdown(&ecs);
+    memory_pool_shutdown(&pool);
+}
+
+/** @brief Test component with a stricter alignment than archetype columns guarantee. */
+typedef struct TestWide {
+    _Alignas(32) f32 lanes[8]; /**< One 256-bit vector. */
+} TestWide;
+
+ECS_COMPONENT(TestWide)
+
+/**
+ * @brief Checks that ECS_COMPONENT types have the same ID and metadata in
+ * every ECS, that runtime types follow them, and that archetype columns honour
+ * a declared alignment above ECS_COLUMN_ALIGNMENT.
+ *
+ * @return void
+ */
+static void test_ecs_static_components(void) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+    assert(ECS_ID(Position) != INVALID_COMPONENT_TYPE && ECS_ID(Velocity) != INVALID_COMPONENT_TYPE && ECS_ID(TestWide) != INVALID_COMPONENT_TYPE);
+    assert(ECS_ID(Position) != ECS_ID(Velocity) && ECS_ID(TestWide) < ecs_component_declared_count());
+    assert(ecs_component_declare("Broken", 8, 3) == INVALID_COMPONENT_TYPE);
+
+    for (u32 storage = 0; storage < 2; ++storage) {
+        ECSManager ecs;
+        ECSConfig config = {0};
+        config.storage = storage == 0 ? ECS_STORAGE_SPARSE_SET : ECS_STORAGE_ARCHETYPE;
+        assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+        assert(ecs.registeredComponents == ecs_component_declared_count());
+        const ComponentArray *wide = &ecs.componentArrays[ECS_ID(TestWide)];
+        assert(wide->size == sizeof(TestWide) && wide->alignment == 32);
+        assert(ecs.componentArrays[ECS_ID(Position)].size == sizeof(Position));
+        assert(ecs.componentArrays[ECS_ID(Position)].name && ecs.componentArrays[ECS_ID(Position)].name[0] == 'P');
+
+        // Runtime types come after the declared ones and guess their alignment.
+        ComponentType runtime = ecs_register_component(&ecs, 12);
+        assert(runtime == ecs_component_declared_count() && ecs.componentArrays[runtime].alignment == 4 && !ecs.componentArrays[runtime].name);
+
+        // A Position column pushes the wide column off a 32-byte boundary unless its alignment is used.
+        ComponentType types[] = {ECS_ID(Position), ECS_ID(TestWide)};
+        EcsSignature mask = ecs_signature_make(types, 2);
+        for (u32 i = 0; i < 3; ++i) {
+            Entity entity = ecs_create_entity(&ecs);
+            assert(ecs_add_component(&ecs, entity, ECS_ID(Position), &(Position){(f32)i, 0.0f, 0.0f}));
+            TestWide *lanes = (TestWide *)ecs_add_component(&ecs, entity, ECS_ID(TestWide), NULL);
+            assert(lanes && ((uintptr_t)lanes & 31) == 0);
+        }
+        if (config.storage == ECS_STORAGE_ARCHETYPE) {
+            assert(ecs.archetypeCount >= 1 && ecs_signature_contains(&ecs.archetypes[ecs.archetypeCount - 1].signature, &mask));
+        }
+        ecs_shutdown(&ecs);
+    }
+    memory_pool_shutdown(&pool);
+}
+
+/**
+ * @brief Checks the vector signature compare against a scalar reference, and
+ * that entity signatures follow adds, removes, batches and destruction.
+ *
+ * @param storage The storage layout to test.
+ * @return void
+ */
+static void test_ecs_signatures(ECSStorage storage) {
+    // The vector compare agrees with a word-by-word reference on random sets.
+    u32 seed = 0x9E3779B9u;
+    for (u32 round = 0; round < 1000; ++round) {
+        EcsSignature sets[3];
+        for (u32 s = 0; s < 3; ++s) {
+            for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+                u64 bits = 0;
+                for (u32 part = 0; part < 4; ++part) {
+                    seed ^= seed << 13;
+                    seed ^= seed >> 17;
+                    seed ^= seed << 5;
+                    bits = (bits << 16) | (seed & 0xFFFF);
+                }
+                // Sparse masks, so some of them match.
+                sets[s].bits[word] = s == 0 ? bits : bits & (bits >> 7) & (bits >> 13) & (bits >> 29);
+            }
+        }
+        b8 expected = true;
+        for (u32 word = 0; word < ECS_SIGNATURE_WORDS; ++word) {
+            expected &= (sets[1].bits[word] & ~sets[0].bits[word]) == 0 && (sets[2].bits[word] & sets[0].bits[word]) == 0;
+        }
+        assert(ecs_signature_matches(&sets[0], &sets[1], &sets[2]) == expected);
+        assert(ecs_signature_matches(&sets[0], &(EcsSignature){0}, &(EcsSignature){0}));
+    }
+
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+
+    // Spread the types over more than one signature word.
+    ComponentType types[3];
+    for (u32 i = 0; i < 70; ++i) {
+        ComponentType type = ecs_register_component(&ecs, sizeof(u32));
+        types[0] = i == 3 ? type : types[0];
+        types[1] = i == 40 ? type : types[1];
+        types[2] = i == 69 ? type : types[2];
+    }
+
+    Entity entity = ecs_create_entity(&ecs);
+    const EcsSignature *signature = ecs_entity_signature(&ecs, entity);
+    assert(signature && !ecs_signature_has(signature, types[0]) && !ecs_signature_has(signature, types[2]));
+    ecs_add_component(&ecs, entity, types[0], NULL);
+    ecs_add_component(&ecs, entity, types[2], NULL);
+    EcsSignature both = ecs_signature_make((ComponentType[]){types[0], types[2]}, 2);
+    assert(ecs_signature_equal(ecs_entity_signature(&ecs, entity), &both));
+
+    EcsQuery query;
+    EcsQueryDesc desc = {0};
+    desc.required = &types[2];
+    desc.requiredCount = 1;
+    desc.excluded = &types[0];
+    desc.excludedCount = 1;
+    assert(ecs_query_init(&query, &ecs, &desc) == ENGINE_SUCCESS);
+    assert(!ecs_query_matches(&query, entity) && ecs_query_count(&query) == 0);
+    ecs_remove_component(&ecs, entity, types[0]);
+    assert(ecs_query_matches(&query, entity) && ecs_query_count(&query) == 1);
+    assert(!ecs_has_component(&ecs, entity, types[0]) && ecs_has_component(&ecs, entity, types[2]));
+
+    // Batches set every entity's signature; destroyed handles have none.
+    Entity batch[4];
+    assert(ecs_create_batch(&ecs, 4, &types[1], 2, NULL, batch) == ENGINE_SUCCESS);
+    EcsSignature pair = ecs_signature_make(&types[1], 2);
+    for (u32 i = 0; i < 4; ++i) {
+        assert(ecs_signature_equal(ecs_entity_signature(&ecs, batch[i]), &pair) && ecs_query_matches(&query, batch[i]));
+    }
+    assert(ecs_query_count(&query) == 5);
+    ecs_destroy_entity(&ecs, entity);
+    assert(!ecs_entity_signature(&ecs, entity) && !ecs_query_matches(&query, entity));
+    Entity reused = ecs_create_entity(&ecs);
+    assert(ecs_signature_equal(ecs_entity_signature(&ecs, reused), &(EcsSignature){0}) && ecs_query_count(&query) == 4);
+
+    ecs_query_destroy(&query);
+    ecs_shutdown(&ecs);
+    memory_pool_shutdown(&pool);
+}
+
+ECS_TAG(TestEnemy)
+
+/** @brief Counts rows of a tag query and rows that had its optional tag. */
+static void test_tag_visit(const EcsView *view, void *userData) {
+    TestQueryVisit *visit = (TestQueryVisit *)userData;
+    for (u32 i = 0; i < view->count; ++i) {
+        assert(ecs_view_row(view, 1, i) != INVALID_ID_U32);
+        visit->optional += ecs_view_row(view, 2, i) != INVALID_ID_U32;
+    }
+    visit->rows += view->count;
+}
+
+/**
+ * @brief Checks that tags are filtered on like components, report presence
+ * through component pointers and views, and allocate no data.
+ *
+ * @param storage The storage layout to test.
+ * @return void
+ */
+static void test_ecs_tags(ECSStorage storage) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 8) == ENGINE_SUCCESS);
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    assert(ecs.componentArrays[ECS_ID(TestEnemy)].size == 0);
+    ComponentType selected = ecs_register_tag(&ecs);
+    ComponentType frozen = ecs_register_tag(&ecs);
+    assert(selected != INVALID_COMPONENT_TYPE && ecs.componentArrays[selected].size == 0);
+
+    // Every entity has a Position; even ones are enemies, every third is selected.
+    Entity entities[TEST_ECS_ENTITY_COUNT];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        entities[i] = ecs_create_entity(&ecs);
+        assert(ecs_add_component(&ecs, entities[i], ECS_ID(Position), &(Position){(f32)i, 0.0f, 0.0f}));
+        if (i % 2 == 0) {
+            assert(ecs_add_component(&ecs, entities[i], ECS_ID(TestEnemy), NULL));
+        }
+        if (i % 3 == 0) {
+            assert(ecs_add_component(&ecs, entities[i], selected, &(u8){1}));
+        }
+    }
+    assert(ecs_get_component(&ecs, entities[0], ECS_ID(TestEnemy)) && !ecs_get_component(&ecs, entities[1], ECS_ID(TestEnemy)));
+    assert(ecs_has_component(&ecs, entities[3], selected) && !ecs_has_component(&ecs, entities[3], ECS_ID(TestEnemy)));
+    assert(ecs_component_count(&ecs, ECS_ID(TestEnemy)) == TEST_ECS_ENTITY_COUNT / 2);
+    ecs_add_component(&ecs, entities[4], frozen, NULL);
+
+    // Enemies that are not frozen, with selection as an optional term.
+    ComponentType required[] = {ECS_ID(Position), ECS_ID(TestEnemy)};
+    EcsQueryDesc desc = {0};
+    desc.required = required;
+    desc.requiredCount = 2;
+    desc.optional = &selected;
+    desc.optionalCount = 1;
+    desc.excluded = &frozen;
+    desc.excludedCount = 1;
+    EcsQuery query;
+    assert(ecs_query_init(&query, &ecs, &desc) == ENGINE_SUCCESS);
+    TestQueryVisit visit = {0};
+    ecs_query_each(&query, test_tag_visit, &visit);
+    assert(visit.rows == TEST_ECS_ENTITY_COUNT / 2 - 1 && visit.optional == (TEST_ECS_ENTITY_COUNT + 5) / 6);
+
+    // Removing and destroying keep tag membership packed.
+    ecs_remove_component(&ecs, entities[0], ECS_ID(TestEnemy));
+    ecs_destroy_entity(&ecs, entities[2]);
+    assert(!ecs_has_component(&ecs, entities[0], ECS_ID(TestEnemy)) && ecs_query_count(&query) == TEST_ECS_ENTITY_COUNT / 2 - 3);
+    assert(ecs_component_count(&ecs, ECS_ID(TestEnemy)) == TEST_ECS_ENTITY_COUNT / 2 - 2);
+
+    // Batches ignore tag data, whatever is passed for it.
+    Entity batch[16];
+    ComponentType batchTypes[] = {ECS_ID(Position), selected};
+    Position positions[16] = {0};
+    const void *initData[] = {positions, positions};
+    assert(ecs_create_batch(&ecs, 16, batchTypes, 2, initData, batch) == ENGINE_SUCCESS);
+    assert(ecs_has_component(&ecs, batch[15], selected) && ecs_query_count(&query) == TEST_ECS_ENTITY_COUNT / 2 - 3);
+    ecs_query_destroy(&query);
+
+    // A query of tags alone still finds every tagged entity.
+    EcsQueryDesc tagDesc = {0};
+    tagDesc.required = &selected;
+    tagDesc.requiredCount = 1;
+    assert(ecs_query_init(&query, &ecs, &tagDesc) == ENGINE_SUCCESS);
+    assert(ecs_query_count(&query) == ecs_component_count(&ecs, selected) && ecs_query_matches(&query, batch[0]));
+    ecs_query_destroy(&query);
+
+    // Tags are never written or owned.
+    tagDesc.writes = &selected;
+    tagDesc.writeCount = 1;
+    assert(ecs_query_init(&query, &ecs, &tagDesc) == ENGINE_ERROR_INVALID_ARGUMENT);
+
+    if (storage == ECS_STORAGE_SPARSE_SET) {
+        // The signature bit is the whole membership: no pages or packed arrays.
+        const ComponentArray *tag = &ecs.componentArrays[selected];
+        assert(tag->data == ecs.componentArrays[frozen].data && !tag->entities && !tag->versions && tag->sparsePageCount == 0);
+        ComponentType owned[] = {ECS_ID(Position), selected};
+        assert(ecs_group_create(&ecs, owned, 2) == INVALID_ID_U32);
+    } else {
+        // A tag column takes no room, so tagged archetypes hold as many rows as untagged ones.
+        const EcsRecord *plain = &ecs.records[ecs_entity_index(entities[1])];
+        const EcsRecord *tagged = &ecs.records[ecs_entity_index(entities[6])];
+        assert(ecs.archetypes[plain->archetype].capacity == ecs.archetypes[tagged->archetype].capacity);
+    }
+
+    // Prefabs carry tags like any other component.
+    EcsPrefab prefab;
+    assert(ecs_prefab_init(&prefab, &ecs) == ENGINE_SUCCESS);
+    u32 root = ecs_prefab_add_entity(&prefab, INVALID_ID_U32, NULL);
+    assert(ecs_prefab_set(&prefab, root, ECS_ID(TestEnemy), NULL) && ecs_prefab_set(&prefab, root, ECS_ID(Position), NULL));
+    Entity spawned[8];
+    assert(ecs_prefab_instantiate(&prefab, 8, NULL, spawned) == ENGINE_SUCCESS);
+    assert(ecs_has_component(&ecs, spawned[7], ECS_ID(TestEnemy)) && ecs_has_component(&ecs, spawned[7], ECS_ID(Position)));
+    ecs_prefab_shutdown(&prefab);
+    ecs_shutdown(&ecs);
+
+    // The same scene with one-byte markers in place of tags takes more memory.
+    u64 usage[2];
+    Entity scene[4096];
+    for (u32 marker = 0; marker < 2; ++marker) {
+        assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+        ComponentType types[9] = {ECS_ID(Position)};
+        for (u32 t = 1; t < 9; ++t) {
+            types[t] = marker ? ecs_register_component(&ecs, 1) : ecs_register_tag(&ecs);
+        }
+        assert(ecs_create_batch(&ecs, 4096, types, 9, NULL, scene) == ENGINE_SUCCESS);
+        usage[marker] = ecs_memory_usage(&ecs);
+        ecs_shutdown(&ecs);
+    }
+    assert(usage[0] < usage[1]);
+    memory_pool_shutdown(&pool);
+}
+
+/** @brief Sorts positions by x, which the sorting test keeps integral. */
+static u64 test_sort_key(const void *component) {
+    return (u64)((const Position *)component)->x;
+}
+
+/**
+ * @brief Asserts that a sorted Position array is in key order and that each
+ * entity's sparse entry points at its row.
+ *
+ * @param ecs A pointer to the ECS manager.
+ * @param type The sorted Position type.
+ * @return void
+ */
+static void test_sort_check(const ECSManager *ecs, ComponentType type) {
+    const ComponentArray *componentArray = &ecs->componentArrays[type];
+    const Position *positions = (const Position *)componentArray->data;
+    for (u32 i = 0; i < componentArray->count; ++i) {
+        assert(i == 0 || positions[i - 1].x <= positions[i].x);
+        assert(componentArray->sortKeys[i] == (u64)positions[i].x);
+        u32 slot = ecs_entity_index(componentArray->entities[i]);
+        assert(componentArray->sparsePages[slot / ECS_SPARSE_PAGE_SIZE][slot % ECS_SPARSE_PAGE_SIZE] == i);
+    }
+}
+
+/** @brief Checks that a query driven by a sorted type visits it in order. */
+static void test_sort_visit(const EcsView *view, void *userData) {
+    f32 *last = (f32 *)userData;
+    const Position *positions = (const Position *)view->columns[0];
+    for (u32 i = 0; i < view->count; ++i) {
+        f32 x = positions[ecs_view_row(view, 0, i)].x;
+        assert(x >= *last);
+        *last = x;
+    }
+}
+
+/**
+ * @brief Checks that a sorted component array stays in key order through
+ * writes, adds, removes and a full reshuffle, moving rows in place for small
+ * changes and radix sorting large ones.
+ *
+ * @return void
+ */
+static void test_ecs_sorting(void) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = ECS_STORAGE_SPARSE_SET;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    ComponentType positionType = ecs_register_component(&ecs, sizeof(Position));
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+    ComponentType tag = ecs_register_tag(&ecs);
+
+    // Keys span three bytes, so the radix sort takes several passes.
+    static Entity entities[TEST_ECS_ENTITY_COUNT * 4];
+    u32 seed = 0x9E3779B9u;
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT * 4; ++i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        entities[i] = ecs_create_entity(&ecs);
+        assert(ecs_add_component(&ecs, entities[i], positionType, &(Position){(f32)(seed % 1000000), 0.0f, 0.0f}));
+        if (i % 4 == 0) {
+            assert(ecs_add_component(&ecs, entities[i], velocityType, NULL));
+        }
+    }
+    assert(ecs_sort_by(&ecs, positionType, test_sort_key) == ENGINE_SUCCESS);
+    test_sort_check(&ecs, positionType);
+
+    // A few writes, adds and removes are moved into place without new arrays.
+    const u8 *data = ecs.componentArrays[positionType].data;
+    const Entity *sorted = ecs_component_entities(&ecs, positionType);
+    Entity first = sorted[50];
+    Entity removed = sorted[ecs_component_count(&ecs, positionType) - 3];
+    ((Position *)ecs_get_component(&ecs, first, positionType))->x = 0.0f;
+    ((Position *)ecs_get_component(&ecs, sorted[100], positionType))->x += 1.0f;
+    ecs_remove_component(&ecs, removed, positionType);
+    Entity added = ecs_create_entity(&ecs);
+    assert(ecs_add_component(&ecs, added, positionType, &(Position){500000.0f, 0.0f, 0.0f}));
+    assert(ecs_sort(&ecs, positionType) == ENGINE_SUCCESS);
+    assert(ecs.componentArrays[positionType].data == data);
+    test_sort_check(&ecs, positionType);
+    assert(((const Position *)data)[0].x == 0.0f && ecs_component_entities(&ecs, positionType)[0] == first);
+
+    // Nothing changed, so nothing is re-keyed.
+    assert(ecs_sort(&ecs, positionType) == ENGINE_SUCCESS);
+    test_sort_check(&ecs, positionType);
+
+    // Reversing every key falls back to the radix sort.
+    Position *positions = (Position *)ecs_component_data(&ecs, positionType);
+    for (u32 i = 0; i < ecs_component_count(&ecs, positionType); ++i) {
+        positions[i].x = (f32)(1000000 - i);
+    }
+    assert(ecs_sort(&ecs, positionType) == ENGINE_SUCCESS);
+    assert(ecs.componentArrays[positionType].data != data);
+    test_sort_check(&ecs, positionType);
+
+    // The sorted type drives queries that require it, though Velocity is smaller.
+    EcsQuery query;
+    ComponentType required[] = {positionType, velocityType};
+    assert(ecs_query_init(&query, &ecs, &(EcsQueryDesc){.required = required, .requiredCount = 2}) == ENGINE_SUCCESS);
+    f32 last = 0.0f;
+    ecs_query_each(&query, test_sort_visit, &last);
+    assert(ecs_query_count(&query) == ecs_component_count(&ecs, velocityType));
+    ecs_query_destroy(&query);
+
+    // Groups, tags and archetype storage cannot sort.
+    assert(ecs_group_create(&ecs, required, 2) == INVALID_ID_U32);
+    assert(ecs_sort_by(&ecs, tag, test_sort_key) == ENGINE_ERROR_INVALID_ARGUMENT);
+    assert(ecs_sort_by(&ecs, positionType, NULL) == ENGINE_SUCCESS && !ecs.componentArrays[positionType].sortKeys);
+    assert(ecs_sort(&ecs, positionType) == ENGINE_ERROR_INVALID_ARGUMENT);
+    ecs_shutdown(&ecs);
+
+    config.storage = ECS_STORAGE_ARCHETYPE;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    positionType = ecs_register_component(&ecs, sizeof(Position));
+    assert(ecs_sort_by(&ecs, positionType, test_sort_key) == ENGINE_ERROR_INVALID_ARGUMENT);
+    ecs_shutdown(&ecs);
+    memory_pool_shutdown(&pool);
+}
+
+/**
+ * @brief Checks that restoring a snapshot undoes adds, removes, writes,
+ * creates and destroys, that a fresh ECS loads it, and that truncated or
+ * mismatched snapshots are rejected without changes.
+ *
+ * @param storage The storage layout to test.
+ * @return void
+ */
+static void test_ecs_snapshots(ECSStorage storage) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 8) == ENGINE_SUCCESS);
+    ECSManager ecs;
+    ECSConfig config = {0};
+    config.storage = storage;
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    ComponentType velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+
+    // Every entity has a Position, odd ones a Velocity, even ones the enemy tag.
+    Entity entities[TEST_ECS_ENTITY_COUNT];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        entities[i] = ecs_create_entity(&ecs);
+        assert(ecs_add_component(&ecs, entities[i], ECS_ID(Position), &(Position){(f32)i, 0.0f, 0.0f}));
+        if (i % 2 == 1) {
+            assert(ecs_add_component(&ecs, entities[i], velocityType, &(Velocity){1.0f, (f32)i, 0.0f}));
+        } else {
+            assert(ecs_add_component(&ecs, entities[i], ECS_ID(TestEnemy), NULL));
+        }
+    }
+    ecs_destroy_entity(&ecs, entities[7]);
+    ecs_destroy_entity(&ecs, entities[8]);
+
+    EcsQuery query;
+    ComponentType required[] = {ECS_ID(Position), velocityType};
+    assert(ecs_query_init(&query, &ecs, &(EcsQueryDesc){.required = required, .requiredCount = 2}) == ENGINE_SUCCESS);
+    u32 moving = ecs_query_count(&query);
+
+    // Sizing and writing agree, equal worlds give equal bytes and short buffers fail.
+    u64 size = ecs_snapshot_size(&ecs);
+    u8 *snapshot = (u8 *)memory_allocate(&pool, size, MEMORY_TAG_ECS);
+    u8 *copy = (u8 *)memory_allocate(&pool, size, MEMORY_TAG_ECS);
+    assert(snapshot && copy);
+    assert(ecs_snapshot(&ecs, snapshot, size) == ENGINE_SUCCESS && ecs_snapshot(&ecs, copy, size) == ENGINE_SUCCESS);
+    for (u64 i = 0; i < size; ++i) {
+        assert(snapshot[i] == copy[i]);
+    }
+    assert(ecs_snapshot(&ecs, copy, size - 1) == ENGINE_ERROR_INVALID_ARGUMENT);
+
+    // Change the world in every way, then roll it back.
+    ((Position *)ecs_get_component(&ecs, entities[0], ECS_ID(Position)))->x = -1.0f;
+    ecs_remove_component(&ecs, entities[1], velocityType);
+    ecs_add_component(&ecs, entities[2], velocityType, &(Velocity){0.0f, 0.0f, 0.0f});
+    ecs_add_component(&ecs, entities[6], velocityType, &(Velocity){0.0f, 0.0f, 0.0f});
+    ecs_remove_component(&ecs, entities[4], ECS_ID(TestEnemy));
+    ecs_destroy_entity(&ecs, entities[10]);
+    Entity created[TEST_ECS_ENTITY_COUNT / 10];
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT / 10; ++i) {
+        created[i] = ecs_create_entity(&ecs);
+        assert(ecs_add_component(&ecs, created[i], velocityType, NULL));
+    }
+    ComponentType later = ecs_register_component(&ecs, sizeof(u32));
+    assert(ecs_add_component(&ecs, entities[0], later, &(u32){1}));
+    assert(ecs_query_count(&query) != moving);
+
+    assert(ecs_restore(&ecs, snapshot, size) == ENGINE_SUCCESS);
+    for (u32 i = 0; i < TEST_ECS_ENTITY_COUNT; ++i) {
+        if (i == 7 || i == 8) {
+            assert(!ecs_entity_alive(&ecs, entities[i]));
+            continue;
+        }
+        assert(ecs_entity_alive(&ecs, entities[i]));
+        assert(((const Position *)ecs_get_component(&ecs, entities[i], ECS_ID(Position)))->x == (f32)i);
+        const Velocity *velocity = (const Velocity *)ecs_get_component(&ecs, entities[i], velocityType);
+        assert(i % 2 == 1 ? velocity && velocity->vy == (f32)i : !velocity);
+        assert(ecs_has_component(&ecs, entities[i], ECS_ID(TestEnemy)) == (i % 2 == 0));
+        assert(!ecs_has_component(&ecs, entities[i], later));
+    }
+    assert(!ecs_entity_alive(&ecs, created[TEST_ECS_ENTITY_COUNT / 10 - 1]));
+    assert(ecs_component_count(&ecs, velocityType) == TEST_ECS_ENTITY_COUNT / 2 - 1 && ecs_component_count(&ecs, later) == 0);
+    assert(ecs_query_count(&query) == moving);
+
+    // The world carries on as the original would: freed indices are reused.
+    Entity reused = ecs_create_entity(&ecs);
+    assert(ecs_entity_index(reused) == ecs_entity_index(entities[8]) || ecs_entity_index(reused) == ecs_entity_index(entities[7]));
+    assert(ecs_add_component(&ecs, reused, velocityType, NULL) && ecs_query_count(&query) == moving);
+    ecs_query_destroy(&query);
+
+    // A snapshot must be whole and from a matching ECS; rejection changes nothing.
+    u32 alive = ecs.entityManager.nextIndex;
+    assert(ecs_restore(&ecs, snapshot, size / 2) == ENGINE_ERROR_INVALID_ARGUMENT);
+    copy[0] ^= 0xFF;
+    assert(ecs_restore(&ecs, copy, size) == ENGINE_ERROR_INVALID_ARGUMENT);
+    assert(ecs.entityManager.nextIndex == alive && ecs_entity_alive(&ecs, reused));
+    ecs_shutdown(&ecs);
+
+    // A fresh ECS with the same types loads it.
+    assert(ecs_init(&ecs, &pool, &config) == ENGINE_SUCCESS);
+    assert(ecs_restore(&ecs, snapshot, size) == ENGINE_ERROR_INVALID_ARGUMENT);
+    velocityType = ecs_register_component(&ecs, sizeof(Velocity));
+
+    // Corrupt contents are rejected without creating archetypes. After the
+    // 48-byte header come the generations, the free indices (7 and 8) and the
+    // type table, each 16-byte aligned; the snapshot ends with the last sparse
+    // page or the last archetype chunk.
+    u64 freeOffset = 48 + sizeof(u32) * TEST_ECS_ENTITY_COUNT;
+    u64 typesOffset = freeOffset + 16;
+    for (u32 corruption = 0; corruption < 5; ++corruption) {
+        memory_copy(copy, snapshot, size);
+        u32 *generations = (u32 *)(copy + 48);
+        u32 *freeIndices = (u32 *)(copy + freeOffset);
+        assert(freeIndices[0] == ecs_entity_index(entities[7]) && freeIndices[1] == ecs_entity_index(entities[8]));
+        switch (corruption) {
+        case 0: // A free index listed twice.
+            freeIndices[1] = freeIndices[0];
+            break;
+        case 1: // A free index that is still alive.
+            freeIndices[0] = ecs_entity_index(entities[0]);
+            break;
+        case 2: // Stored handles older than their index's generation.
+            generations[ecs_entity_index(entities[0])]++;
+            break;
+        case 3: // A type count that disagrees with the stored entities.
+            ((u32 *)(copy + typesOffset + 16 * (u64)velocityType))[1]--;
+            break;
+        default:
+            if (storage == ECS_STORAGE_SPARSE_SET) {
+                *(u32 *)(copy + size - sizeof(u32)) = TEST_ECS_ENTITY_COUNT * 2;
+            } else {
+                *(Entity *)(copy + size - ECS_CHUNK_SIZE) = INVALID_ENTITY;
+            }
+            break;
+        }
+        assert(ecs_restore(&ecs, copy, size) == ENGINE_ERROR_INVALID_ARGUMENT);
+        assert(ecs.archetypeCount == 0 && ecs.entityManager.nextIndex == 0);
+    }
+
+    assert(ecs_restore(&ecs, snapshot, size) == ENGINE_SUCCESS);
+    assert(ecs_entity_alive(&ecs, entities[999]) && ((const Velocity *)ecs_get_component(&ecs, entities[999], velocityType))->vy == 999.0f);
+    assert(ecs_component_count(&ecs, ECS_ID(TestEnemy)) == TEST_ECS_ENTITY_COUNT / 2 - 1);
+    assert(ecs_query_init(&query, &ecs, &(EcsQueryDesc){.required = required, .requiredCount = 2}) == ENGINE_SUCCESS);
+    assert(ecs_query_count(&query) == moving);
+    ecs_query_destroy(&query);
+    ecs_shutdown(&ecs);
+
+    memory_free(&pool, snapshot, MEMORY_TAG_ECS);
+    memory_free(&pool, copy, MEMORY_TAG_ECS);
+    memory_pool_shutdown(&pool);
+}
+
+void test_ecs(void) {
+    test_ecs_static_components();
+    test_ecs_storage(ECS_STORAGE_SPARSE_SET);
+    test_ecs_storage(ECS_STORAGE_ARCHETYPE);
+    test_ecs_sparse_pages();
+    test_ecs_signatures(ECS_STORAGE_SPARSE_SET);
+    test_ecs_signatures(ECS_STORAGE_ARCHETYPE);
+    test_ecs_tags(ECS_STORAGE_SPARSE_SET);
+    test_ecs_tags(ECS_STORAGE_ARCHETYPE);
+    test_ecs_queries(ECS_STORAGE_SPARSE_SET);
+    test_ecs_queries(ECS_STORAGE_ARCHETYPE);
+    test_ecs_changes(ECS_STORAGE_SPARSE_SET);
+    test_ecs_changes(ECS_STORAGE_ARCHETYPE);
+    test_ecs_batches(ECS_STORAGE_SPARSE_SET);
+    test_ecs_batches(ECS_STORAGE_ARCHETYPE);
+    test_ecs_groups();
+    test_ecs_sorting();
+    test_ecs_snapshots(ECS_STORAGE_SPARSE_SET);
+    test_ecs_snapshots(ECS_STORAGE_ARCHETYPE);
+    test_ecs_systems(ECS_STORAGE_SPARSE_SET, 0);
+    test_ecs_systems(ECS_STORAGE_ARCHETYPE, 0);
+    test_ecs_systems(ECS_STORAGE_SPARSE_SET, 4);
+    test_ecs_systems(ECS_STORAGE_ARCHETYPE, 4);
+    test_ecs_commands(ECS_STORAGE_SPARSE_SET, 0);
+    test_ecs_commands(ECS_STORAGE_ARCHETYPE, 0);
+    test_ecs_commands(ECS_STORAGE_SPARSE_SET, 4);
+    test_ecs_commands(ECS_STORAGE_ARCHETYPE, 4);
+    test_ecs_hierarchy(0);
+    test_ecs_hierarchy(4);
+    test_ecs_prefabs(ECS_STORAGE_SPARSE_SET);
+    test_ecs_prefabs(ECS_STORAGE_ARCHETYPE);
+
+    log_info("ECS unit tests passed.");
+}
@@ -0,0 +1,113 @@
+#include "tests.h"
+#include <assert.h>
+#include <engine/job_system.h>
+#include <engine/logging.h>
+#include <engine/memory.h>
+#include <engine/parallel.h>
+
+#define TEST_JOB_COUNT 10000
+#define TEST_CHILD_COUNT 16
+#define TEST_PARALLEL_COUNT 100000
+
+static PlatformAtomicI32 executed;
+
+static void increment_job(void *userData) {
+    ENGINE_UNUSED(userData);
+    platform_atomic_fetch_add_i32(&executed, 1);
+}
+
+// Spawns children and waits on them from inside a job.
+static void parent_job(void *userData) {
+    ENGINE_UNUSED(userData);
+
+    JobDecl children[TEST_CHILD_COUNT];
+    for (u32 i = 0; i < TEST_CHILD_COUNT; ++i) {
+        children[i] = (JobDecl){increment_job, NULL};
+    }
+
+    JobCounter counter = {0};
+    job_run(children, TEST_CHILD_COUNT, &counter);
+    job_wait(&counter);
+    assert(job_is_complete(&counter));
+}
+
+static void square_range(u32 begin, u32 end, void *userData) {
+    u32 *values = (u32 *)userData;
+    for (u32 i = begin; i < end; ++i) {
+        values[i] = i * 2;
+    }
+}
+
+static void sum_range(u32 begin, u32 end, void *partial, void *userData) {
+    const u32 *values = (const u32 *)userData;
+    u64 sum = *(u64 *)partial;
+    for (u32 i = begin; i < end; ++i) {
+        sum += values[i];
+    }
+    *(u64 *)partial = sum;
+}
+
+static void sum_combine(void *result, const void *partial, void *userData) {
+    ENGINE_UNUSED(userData);
+    *(u64 *)result += *(const u64 *)partial;
+}
+
+/**
+ * @brief Runs the job system tests in thread or fiber mode.
+ *
+ * @param useFibers True to run jobs on fibers.
+ * @return void
+ */
+static void test_job_system_mode(b8 useFibers) {
+    MemoryPool pool;
+    assert(memory_pool_init(&pool, 1024 * 1024 * 4) == ENGINE_SUCCESS);
+
+    JobSystemConfig config = {0};
+    config.workerCount = 4;
+    config.useFibers = useFibers;
+    config.fiberCount = 32; // Fewer than the parents, so some run without a fiber.
+    assert(job_system_init(&pool, &config) == ENGINE_SUCCESS);
+    assert(job_system_uses_fibers() == (useFibers && platform_fiber_supported()));
+    assert(job_system_get_worker_count() == 4);
+    assert(job_system_get_worker_index() == 0);
+
+    // Flat batch larger than a single queue.
+    static JobDecl jobs[TEST_JOB_COUNT];
+    for (u32 i = 0; i < TEST_JOB_COUNT; ++i) {
+        jobs[i] = (JobDecl){increment_job, NULL};
+    }
+
+    platform_atomic_store_i32(&executed, 0);
+    JobCounter counter = {0};
+    job_run(jobs, TEST_JOB_COUNT, &counter);
+    job_wait(&counter);
+    assert(platform_atomic_load_i32(&executed) == TEST_JOB_COUNT);
+
+    // Nested waits must make progress instead of deadlocking the workers.
+    JobDecl parents[64];
+    for (u32 i = 0; i < 64; ++i) {
+        parents[i] = (JobDecl){parent_job, NULL};
+    }
+
+    platform_atomic_store_i32(&executed, 0);
+    job_run(parents, 64, &counter);
+    job_wait(&counter);
+    assert(platform_atomic_load_i32(&executed) == 64 * TEST_CHILD_COUNT);
+
+    // Every element is visited exactly once and the reduction sees them all.
+    static u32 values[TEST_PARALLEL_COUNT];
+    parallel_for(TEST_PARALLEL_COUNT, 0, square_range, values);
+    u64 sum = 0;
+    parallel_reduce(TEST_PARALLEL_COUNT, 0, sum_range, sum_combine, &sum, sizeof(sum), values);
+    assert(sum == (u64)TEST_PARALLEL_COUNT * (TEST_PARALLEL_COUNT - 1));
+
+    job_system_shutdown();
+    memory_pool_shutdown(&pool);
+}
+
+void test_job_system(void) {
+    test_job_system_mode(false);
+    test_job_system_mode(true);
+
+    log_info("Job system unit tests passed.");
+}
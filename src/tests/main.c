@@ -0,0 +1,10 @@
+#include "tests.h"
+
+int main(void) {
+    test_job_system();
+    test_ecs();
+
+    // Last, as it needs a video device and the others do not.
+    test_platform_initialization();
+    return 0;
+}
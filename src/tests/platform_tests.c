@@ -1,7 +1,9 @@
+#include "tests.h"
 #include <assert.h>
 #include <engine/logging.h>
 #include <engine/memory.h>
 #include <engine/platform.h>
+#include <engine/window.h>
 
 void test_platform_initialization(void) {
     MemoryPool pool;
@@ -10,8 +12,20 @@ void test_platform_initialization(void) {
     // Initialize memory pool.
     assert(memory_pool_init(&pool, poolSize) == ENGINE_SUCCESS);
 
+    // Describe the window the platform creates.
+    Window window = {0};
+    WindowConfig windowConfig = {0};
+    windowConfig.title = "Era Platform Tests";
+    windowConfig.x = 100;
+    windowConfig.y = 100;
+    windowConfig.width = 640;
+    windowConfig.height = 480;
+    windowConfig.fullScreen = false;
+    assert(window_init(&pool, &windowConfig, &window) == ENGINE_SUCCESS);
+
     // Initialize Platform.
     Platform platform = {0};
+    platform.window = &window;
     assert(platform_init(&platform, &pool) == ENGINE_SUCCESS);
 
     // Check if the platform is running.
@@ -19,14 +33,10 @@ void test_platform_initialization(void) {
 
     // Shutdown Platform.
     platform_shutdown(&platform);
+    window_shutdown(&pool, &window);
 
     // Shutdown memory pool.
     memory_pool_shutdown(&pool);
 
     log_info("Platform unit tests passed.");
 }
-
-int main(void) {
-    test_platform_initialization();
-    return 0;
-}
@@ -0,0 +1,10 @@
+#ifndef TESTS_H
+#define TESTS_H
+
+// Each test suite lives in its own source file and is run from main.c.
+
+void test_platform_initialization(void);
+void test_job_system(void);
+void test_ecs(void);
+
+#endif // TESTS_H